@@ -0,0 +1,8 @@
+// Per-frame camera data, bound to UniformBinding::Camera by the renderer
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec3 cameraPosition;
+    float time;
+};
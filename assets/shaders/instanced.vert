@@ -0,0 +1,10 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 3) in mat4 aInstanceModel;
+
+#include "include/camera.glsl"
+
+void main() {
+    gl_Position = viewProjection * aInstanceModel * vec4(aPos, 1.0);
+}
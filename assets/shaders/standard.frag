@@ -0,0 +1,36 @@
+#version 330 core
+#ifdef CIRCE_BINDLESS
+#extension GL_ARB_bindless_texture : require
+#endif
+
+// Features: HAS_ALBEDO, ALPHA_TEST
+// CIRCE_BINDLESS is defined by the engine when bindless textures are enabled
+
+#ifdef HAS_ALBEDO
+in vec2 vTexCoord;
+#ifndef CIRCE_BINDLESS
+uniform sampler2D albedo;
+#endif
+#endif
+
+out vec4 FragColor;
+
+layout(std140) uniform Material {
+    vec4 color;
+#if defined(HAS_ALBEDO) && defined(CIRCE_BINDLESS)
+    sampler2D albedo;
+#endif
+};
+
+void main() {
+    vec4 result = color;
+#ifdef HAS_ALBEDO
+    result *= texture(albedo, vTexCoord);
+#endif
+#ifdef ALPHA_TEST
+    if (result.a < 0.5) {
+        discard;
+    }
+#endif
+    FragColor = result;
+}
@@ -0,0 +1,31 @@
+#version 330 core
+
+// Features: INSTANCED, HAS_ALBEDO
+
+layout (location = 0) in vec3 aPos;
+layout (location = 2) in vec2 aTexCoord;
+#ifdef INSTANCED
+layout (location = 3) in mat4 aInstanceModel;
+#endif
+
+#include "include/camera.glsl"
+
+#ifndef INSTANCED
+uniform mat4 model;
+#endif
+
+#ifdef HAS_ALBEDO
+out vec2 vTexCoord;
+#endif
+
+void main() {
+#ifdef INSTANCED
+    mat4 world = aInstanceModel;
+#else
+    mat4 world = model;
+#endif
+#ifdef HAS_ALBEDO
+    vTexCoord = aTexCoord;
+#endif
+    gl_Position = viewProjection * world * vec4(aPos, 1.0);
+}
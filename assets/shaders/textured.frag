@@ -0,0 +1,15 @@
+#version 330 core
+
+in vec2 vTexCoord;
+
+out vec4 FragColor;
+
+uniform sampler2D albedo;
+
+layout(std140) uniform Material {
+    vec4 color;
+};
+
+void main() {
+    FragColor = texture(albedo, vTexCoord) * color;
+}
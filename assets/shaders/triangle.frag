@@ -2,7 +2,9 @@
 
 out vec4 FragColor;
 
-uniform vec4 color;
+layout(std140) uniform Material {
+    vec4 color;
+};
 
 void main() {
     FragColor = color;
@@ -1,15 +1,37 @@
 #include "Engine.h"
 #include "Window.h"
 #include "Time.h"
+#include "FileWatcher.h"
 #include "../Renderer/Renderer.h"
+#include "../Renderer/Framebuffer.h"
+#include "../Renderer/MaterialBlockPool.h"
+#include "../Renderer/ShaderCache.h"
+#include "../Renderer/ShaderLibrary.h"
+#include "../Renderer/Texture.h"
+#include "../Renderer/TextureLoader.h"
+#include "../Ressources/TextureManager.h"
 #include "../Scene/Scene.h"
 #include "Logging/ErrorReporting.h"
+#include "Jobs/JobSystem.h"
+#include "Profiling/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <utility>
 
 namespace Circe {
 
-    Engine::Engine(int width, int height, const char* title) {
-        m_Window = std::make_unique<Window>(width, height, title);
-        m_Renderer = std::make_unique<Renderer>();
+    Engine::Engine(int width, int height, const char* title)
+        : Engine(width, height, title, EngineSettings{}) {
+    }
+
+    Engine::Engine(int width, int height, const char* title, const EngineSettings& settings)
+        : m_Settings(settings) {
+        m_Settings.FrameLatency = std::clamp(m_Settings.FrameLatency, 1u, MaxFrameLatency);
+        m_Window = std::make_unique<Window>(width, height, title, !settings.Headless);
+        m_Window->SetVSync(settings.VSync && !settings.Headless);
+        // Pipelined, every frame the main thread may be ahead by needs its own command packet
+        m_Renderer = std::make_unique<Renderer>(m_Settings.Pipelined ? m_Settings.FrameLatency + 1 : 2);
         Initialize();
     }
     
@@ -18,13 +40,40 @@ namespace Circe {
     }
     
     void Engine::Initialize() {
+        CIRCE_PROFILE_THREAD("Main");
+        JobSystem::Initialize();
+        if (m_Settings.HotReload) {
+            FileWatcher::Initialize();
+        }
         m_Renderer->Initialize();
+        ShaderCache::Initialize(m_Settings.ShaderCacheDirectory);
+        ShaderLibrary::Initialize();
+        if (m_Settings.BindlessTextures && Texture::SupportsBindless()) {
+            ShaderLibrary::AddGlobalDefine("CIRCE_BINDLESS");
+        }
+        Profiler::Initialize();
+        TextureLoader::Initialize();
+        if (m_Settings.Headless) {
+            m_Framebuffer = std::make_unique<Framebuffer>(m_Window->GetWidth(), m_Window->GetHeight());
+        }
         m_Running = true;
         enableReportGlErrors();
     }
 
     void Engine::Shutdown() {
         m_Running = false;
+        if (m_RenderThread.joinable()) {
+            StopRenderThread();
+        }
+        m_Framebuffer.reset();
+        TextureManager::Clear();
+        TextureLoader::Shutdown();
+        MaterialBlockPool::Shutdown();
+        Profiler::Shutdown();
+        ShaderLibrary::Shutdown();
+        ShaderCache::Shutdown();
+        FileWatcher::Shutdown();
+        JobSystem::Shutdown();
     }
 
     void Engine::SetScene(Scene* scene) {
@@ -38,30 +87,188 @@ namespace Circe {
             m_ActiveScene->OnInit();
         }
         
+        m_FrameStats = {};
+        m_SimulationTotalMs = 0.0;
+        m_RenderTotalMs = 0.0;
+        m_LatencyTotalMs = 0.0;
+        m_AddedLatencyTotalMs = 0.0;
+        Profiler::ResetFrameTimes();
+        if (m_Settings.Pipelined) {
+            StartRenderThread();
+        }
+
+        uint32_t frame = 0;
         while (m_Running && !m_Window->ShouldClose()) {
+            if (m_Settings.FrameLimit > 0 && frame >= m_Settings.FrameLimit) {
+                break;
+            }
+            const auto frameStart = std::chrono::steady_clock::now();
+            if (m_Settings.Pipelined) {
+                // Waiting before the update rather than after it keeps input fresh. The render
+                // thread marks profiler frames, it owns the GPU queries.
+                if (!WaitForFrameSlot()) {
+                    break;
+                }
+            } else {
+                CIRCE_PROFILE_FRAME();
+            }
+            CIRCE_PROFILE_SCOPE("Frame");
+            const auto simulationStart = std::chrono::steady_clock::now();
+
             float deltaTime = Time::GetDeltaTime();
             Time::Update();
 
             m_Window->PollEvents();
             
             Update(deltaTime);
-            Render();
-            
-            m_Window->SwapBuffers();
+
+            if (m_Settings.Pipelined) {
+                SubmitFrame(simulationStart);
+            } else {
+                const auto renderStart = std::chrono::steady_clock::now();
+                Render();
+                m_Window->SwapBuffers();
+
+                const auto renderEnd = std::chrono::steady_clock::now();
+                m_SimulationTotalMs += std::chrono::duration<double, std::milli>(renderStart - simulationStart).count();
+                m_RenderTotalMs += std::chrono::duration<double, std::milli>(renderEnd - renderStart).count();
+                m_LatencyTotalMs += std::chrono::duration<double, std::milli>(renderEnd - simulationStart).count();
+            }
+
+            const auto frameEnd = std::chrono::steady_clock::now();
+            RecordFrameTime(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+            frame++;
+        }
+
+        if (m_Settings.Pipelined) {
+            StopRenderThread();
+            if (m_RenderThreadError) {
+                std::rethrow_exception(std::exchange(m_RenderThreadError, nullptr));
+            }
         }
         
         if (m_ActiveScene) {
             m_ActiveScene->OnShutdown();
         }
+
+        const FrameTimePercentiles percentiles = Profiler::GetFrameTimePercentiles();
+        m_FrameStats.P50Ms = percentiles.P50;
+        m_FrameStats.P95Ms = percentiles.P95;
+        m_FrameStats.P99Ms = percentiles.P99;
+
+        if (m_FrameStats.Frames > 0) {
+            const double frames = m_FrameStats.Frames;
+            m_FrameStats.SimulationMs = m_SimulationTotalMs / frames;
+            m_FrameStats.RenderMs = m_RenderTotalMs / frames;
+            m_FrameStats.LatencyMs = m_LatencyTotalMs / frames;
+            m_FrameStats.AddedLatencyMs = m_AddedLatencyTotalMs / frames;
+            m_FrameStats.OverlapMs = std::max(0.0, m_FrameStats.SimulationMs + m_FrameStats.RenderMs - m_FrameStats.AverageMs);
+            const double shorterStage = std::min(m_FrameStats.SimulationMs, m_FrameStats.RenderMs);
+            m_FrameStats.OverlapRatio = shorterStage > 0.0 ? std::min(1.0, m_FrameStats.OverlapMs / shorterStage) : 0.0;
+        }
+
+        if (m_Settings.Headless) {
+            std::cout << "Frames: " << m_FrameStats.Frames
+                << " | avg " << m_FrameStats.AverageMs << " ms"
+                << " | min " << m_FrameStats.MinMs << " ms"
+                << " | max " << m_FrameStats.MaxMs << " ms"
+                << " | p50 " << m_FrameStats.P50Ms << " ms"
+                << " | p95 " << m_FrameStats.P95Ms << " ms"
+                << " | p99 " << m_FrameStats.P99Ms << " ms" << std::endl;
+            std::cout << (m_Settings.Pipelined ? "Pipelined" : "Serial")
+                << " | simulation " << m_FrameStats.SimulationMs << " ms"
+                << " | render " << m_FrameStats.RenderMs << " ms"
+                << " | overlap " << m_FrameStats.OverlapMs << " ms (" << m_FrameStats.OverlapRatio * 100.0 << "%)"
+                << " | latency " << m_FrameStats.LatencyMs << " ms (+" << m_FrameStats.AddedLatencyMs << " ms queued)" << std::endl;
+        }
+
+#if CIRCE_PROFILE_ENABLED
+        if (!m_Settings.TraceOutput.empty() && !Profiler::ExportChromeTrace(m_Settings.TraceOutput)) {
+            std::cerr << "Failed to write trace to " << m_Settings.TraceOutput << std::endl;
+        }
+#endif
+    }
+
+    void Engine::RecordFrameTime(double milliseconds) {
+        FrameStats& stats = m_FrameStats;
+        stats.MinMs = stats.Frames == 0 ? milliseconds : std::min(stats.MinMs, milliseconds);
+        stats.MaxMs = std::max(stats.MaxMs, milliseconds);
+        stats.TotalMs += milliseconds;
+        stats.Frames++;
+        stats.AverageMs = stats.TotalMs / stats.Frames;
+        Profiler::RecordFrameTime(milliseconds);
+    }
+
+    void Engine::ReadPixels(std::vector<uint8_t>& pixels) const {
+        if (m_Framebuffer) {
+            m_Framebuffer->ReadPixels(pixels);
+            return;
+        }
+
+        // Windowed: read the back buffer the last frame was rendered to
+        pixels.resize(static_cast<size_t>(m_Window->GetWidth()) * m_Window->GetHeight() * 4);
+        m_Renderer->ReadPixels(0, 0, m_Window->GetWidth(), m_Window->GetHeight(), pixels.data());
     }
 
     void Engine::Update(float deltaTime) {
+        CIRCE_PROFILE_FUNCTION();
         if (m_ActiveScene) {
             m_ActiveScene->Update(deltaTime);
         }
     }
 
+    void Engine::ProcessReloads() {
+        if (FileWatcher::IsRunning()) {
+            const std::vector<std::string> changes = FileWatcher::PollChanges();
+            if (!changes.empty()) {
+                ShaderLibrary::OnFilesChanged(changes);
+                TextureManager::OnFilesChanged(changes);
+            }
+        }
+        ShaderLibrary::UpdateReloads();
+    }
+
+    void Engine::RunOnRenderThread(std::function<void()> task) {
+        std::lock_guard<std::mutex> lock(m_RenderTasksMutex);
+        m_RenderTasks.push_back(std::move(task));
+    }
+
+    void Engine::RunRenderTasks() {
+        {
+            // Swapping keeps both lists' storage, so frames without new tasks never allocate
+            std::lock_guard<std::mutex> lock(m_RenderTasksMutex);
+            m_RunningTasks.swap(m_RenderTasks);
+        }
+        for (std::function<void()>& task : m_RunningTasks) {
+            task();
+        }
+        m_RunningTasks.clear();
+    }
+
+    void Engine::BeginRenderFrame() {
+        // Meshes and materials of entities destroyed while this frame was recorded
+        m_ReleasingResources.clear();
+        RunRenderTasks();
+
+        int width = 0;
+        int height = 0;
+        if (m_Window->ConsumeResize(width, height)) {
+            m_Renderer->SetViewport(0, 0, width, height);
+        }
+        if (m_Framebuffer) {
+            m_Framebuffer->Bind();
+        }
+
+        ProcessReloads();
+        TextureLoader::Update();
+        TextureManager::Update();
+    }
+
     void Engine::Render() {
+        CIRCE_PROFILE_FUNCTION();
+        BeginRenderFrame();
+
+        m_Renderer->BeginFrame();
         m_Renderer->Clear();
         
         if (m_ActiveScene) {
@@ -71,4 +278,121 @@ namespace Circe {
         m_Renderer->Present();
     }
 
-}
\ No newline at end of file
+    void Engine::StartRenderThread() {
+        m_FramesSubmitted = 0;
+        m_FramesDrawn = 0;
+        m_StopRenderThread = false;
+        m_RenderThreadError = nullptr;
+        m_Renderer->SetGpuFrameLatency(m_Settings.FrameLatency);
+        if (m_ActiveScene) {
+            m_ActiveScene->SetDeferResourceRelease(true);
+        }
+
+        m_Window->ReleaseContext();
+        m_RenderThread = std::thread(&Engine::RenderThreadLoop, this);
+    }
+
+    void Engine::StopRenderThread() {
+        // The render thread draws whatever is still queued before it exits
+        {
+            std::lock_guard<std::mutex> lock(m_PipelineMutex);
+            m_StopRenderThread = true;
+        }
+        m_PipelineCondition.notify_all();
+        m_RenderThread.join();
+
+        m_Window->MakeContextCurrent();
+        m_Renderer->SetGpuFrameLatency(0);
+        m_ReleasingResources.clear();
+        if (m_ActiveScene) {
+            m_ActiveScene->SetDeferResourceRelease(false);
+        }
+        RunRenderTasks();
+    }
+
+    bool Engine::WaitForFrameSlot() {
+        // Recording reuses the packet of frame N - FrameLatency - 1, which has to be drawn by then
+        CIRCE_PROFILE_SCOPE("WaitForRenderThread");
+        std::unique_lock<std::mutex> lock(m_PipelineMutex);
+        m_PipelineCondition.wait(lock, [this] {
+            return m_FramesSubmitted - m_FramesDrawn <= m_Settings.FrameLatency || m_RenderThreadError;
+        });
+        return !m_RenderThreadError;
+    }
+
+    void Engine::SubmitFrame(std::chrono::steady_clock::time_point simulationStart) {
+        {
+            CIRCE_PROFILE_SCOPE("RecordCommands");
+            m_Renderer->BeginFrame();
+            if (m_ActiveScene) {
+                m_ActiveScene->RecordCommands(*m_Renderer);
+            }
+        }
+        const uint32_t packet = m_Renderer->EndFrame();
+        const auto simulationEnd = std::chrono::steady_clock::now();
+        const double simulationMs = std::chrono::duration<double, std::milli>(simulationEnd - simulationStart).count();
+
+        {
+            std::lock_guard<std::mutex> lock(m_PipelineMutex);
+            const size_t slot = m_FramesSubmitted % (MaxFrameLatency + 1);
+            m_PipelineFrames[slot] = { packet, simulationStart, simulationMs };
+            // Swapping hands the storage back and forth, so frames without destroys never allocate
+            if (m_ActiveScene) {
+                m_ActiveScene->SwapReleasedResources(m_PipelineReleases[slot]);
+            }
+            m_FramesSubmitted++;
+            m_SimulationTotalMs += simulationMs;
+        }
+        m_PipelineCondition.notify_all();
+    }
+
+    void Engine::RenderThreadLoop() {
+        CIRCE_PROFILE_THREAD("Render");
+        m_Window->MakeContextCurrent();
+        try {
+            while (true) {
+                PipelineFrame frame;
+                {
+                    std::unique_lock<std::mutex> lock(m_PipelineMutex);
+                    m_PipelineCondition.wait(lock, [this] {
+                        return m_FramesDrawn < m_FramesSubmitted || m_StopRenderThread;
+                    });
+                    if (m_FramesDrawn == m_FramesSubmitted) {
+                        break;
+                    }
+                    frame = m_PipelineFrames[m_FramesDrawn % (MaxFrameLatency + 1)];
+                    m_ReleasingResources.swap(m_PipelineReleases[m_FramesDrawn % (MaxFrameLatency + 1)]);
+                }
+
+                const auto renderStart = std::chrono::steady_clock::now();
+                {
+                    CIRCE_PROFILE_FRAME();
+                    CIRCE_PROFILE_SCOPE("RenderFrame");
+                    BeginRenderFrame();
+                    m_Renderer->Clear();
+                    m_Renderer->Flush(frame.Packet);
+                    m_Renderer->Present();
+                    m_Window->SwapBuffers();
+                }
+                const auto renderEnd = std::chrono::steady_clock::now();
+                const double renderMs = std::chrono::duration<double, std::milli>(renderEnd - renderStart).count();
+                const double latencyMs = std::chrono::duration<double, std::milli>(renderEnd - frame.Start).count();
+
+                {
+                    std::lock_guard<std::mutex> lock(m_PipelineMutex);
+                    m_RenderTotalMs += renderMs;
+                    m_LatencyTotalMs += latencyMs;
+                    m_AddedLatencyTotalMs += std::max(0.0, latencyMs - frame.SimulationMs - renderMs);
+                    m_FramesDrawn++;
+                }
+                m_PipelineCondition.notify_all();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_PipelineMutex);
+            m_RenderThreadError = std::current_exception();
+        }
+        m_PipelineCondition.notify_all();
+        m_Window->ReleaseContext();
+    }
+
+}
@@ -1,13 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace Circe {
     class Window;
     class Renderer;
     class Scene;
+    class Framebuffer;
+
+    struct EngineSettings {
+        // Invisible window (or a display-less context when no display is available),
+        // rendering goes to an offscreen framebuffer
+        bool Headless = false;
+        // Run() returns after this many frames, 0 runs until the window closes
+        uint32_t FrameLimit = 0;
+        bool VSync = true;
+        // Chrome trace JSON written when Run() returns (profiler builds only)
+        std::string TraceOutput;
+        // Linked program binaries are cached here between runs, empty disables the cache
+        std::string ShaderCacheDirectory = "shader_cache";
+        // Watch loaded shader and texture files and reload them in place when they change
+        bool HotReload = false;
+        // Pass material textures as ARB_bindless_texture handles where the driver supports it;
+        // shaders see CIRCE_BINDLESS defined
+        bool BindlessTextures = false;
+        // Simulate and render on separate threads: a render thread takes the GL context and
+        // draws frame N while the main thread updates and records frame N + 1. Scene code then
+        // must not call GL or change resources a queued frame still draws with; hand that
+        // work to Engine::RunOnRenderThread. Meshes, materials and models that destroyed
+        // entities drop are released on the render thread by the engine.
+        bool Pipelined = false;
+        // Frames the main thread may run ahead of the render thread, and the GPU behind it (1-3)
+        uint32_t FrameLatency = 1;
+    };
+
+    // Frame times of the frames rendered by the last Run(), in milliseconds
+    struct FrameStats {
+        uint32_t Frames = 0;
+        double TotalMs = 0.0;
+        double MinMs = 0.0;
+        double MaxMs = 0.0;
+        double AverageMs = 0.0;
+        double P50Ms = 0.0;
+        double P95Ms = 0.0;
+        double P99Ms = 0.0;
+        // Per-frame stage averages. Simulation is events and update, plus command recording
+        // when pipelined; Render runs through the buffer swap, GPU throttling included.
+        double SimulationMs = 0.0;
+        double RenderMs = 0.0;
+        // Stage time hidden by running the stages at once (Simulation + Render - frame time),
+        // and that as a share of the shorter stage: 1 when it is hidden completely
+        double OverlapMs = 0.0;
+        double OverlapRatio = 0.0;
+        // Event poll to buffer swap of the same frame, and the part of it the frame spent
+        // queued between the stages instead of being worked on
+        double LatencyMs = 0.0;
+        double AddedLatencyMs = 0.0;
+    };
 
     class Engine {
     public:
         Engine(int width, int height, const char* title);
+        Engine(int width, int height, const char* title, const EngineSettings& settings);
         ~Engine();
 
         // Main loop - call this from main()
@@ -16,20 +79,81 @@ namespace Circe {
         // Access to subsystems
         Window* GetWindow() const { return m_Window.get(); }
         Renderer* GetRenderer() const { return m_Renderer.get(); }
+        // Offscreen target used in headless mode, null otherwise
+        Framebuffer* GetFramebuffer() const { return m_Framebuffer.get(); }
         
         // Game sets the active scene
         void SetScene(Scene* scene);
 
+        const EngineSettings& GetSettings() const { return m_Settings; }
+        const FrameStats& GetFrameStats() const { return m_FrameStats; }
+
+        // RGBA8 pixels of the last rendered frame, bottom row first
+        void ReadPixels(std::vector<uint8_t>& pixels) const;
+
+        // Runs task on the thread holding the GL context before it draws its next frame: the
+        // render thread when pipelined, otherwise the main thread at the start of rendering
+        void RunOnRenderThread(std::function<void()> task);
+
     private:
+        static constexpr uint32_t MaxFrameLatency = 3;
+
         void Initialize();
         void Shutdown();
         void Update(float deltaTime);
         void Render();
+        // GL thread, before drawing: queued tasks, viewport, reloads and texture uploads
+        void BeginRenderFrame();
+        void RunRenderTasks();
+        // Frame boundary: routes file changes to the reloaders and swaps in finished rebuilds
+        void ProcessReloads();
+        void RecordFrameTime(double milliseconds);
 
+        // Pipelined mode. The main thread records frames and hands them over; the render
+        // thread draws them in order.
+        void StartRenderThread();
+        void StopRenderThread();
+        void SubmitFrame(std::chrono::steady_clock::time_point simulationStart);
+        void RenderThreadLoop();
+        // Blocks until recording another frame keeps within FrameLatency; false on a render thread error
+        bool WaitForFrameSlot();
+
+        EngineSettings m_Settings;
         std::unique_ptr<Window> m_Window;
         std::unique_ptr<Renderer> m_Renderer;
+        std::unique_ptr<Framebuffer> m_Framebuffer;
         Scene* m_ActiveScene = nullptr;
+        FrameStats m_FrameStats;
+        // Stage sums of the current Run(), averaged into m_FrameStats when it returns
+        double m_SimulationTotalMs = 0.0;
+        double m_RenderTotalMs = 0.0;
+        double m_LatencyTotalMs = 0.0;
+        double m_AddedLatencyTotalMs = 0.0;
+
+        std::mutex m_RenderTasksMutex;
+        std::vector<std::function<void()>> m_RenderTasks;
+        std::vector<std::function<void()>> m_RunningTasks;
+
+        // A frame handed to the render thread: its command packet and when it started
+        struct PipelineFrame {
+            uint32_t Packet = 0;
+            std::chrono::steady_clock::time_point Start;
+            double SimulationMs = 0.0;
+        };
+        std::thread m_RenderThread;
+        std::mutex m_PipelineMutex;
+        std::condition_variable m_PipelineCondition;
+        // Frame n waits in slot n % size until the render thread takes it
+        PipelineFrame m_PipelineFrames[MaxFrameLatency + 1];
+        // Resources the scene dropped while recording frame n, released before the render
+        // thread draws it, once no earlier frame can still reference them
+        std::vector<std::shared_ptr<void>> m_PipelineReleases[MaxFrameLatency + 1];
+        std::vector<std::shared_ptr<void>> m_ReleasingResources;
+        uint64_t m_FramesSubmitted = 0;
+        uint64_t m_FramesDrawn = 0;
+        bool m_StopRenderThread = false;
+        std::exception_ptr m_RenderThreadError;
         
         bool m_Running = false;
     };
-}
\ No newline at end of file
+}
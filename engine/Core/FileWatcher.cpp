@@ -0,0 +1,291 @@
+#include "FileWatcher.h"
+#include "Profiling/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#endif
+
+namespace Circe {
+
+    namespace {
+
+        using Clock = std::chrono::steady_clock;
+
+        struct WatchedFile {
+            // Spellings handed to Watch() with their Watch() counts, all reported on a change
+            std::unordered_map<std::string, int> Names;
+            std::filesystem::file_time_type LastWrite{};
+        };
+
+        std::mutex s_Mutex;
+        std::thread s_Thread;
+        std::atomic<bool> s_Running{ false };
+        std::atomic<int> s_SettleDelay{ 100 };
+
+        // Keyed by canonical path
+        std::unordered_map<std::string, WatchedFile> s_Files;
+        // Last change seen per file, reported once older than the settle delay
+        std::unordered_map<std::string, Clock::time_point> s_Pending;
+
+#ifdef __linux__
+        constexpr uint32_t WatchMask = IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE;
+
+        struct DirectoryWatch {
+            int Descriptor = -1;
+            int References = 0;
+        };
+
+        int s_Inotify = -1;
+        // Written to on shutdown so the blocked poll() returns
+        int s_WakePipe[2] = { -1, -1 };
+        std::unordered_map<std::string, DirectoryWatch> s_DirectoryWatches;
+        std::unordered_map<int, std::string> s_Directories;
+#else
+        constexpr auto PollInterval = std::chrono::milliseconds(250);
+
+        std::condition_variable s_WakeCondition;
+#endif
+
+        std::string Canonicalize(const std::string& path) {
+            std::error_code error;
+            std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+            if (error) {
+                canonical = std::filesystem::absolute(path, error).lexically_normal();
+            }
+            return canonical.string();
+        }
+
+        std::filesystem::file_time_type GetWriteTime(const std::string& path) {
+            std::error_code error;
+            const auto time = std::filesystem::last_write_time(path, error);
+            return error ? std::filesystem::file_time_type{} : time;
+        }
+
+#ifdef __linux__
+        void AddDirectory(const std::string& directory) {
+            DirectoryWatch& watch = s_DirectoryWatches[directory];
+            if (watch.References++ > 0) {
+                return;
+            }
+            watch.Descriptor = inotify_add_watch(s_Inotify, directory.c_str(), WatchMask);
+            if (watch.Descriptor < 0) {
+                std::cerr << "FileWatcher: cannot watch " << directory << std::endl;
+                return;
+            }
+            s_Directories[watch.Descriptor] = directory;
+        }
+
+        void RemoveDirectory(const std::string& directory) {
+            auto it = s_DirectoryWatches.find(directory);
+            if (it == s_DirectoryWatches.end() || --it->second.References > 0) {
+                return;
+            }
+            if (it->second.Descriptor >= 0) {
+                inotify_rm_watch(s_Inotify, it->second.Descriptor);
+                s_Directories.erase(it->second.Descriptor);
+            }
+            s_DirectoryWatches.erase(it);
+        }
+
+        void ThreadMain() {
+            CIRCE_PROFILE_THREAD("FileWatcher");
+            pollfd descriptors[2] = { { s_Inotify, POLLIN, 0 }, { s_WakePipe[0], POLLIN, 0 } };
+            alignas(inotify_event) char buffer[4096];
+
+            while (s_Running.load(std::memory_order_acquire)) {
+                if (poll(descriptors, 2, -1) < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    break;
+                }
+                if (descriptors[1].revents) {
+                    break;
+                }
+
+                ssize_t length;
+                while ((length = read(s_Inotify, buffer, sizeof(buffer))) > 0) {
+                    const Clock::time_point now = Clock::now();
+                    std::lock_guard<std::mutex> lock(s_Mutex);
+                    for (char* cursor = buffer; cursor < buffer + length;) {
+                        const auto* event = reinterpret_cast<const inotify_event*>(cursor);
+                        cursor += sizeof(inotify_event) + event->len;
+                        if (event->len == 0) {
+                            continue;
+                        }
+                        auto directory = s_Directories.find(event->wd);
+                        if (directory == s_Directories.end()) {
+                            continue;
+                        }
+                        const std::string path = (std::filesystem::path(directory->second) / event->name).string();
+                        if (s_Files.count(path)) {
+                            s_Pending[path] = now;
+                        }
+                    }
+                }
+            }
+        }
+#else
+        void ThreadMain() {
+            CIRCE_PROFILE_THREAD("FileWatcher");
+            std::unique_lock<std::mutex> lock(s_Mutex);
+            while (s_Running.load(std::memory_order_acquire)) {
+                s_WakeCondition.wait_for(lock, PollInterval);
+                const Clock::time_point now = Clock::now();
+                for (auto& [path, file] : s_Files) {
+                    const auto time = GetWriteTime(path);
+                    if (time != file.LastWrite) {
+                        file.LastWrite = time;
+                        s_Pending[path] = now;
+                    }
+                }
+            }
+        }
+#endif
+
+    }
+
+    void FileWatcher::Initialize() {
+        if (s_Running) {
+            return;
+        }
+
+#ifdef __linux__
+        s_Inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (s_Inotify < 0 || pipe2(s_WakePipe, O_CLOEXEC) != 0) {
+            std::cerr << "FileWatcher: inotify is unavailable, file changes will not be detected" << std::endl;
+            if (s_Inotify >= 0) {
+                close(s_Inotify);
+                s_Inotify = -1;
+            }
+            return;
+        }
+#endif
+
+        s_Running = true;
+        s_Thread = std::thread(ThreadMain);
+    }
+
+    void FileWatcher::Shutdown() {
+        if (!s_Running) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(s_Mutex);
+            s_Running = false;
+        }
+#ifdef __linux__
+        const char wake = 1;
+        [[maybe_unused]] const ssize_t written = write(s_WakePipe[1], &wake, 1);
+#else
+        s_WakeCondition.notify_all();
+#endif
+        s_Thread.join();
+
+        std::lock_guard<std::mutex> lock(s_Mutex);
+#ifdef __linux__
+        close(s_Inotify);
+        close(s_WakePipe[0]);
+        close(s_WakePipe[1]);
+        s_Inotify = -1;
+        s_WakePipe[0] = s_WakePipe[1] = -1;
+        s_DirectoryWatches.clear();
+        s_Directories.clear();
+#endif
+        s_Files.clear();
+        s_Pending.clear();
+    }
+
+    bool FileWatcher::IsRunning() {
+        return s_Running.load(std::memory_order_acquire);
+    }
+
+    void FileWatcher::Watch(const std::string& path) {
+        if (!IsRunning()) {
+            return;
+        }
+
+        const std::string canonical = Canonicalize(path);
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        auto [it, inserted] = s_Files.try_emplace(canonical);
+        WatchedFile& file = it->second;
+        file.Names[path]++;
+        if (!inserted) {
+            return;
+        }
+
+        file.LastWrite = GetWriteTime(canonical);
+#ifdef __linux__
+        AddDirectory(std::filesystem::path(canonical).parent_path().string());
+#endif
+    }
+
+    void FileWatcher::Unwatch(const std::string& path) {
+        if (!IsRunning()) {
+            return;
+        }
+
+        const std::string canonical = Canonicalize(path);
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        auto it = s_Files.find(canonical);
+        if (it == s_Files.end()) {
+            return;
+        }
+        auto& names = it->second.Names;
+        auto name = names.find(path);
+        if (name == names.end() || --name->second > 0) {
+            return;
+        }
+        names.erase(name);
+        if (!names.empty()) {
+            return;
+        }
+
+        s_Files.erase(it);
+        s_Pending.erase(canonical);
+#ifdef __linux__
+        RemoveDirectory(std::filesystem::path(canonical).parent_path().string());
+#endif
+    }
+
+    std::vector<std::string> FileWatcher::PollChanges() {
+        std::vector<std::string> changes;
+        const Clock::time_point settled = Clock::now() - std::chrono::milliseconds(s_SettleDelay.load(std::memory_order_relaxed));
+
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        for (auto it = s_Pending.begin(); it != s_Pending.end();) {
+            if (it->second > settled) {
+                ++it;
+                continue;
+            }
+            auto file = s_Files.find(it->first);
+            if (file != s_Files.end()) {
+                for (const auto& [name, count] : file->second.Names) {
+                    changes.push_back(name);
+                }
+            }
+            it = s_Pending.erase(it);
+        }
+        return changes;
+    }
+
+    void FileWatcher::SetSettleDelay(int milliseconds) {
+        s_SettleDelay.store(std::max(0, milliseconds), std::memory_order_relaxed);
+    }
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Circe {
+
+    // Reports changes to individual files. A background thread waits on inotify (Linux) or
+    // polls modification times (elsewhere); editors that save through a temporary file and a
+    // rename are covered because the containing directory is what gets watched. Bursts of
+    // writes to one file are reported once, after the file has been quiet for the settle delay.
+    class FileWatcher {
+    public:
+        static void Initialize();
+        static void Shutdown();
+
+        static bool IsRunning();
+
+        // Any thread. No-op while the watcher is not running. Watches are counted per path,
+        // each Watch() needs a matching Unwatch().
+        static void Watch(const std::string& path);
+        static void Unwatch(const std::string& path);
+
+        // Paths, as passed to Watch(), that changed and have settled since the last call
+        static std::vector<std::string> PollChanges();
+
+        static void SetSettleDelay(int milliseconds);
+    };
+
+}
@@ -0,0 +1,403 @@
+#include "JobSystem.h"
+#include "../Profiling/Profiler.h"
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+
+namespace Circe {
+
+    struct Job {
+        std::function<void()> Function;
+        // ParallelFor chunks run Range(Context, First, Last) instead of Function
+        void (*Range)(void*, size_t, size_t) = nullptr;
+        void* Context = nullptr;
+        size_t First = 0;
+        size_t Last = 0;
+        JobCounter* Signal = nullptr;
+    };
+
+    namespace {
+
+        // Chase-Lev deque (Le et al. C11 formulation): the owner pushes and pops at the
+        // bottom, other threads steal from the top.
+        class WorkStealingQueue {
+        public:
+            static constexpr int64_t Capacity = 4096;
+
+            bool Push(Job* job) {
+                const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+                const int64_t top = m_Top.load(std::memory_order_acquire);
+                if (bottom - top >= Capacity) {
+                    return false;
+                }
+                m_Jobs[bottom & (Capacity - 1)].store(job, std::memory_order_release);
+                std::atomic_thread_fence(std::memory_order_release);
+                m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+                return true;
+            }
+
+            Job* Pop() {
+                const int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+                m_Bottom.store(bottom, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t top = m_Top.load(std::memory_order_relaxed);
+
+                if (top > bottom) {
+                    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                Job* job = m_Jobs[bottom & (Capacity - 1)].load(std::memory_order_acquire);
+                if (top == bottom) {
+                    // Last element, race the thieves for it
+                    if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                        job = nullptr;
+                    }
+                    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+                }
+                return job;
+            }
+
+            Job* Steal() {
+                int64_t top = m_Top.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+                if (top >= bottom) {
+                    return nullptr;
+                }
+
+                Job* job = m_Jobs[top & (Capacity - 1)].load(std::memory_order_acquire);
+                if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    return nullptr;
+                }
+                return job;
+            }
+
+        private:
+            alignas(64) std::atomic<int64_t> m_Top{ 0 };
+            alignas(64) std::atomic<int64_t> m_Bottom{ 0 };
+            std::array<std::atomic<Job*>, Capacity> m_Jobs{};
+        };
+
+        thread_local int t_ThreadIndex = -1;
+
+        std::vector<std::unique_ptr<WorkStealingQueue>> s_Queues;
+        std::vector<std::thread> s_Workers;
+        std::atomic<bool> s_Running{ false };
+
+        // Jobs submitted from threads outside the pool
+        std::mutex s_SharedMutex;
+        std::deque<Job*> s_SharedQueue;
+
+        // Background jobs, never taken by thread 0
+        std::mutex s_BackgroundMutex;
+        std::deque<Job*> s_BackgroundQueue;
+
+        // Finished jobs kept for reuse, so steady-state submission does not touch the heap.
+        // How many are in flight at once depends on thread timing, so a reserve is made up
+        // front rather than letting the list creep up over the first frames.
+        constexpr size_t ReservedJobs = 512;
+        std::mutex s_FreeJobsMutex;
+        std::vector<Job*> s_FreeJobs;
+
+        std::atomic<int> s_PendingJobs{ 0 };
+        std::atomic<int> s_SleepingWorkers{ 0 };
+        std::mutex s_SleepMutex;
+        std::condition_variable s_WakeCondition;
+
+        Job* AcquireJob() {
+            {
+                std::lock_guard<std::mutex> lock(s_FreeJobsMutex);
+                if (!s_FreeJobs.empty()) {
+                    Job* job = s_FreeJobs.back();
+                    s_FreeJobs.pop_back();
+                    return job;
+                }
+            }
+            return new Job;
+        }
+
+        void ReleaseJob(Job* job) {
+            job->Function = nullptr;
+            job->Range = nullptr;
+            job->Signal = nullptr;
+            std::lock_guard<std::mutex> lock(s_FreeJobsMutex);
+            s_FreeJobs.push_back(job);
+        }
+
+        void NotifyWorkers() {
+            // Sequentially consistent with the sleeper side so a wakeup cannot be missed
+            s_PendingJobs.fetch_add(1);
+            if (s_SleepingWorkers.load() > 0) {
+                { std::lock_guard<std::mutex> lock(s_SleepMutex); }
+                s_WakeCondition.notify_one();
+            }
+        }
+
+    }
+
+    bool JobSystem::s_Initialized = false;
+    unsigned int JobSystem::s_ThreadCount = 1;
+
+    void JobSystem::Initialize(unsigned int threadCount) {
+        if (s_Initialized) {
+            return;
+        }
+
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        s_ThreadCount = threadCount;
+
+        s_Queues.clear();
+        for (unsigned int i = 0; i < threadCount; ++i) {
+            s_Queues.push_back(std::make_unique<WorkStealingQueue>());
+        }
+
+        s_FreeJobs.reserve(ReservedJobs * 2);
+        while (s_FreeJobs.size() < ReservedJobs) {
+            s_FreeJobs.push_back(new Job);
+        }
+
+        t_ThreadIndex = 0;
+        s_Running = true;
+        for (unsigned int i = 1; i < threadCount; ++i) {
+            s_Workers.emplace_back(WorkerLoop, i);
+        }
+        s_Initialized = true;
+    }
+
+    void JobSystem::Shutdown() {
+        if (!s_Initialized) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(s_SleepMutex);
+            s_Running = false;
+        }
+        s_WakeCondition.notify_all();
+
+        for (std::thread& worker : s_Workers) {
+            worker.join();
+        }
+        s_Workers.clear();
+
+        // Drain anything still queued so counters held by callers settle. Drained jobs can
+        // queue more (continuations, regular jobs run by background work), so repeat until
+        // both the deques and the background queue stay empty.
+        for (;;) {
+            if (Job* job = FindJob(0)) {
+                Execute(job);
+            } else if (!s_BackgroundQueue.empty()) {
+                Job* background = s_BackgroundQueue.front();
+                s_BackgroundQueue.pop_front();
+                s_PendingJobs.fetch_sub(1, std::memory_order_relaxed);
+                Execute(background);
+            } else {
+                break;
+            }
+        }
+
+        s_Queues.clear();
+        {
+            std::lock_guard<std::mutex> lock(s_FreeJobsMutex);
+            for (Job* job : s_FreeJobs) {
+                delete job;
+            }
+            s_FreeJobs.clear();
+        }
+        t_ThreadIndex = -1;
+        s_ThreadCount = 1;
+        s_Initialized = false;
+    }
+
+    int JobSystem::GetThreadIndex() {
+        return t_ThreadIndex;
+    }
+
+    void JobSystem::Run(std::function<void()> function, JobCounter* signal, JobCounter* dependency) {
+        if (signal) {
+            signal->m_Value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Job* job = AcquireJob();
+        job->Function = std::move(function);
+        job->Signal = signal;
+
+        if (!s_Initialized) {
+            Execute(job);
+            return;
+        }
+
+        if (dependency) {
+            std::lock_guard<std::mutex> lock(dependency->m_Mutex);
+            if (!dependency->IsDone()) {
+                dependency->m_Continuations.push_back(job);
+                return;
+            }
+        }
+        Submit(job);
+    }
+
+    void JobSystem::RunBackground(std::function<void()> function, JobCounter* signal) {
+        if (signal) {
+            signal->m_Value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Job* job = AcquireJob();
+        job->Function = std::move(function);
+        job->Signal = signal;
+
+        if (!s_Initialized || s_ThreadCount <= 1) {
+            Execute(job);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(s_BackgroundMutex);
+            s_BackgroundQueue.push_back(job);
+        }
+        NotifyWorkers();
+    }
+
+    void JobSystem::RunRange(RangeFunction function, void* context, size_t first, size_t last, JobCounter* signal) {
+        signal->m_Value.fetch_add(1, std::memory_order_relaxed);
+
+        Job* job = AcquireJob();
+        job->Range = function;
+        job->Context = context;
+        job->First = first;
+        job->Last = last;
+        job->Signal = signal;
+        Submit(job);
+    }
+
+    void JobSystem::Wait(JobCounter& counter) {
+        while (!counter.IsDone()) {
+            if (Job* job = s_Initialized ? FindJob(t_ThreadIndex) : nullptr) {
+                Execute(job);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        // The final decrement happens under the lock; taking it here means the finishing
+        // thread is done touching the counter and the caller may destroy it
+        std::lock_guard<std::mutex> lock(counter.m_Mutex);
+    }
+
+    void JobSystem::Submit(Job* job) {
+        const int index = t_ThreadIndex;
+        if (index < 0 || !s_Queues[index]->Push(job)) {
+            if (index >= 0) {
+                // Own deque is full, running inline keeps the submitter making progress
+                Execute(job);
+                return;
+            }
+            std::lock_guard<std::mutex> lock(s_SharedMutex);
+            s_SharedQueue.push_back(job);
+        }
+
+        NotifyWorkers();
+    }
+
+    void JobSystem::Execute(Job* job) {
+        {
+            CIRCE_PROFILE_SCOPE("Job");
+            if (job->Range) {
+                job->Range(job->Context, job->First, job->Last);
+            } else {
+                job->Function();
+            }
+        }
+        JobCounter* signal = job->Signal;
+        ReleaseJob(job);
+        if (signal) {
+            Finish(signal);
+        }
+    }
+
+    void JobSystem::Finish(JobCounter* counter) {
+        // Decrements that cannot reach zero stay lock-free
+        int value = counter->m_Value.load(std::memory_order_relaxed);
+        while (value > 1) {
+            if (counter->m_Value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+
+        std::vector<Job*> ready;
+        {
+            std::lock_guard<std::mutex> lock(counter->m_Mutex);
+            if (counter->m_Value.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                ready.swap(counter->m_Continuations);
+            }
+        }
+        for (Job* job : ready) {
+            Submit(job);
+        }
+    }
+
+    Job* JobSystem::FindJob(int threadIndex) {
+        Job* job = nullptr;
+        if (threadIndex >= 0) {
+            job = s_Queues[threadIndex]->Pop();
+        }
+
+        if (!job) {
+            std::lock_guard<std::mutex> lock(s_SharedMutex);
+            if (!s_SharedQueue.empty()) {
+                job = s_SharedQueue.front();
+                s_SharedQueue.pop_front();
+            }
+        }
+
+        // Steal round-robin starting after our own queue to spread contention
+        const size_t queueCount = s_Queues.size();
+        const size_t start = threadIndex >= 0 ? static_cast<size_t>(threadIndex) + 1 : 0;
+        for (size_t i = 0; !job && i < queueCount; ++i) {
+            const size_t victim = (start + i) % queueCount;
+            if (static_cast<int>(victim) != threadIndex) {
+                job = s_Queues[victim]->Steal();
+            }
+        }
+
+        if (!job && threadIndex > 0) {
+            std::lock_guard<std::mutex> lock(s_BackgroundMutex);
+            if (!s_BackgroundQueue.empty()) {
+                job = s_BackgroundQueue.front();
+                s_BackgroundQueue.pop_front();
+            }
+        }
+
+        if (job) {
+            s_PendingJobs.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    void JobSystem::WorkerLoop(unsigned int threadIndex) {
+        t_ThreadIndex = static_cast<int>(threadIndex);
+        CIRCE_PROFILE_THREAD("Worker " + std::to_string(threadIndex));
+
+        while (s_Running.load(std::memory_order_acquire)) {
+            if (Job* job = FindJob(t_ThreadIndex)) {
+                Execute(job);
+                continue;
+            }
+
+            s_SleepingWorkers.fetch_add(1);
+            {
+                std::unique_lock<std::mutex> lock(s_SleepMutex);
+                s_WakeCondition.wait(lock, [] {
+                    return s_PendingJobs.load() > 0 || !s_Running.load();
+                });
+            }
+            s_SleepingWorkers.fetch_sub(1);
+        }
+    }
+
+}
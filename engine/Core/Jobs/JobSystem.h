@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace Circe {
+
+    struct Job;
+
+    // Counts outstanding jobs. Jobs may wait on a counter as a dependency; they are
+    // queued once it drops to zero. Pass a counter to JobSystem::Wait before destroying it.
+    class JobCounter {
+    public:
+        JobCounter() = default;
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        bool IsDone() const { return m_Value.load(std::memory_order_acquire) == 0; }
+        int GetValue() const { return m_Value.load(std::memory_order_acquire); }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<int> m_Value{ 0 };
+        std::mutex m_Mutex;
+        std::vector<Job*> m_Continuations;
+    };
+
+    // Fixed pool of worker threads with one work-stealing deque per thread. The thread
+    // that calls Initialize() participates as worker 0 whenever it waits on a counter.
+    class JobSystem {
+    public:
+        // workerCount 0 uses hardware_concurrency, including the calling thread
+        static void Initialize(unsigned int threadCount = 0);
+        static void Shutdown();
+
+        static bool IsInitialized() { return s_Initialized; }
+        // Threads executing jobs, the initializing thread included
+        static unsigned int GetThreadCount() { return s_ThreadCount; }
+        // 0 for the initializing thread, 1..N-1 for workers, -1 for any other thread
+        static int GetThreadIndex();
+
+        // signal is incremented now and decremented when the job has run. When dependency
+        // is given the job is held back until that counter reaches zero.
+        static void Run(std::function<void()> function, JobCounter* signal = nullptr, JobCounter* dependency = nullptr);
+
+        // Long-running work (file IO, decoding) picked up only by pool workers once they run
+        // out of regular jobs, so the initializing thread never stalls on it inside Wait.
+        // Runs inline when there are no worker threads.
+        static void RunBackground(std::function<void()> function, JobCounter* signal = nullptr);
+
+        // Executes queued jobs on the calling thread until the counter reaches zero
+        static void Wait(JobCounter& counter);
+
+        // Splits [begin, end) into chunks and calls func(first, last) for each, returning
+        // once all chunks are done. Runs inline when the pool is not running.
+        template<typename Func>
+        static void ParallelFor(size_t begin, size_t end, Func&& func, size_t grainSize = 0) {
+            if (end <= begin) {
+                return;
+            }
+
+            const size_t count = end - begin;
+            if (grainSize == 0) {
+                grainSize = std::max<size_t>(1, count / (static_cast<size_t>(s_ThreadCount) * 4));
+            }
+            if (!s_Initialized || s_ThreadCount <= 1 || count <= grainSize) {
+                func(begin, end);
+                return;
+            }
+
+            // Chunks call func through a plain function pointer, no closure to allocate
+            void* context = const_cast<void*>(static_cast<const void*>(&func));
+            JobCounter counter;
+            for (size_t first = begin; first < end; first += grainSize) {
+                const size_t last = std::min(end, first + grainSize);
+                RunRange(&InvokeRange<std::remove_reference_t<Func>>, context, first, last, &counter);
+            }
+            Wait(counter);
+        }
+
+    private:
+        using RangeFunction = void (*)(void* context, size_t first, size_t last);
+
+        template<typename Func>
+        static void InvokeRange(void* context, size_t first, size_t last) {
+            (*static_cast<Func*>(context))(first, last);
+        }
+
+        static void RunRange(RangeFunction function, void* context, size_t first, size_t last, JobCounter* signal);
+        static void Submit(Job* job);
+        static void Execute(Job* job);
+        static void Finish(JobCounter* counter);
+        static Job* FindJob(int threadIndex);
+        static void WorkerLoop(unsigned int threadIndex);
+
+        static bool s_Initialized;
+        static unsigned int s_ThreadCount;
+    };
+
+}
@@ -0,0 +1,136 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Circe {
+
+    MappedFile::~MappedFile() {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            Close();
+            m_Data = std::exchange(other.m_Data, nullptr);
+            m_Size = std::exchange(other.m_Size, 0);
+#ifdef _WIN32
+            m_File = std::exchange(other.m_File, nullptr);
+            m_Mapping = std::exchange(other.m_Mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+#ifdef _WIN32
+
+    void MappedFile::Open(const std::string& path) {
+        Close();
+
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Failed to open file: " + path);
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            throw std::runtime_error("Failed to map empty or unreadable file: " + path);
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!data) {
+            if (mapping) {
+                CloseHandle(mapping);
+            }
+            CloseHandle(file);
+            throw std::runtime_error("Failed to map file: " + path);
+        }
+
+        m_File = file;
+        m_Mapping = mapping;
+        m_Data = static_cast<const unsigned char*>(data);
+        m_Size = static_cast<size_t>(size.QuadPart);
+    }
+
+    void MappedFile::Close() {
+        if (m_Data) {
+            UnmapViewOfFile(m_Data);
+            CloseHandle(m_Mapping);
+            CloseHandle(m_File);
+        }
+        m_Data = nullptr;
+        m_Size = 0;
+        m_File = nullptr;
+        m_Mapping = nullptr;
+    }
+
+    void MappedFile::PrefetchSequential() const {
+        if (m_Data) {
+            WIN32_MEMORY_RANGE_ENTRY range{ const_cast<unsigned char*>(m_Data), m_Size };
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+        }
+    }
+
+#else
+
+    void MappedFile::Open(const std::string& path) {
+        Close();
+
+        const int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            throw std::runtime_error("Failed to open file: " + path);
+        }
+
+        struct stat info;
+        if (fstat(file, &info) != 0 || info.st_size == 0) {
+            ::close(file);
+            throw std::runtime_error("Failed to map empty or unreadable file: " + path);
+        }
+
+        void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        // The mapping keeps its own reference to the file
+        ::close(file);
+        if (data == MAP_FAILED) {
+            throw std::runtime_error("Failed to map file: " + path);
+        }
+
+        m_Data = static_cast<const unsigned char*>(data);
+        m_Size = static_cast<size_t>(info.st_size);
+    }
+
+    void MappedFile::Close() {
+        if (m_Data) {
+            munmap(const_cast<unsigned char*>(m_Data), m_Size);
+        }
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+
+    void MappedFile::PrefetchSequential() const {
+        if (m_Data) {
+            // Advice values are not flags, so each one is a separate call
+            void* data = const_cast<unsigned char*>(m_Data);
+            madvise(data, m_Size, MADV_SEQUENTIAL);
+            madvise(data, m_Size, MADV_WILLNEED);
+        }
+    }
+
+#endif
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Circe {
+
+    // Read-only memory mapping of a whole file. Pages are faulted in on first touch.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // Throws std::runtime_error when the file cannot be opened or mapped
+        void Open(const std::string& path);
+        void Close();
+
+        // Hints that the whole file will be read front to back
+        void PrefetchSequential() const;
+
+        const unsigned char* GetData() const { return m_Data; }
+        size_t GetSize() const { return m_Size; }
+        bool IsOpen() const { return m_Data != nullptr; }
+
+    private:
+        const unsigned char* m_Data = nullptr;
+        size_t m_Size = 0;
+#ifdef _WIN32
+        void* m_File = nullptr;
+        void* m_Mapping = nullptr;
+#endif
+    };
+
+}
@@ -0,0 +1,109 @@
+#include "FrameAllocator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace Circe {
+
+    namespace {
+
+        uintptr_t AlignUp(uintptr_t value, size_t alignment) {
+            return (value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        }
+
+    }
+
+    FrameAllocator::FrameAllocator(size_t capacity, uint32_t frameCount)
+        : m_FrameCount(std::clamp<uint32_t>(frameCount, 1, MaxFrames)) {
+        for (uint32_t i = 0; i < m_FrameCount; ++i) {
+            m_Arenas[i].Base = static_cast<unsigned char*>(AllocateBlock(capacity));
+            m_Arenas[i].Capacity = capacity;
+        }
+    }
+
+    FrameAllocator::~FrameAllocator() {
+        for (uint32_t i = 0; i < m_FrameCount; ++i) {
+            Reset(m_Arenas[i]);
+            std::free(m_Arenas[i].Base);
+        }
+    }
+
+    void FrameAllocator::BeginFrame() {
+        m_Current = (m_Current + 1) % m_FrameCount;
+        Reset(m_Arenas[m_Current]);
+    }
+
+    void* FrameAllocator::Allocate(size_t size, size_t alignment) {
+        Arena& arena = m_Arenas[m_Current];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(arena.Base);
+        const uintptr_t start = AlignUp(base + arena.Offset, alignment);
+        if (start + size <= base + arena.Capacity) {
+            arena.Used += start + size - (base + arena.Offset);
+            arena.Offset = start + size - base;
+            return reinterpret_cast<void*>(start);
+        }
+        return AllocateOverflow(arena, size, alignment);
+    }
+
+    size_t FrameAllocator::GetUsed() const {
+        return m_Arenas[m_Current].Used;
+    }
+
+    size_t FrameAllocator::GetCapacity() const {
+        return m_Arenas[m_Current].Capacity;
+    }
+
+    void* FrameAllocator::AllocateOverflow(Arena& arena, size_t size, size_t alignment) {
+        const size_t headerSize = AlignUp(sizeof(OverflowBlock), alignof(std::max_align_t));
+        OverflowBlock* block = arena.Overflow;
+        if (block) {
+            const uintptr_t base = reinterpret_cast<uintptr_t>(block);
+            const uintptr_t start = AlignUp(base + arena.OverflowOffset, alignment);
+            if (start + size <= base + block->Capacity) {
+                arena.Used += start + size - (base + arena.OverflowOffset);
+                arena.OverflowOffset = start + size - base;
+                return reinterpret_cast<void*>(start);
+            }
+        }
+
+        // Each overflow block at least doubles what the arena holds, keeping their number small
+        const size_t capacity = headerSize + std::max(size + alignment, arena.Capacity + arena.Used);
+        block = static_cast<OverflowBlock*>(AllocateBlock(capacity));
+        block->Next = arena.Overflow;
+        block->Capacity = capacity;
+        arena.Overflow = block;
+
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block);
+        const uintptr_t start = AlignUp(base + headerSize, alignment);
+        arena.Used += start + size - (base + headerSize);
+        arena.OverflowOffset = start + size - base;
+        return reinterpret_cast<void*>(start);
+    }
+
+    void FrameAllocator::Reset(Arena& arena) {
+        if (arena.Overflow) {
+            while (OverflowBlock* block = arena.Overflow) {
+                arena.Overflow = block->Next;
+                std::free(block);
+            }
+            // Regrow to the peak with some headroom so the next frame like it fits in one block
+            const size_t capacity = arena.Used + arena.Used / 4;
+            std::free(arena.Base);
+            arena.Base = static_cast<unsigned char*>(AllocateBlock(capacity));
+            arena.Capacity = capacity;
+        }
+        arena.Offset = 0;
+        arena.OverflowOffset = 0;
+        arena.Used = 0;
+    }
+
+    void* FrameAllocator::AllocateBlock(size_t size) {
+        void* block = std::malloc(std::max<size_t>(size, 1));
+        if (!block) {
+            throw std::runtime_error("FrameAllocator: out of memory");
+        }
+        m_HeapAllocations++;
+        return block;
+    }
+
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+namespace Circe {
+
+    // Linear allocator for data that lives for one frame. Allocation bumps an offset and
+    // nothing is freed individually; BeginFrame() moves on to the next of FrameCount arenas
+    // and resets it, so memory handed out stays valid for FrameCount - 1 further frames
+    // (while a pipelined consumer still reads it). An arena that runs out takes overflow
+    // blocks from the heap and is regrown to its peak usage at its next reset, so after
+    // the first few frames a steady workload never touches the heap.
+    // Not thread-safe: one thread allocates, others may read what it handed out.
+    class FrameAllocator {
+    public:
+        explicit FrameAllocator(size_t capacity = 1 << 20, uint32_t frameCount = 2);
+        ~FrameAllocator();
+
+        FrameAllocator(const FrameAllocator&) = delete;
+        FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+        void BeginFrame();
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        // Uninitialized storage for count objects; only types without destructors
+        template<typename T>
+        T* Allocate(size_t count) {
+            static_assert(std::is_trivially_destructible_v<T>, "frame memory is never destroyed");
+            return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        uint32_t GetFrameCount() const { return m_FrameCount; }
+        // Bytes handed out by the current arena this frame
+        size_t GetUsed() const;
+        // Main block size of the current arena
+        size_t GetCapacity() const;
+        // Blocks taken from the heap so far, arenas and overflow together
+        uint64_t GetHeapAllocations() const { return m_HeapAllocations; }
+
+    private:
+        static constexpr uint32_t MaxFrames = 4;
+
+        // Header at the start of every overflow block
+        struct OverflowBlock {
+            OverflowBlock* Next;
+            size_t Capacity;
+        };
+
+        struct Arena {
+            unsigned char* Base = nullptr;
+            size_t Capacity = 0;
+            size_t Offset = 0;
+            OverflowBlock* Overflow = nullptr;
+            size_t OverflowOffset = 0;
+            // Everything handed out since the reset, overflow included
+            size_t Used = 0;
+        };
+
+        void* AllocateOverflow(Arena& arena, size_t size, size_t alignment);
+        void Reset(Arena& arena);
+        void* AllocateBlock(size_t size);
+
+        Arena m_Arenas[MaxFrames];
+        uint32_t m_FrameCount;
+        uint32_t m_Current = 0;
+        uint64_t m_HeapAllocations = 0;
+    };
+
+    // Growable array in frame memory for trivially copyable elements. Growing copies into a
+    // fresh allocation and abandons the old one until the arena resets, so Reserve() with a
+    // known bound (last frame's size) keeps that waste to nothing.
+    template<typename T>
+    class FrameArray {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>);
+
+    public:
+        FrameArray() = default;
+        explicit FrameArray(FrameAllocator& allocator)
+            : m_Allocator(&allocator) {
+        }
+
+        // Forgets the contents without touching the memory; call once the allocator has
+        // moved to a new frame
+        void Reset() {
+            m_Data = nullptr;
+            m_Size = 0;
+            m_Capacity = 0;
+        }
+
+        void Clear() { m_Size = 0; }
+
+        void Reserve(size_t capacity) {
+            if (capacity <= m_Capacity) {
+                return;
+            }
+            T* data = m_Allocator->Allocate<T>(capacity);
+            if (m_Size > 0) {
+                std::memcpy(static_cast<void*>(data), m_Data, m_Size * sizeof(T));
+            }
+            m_Data = data;
+            m_Capacity = capacity;
+        }
+
+        // Appends count value-initialized elements and returns the first
+        T* Append(size_t count) {
+            Grow(m_Size + count);
+            T* first = m_Data + m_Size;
+            for (size_t i = 0; i < count; ++i) {
+                new (first + i) T{};
+            }
+            m_Size += count;
+            return first;
+        }
+
+        // Appends count elements left uninitialized and returns the first
+        T* AppendUninitialized(size_t count) {
+            Grow(m_Size + count);
+            T* first = m_Data + m_Size;
+            m_Size += count;
+            return first;
+        }
+
+        void Push(const T& value) {
+            Grow(m_Size + 1);
+            m_Data[m_Size++] = value;
+        }
+
+        size_t Size() const { return m_Size; }
+        bool Empty() const { return m_Size == 0; }
+        T* Data() { return m_Data; }
+        const T* Data() const { return m_Data; }
+
+        T& operator[](size_t index) { return m_Data[index]; }
+        const T& operator[](size_t index) const { return m_Data[index]; }
+
+        T* begin() { return m_Data; }
+        T* end() { return m_Data + m_Size; }
+        const T* begin() const { return m_Data; }
+        const T* end() const { return m_Data + m_Size; }
+
+    private:
+        void Grow(size_t size) {
+            if (size > m_Capacity) {
+                Reserve(size > m_Capacity * 2 ? size : m_Capacity * 2);
+            }
+        }
+
+        FrameAllocator* m_Allocator = nullptr;
+        T* m_Data = nullptr;
+        size_t m_Size = 0;
+        size_t m_Capacity = 0;
+    };
+
+}
@@ -0,0 +1,310 @@
+#include "Profiler.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
+namespace Circe {
+
+    namespace {
+
+        // Single-producer ring: only the owning thread writes, the exporter reads
+        // behind Head and drops whatever was overwritten while it copied
+        struct ThreadBuffer {
+            static constexpr uint64_t Capacity = 1 << 15;
+
+            // Relaxed atomics so a torn read during export is well-defined (plain movs on x86)
+            struct Slot {
+                std::atomic<const char*> Name{ nullptr };
+                std::atomic<uint64_t> Start{ 0 };
+                std::atomic<uint64_t> End{ 0 };
+            };
+
+            std::string Name;
+            uint32_t Id = 0;
+            std::unique_ptr<Slot[]> Slots = std::make_unique<Slot[]>(Capacity);
+            std::atomic<uint64_t> Head{ 0 };
+
+            void Push(const ProfileZone& zone) {
+                const uint64_t head = Head.load(std::memory_order_relaxed);
+                Slot& slot = Slots[head & (Capacity - 1)];
+                slot.Name.store(zone.Name, std::memory_order_relaxed);
+                slot.Start.store(zone.Start, std::memory_order_relaxed);
+                slot.End.store(zone.End, std::memory_order_relaxed);
+                Head.store(head + 1, std::memory_order_release);
+            }
+
+            ProfileZone Read(uint64_t index) const {
+                const Slot& slot = Slots[index & (Capacity - 1)];
+                return {
+                    slot.Name.load(std::memory_order_relaxed),
+                    slot.Start.load(std::memory_order_relaxed),
+                    slot.End.load(std::memory_order_relaxed)
+                };
+            }
+        };
+
+        const auto s_Epoch = std::chrono::steady_clock::now();
+
+        // Buffers outlive their threads so zones of finished workers still export
+        std::mutex s_ThreadsMutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> s_Threads;
+        thread_local ThreadBuffer* t_Buffer = nullptr;
+
+        ThreadBuffer* RegisterBuffer(std::string name) {
+            std::lock_guard<std::mutex> lock(s_ThreadsMutex);
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->Id = static_cast<uint32_t>(s_Threads.size());
+            buffer->Name = name.empty() ? "Thread " + std::to_string(buffer->Id) : std::move(name);
+            s_Threads.push_back(std::move(buffer));
+            return s_Threads.back().get();
+        }
+
+        ThreadBuffer& GetThreadBuffer() {
+            if (!t_Buffer) {
+                t_Buffer = RegisterBuffer({});
+            }
+            return *t_Buffer;
+        }
+
+        // GPU queries are resolved FrameLatency frames after they were issued so
+        // reading the result never stalls on the pipeline
+        constexpr size_t FrameLatency = 3;
+
+        struct PendingQuery {
+            const char* Name;
+            GLuint Query;
+        };
+
+        struct GpuFrame {
+            std::vector<PendingQuery> Queries;
+            uint64_t CpuStart = 0;
+        };
+
+        bool s_GpuReady = false;
+        std::array<GpuFrame, FrameLatency> s_GpuFrames;
+        uint64_t s_FrameIndex = 0;
+        int s_ActiveGpuZone = -1;
+        std::vector<GLuint> s_FreeQueries;
+        std::vector<GpuTiming> s_GpuTimings;
+        ThreadBuffer* s_GpuTrack = nullptr;
+
+        constexpr double BucketWidthMs = 0.05;
+        constexpr size_t BucketCount = 4000;
+
+        // Last bucket collects everything past BucketCount * BucketWidthMs
+        std::array<uint32_t, BucketCount + 1> s_FrameBuckets{};
+        uint32_t s_FrameSamples = 0;
+        double s_MaxFrameMs = 0.0;
+
+        double Percentile(double fraction) {
+            const uint32_t target = std::max<uint32_t>(1, static_cast<uint32_t>(std::ceil(fraction * s_FrameSamples)));
+            uint32_t cumulative = 0;
+            for (size_t i = 0; i < s_FrameBuckets.size(); i++) {
+                cumulative += s_FrameBuckets[i];
+                if (cumulative >= target) {
+                    return i == BucketCount ? s_MaxFrameMs : std::min((i + 1) * BucketWidthMs, s_MaxFrameMs);
+                }
+            }
+            return s_MaxFrameMs;
+        }
+
+        void WriteEscaped(std::ofstream& out, const char* text) {
+            for (const char* c = text; *c; c++) {
+                if (*c == '"' || *c == '\\') {
+                    out << '\\';
+                }
+                out << (static_cast<unsigned char>(*c) < 0x20 ? ' ' : *c);
+            }
+        }
+
+    }
+
+    std::atomic<bool> Profiler::s_Enabled{ true };
+
+    void Profiler::Initialize() {
+        s_GpuReady = true;
+        s_FrameIndex = 0;
+        s_ActiveGpuZone = -1;
+        if (!s_GpuTrack) {
+            s_GpuTrack = RegisterBuffer("GPU");
+        }
+        s_GpuFrames[0].CpuStart = Now();
+    }
+
+    void Profiler::Shutdown() {
+        if (!s_GpuReady) {
+            return;
+        }
+
+        for (GpuFrame& frame : s_GpuFrames) {
+            for (const PendingQuery& pending : frame.Queries) {
+                s_FreeQueries.push_back(pending.Query);
+            }
+            frame.Queries.clear();
+        }
+        if (!s_FreeQueries.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(s_FreeQueries.size()), s_FreeQueries.data());
+            s_FreeQueries.clear();
+        }
+        s_GpuTimings.clear();
+        s_GpuReady = false;
+    }
+
+    void Profiler::SetThreadName(const std::string& name) {
+        if (t_Buffer) {
+            std::lock_guard<std::mutex> lock(s_ThreadsMutex);
+            t_Buffer->Name = name;
+            return;
+        }
+        t_Buffer = RegisterBuffer(name);
+    }
+
+    uint64_t Profiler::Now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - s_Epoch).count());
+    }
+
+    void Profiler::RecordZone(const char* name, uint64_t start, uint64_t end) {
+        GetThreadBuffer().Push({ name, start, end });
+    }
+
+    void Profiler::NewFrame() {
+        if (!s_GpuReady) {
+            return;
+        }
+
+        s_FrameIndex++;
+        GpuFrame& frame = s_GpuFrames[s_FrameIndex % FrameLatency];
+
+        if (!frame.Queries.empty()) {
+            s_GpuTimings.clear();
+            // Elapsed queries carry durations only, lay them out back to back from the
+            // CPU start of the frame that issued them
+            uint64_t cursor = frame.CpuStart;
+            for (const PendingQuery& pending : frame.Queries) {
+                GLuint64 elapsed = 0;
+                glGetQueryObjectui64v(pending.Query, GL_QUERY_RESULT, &elapsed);
+                s_GpuTimings.push_back({ pending.Name, static_cast<double>(elapsed) / 1e6 });
+                s_GpuTrack->Push({ pending.Name, cursor, cursor + elapsed });
+                cursor += elapsed;
+                s_FreeQueries.push_back(pending.Query);
+            }
+            frame.Queries.clear();
+        }
+        frame.CpuStart = Now();
+    }
+
+    int Profiler::BeginGpuZone(const char* name) {
+        if (!s_GpuReady || s_ActiveGpuZone >= 0 || !IsEnabled()) {
+            return -1;
+        }
+
+        GLuint query = 0;
+        if (s_FreeQueries.empty()) {
+            glGenQueries(1, &query);
+        } else {
+            query = s_FreeQueries.back();
+            s_FreeQueries.pop_back();
+        }
+
+        GpuFrame& frame = s_GpuFrames[s_FrameIndex % FrameLatency];
+        frame.Queries.push_back({ name, query });
+        glBeginQuery(GL_TIME_ELAPSED, query);
+        s_ActiveGpuZone = static_cast<int>(frame.Queries.size() - 1);
+        return s_ActiveGpuZone;
+    }
+
+    void Profiler::EndGpuZone(int zone) {
+        if (zone < 0 || zone != s_ActiveGpuZone) {
+            return;
+        }
+        glEndQuery(GL_TIME_ELAPSED);
+        s_ActiveGpuZone = -1;
+    }
+
+    const std::vector<GpuTiming>& Profiler::GetGpuTimings() {
+        return s_GpuTimings;
+    }
+
+    void Profiler::RecordFrameTime(double milliseconds) {
+        const size_t bucket = std::min(static_cast<size_t>(std::max(milliseconds, 0.0) / BucketWidthMs), BucketCount);
+        s_FrameBuckets[bucket]++;
+        s_FrameSamples++;
+        s_MaxFrameMs = std::max(s_MaxFrameMs, milliseconds);
+    }
+
+    FrameTimePercentiles Profiler::GetFrameTimePercentiles() {
+        FrameTimePercentiles result;
+        result.Samples = s_FrameSamples;
+        if (s_FrameSamples == 0) {
+            return result;
+        }
+        result.P50 = Percentile(0.50);
+        result.P95 = Percentile(0.95);
+        result.P99 = Percentile(0.99);
+        result.Max = s_MaxFrameMs;
+        return result;
+    }
+
+    void Profiler::ResetFrameTimes() {
+        s_FrameBuckets.fill(0);
+        s_FrameSamples = 0;
+        s_MaxFrameMs = 0.0;
+    }
+
+    bool Profiler::ExportChromeTrace(const std::string& path) {
+        std::ofstream out(path);
+        if (!out) {
+            return false;
+        }
+
+        out << std::fixed << std::setprecision(3);
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        auto separator = [&]() {
+            out << (first ? "\n" : ",\n");
+            first = false;
+        };
+
+        std::lock_guard<std::mutex> lock(s_ThreadsMutex);
+        std::vector<ProfileZone> zones;
+        for (const auto& buffer : s_Threads) {
+            separator();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->Id << ",\"args\":{\"name\":\"";
+            WriteEscaped(out, buffer->Name.c_str());
+            out << "\"}}";
+
+            const uint64_t head = buffer->Head.load(std::memory_order_acquire);
+            const uint64_t begin = head > ThreadBuffer::Capacity ? head - ThreadBuffer::Capacity : 0;
+            zones.clear();
+            for (uint64_t i = begin; i < head; i++) {
+                zones.push_back(buffer->Read(i));
+            }
+
+            // Slots the owner wrapped around onto during the copy are torn
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t after = buffer->Head.load(std::memory_order_relaxed);
+            const uint64_t valid = after > ThreadBuffer::Capacity ? after - ThreadBuffer::Capacity : 0;
+            const size_t skip = static_cast<size_t>(std::min<uint64_t>(valid > begin ? valid - begin : 0, zones.size()));
+
+            for (size_t i = skip; i < zones.size(); i++) {
+                const ProfileZone& zone = zones[i];
+                separator();
+                out << "{\"name\":\"";
+                WriteEscaped(out, zone.Name);
+                out << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->Id
+                    << ",\"ts\":" << static_cast<double>(zone.Start) / 1000.0
+                    << ",\"dur\":" << static_cast<double>(zone.End - zone.Start) / 1000.0 << "}";
+            }
+        }
+        out << "\n]}\n";
+        return static_cast<bool>(out);
+    }
+
+}
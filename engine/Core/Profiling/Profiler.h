@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Zones are compiled in when CIRCE_PROFILE_ENABLED is set (CMake option CIRCE_PROFILER).
+// Otherwise every CIRCE_PROFILE_* macro expands to nothing.
+#if CIRCE_PROFILE_ENABLED
+    #define CIRCE_PROFILE_CONCAT_INNER(a, b) a##b
+    #define CIRCE_PROFILE_CONCAT(a, b) CIRCE_PROFILE_CONCAT_INNER(a, b)
+    // Name must outlive the profiler (string literal or __func__)
+    #define CIRCE_PROFILE_SCOPE(name) ::Circe::ProfileScope CIRCE_PROFILE_CONCAT(circeProfileScope, __LINE__)(name)
+    #define CIRCE_PROFILE_FUNCTION() CIRCE_PROFILE_SCOPE(__func__)
+    // GL_TIME_ELAPSED queries cannot nest, inner GPU scopes are ignored
+    #define CIRCE_PROFILE_GPU_SCOPE(name) ::Circe::GpuProfileScope CIRCE_PROFILE_CONCAT(circeGpuProfileScope, __LINE__)(name)
+    #define CIRCE_PROFILE_THREAD(name) ::Circe::Profiler::SetThreadName(name)
+    #define CIRCE_PROFILE_FRAME() ::Circe::Profiler::NewFrame()
+#else
+    #define CIRCE_PROFILE_SCOPE(name)
+    #define CIRCE_PROFILE_FUNCTION()
+    #define CIRCE_PROFILE_GPU_SCOPE(name)
+    #define CIRCE_PROFILE_THREAD(name)
+    #define CIRCE_PROFILE_FRAME()
+#endif
+
+namespace Circe {
+
+    // Timestamps are nanoseconds since the profiler epoch
+    struct ProfileZone {
+        const char* Name = nullptr;
+        uint64_t Start = 0;
+        uint64_t End = 0;
+    };
+
+    struct GpuTiming {
+        const char* Name = nullptr;
+        double Milliseconds = 0.0;
+    };
+
+    struct FrameTimePercentiles {
+        uint32_t Samples = 0;
+        double P50 = 0.0;
+        double P95 = 0.0;
+        double P99 = 0.0;
+        double Max = 0.0;
+    };
+
+    class Profiler {
+    public:
+        // GPU queries need the GL context, call after the window exists
+        static void Initialize();
+        static void Shutdown();
+
+        // Runtime switch for zone capture (only meaningful when compiled in)
+        static void SetEnabled(bool enabled) { s_Enabled.store(enabled, std::memory_order_relaxed); }
+        static bool IsEnabled() { return s_Enabled.load(std::memory_order_relaxed); }
+
+        static void SetThreadName(const std::string& name);
+        static uint64_t Now();
+        // Appends to the calling thread's ring buffer, no locks
+        static void RecordZone(const char* name, uint64_t start, uint64_t end);
+
+        // Collects GPU timings of the frame that left the query ring, GL thread only
+        static void NewFrame();
+        static int BeginGpuZone(const char* name);
+        static void EndGpuZone(int zone);
+        // Timings of the most recently resolved frame
+        static const std::vector<GpuTiming>& GetGpuTimings();
+
+        // Frame-time histogram, 0.05 ms buckets up to 200 ms
+        static void RecordFrameTime(double milliseconds);
+        static FrameTimePercentiles GetFrameTimePercentiles();
+        static void ResetFrameTimes();
+
+        // Chrome trace event JSON (chrome://tracing, Perfetto). Call between frames.
+        static bool ExportChromeTrace(const std::string& path);
+
+    private:
+        static std::atomic<bool> s_Enabled;
+    };
+
+    class ProfileScope {
+    public:
+        explicit ProfileScope(const char* name)
+            : m_Name(Profiler::IsEnabled() ? name : nullptr),
+              m_Start(m_Name ? Profiler::Now() : 0) {
+        }
+
+        ~ProfileScope() {
+            if (m_Name) {
+                Profiler::RecordZone(m_Name, m_Start, Profiler::Now());
+            }
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        const char* m_Name;
+        uint64_t m_Start;
+    };
+
+    class GpuProfileScope {
+    public:
+        explicit GpuProfileScope(const char* name)
+            : m_Zone(Profiler::BeginGpuZone(name)) {
+        }
+
+        ~GpuProfileScope() {
+            Profiler::EndGpuZone(m_Zone);
+        }
+
+        GpuProfileScope(const GpuProfileScope&) = delete;
+        GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+    private:
+        int m_Zone;
+    };
+
+}
@@ -1,11 +1,29 @@
 #include "Window.h"
 #include <GLFW/glfw3.h>
+#include <cstdlib>
 #include <stdexcept>
 
 namespace Circe {
 
-    Window::Window(int width, int height, const char* title)
-        : m_Width(width), m_Height(height) {
+#if defined(GLFW_PLATFORM_NULL)
+    static bool HasDisplay() {
+        return std::getenv("DISPLAY") || std::getenv("WAYLAND_DISPLAY");
+    }
+#endif
+
+    Window::Window(int width, int height, const char* title, bool visible)
+        : m_Width(width), m_Height(height), m_Visible(visible) {
+
+#if defined(GLFW_PLATFORM_NULL)
+        // Build farm machines have no display: fall back to the null platform + OSMesa
+        // (Mesa llvmpipe) so headless runs still get a GL context
+        const bool surfaceless = !visible && !HasDisplay();
+        if (surfaceless) {
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        }
+#else
+        const bool surfaceless = false;
+#endif
         
         if (!glfwInit()) {
             throw std::runtime_error("Failed to initialize GLFW");
@@ -14,6 +32,12 @@ namespace Circe {
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
+#if defined(GLFW_OSMESA_CONTEXT_API)
+        if (surfaceless) {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        }
+#endif
 
         m_Window = glfwCreateWindow(width, height, title, nullptr, nullptr);
         if (!m_Window) {
@@ -24,9 +48,13 @@ namespace Circe {
         glfwMakeContextCurrent(m_Window);
         SetVSync(true);
 
-        // Framebuffer size callback
+        // Framebuffer size callback, runs inside PollEvents which may not hold the context
+        glfwSetWindowUserPointer(m_Window, this);
         glfwSetFramebufferSizeCallback(m_Window, [](GLFWwindow* window, int width, int height) {
-            glViewport(0, 0, width, height);
+            Window* self = static_cast<Window*>(glfwGetWindowUserPointer(window));
+            self->m_FramebufferWidth.store(width, std::memory_order_relaxed);
+            self->m_FramebufferHeight.store(height, std::memory_order_relaxed);
+            self->m_ResizePending.store(true, std::memory_order_release);
         });
     }
 
@@ -51,4 +79,21 @@ namespace Circe {
         glfwSwapInterval(enabled ? 1 : 0);
     }
 
+    void Window::MakeContextCurrent() {
+        glfwMakeContextCurrent(m_Window);
+    }
+
+    void Window::ReleaseContext() {
+        glfwMakeContextCurrent(nullptr);
+    }
+
+    bool Window::ConsumeResize(int& width, int& height) {
+        if (!m_ResizePending.exchange(false, std::memory_order_acquire)) {
+            return false;
+        }
+        width = m_FramebufferWidth.load(std::memory_order_relaxed);
+        height = m_FramebufferHeight.load(std::memory_order_relaxed);
+        return true;
+    }
+
 }
\ No newline at end of file
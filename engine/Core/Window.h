@@ -1,17 +1,24 @@
 #pragma once
 
+#include <atomic>
+
 struct GLFWwindow;
 
 namespace Circe {
 
     class Window {
     public:
-        Window(int width, int height, const char* title);
+        // visible = false creates a hidden window for headless runs. Without any display
+        // server the context is created surfaceless through OSMesa (GLFW 3.4 null platform).
+        Window(int width, int height, const char* title, bool visible = true);
         ~Window();
 
+        // Main thread only
         void PollEvents();
+        // Thread holding the context
         void SwapBuffers();
         bool ShouldClose() const;
+        bool IsVisible() const { return m_Visible; }
 
         int GetWidth() const { return m_Width; }
         int GetHeight() const { return m_Height; }
@@ -19,10 +26,22 @@ namespace Circe {
 
         void SetVSync(bool enabled);
 
+        // Moves the GL context to the calling thread; release it on the old thread first
+        void MakeContextCurrent();
+        void ReleaseContext();
+
+        // Resizes land here from PollEvents; the thread holding the context applies them.
+        // True once per resize, with the new framebuffer size.
+        bool ConsumeResize(int& width, int& height);
+
     private:
         GLFWwindow* m_Window;
         int m_Width;
         int m_Height;
+        bool m_Visible;
+        std::atomic<bool> m_ResizePending{ false };
+        std::atomic<int> m_FramebufferWidth{ 0 };
+        std::atomic<int> m_FramebufferHeight{ 0 };
     };
 
 }
\ No newline at end of file
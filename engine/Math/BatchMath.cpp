@@ -0,0 +1,673 @@
+#include "BatchMath.h"
+#include <atomic>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define CIRCE_BATCH_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+// GCC and Clang build each kernel for its own instruction set while the rest of the engine
+// keeps the baseline, so one binary runs everywhere and dispatches at runtime
+#if defined(CIRCE_BATCH_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define CIRCE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #define CIRCE_TARGET_SSE41 __attribute__((target("sse4.1")))
+#else
+    #define CIRCE_TARGET_AVX2
+    #define CIRCE_TARGET_SSE41
+#endif
+
+namespace Circe {
+
+    namespace BatchMath {
+
+        namespace {
+
+            static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "kernels address a mat4 as 16 floats");
+            static_assert(sizeof(glm::quat) == 4 * sizeof(float), "kernels address a quat as 4 floats");
+            static_assert(sizeof(Transform) % sizeof(float) == 0 && sizeof(AABB) == 6 * sizeof(float));
+
+            // Float offsets of the members, so the kernels assume no member order (glm's quat
+            // is xyzw or wxyz depending on GLM_FORCE_QUAT_DATA_WXYZ)
+            constexpr int TransformStride = sizeof(Transform) / sizeof(float);
+            constexpr int PositionOffset = offsetof(Transform, Position) / sizeof(float);
+            constexpr int ScaleOffset = offsetof(Transform, Scale) / sizeof(float);
+            constexpr int QuatX = (offsetof(Transform, Rotation) + offsetof(glm::quat, x)) / sizeof(float);
+            constexpr int QuatY = (offsetof(Transform, Rotation) + offsetof(glm::quat, y)) / sizeof(float);
+            constexpr int QuatZ = (offsetof(Transform, Rotation) + offsetof(glm::quat, z)) / sizeof(float);
+            constexpr int QuatW = (offsetof(Transform, Rotation) + offsetof(glm::quat, w)) / sizeof(float);
+            constexpr int BoxMinOffset = offsetof(AABB, Min) / sizeof(float);
+            constexpr int BoxMaxOffset = offsetof(AABB, Max) / sizeof(float);
+
+            const glm::quat IdentityQuat(1.0f, 0.0f, 0.0f, 0.0f);
+
+            // Eberly, "A Fast and Accurate Algorithm for Computing SLERP": sin(t * angle) / sin(angle)
+            // is t * (1 + b[0] * (1 + b[1] * (...))) with b[i] = (U(i) t^2 - V(i)) (cos(angle) - 1).
+            // The paper's 8 terms are only good to 2e-5 near 90 degrees; 14 with a refitted mu
+            // stay within 2e-7 over the whole shorter arc.
+            constexpr int SlerpTerms = 14;
+            constexpr float SlerpMu = 1.90659569f;
+            constexpr float SlerpU(int i) {
+                return (i + 1 < SlerpTerms ? 1.0f : SlerpMu) / ((i + 1) * (2 * i + 3));
+            }
+            constexpr float SlerpV(int i) {
+                return (i + 1 < SlerpTerms ? 1.0f : SlerpMu) * (i + 1) / (2 * i + 3);
+            }
+
+            // Scalar kernels: the reference results, and the tails of the SIMD ones
+
+            void ComposeTRSScalar(const Transform* transforms, glm::mat4* out, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    out[i] = transforms[i].GetModelMatrix();
+                }
+            }
+
+            void MultiplyScalar(const glm::mat4* a, const glm::mat4* b, glm::mat4* out, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    out[i] = a[i] * b[i];
+                }
+            }
+
+            void MultiplyBroadcastScalar(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count) {
+                const glm::mat4 left = a;
+                for (size_t i = 0; i < count; ++i) {
+                    out[i] = left * b[i];
+                }
+            }
+
+            void NormalizeScalar(glm::quat* quats, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    quats[i] = glm::normalize(quats[i]);
+                }
+            }
+
+            void SlerpScalar(const glm::quat* a, const glm::quat* b, float t, glm::quat* out, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    out[i] = glm::slerp(a[i], b[i], t);
+                }
+            }
+
+            void TransformAABBsScalar(const AABB* boxes, const glm::mat4* matrices, AABB* out, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    out[i] = boxes[i].Transformed(matrices[i]);
+                }
+            }
+
+#if defined(CIRCE_BATCH_X86)
+
+            // AVX2 + FMA, 8 elements per step
+
+            // 4x4 transpose within each 128-bit half: rows a..d become columns
+            CIRCE_TARGET_AVX2 inline void Transpose(__m256& a, __m256& b, __m256& c, __m256& d) {
+                const __m256 t0 = _mm256_unpacklo_ps(a, b);
+                const __m256 t1 = _mm256_unpackhi_ps(a, b);
+                const __m256 t2 = _mm256_unpacklo_ps(c, d);
+                const __m256 t3 = _mm256_unpackhi_ps(c, d);
+                a = _mm256_shuffle_ps(t0, t2, 0x44);
+                b = _mm256_shuffle_ps(t0, t2, 0xEE);
+                c = _mm256_shuffle_ps(t1, t3, 0x44);
+                d = _mm256_shuffle_ps(t1, t3, 0xEE);
+            }
+
+            CIRCE_TARGET_AVX2 inline __m256 Gather(const float* base, __m256i lanes) {
+                return _mm256_i32gather_ps(base, lanes, 4);
+            }
+
+            CIRCE_TARGET_AVX2 void ComposeTRSAVX2(const Transform* transforms, glm::mat4* out, size_t count) {
+                const __m256i lanes = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(TransformStride));
+                const __m256 one = _mm256_set1_ps(1.0f);
+                const __m256 two = _mm256_set1_ps(2.0f);
+
+                size_t i = 0;
+                for (; i + 8 <= count; i += 8) {
+                    const float* base = reinterpret_cast<const float*>(transforms + i);
+                    const __m256 x = Gather(base + QuatX, lanes);
+                    const __m256 y = Gather(base + QuatY, lanes);
+                    const __m256 z = Gather(base + QuatZ, lanes);
+                    const __m256 w = Gather(base + QuatW, lanes);
+                    const __m256 scaleX = Gather(base + ScaleOffset, lanes);
+                    const __m256 scaleY = Gather(base + ScaleOffset + 1, lanes);
+                    const __m256 scaleZ = Gather(base + ScaleOffset + 2, lanes);
+
+                    const __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+                    const __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+                    const __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+                    // Same terms as Transform::GetModelMatrix, one register per matrix element
+                    __m256 column0[4] = {
+                        _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), scaleX),
+                        _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), scaleX),
+                        _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), scaleX),
+                        _mm256_setzero_ps()
+                    };
+                    __m256 column1[4] = {
+                        _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), scaleY),
+                        _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), scaleY),
+                        _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), scaleY),
+                        _mm256_setzero_ps()
+                    };
+                    __m256 column2[4] = {
+                        _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), scaleZ),
+                        _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), scaleZ),
+                        _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), scaleZ),
+                        _mm256_setzero_ps()
+                    };
+                    __m256 column3[4] = {
+                        Gather(base + PositionOffset, lanes),
+                        Gather(base + PositionOffset + 1, lanes),
+                        Gather(base + PositionOffset + 2, lanes),
+                        one
+                    };
+
+                    // Back to one register per column: register k holds matrix k | matrix k + 4
+                    Transpose(column0[0], column0[1], column0[2], column0[3]);
+                    Transpose(column1[0], column1[1], column1[2], column1[3]);
+                    Transpose(column2[0], column2[1], column2[2], column2[3]);
+                    Transpose(column3[0], column3[1], column3[2], column3[3]);
+
+                    float* dst = reinterpret_cast<float*>(out + i);
+                    for (int k = 0; k < 4; ++k) {
+                        _mm256_storeu_ps(dst + k * 16, _mm256_permute2f128_ps(column0[k], column1[k], 0x20));
+                        _mm256_storeu_ps(dst + k * 16 + 8, _mm256_permute2f128_ps(column2[k], column3[k], 0x20));
+                        _mm256_storeu_ps(dst + (k + 4) * 16, _mm256_permute2f128_ps(column0[k], column1[k], 0x31));
+                        _mm256_storeu_ps(dst + (k + 4) * 16 + 8, _mm256_permute2f128_ps(column2[k], column3[k], 0x31));
+                    }
+                }
+                ComposeTRSScalar(transforms + i, out + i, count - i);
+            }
+
+            // Two result columns per register: column j is the a columns weighted by b[j]
+            CIRCE_TARGET_AVX2 inline void MultiplyOne(__m256 a0, __m256 a1, __m256 a2, __m256 a3, const float* b, float* out) {
+                const __m256 b01 = _mm256_loadu_ps(b);
+                const __m256 b23 = _mm256_loadu_ps(b + 8);
+                __m256 r01 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b01, b01, 0x00));
+                __m256 r23 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b23, b23, 0x00));
+                r01 = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(b01, b01, 0x55), r01);
+                r23 = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(b23, b23, 0x55), r23);
+                r01 = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(b01, b01, 0xAA), r01);
+                r23 = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(b23, b23, 0xAA), r23);
+                r01 = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(b01, b01, 0xFF), r01);
+                r23 = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(b23, b23, 0xFF), r23);
+                _mm256_storeu_ps(out, r01);
+                _mm256_storeu_ps(out + 8, r23);
+            }
+
+            CIRCE_TARGET_AVX2 void MultiplyAVX2(const glm::mat4* a, const glm::mat4* b, glm::mat4* out, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    const float* left = reinterpret_cast<const float*>(a + i);
+                    MultiplyOne(
+                        _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left)),
+                        _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left + 4)),
+                        _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left + 8)),
+                        _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left + 12)),
+                        reinterpret_cast<const float*>(b + i), reinterpret_cast<float*>(out + i));
+                }
+            }
+
+            CIRCE_TARGET_AVX2 void MultiplyBroadcastAVX2(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count) {
+                const float* left = reinterpret_cast<const float*>(&a);
+                const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left));
+                const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left + 4));
+                const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left + 8));
+                const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left + 12));
+                for (size_t i = 0; i < count; ++i) {
+                    MultiplyOne(a0, a1, a2, a3, reinterpret_cast<const float*>(b + i), reinterpret_cast<float*>(out + i));
+                }
+            }
+
+            CIRCE_TARGET_AVX2 void NormalizeAVX2(glm::quat* quats, size_t count) {
+                const __m256 identity = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&IdentityQuat));
+                size_t i = 0;
+                for (; i + 2 <= count; i += 2) {
+                    float* q = reinterpret_cast<float*>(quats + i);
+                    const __m256 v = _mm256_loadu_ps(q);
+                    const __m256 lengthSquared = _mm256_dp_ps(v, v, 0xFF);
+                    const __m256 degenerate = _mm256_cmp_ps(lengthSquared, _mm256_setzero_ps(), _CMP_LE_OQ);
+                    const __m256 normalized = _mm256_div_ps(v, _mm256_sqrt_ps(lengthSquared));
+                    _mm256_storeu_ps(q, _mm256_blendv_ps(normalized, identity, degenerate));
+                }
+                NormalizeScalar(quats + i, count - i);
+            }
+
+            CIRCE_TARGET_AVX2 void SlerpAVX2(const glm::quat* a, const glm::quat* b, float t, glm::quat* out, size_t count) {
+                // The polynomial coefficients depend on t alone
+                const float d = 1.0f - t;
+                __m256 coefficientsT[SlerpTerms];
+                __m256 coefficientsD[SlerpTerms];
+                for (int k = 0; k < SlerpTerms; ++k) {
+                    coefficientsT[k] = _mm256_set1_ps(SlerpU(k) * t * t - SlerpV(k));
+                    coefficientsD[k] = _mm256_set1_ps(SlerpU(k) * d * d - SlerpV(k));
+                }
+                const __m256 one = _mm256_set1_ps(1.0f);
+                const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+                size_t i = 0;
+                for (; i + 8 <= count; i += 8) {
+                    const float* pa = reinterpret_cast<const float*>(a + i);
+                    const float* pb = reinterpret_cast<const float*>(b + i);
+                    __m256 a0 = _mm256_loadu_ps(pa), a1 = _mm256_loadu_ps(pa + 8), a2 = _mm256_loadu_ps(pa + 16), a3 = _mm256_loadu_ps(pa + 24);
+                    __m256 b0 = _mm256_loadu_ps(pb), b1 = _mm256_loadu_ps(pb + 8), b2 = _mm256_loadu_ps(pb + 16), b3 = _mm256_loadu_ps(pb + 24);
+                    // One register per quaternion component; lanes are out of order but consistently so
+                    Transpose(a0, a1, a2, a3);
+                    Transpose(b0, b1, b2, b3);
+
+                    __m256 cosAngle = _mm256_mul_ps(a0, b0);
+                    cosAngle = _mm256_fmadd_ps(a1, b1, cosAngle);
+                    cosAngle = _mm256_fmadd_ps(a2, b2, cosAngle);
+                    cosAngle = _mm256_fmadd_ps(a3, b3, cosAngle);
+                    // Shorter arc: negative dot products flip b
+                    const __m256 sign = _mm256_and_ps(cosAngle, signBit);
+                    const __m256 cosMinusOne = _mm256_sub_ps(_mm256_xor_ps(cosAngle, sign), one);
+
+                    __m256 seriesT = _mm256_fmadd_ps(coefficientsT[SlerpTerms - 1], cosMinusOne, one);
+                    __m256 seriesD = _mm256_fmadd_ps(coefficientsD[SlerpTerms - 1], cosMinusOne, one);
+                    for (int k = SlerpTerms - 2; k >= 0; --k) {
+                        seriesT = _mm256_fmadd_ps(_mm256_mul_ps(coefficientsT[k], cosMinusOne), seriesT, one);
+                        seriesD = _mm256_fmadd_ps(_mm256_mul_ps(coefficientsD[k], cosMinusOne), seriesD, one);
+                    }
+                    const __m256 weightB = _mm256_xor_ps(_mm256_mul_ps(_mm256_set1_ps(t), seriesT), sign);
+                    const __m256 weightA = _mm256_mul_ps(_mm256_set1_ps(d), seriesD);
+
+                    __m256 r0 = _mm256_fmadd_ps(weightA, a0, _mm256_mul_ps(weightB, b0));
+                    __m256 r1 = _mm256_fmadd_ps(weightA, a1, _mm256_mul_ps(weightB, b1));
+                    __m256 r2 = _mm256_fmadd_ps(weightA, a2, _mm256_mul_ps(weightB, b2));
+                    __m256 r3 = _mm256_fmadd_ps(weightA, a3, _mm256_mul_ps(weightB, b3));
+                    Transpose(r0, r1, r2, r3);
+
+                    float* dst = reinterpret_cast<float*>(out + i);
+                    _mm256_storeu_ps(dst, r0);
+                    _mm256_storeu_ps(dst + 8, r1);
+                    _mm256_storeu_ps(dst + 16, r2);
+                    _mm256_storeu_ps(dst + 24, r3);
+                }
+                SlerpScalar(a + i, b + i, t, out + i, count - i);
+            }
+
+            CIRCE_TARGET_AVX2 void TransformAABBsAVX2(const AABB* boxes, const glm::mat4* matrices, AABB* out, size_t count) {
+                const __m256i boxLanes = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(6));
+                const __m256i matrixLanes = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(16));
+                const __m256 half = _mm256_set1_ps(0.5f);
+                const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+                alignas(32) float result[6][8];
+
+                size_t i = 0;
+                for (; i + 8 <= count; i += 8) {
+                    const float* box = reinterpret_cast<const float*>(boxes + i);
+                    const float* matrix = reinterpret_cast<const float*>(matrices + i);
+
+                    __m256 minimum[3], maximum[3], center[3], extents[3];
+                    __m256 invalid = _mm256_setzero_ps();
+                    for (int axis = 0; axis < 3; ++axis) {
+                        minimum[axis] = Gather(box + BoxMinOffset + axis, boxLanes);
+                        maximum[axis] = Gather(box + BoxMaxOffset + axis, boxLanes);
+                        center[axis] = _mm256_mul_ps(_mm256_add_ps(minimum[axis], maximum[axis]), half);
+                        extents[axis] = _mm256_mul_ps(_mm256_sub_ps(maximum[axis], minimum[axis]), half);
+                        invalid = _mm256_or_ps(invalid, _mm256_cmp_ps(minimum[axis], maximum[axis], _CMP_NLE_UQ));
+                    }
+
+                    // Arvo's method per output axis; invalid (empty) boxes pass through unchanged
+                    for (int row = 0; row < 3; ++row) {
+                        __m256 worldCenter = Gather(matrix + 12 + row, matrixLanes);
+                        __m256 worldExtent = _mm256_setzero_ps();
+                        for (int column = 0; column < 3; ++column) {
+                            const __m256 element = Gather(matrix + column * 4 + row, matrixLanes);
+                            worldCenter = _mm256_fmadd_ps(element, center[column], worldCenter);
+                            worldExtent = _mm256_fmadd_ps(_mm256_and_ps(element, absMask), extents[column], worldExtent);
+                        }
+                        _mm256_store_ps(result[row], _mm256_blendv_ps(_mm256_sub_ps(worldCenter, worldExtent), minimum[row], invalid));
+                        _mm256_store_ps(result[3 + row], _mm256_blendv_ps(_mm256_add_ps(worldCenter, worldExtent), maximum[row], invalid));
+                    }
+
+                    for (int k = 0; k < 8; ++k) {
+                        out[i + k] = AABB(glm::vec3(result[0][k], result[1][k], result[2][k]), glm::vec3(result[3][k], result[4][k], result[5][k]));
+                    }
+                }
+                TransformAABBsScalar(boxes + i, matrices + i, out + i, count - i);
+            }
+
+            // SSE4.1, 4 elements per step (no FMA, no gathers)
+
+            CIRCE_TARGET_SSE41 inline __m128 Load4(const float* base, int stride) {
+                return _mm_setr_ps(base[0], base[stride], base[stride * 2], base[stride * 3]);
+            }
+
+            CIRCE_TARGET_SSE41 void ComposeTRSSSE41(const Transform* transforms, glm::mat4* out, size_t count) {
+                const __m128 one = _mm_set1_ps(1.0f);
+                const __m128 two = _mm_set1_ps(2.0f);
+
+                size_t i = 0;
+                for (; i + 4 <= count; i += 4) {
+                    const float* base = reinterpret_cast<const float*>(transforms + i);
+                    const __m128 x = Load4(base + QuatX, TransformStride);
+                    const __m128 y = Load4(base + QuatY, TransformStride);
+                    const __m128 z = Load4(base + QuatZ, TransformStride);
+                    const __m128 w = Load4(base + QuatW, TransformStride);
+                    const __m128 scaleX = Load4(base + ScaleOffset, TransformStride);
+                    const __m128 scaleY = Load4(base + ScaleOffset + 1, TransformStride);
+                    const __m128 scaleZ = Load4(base + ScaleOffset + 2, TransformStride);
+
+                    const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+                    const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+                    const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+                    __m128 column0[4] = {
+                        _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), scaleX),
+                        _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), scaleX),
+                        _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), scaleX),
+                        _mm_setzero_ps()
+                    };
+                    __m128 column1[4] = {
+                        _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), scaleY),
+                        _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), scaleY),
+                        _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), scaleY),
+                        _mm_setzero_ps()
+                    };
+                    __m128 column2[4] = {
+                        _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), scaleZ),
+                        _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), scaleZ),
+                        _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), scaleZ),
+                        _mm_setzero_ps()
+                    };
+                    __m128 column3[4] = {
+                        Load4(base + PositionOffset, TransformStride),
+                        Load4(base + PositionOffset + 1, TransformStride),
+                        Load4(base + PositionOffset + 2, TransformStride),
+                        one
+                    };
+                    _MM_TRANSPOSE4_PS(column0[0], column0[1], column0[2], column0[3]);
+                    _MM_TRANSPOSE4_PS(column1[0], column1[1], column1[2], column1[3]);
+                    _MM_TRANSPOSE4_PS(column2[0], column2[1], column2[2], column2[3]);
+                    _MM_TRANSPOSE4_PS(column3[0], column3[1], column3[2], column3[3]);
+
+                    float* dst = reinterpret_cast<float*>(out + i);
+                    for (int k = 0; k < 4; ++k) {
+                        _mm_storeu_ps(dst + k * 16, column0[k]);
+                        _mm_storeu_ps(dst + k * 16 + 4, column1[k]);
+                        _mm_storeu_ps(dst + k * 16 + 8, column2[k]);
+                        _mm_storeu_ps(dst + k * 16 + 12, column3[k]);
+                    }
+                }
+                ComposeTRSScalar(transforms + i, out + i, count - i);
+            }
+
+            CIRCE_TARGET_SSE41 inline __m128 MultiplyColumn(__m128 a0, __m128 a1, __m128 a2, __m128 a3, __m128 b) {
+                __m128 result = _mm_mul_ps(a0, _mm_shuffle_ps(b, b, 0x00));
+                result = _mm_add_ps(result, _mm_mul_ps(a1, _mm_shuffle_ps(b, b, 0x55)));
+                result = _mm_add_ps(result, _mm_mul_ps(a2, _mm_shuffle_ps(b, b, 0xAA)));
+                return _mm_add_ps(result, _mm_mul_ps(a3, _mm_shuffle_ps(b, b, 0xFF)));
+            }
+
+            CIRCE_TARGET_SSE41 inline void MultiplyOne(__m128 a0, __m128 a1, __m128 a2, __m128 a3, const float* b, float* out) {
+                const __m128 b0 = _mm_loadu_ps(b), b1 = _mm_loadu_ps(b + 4), b2 = _mm_loadu_ps(b + 8), b3 = _mm_loadu_ps(b + 12);
+                _mm_storeu_ps(out, MultiplyColumn(a0, a1, a2, a3, b0));
+                _mm_storeu_ps(out + 4, MultiplyColumn(a0, a1, a2, a3, b1));
+                _mm_storeu_ps(out + 8, MultiplyColumn(a0, a1, a2, a3, b2));
+                _mm_storeu_ps(out + 12, MultiplyColumn(a0, a1, a2, a3, b3));
+            }
+
+            CIRCE_TARGET_SSE41 void MultiplySSE41(const glm::mat4* a, const glm::mat4* b, glm::mat4* out, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    const float* left = reinterpret_cast<const float*>(a + i);
+                    MultiplyOne(_mm_loadu_ps(left), _mm_loadu_ps(left + 4), _mm_loadu_ps(left + 8), _mm_loadu_ps(left + 12),
+                        reinterpret_cast<const float*>(b + i), reinterpret_cast<float*>(out + i));
+                }
+            }
+
+            CIRCE_TARGET_SSE41 void MultiplyBroadcastSSE41(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count) {
+                const float* left = reinterpret_cast<const float*>(&a);
+                const __m128 a0 = _mm_loadu_ps(left), a1 = _mm_loadu_ps(left + 4), a2 = _mm_loadu_ps(left + 8), a3 = _mm_loadu_ps(left + 12);
+                for (size_t i = 0; i < count; ++i) {
+                    MultiplyOne(a0, a1, a2, a3, reinterpret_cast<const float*>(b + i), reinterpret_cast<float*>(out + i));
+                }
+            }
+
+            CIRCE_TARGET_SSE41 void NormalizeSSE41(glm::quat* quats, size_t count) {
+                const __m128 identity = _mm_loadu_ps(reinterpret_cast<const float*>(&IdentityQuat));
+                for (size_t i = 0; i < count; ++i) {
+                    float* q = reinterpret_cast<float*>(quats + i);
+                    const __m128 v = _mm_loadu_ps(q);
+                    const __m128 lengthSquared = _mm_dp_ps(v, v, 0xFF);
+                    const __m128 degenerate = _mm_cmple_ps(lengthSquared, _mm_setzero_ps());
+                    _mm_storeu_ps(q, _mm_blendv_ps(_mm_div_ps(v, _mm_sqrt_ps(lengthSquared)), identity, degenerate));
+                }
+            }
+
+            CIRCE_TARGET_SSE41 void SlerpSSE41(const glm::quat* a, const glm::quat* b, float t, glm::quat* out, size_t count) {
+                const float d = 1.0f - t;
+                __m128 coefficientsT[SlerpTerms];
+                __m128 coefficientsD[SlerpTerms];
+                for (int k = 0; k < SlerpTerms; ++k) {
+                    coefficientsT[k] = _mm_set1_ps(SlerpU(k) * t * t - SlerpV(k));
+                    coefficientsD[k] = _mm_set1_ps(SlerpU(k) * d * d - SlerpV(k));
+                }
+                const __m128 one = _mm_set1_ps(1.0f);
+                const __m128 signBit = _mm_set1_ps(-0.0f);
+
+                size_t i = 0;
+                for (; i + 4 <= count; i += 4) {
+                    const float* pa = reinterpret_cast<const float*>(a + i);
+                    const float* pb = reinterpret_cast<const float*>(b + i);
+                    __m128 a0 = _mm_loadu_ps(pa), a1 = _mm_loadu_ps(pa + 4), a2 = _mm_loadu_ps(pa + 8), a3 = _mm_loadu_ps(pa + 12);
+                    __m128 b0 = _mm_loadu_ps(pb), b1 = _mm_loadu_ps(pb + 4), b2 = _mm_loadu_ps(pb + 8), b3 = _mm_loadu_ps(pb + 12);
+                    _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+                    _MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+
+                    __m128 cosAngle = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, b0), _mm_mul_ps(a1, b1)), _mm_add_ps(_mm_mul_ps(a2, b2), _mm_mul_ps(a3, b3)));
+                    const __m128 sign = _mm_and_ps(cosAngle, signBit);
+                    const __m128 cosMinusOne = _mm_sub_ps(_mm_xor_ps(cosAngle, sign), one);
+
+                    __m128 seriesT = _mm_add_ps(one, _mm_mul_ps(coefficientsT[SlerpTerms - 1], cosMinusOne));
+                    __m128 seriesD = _mm_add_ps(one, _mm_mul_ps(coefficientsD[SlerpTerms - 1], cosMinusOne));
+                    for (int k = SlerpTerms - 2; k >= 0; --k) {
+                        seriesT = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(coefficientsT[k], cosMinusOne), seriesT));
+                        seriesD = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(coefficientsD[k], cosMinusOne), seriesD));
+                    }
+                    const __m128 weightB = _mm_xor_ps(_mm_mul_ps(_mm_set1_ps(t), seriesT), sign);
+                    const __m128 weightA = _mm_mul_ps(_mm_set1_ps(d), seriesD);
+
+                    __m128 r0 = _mm_add_ps(_mm_mul_ps(weightA, a0), _mm_mul_ps(weightB, b0));
+                    __m128 r1 = _mm_add_ps(_mm_mul_ps(weightA, a1), _mm_mul_ps(weightB, b1));
+                    __m128 r2 = _mm_add_ps(_mm_mul_ps(weightA, a2), _mm_mul_ps(weightB, b2));
+                    __m128 r3 = _mm_add_ps(_mm_mul_ps(weightA, a3), _mm_mul_ps(weightB, b3));
+                    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+                    float* dst = reinterpret_cast<float*>(out + i);
+                    _mm_storeu_ps(dst, r0);
+                    _mm_storeu_ps(dst + 4, r1);
+                    _mm_storeu_ps(dst + 8, r2);
+                    _mm_storeu_ps(dst + 12, r3);
+                }
+                SlerpScalar(a + i, b + i, t, out + i, count - i);
+            }
+
+            CIRCE_TARGET_SSE41 void TransformAABBsSSE41(const AABB* boxes, const glm::mat4* matrices, AABB* out, size_t count) {
+                const __m128 half = _mm_set1_ps(0.5f);
+                const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+                alignas(16) float result[6][4];
+
+                size_t i = 0;
+                for (; i + 4 <= count; i += 4) {
+                    const float* box = reinterpret_cast<const float*>(boxes + i);
+                    const float* matrix = reinterpret_cast<const float*>(matrices + i);
+
+                    __m128 minimum[3], maximum[3], center[3], extents[3];
+                    __m128 invalid = _mm_setzero_ps();
+                    for (int axis = 0; axis < 3; ++axis) {
+                        minimum[axis] = Load4(box + BoxMinOffset + axis, 6);
+                        maximum[axis] = Load4(box + BoxMaxOffset + axis, 6);
+                        center[axis] = _mm_mul_ps(_mm_add_ps(minimum[axis], maximum[axis]), half);
+                        extents[axis] = _mm_mul_ps(_mm_sub_ps(maximum[axis], minimum[axis]), half);
+                        invalid = _mm_or_ps(invalid, _mm_cmpnle_ps(minimum[axis], maximum[axis]));
+                    }
+
+                    for (int row = 0; row < 3; ++row) {
+                        __m128 worldCenter = Load4(matrix + 12 + row, 16);
+                        __m128 worldExtent = _mm_setzero_ps();
+                        for (int column = 0; column < 3; ++column) {
+                            const __m128 element = Load4(matrix + column * 4 + row, 16);
+                            worldCenter = _mm_add_ps(worldCenter, _mm_mul_ps(element, center[column]));
+                            worldExtent = _mm_add_ps(worldExtent, _mm_mul_ps(_mm_and_ps(element, absMask), extents[column]));
+                        }
+                        _mm_store_ps(result[row], _mm_blendv_ps(_mm_sub_ps(worldCenter, worldExtent), minimum[row], invalid));
+                        _mm_store_ps(result[3 + row], _mm_blendv_ps(_mm_add_ps(worldCenter, worldExtent), maximum[row], invalid));
+                    }
+
+                    for (int k = 0; k < 4; ++k) {
+                        out[i + k] = AABB(glm::vec3(result[0][k], result[1][k], result[2][k]), glm::vec3(result[3][k], result[4][k], result[5][k]));
+                    }
+                }
+                TransformAABBsScalar(boxes + i, matrices + i, out + i, count - i);
+            }
+
+            void Cpuid(int info[4], int leaf, int subleaf) {
+#if defined(_MSC_VER)
+                __cpuidex(info, leaf, subleaf);
+#else
+                unsigned int a = 0, b = 0, c = 0, d = 0;
+                __cpuid_count(leaf, subleaf, a, b, c, d);
+                info[0] = static_cast<int>(a);
+                info[1] = static_cast<int>(b);
+                info[2] = static_cast<int>(c);
+                info[3] = static_cast<int>(d);
+#endif
+            }
+
+            uint64_t ReadXCR0() {
+#if defined(_MSC_VER)
+                return _xgetbv(0);
+#else
+                uint32_t low = 0, high = 0;
+                __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+                return (static_cast<uint64_t>(high) << 32) | low;
+#endif
+            }
+
+#endif
+
+            SimdLevel DetectLevel() {
+#if defined(CIRCE_BATCH_X86)
+                int info[4] = {};
+                Cpuid(info, 0, 0);
+                const int maxLeaf = info[0];
+
+                Cpuid(info, 1, 0);
+                const bool sse41 = (info[2] & (1 << 19)) != 0;
+                const bool fma = (info[2] & (1 << 12)) != 0;
+                const bool osxsave = (info[2] & (1 << 27)) != 0;
+                const bool avx = (info[2] & (1 << 28)) != 0;
+                // The OS must save the YMM registers across context switches (XCR0 bits 1 and 2)
+                const bool ymmEnabled = osxsave && avx && (ReadXCR0() & 0x6) == 0x6;
+
+                bool avx2 = false;
+                if (maxLeaf >= 7) {
+                    Cpuid(info, 7, 0);
+                    avx2 = (info[1] & (1 << 5)) != 0;
+                }
+
+                if (avx2 && fma && ymmEnabled) {
+                    return SimdLevel::AVX2;
+                }
+                if (sse41) {
+                    return SimdLevel::SSE41;
+                }
+#endif
+                return SimdLevel::Scalar;
+            }
+
+            struct Kernels {
+                void (*ComposeTRS)(const Transform*, glm::mat4*, size_t);
+                void (*Multiply)(const glm::mat4*, const glm::mat4*, glm::mat4*, size_t);
+                void (*MultiplyBroadcast)(const glm::mat4&, const glm::mat4*, glm::mat4*, size_t);
+                void (*Normalize)(glm::quat*, size_t);
+                void (*Slerp)(const glm::quat*, const glm::quat*, float, glm::quat*, size_t);
+                void (*TransformAABBs)(const AABB*, const glm::mat4*, AABB*, size_t);
+            };
+
+            const Kernels ScalarKernels = {
+                ComposeTRSScalar, MultiplyScalar, MultiplyBroadcastScalar, NormalizeScalar, SlerpScalar, TransformAABBsScalar
+            };
+#if defined(CIRCE_BATCH_X86)
+            const Kernels SSE41Kernels = {
+                ComposeTRSSSE41, MultiplySSE41, MultiplyBroadcastSSE41, NormalizeSSE41, SlerpSSE41, TransformAABBsSSE41
+            };
+            const Kernels AVX2Kernels = {
+                ComposeTRSAVX2, MultiplyAVX2, MultiplyBroadcastAVX2, NormalizeAVX2, SlerpAVX2, TransformAABBsAVX2
+            };
+#endif
+
+            // -1 until SetLevel, meaning the supported level
+            std::atomic<int> s_Level{ -1 };
+
+            const Kernels& GetKernels() {
+                switch (GetLevel()) {
+#if defined(CIRCE_BATCH_X86)
+                case SimdLevel::AVX2:
+                    return AVX2Kernels;
+                case SimdLevel::SSE41:
+                    return SSE41Kernels;
+#endif
+                default:
+                    return ScalarKernels;
+                }
+            }
+
+        }
+
+        SimdLevel GetSupportedLevel() {
+            static const SimdLevel level = DetectLevel();
+            return level;
+        }
+
+        SimdLevel GetLevel() {
+            const int level = s_Level.load(std::memory_order_relaxed);
+            return level < 0 ? GetSupportedLevel() : static_cast<SimdLevel>(level);
+        }
+
+        void SetLevel(SimdLevel level) {
+            const SimdLevel supported = GetSupportedLevel();
+            s_Level.store(static_cast<int>(level > supported ? supported : level), std::memory_order_relaxed);
+        }
+
+        const char* GetLevelName(SimdLevel level) {
+            switch (level) {
+            case SimdLevel::AVX2:
+                return "AVX2";
+            case SimdLevel::SSE41:
+                return "SSE4.1";
+            default:
+                return "Scalar";
+            }
+        }
+
+        void ComposeTRS(const Transform* transforms, glm::mat4* out, size_t count) {
+            GetKernels().ComposeTRS(transforms, out, count);
+        }
+
+        void Multiply(const glm::mat4* a, const glm::mat4* b, glm::mat4* out, size_t count) {
+            GetKernels().Multiply(a, b, out, count);
+        }
+
+        void Multiply(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count) {
+            GetKernels().MultiplyBroadcast(a, b, out, count);
+        }
+
+        void Normalize(glm::quat* quats, size_t count) {
+            GetKernels().Normalize(quats, count);
+        }
+
+        void Slerp(const glm::quat* a, const glm::quat* b, float t, glm::quat* out, size_t count) {
+            GetKernels().Slerp(a, b, t, out, count);
+        }
+
+        void TransformAABBs(const AABB* boxes, const glm::mat4* matrices, AABB* out, size_t count) {
+            GetKernels().TransformAABBs(boxes, matrices, out, count);
+        }
+
+    }
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Bounds.h"
+#include "Transform.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace Circe {
+
+    // Math over arrays of the engine's glm types. Each kernel has an AVX2/FMA, an SSE4.1 and
+    // a scalar version; the widest one the CPU and OS support is picked at startup (CPUID).
+    // TRS composition, slerp and box transforms load their inputs into SoA registers, 8 (AVX2)
+    // or 4 (SSE4.1) elements per step. Matrix products and normalization work a whole mat4
+    // or quat per register instead, which is already the dense layout for them.
+    namespace BatchMath {
+
+        enum class SimdLevel : uint8_t {
+            Scalar = 0,
+            SSE41 = 1,
+            AVX2 = 2
+        };
+
+        // Widest level this CPU supports
+        SimdLevel GetSupportedLevel();
+        // Level the kernels currently run at, also used by Frustum::CullSpheres
+        SimdLevel GetLevel();
+        // Clamped to the supported level. For tests and benchmarks; not while kernels run.
+        void SetLevel(SimdLevel level);
+        const char* GetLevelName(SimdLevel level);
+
+        // out[i] = transforms[i].GetModelMatrix()
+        void ComposeTRS(const Transform* transforms, glm::mat4* out, size_t count);
+
+        // out[i] = a[i] * b[i]; out may be a or b
+        void Multiply(const glm::mat4* a, const glm::mat4* b, glm::mat4* out, size_t count);
+        // out[i] = a * b[i]; out may be b
+        void Multiply(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count);
+
+        // In place, zero-length quaternions become identity like glm::normalize
+        void Normalize(glm::quat* quats, size_t count);
+        // out[i] = glm::slerp(a[i], b[i], t) along the shorter arc. The SIMD versions use
+        // Eberly's polynomial for sin(t * angle) / sin(angle), within 1e-6 of glm for unit inputs.
+        void Slerp(const glm::quat* a, const glm::quat* b, float t, glm::quat* out, size_t count);
+
+        // out[i] = boxes[i].Transformed(matrices[i]); out may be boxes
+        void TransformAABBs(const AABB* boxes, const glm::mat4* matrices, AABB* out, size_t count);
+
+    }
+
+}
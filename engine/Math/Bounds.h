@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cmath>
+#include <limits>
+
+namespace Circe {
+
+    struct AABB {
+        AABB()
+            : Min(std::numeric_limits<float>::max()), Max(-std::numeric_limits<float>::max()) {}
+        AABB(const glm::vec3& min, const glm::vec3& max)
+            : Min(min), Max(max) {}
+
+        glm::vec3 Min;
+        glm::vec3 Max;
+
+        bool IsValid() const { return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z; }
+        glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+        glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+        void Expand(const glm::vec3& point) {
+            Min = glm::min(Min, point);
+            Max = glm::max(Max, point);
+        }
+
+        // Arvo's method: transform the center, project the extents onto the absolute basis
+        AABB Transformed(const glm::mat4& matrix) const {
+            if (!IsValid()) {
+                return *this;
+            }
+            const glm::vec3 center = glm::vec3(matrix * glm::vec4(GetCenter(), 1.0f));
+            const glm::vec3 extents = GetExtents();
+            const glm::vec3 worldExtents =
+                glm::abs(glm::vec3(matrix[0])) * extents.x +
+                glm::abs(glm::vec3(matrix[1])) * extents.y +
+                glm::abs(glm::vec3(matrix[2])) * extents.z;
+            return AABB(center - worldExtents, center + worldExtents);
+        }
+    };
+
+    struct BoundingSphere {
+        glm::vec3 Center = glm::vec3(0.0f);
+        // Negative when there is nothing to bound (a mesh without vertices)
+        float Radius = -1.0f;
+
+        bool IsValid() const { return Radius >= 0.0f; }
+
+        // Conservative under non-uniform scale: the radius grows by the largest axis scale
+        BoundingSphere Transformed(const glm::mat4& matrix) const {
+            if (!IsValid()) {
+                return *this;
+            }
+            const float scaleX = glm::dot(glm::vec3(matrix[0]), glm::vec3(matrix[0]));
+            const float scaleY = glm::dot(glm::vec3(matrix[1]), glm::vec3(matrix[1]));
+            const float scaleZ = glm::dot(glm::vec3(matrix[2]), glm::vec3(matrix[2]));
+            const float maxScale = std::sqrt(glm::max(scaleX, glm::max(scaleY, scaleZ)));
+            return { glm::vec3(matrix * glm::vec4(Center, 1.0f)), Radius * maxScale };
+        }
+    };
+
+}
@@ -0,0 +1,172 @@
+#include "Frustum.h"
+#include "BatchMath.h"
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define CIRCE_CULL_X86 1
+    #include <immintrin.h>
+#endif
+
+// Like BatchMath, the wide paths are built for their own instruction set and picked at runtime
+#if defined(CIRCE_CULL_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define CIRCE_TARGET_AVX __attribute__((target("avx")))
+    #define CIRCE_TARGET_SSE __attribute__((target("sse")))
+#else
+    #define CIRCE_TARGET_AVX
+    #define CIRCE_TARGET_SSE
+#endif
+
+namespace Circe {
+
+    namespace {
+
+        struct SphereArrays {
+            const float* X;
+            const float* Y;
+            const float* Z;
+            const float* Radius;
+        };
+
+        // Culls [i, count), the reference result and the tail of the wide paths
+        size_t CullSpheresScalar(const glm::vec4* planes, const SphereArrays& spheres, uint8_t* visible, size_t i, size_t count) {
+            size_t visibleCount = 0;
+            for (; i < count; ++i) {
+                bool inside = true;
+                for (int p = 0; p < Frustum::PlaneCount; ++p) {
+                    const glm::vec4& plane = planes[p];
+                    if (spheres.X[i] * plane.x + spheres.Y[i] * plane.y + spheres.Z[i] * plane.z + plane.w < -spheres.Radius[i]) {
+                        inside = false;
+                        break;
+                    }
+                }
+                visible[i] = inside ? 1 : 0;
+                visibleCount += inside ? 1 : 0;
+            }
+            return visibleCount;
+        }
+
+#if defined(CIRCE_CULL_X86)
+        // Both wide paths cull whole groups from 0 and advance i past the last one
+
+        CIRCE_TARGET_AVX size_t CullSpheresAVX(const glm::vec4* planes, const SphereArrays& spheres, uint8_t* visible, size_t& i, size_t count) {
+            size_t visibleCount = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256 x = _mm256_loadu_ps(spheres.X + i);
+                const __m256 y = _mm256_loadu_ps(spheres.Y + i);
+                const __m256 z = _mm256_loadu_ps(spheres.Z + i);
+                const __m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(spheres.Radius + i));
+
+                // Accumulate "fully outside some plane" so NaNs compare like the scalar path
+                __m256 outside = _mm256_setzero_ps();
+                for (int p = 0; p < Frustum::PlaneCount; ++p) {
+                    const glm::vec4& plane = planes[p];
+                    __m256 distance = _mm256_add_ps(
+                        _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(plane.x)), _mm256_mul_ps(y, _mm256_set1_ps(plane.y))),
+                        _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(plane.z)), _mm256_set1_ps(plane.w)));
+                    outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, negRadius, _CMP_LT_OQ));
+                }
+
+                const unsigned int mask = ~static_cast<unsigned int>(_mm256_movemask_ps(outside)) & 0xFFu;
+                for (int lane = 0; lane < 8; ++lane) {
+                    visible[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+                }
+                visibleCount += static_cast<size_t>(std::popcount(mask));
+            }
+            return visibleCount;
+        }
+
+        CIRCE_TARGET_SSE size_t CullSpheresSSE(const glm::vec4* planes, const SphereArrays& spheres, uint8_t* visible, size_t& i, size_t count) {
+            size_t visibleCount = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128 x = _mm_loadu_ps(spheres.X + i);
+                const __m128 y = _mm_loadu_ps(spheres.Y + i);
+                const __m128 z = _mm_loadu_ps(spheres.Z + i);
+                const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(spheres.Radius + i));
+
+                // Accumulate "fully outside some plane" so NaNs compare like the scalar path
+                __m128 outside = _mm_setzero_ps();
+                for (int p = 0; p < Frustum::PlaneCount; ++p) {
+                    const glm::vec4& plane = planes[p];
+                    __m128 distance = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)), _mm_mul_ps(y, _mm_set1_ps(plane.y))),
+                        _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+                    outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negRadius));
+                }
+
+                const unsigned int mask = ~static_cast<unsigned int>(_mm_movemask_ps(outside)) & 0xFu;
+                for (int lane = 0; lane < 4; ++lane) {
+                    visible[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+                }
+                visibleCount += static_cast<size_t>(std::popcount(mask));
+            }
+            return visibleCount;
+        }
+#endif
+
+    }
+
+    Frustum::Frustum(const glm::mat4& viewProjection) {
+        // glm is column-major, the rows of the matrix are m[0][r], m[1][r], ...
+        auto row = [&](int r) {
+            return glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+        };
+        const glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+        m_Planes[Left] = r3 + r0;
+        m_Planes[Right] = r3 - r0;
+        m_Planes[Bottom] = r3 + r1;
+        m_Planes[Top] = r3 - r1;
+        m_Planes[Near] = r3 + r2;
+        m_Planes[Far] = r3 - r2;
+
+        for (glm::vec4& plane : m_Planes) {
+            const float length = glm::length(glm::vec3(plane));
+            if (length > 0.0f) {
+                plane = plane / length;
+            }
+        }
+    }
+
+    bool Frustum::Intersects(const BoundingSphere& sphere) const {
+        for (const glm::vec4& plane : m_Planes) {
+            if (glm::dot(glm::vec3(plane), sphere.Center) + plane.w < -sphere.Radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Frustum::Intersects(const AABB& box) const {
+        const glm::vec3 center = box.GetCenter();
+        const glm::vec3 extents = box.GetExtents();
+        for (const glm::vec4& plane : m_Planes) {
+            const glm::vec3 normal = glm::vec3(plane);
+            const float radius = glm::dot(extents, glm::abs(normal));
+            if (glm::dot(normal, center) + plane.w < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t Frustum::CullSpheres(const PackedSpheres& spheres, uint8_t* visible) const {
+        const size_t count = spheres.Size();
+        const SphereArrays arrays{ spheres.X.data(), spheres.Y.data(), spheres.Z.data(), spheres.Radius.data() };
+        size_t visibleCount = 0;
+        size_t i = 0;
+
+#if defined(CIRCE_CULL_X86)
+        // Follows the BatchMath level, so BatchMath::SetLevel also selects the cull path
+        const BatchMath::SimdLevel level = BatchMath::GetLevel();
+        if (level >= BatchMath::SimdLevel::AVX2) {
+            visibleCount += CullSpheresAVX(m_Planes, arrays, visible, i, count);
+        } else if (level >= BatchMath::SimdLevel::SSE41) {
+            visibleCount += CullSpheresSSE(m_Planes, arrays, visible, i, count);
+        }
+#endif
+
+        // Scalar tail, and the whole batch at the scalar level or off x86
+        return visibleCount + CullSpheresScalar(m_Planes, arrays, visible, i, count);
+    }
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Bounds.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Circe {
+
+    // Bounding spheres in SoA layout so the cull test can run several at a time
+    struct PackedSpheres {
+        std::vector<float> X;
+        std::vector<float> Y;
+        std::vector<float> Z;
+        std::vector<float> Radius;
+
+        size_t Size() const { return X.size(); }
+        void Clear() { X.clear(); Y.clear(); Z.clear(); Radius.clear(); }
+        void Reserve(size_t count) { X.reserve(count); Y.reserve(count); Z.reserve(count); Radius.reserve(count); }
+        void Resize(size_t count) { X.resize(count); Y.resize(count); Z.resize(count); Radius.resize(count); }
+        void Push(const BoundingSphere& sphere) {
+            X.push_back(sphere.Center.x);
+            Y.push_back(sphere.Center.y);
+            Z.push_back(sphere.Center.z);
+            Radius.push_back(sphere.Radius);
+        }
+        void Set(size_t index, const BoundingSphere& sphere) {
+            X[index] = sphere.Center.x;
+            Y[index] = sphere.Center.y;
+            Z[index] = sphere.Center.z;
+            Radius[index] = sphere.Radius;
+        }
+    };
+
+    class Frustum {
+    public:
+        enum Plane { Left = 0, Right, Bottom, Top, Near, Far, PlaneCount };
+
+        Frustum() = default;
+        // Gribb/Hartmann plane extraction, planes point inwards and are normalized
+        explicit Frustum(const glm::mat4& viewProjection);
+
+        const glm::vec4& GetPlane(int index) const { return m_Planes[index]; }
+
+        bool Intersects(const BoundingSphere& sphere) const;
+        bool Intersects(const AABB& box) const;
+
+        // Writes 1 to visible[i] when sphere i touches the frustum, 0 otherwise. Returns the visible count.
+        // Runs 8 (AVX), 4 (SSE) or 1 sphere per step following BatchMath::GetLevel().
+        size_t CullSpheres(const PackedSpheres& spheres, uint8_t* visible) const;
+
+    private:
+        glm::vec4 m_Planes[PlaneCount];
+    };
+
+}
@@ -15,11 +15,24 @@ namespace Circe {
         glm::quat Rotation;
         glm::vec3 Scale;
 
+        // translate * rotate * scale, composed directly from the quaternion
         glm::mat4 GetModelMatrix() const {
-            glm::mat4 translation = glm::translate(glm::mat4(1.0f), Position);
-            glm::mat4 rotation = glm::mat4_cast(Rotation);
-            glm::mat4 scale = glm::scale(glm::mat4(1.0f), Scale);
-            return translation * rotation * scale;
+            const float x = Rotation.x, y = Rotation.y, z = Rotation.z, w = Rotation.w;
+            const float xx = x * x, yy = y * y, zz = z * z;
+            const float xy = x * y, xz = x * z, yz = y * z;
+            const float wx = w * x, wy = w * y, wz = w * z;
+
+            return glm::mat4(
+                glm::vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f) * Scale.x,
+                glm::vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f) * Scale.y,
+                glm::vec4(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f) * Scale.z,
+                glm::vec4(Position, 1.0f));
+        }
+
+        bool IsIdentity() const {
+            return Position == glm::vec3(0.0f)
+                && Rotation == glm::quat(1.0f, 0.0f, 0.0f, 0.0f)
+                && Scale == glm::vec3(1.0f);
         }
 
         glm::vec3 Forward() const {
@@ -0,0 +1,87 @@
+#include "Framebuffer.h"
+#include <glad/glad.h>
+#include <stdexcept>
+
+namespace Circe {
+
+    Framebuffer::Framebuffer(int width, int height)
+        : m_Width(width), m_Height(height) {
+        Create();
+    }
+
+    Framebuffer::~Framebuffer() {
+        Release();
+    }
+
+    void Framebuffer::Create() {
+        glGenFramebuffers(1, &m_ID);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_ID);
+
+        glGenTextures(1, &m_ColorAttachment);
+        glBindTexture(GL_TEXTURE_2D, m_ColorAttachment);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ColorAttachment, 0);
+
+        glGenRenderbuffers(1, &m_DepthAttachment);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachment);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Width, m_Height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthAttachment);
+
+        const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            Release();
+            throw std::runtime_error("Framebuffer is incomplete");
+        }
+    }
+
+    void Framebuffer::Release() {
+        if (m_DepthAttachment) {
+            glDeleteRenderbuffers(1, &m_DepthAttachment);
+            m_DepthAttachment = 0;
+        }
+        if (m_ColorAttachment) {
+            glDeleteTextures(1, &m_ColorAttachment);
+            m_ColorAttachment = 0;
+        }
+        if (m_ID) {
+            glDeleteFramebuffers(1, &m_ID);
+            m_ID = 0;
+        }
+    }
+
+    void Framebuffer::Bind() const {
+        glBindFramebuffer(GL_FRAMEBUFFER, m_ID);
+        glViewport(0, 0, m_Width, m_Height);
+    }
+
+    void Framebuffer::Unbind() const {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    void Framebuffer::Resize(int width, int height) {
+        if (width == m_Width && height == m_Height) {
+            return;
+        }
+        Release();
+        m_Width = width;
+        m_Height = height;
+        Create();
+    }
+
+    void Framebuffer::ReadPixels(std::vector<uint8_t>& pixels) const {
+        pixels.resize(static_cast<size_t>(m_Width) * m_Height * 4);
+
+        GLint previous = 0;
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_ID);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(previous));
+    }
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Circe {
+
+    // Offscreen RGBA8 color + 24/8 depth-stencil render target
+    class Framebuffer {
+    public:
+        Framebuffer(int width, int height);
+        ~Framebuffer();
+
+        Framebuffer(const Framebuffer&) = delete;
+        Framebuffer& operator=(const Framebuffer&) = delete;
+
+        void Bind() const;
+        void Unbind() const;
+        void Resize(int width, int height);
+
+        // Tightly packed RGBA8 rows, bottom row first (GL convention)
+        void ReadPixels(std::vector<uint8_t>& pixels) const;
+
+        unsigned int GetID() const { return m_ID; }
+        unsigned int GetColorAttachment() const { return m_ColorAttachment; }
+        int GetWidth() const { return m_Width; }
+        int GetHeight() const { return m_Height; }
+
+    private:
+        void Create();
+        void Release();
+
+        unsigned int m_ID = 0;
+        unsigned int m_ColorAttachment = 0;
+        unsigned int m_DepthAttachment = 0;
+        int m_Width = 0;
+        int m_Height = 0;
+    };
+
+}
@@ -0,0 +1,292 @@
+#include "Ktx2.h"
+#include "../Core/MappedFile.h"
+#include "../Core/Profiling/Profiler.h"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace Circe {
+
+    static_assert(std::endian::native == std::endian::little, "KTX2 headers are read and written in place");
+
+    namespace {
+
+        constexpr unsigned char Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+        struct Header {
+            unsigned char Identifier[12];
+            uint32_t VkFormat;
+            uint32_t TypeSize;
+            uint32_t PixelWidth;
+            uint32_t PixelHeight;
+            uint32_t PixelDepth;
+            uint32_t LayerCount;
+            uint32_t FaceCount;
+            uint32_t LevelCount;
+            uint32_t SupercompressionScheme;
+            uint32_t DfdByteOffset;
+            uint32_t DfdByteLength;
+            uint32_t KvdByteOffset;
+            uint32_t KvdByteLength;
+            uint64_t SgdByteOffset;
+            uint64_t SgdByteLength;
+        };
+
+        struct LevelIndex {
+            uint64_t ByteOffset;
+            uint64_t ByteLength;
+            uint64_t UncompressedByteLength;
+        };
+
+        static_assert(sizeof(Header) == 80 && sizeof(LevelIndex) == 24);
+
+        struct FormatInfo {
+            TextureFormat Format;
+            bool SRGB;
+            uint32_t VkFormat;
+            // Khronos data format color model
+            uint32_t ColorModel;
+        };
+
+        // VK_FORMAT_R8G8B8A8_*, BC1_RGBA_*, BC3_*, BC5_UNORM, BC7_*
+        constexpr FormatInfo Formats[] = {
+            { TextureFormat::RGBA8, false, 37, 1 },
+            { TextureFormat::RGBA8, true, 43, 1 },
+            { TextureFormat::BC1, false, 133, 128 },
+            { TextureFormat::BC1, true, 134, 128 },
+            { TextureFormat::BC3, false, 137, 130 },
+            { TextureFormat::BC3, true, 138, 130 },
+            { TextureFormat::BC5, false, 141, 132 },
+            { TextureFormat::BC7, false, 145, 134 },
+            { TextureFormat::BC7, true, 146, 134 },
+        };
+
+        const FormatInfo* FindFormat(TextureFormat format, bool srgb) {
+            // BC5 has no sRGB flavor, its two channels are never color
+            if (format == TextureFormat::BC5) {
+                srgb = false;
+            }
+            for (const FormatInfo& info : Formats) {
+                if (info.Format == format && info.SRGB == srgb) {
+                    return &info;
+                }
+            }
+            return nullptr;
+        }
+
+        const FormatInfo* FindFormat(uint32_t vkFormat) {
+            for (const FormatInfo& info : Formats) {
+                if (info.VkFormat == vkFormat) {
+                    return &info;
+                }
+            }
+            return nullptr;
+        }
+
+        // Level data offsets are multiples of lcm(texel block size, 4)
+        uint64_t GetLevelAlignment(TextureFormat format) {
+            return std::max<uint64_t>(4, TextureCompression::GetBlockSize(format));
+        }
+
+        uint64_t Align(uint64_t offset, uint64_t alignment) {
+            return (offset + alignment - 1) / alignment * alignment;
+        }
+
+        // Basic data format descriptor block, as the Khronos dfd utilities emit it
+        std::vector<uint32_t> BuildDescriptor(const FormatInfo& info) {
+            struct Sample {
+                uint32_t BitOffset;
+                uint32_t BitLength;
+                uint32_t Channel;
+                uint32_t Upper;
+            };
+            constexpr uint32_t Full = std::numeric_limits<uint32_t>::max();
+            // Channel ids: RGBSDA red 0, green 1, blue 2, alpha 15; BC1A color 0 / alpha-present 1;
+            // BC3 color 0 / alpha 15; BC5 red 0 / green 1; BC7 color 0. 0x10 marks linear alpha.
+            std::vector<Sample> samples;
+            switch (info.Format) {
+                case TextureFormat::RGBA8:
+                    samples = { { 0, 8, 0, 255 }, { 8, 8, 1, 255 }, { 16, 8, 2, 255 }, { 24, 8, info.SRGB ? 0x1Fu : 15u, 255 } };
+                    break;
+                case TextureFormat::BC1: samples = { { 0, 64, 1, Full } }; break;
+                case TextureFormat::BC3: samples = { { 0, 64, 15, Full }, { 64, 64, 0, Full } }; break;
+                case TextureFormat::BC5: samples = { { 0, 64, 0, Full }, { 64, 64, 1, Full } }; break;
+                case TextureFormat::BC7: samples = { { 0, 128, 0, Full } }; break;
+            }
+
+            const bool compressed = TextureCompression::IsCompressed(info.Format);
+            const uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+            std::vector<uint32_t> words = {
+                4 + blockSize,
+                0,
+                2u | (blockSize << 16),
+                // BT.709 primaries, sRGB or linear transfer, straight alpha
+                info.ColorModel | (1u << 8) | ((info.SRGB ? 2u : 1u) << 16),
+                compressed ? (3u | (3u << 8)) : 0u,
+                static_cast<uint32_t>(TextureCompression::GetBlockSize(info.Format)),
+                0
+            };
+            for (const Sample& sample : samples) {
+                words.push_back(sample.BitOffset | ((sample.BitLength - 1) << 16) | (sample.Channel << 24));
+                words.push_back(0);
+                words.push_back(0);
+                words.push_back(sample.Upper);
+            }
+            return words;
+        }
+
+        std::vector<unsigned char> BuildKeyValueData() {
+            const std::string key = "KTXwriter";
+            const std::string value = "Circe TextureCooker";
+            const uint32_t length = static_cast<uint32_t>(key.size() + value.size() + 2);
+            std::vector<unsigned char> data(4);
+            std::memcpy(data.data(), &length, 4);
+            data.insert(data.end(), key.begin(), key.end());
+            data.push_back(0);
+            data.insert(data.end(), value.begin(), value.end());
+            data.push_back(0);
+            data.resize(Align(data.size(), 4), 0);
+            return data;
+        }
+
+    }
+
+    void Ktx2::Write(const TextureImage& image, const std::string& path) {
+        CIRCE_PROFILE_SCOPE("Ktx2::Write");
+
+        const FormatInfo* info = FindFormat(image.Format, image.SRGB);
+        if (!info || image.Levels.empty()) {
+            throw std::runtime_error("Cannot write KTX2 texture without levels: " + path);
+        }
+        const std::vector<uint32_t> descriptor = BuildDescriptor(*info);
+        const std::vector<unsigned char> keyValues = BuildKeyValueData();
+        const size_t levelCount = image.Levels.size();
+
+        Header header{};
+        std::memcpy(header.Identifier, Identifier, sizeof(Identifier));
+        header.VkFormat = info->VkFormat;
+        header.TypeSize = 1;
+        header.PixelWidth = static_cast<uint32_t>(image.Width);
+        header.PixelHeight = static_cast<uint32_t>(image.Height);
+        header.FaceCount = 1;
+        header.LevelCount = static_cast<uint32_t>(levelCount);
+        header.DfdByteOffset = static_cast<uint32_t>(sizeof(Header) + levelCount * sizeof(LevelIndex));
+        header.DfdByteLength = static_cast<uint32_t>(descriptor.size() * sizeof(uint32_t));
+        header.KvdByteOffset = header.DfdByteOffset + header.DfdByteLength;
+        header.KvdByteLength = static_cast<uint32_t>(keyValues.size());
+
+        // Level data goes smallest first, the index stays in level order
+        const uint64_t alignment = GetLevelAlignment(image.Format);
+        std::vector<LevelIndex> levels(levelCount);
+        uint64_t offset = header.KvdByteOffset + header.KvdByteLength;
+        for (size_t i = levelCount; i-- > 0;) {
+            offset = Align(offset, alignment);
+            levels[i] = { offset, image.Levels[i].Size, image.Levels[i].Size };
+            offset += image.Levels[i].Size;
+        }
+
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                throw std::runtime_error("Failed to create KTX2 texture: " + path);
+            }
+
+            uint64_t position = 0;
+            auto write = [&](const void* data, uint64_t size) {
+                file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+                position += size;
+            };
+            write(&header, sizeof(header));
+            write(levels.data(), levels.size() * sizeof(LevelIndex));
+            write(descriptor.data(), header.DfdByteLength);
+            write(keyValues.data(), keyValues.size());
+            for (size_t i = levelCount; i-- > 0;) {
+                static const char zeros[16] = {};
+                write(zeros, levels[i].ByteOffset - position);
+                write(image.GetLevelData(i), levels[i].ByteLength);
+            }
+
+            if (!file.good()) {
+                file.close();
+                std::filesystem::remove(temporary);
+                throw std::runtime_error("Failed to write KTX2 texture: " + path);
+            }
+        }
+        std::filesystem::rename(temporary, path);
+    }
+
+    TextureImage Ktx2::Read(const std::string& path) {
+        CIRCE_PROFILE_SCOPE("Ktx2::Read");
+
+        MappedFile file;
+        file.Open(path);
+        const unsigned char* base = file.GetData();
+        const uint64_t size = file.GetSize();
+        auto fail = [&](const char* reason) {
+            throw std::runtime_error(std::string("Invalid KTX2 texture (") + reason + "): " + path);
+        };
+
+        if (size < sizeof(Header)) {
+            fail("truncated header");
+        }
+        Header header;
+        std::memcpy(&header, base, sizeof(header));
+        if (std::memcmp(header.Identifier, Identifier, sizeof(Identifier)) != 0) {
+            fail("bad identifier");
+        }
+        const FormatInfo* info = FindFormat(header.VkFormat);
+        if (!info) {
+            fail("unsupported format");
+        }
+        if (header.PixelWidth == 0 || header.PixelHeight == 0 || header.PixelWidth > 65536 || header.PixelHeight > 65536 || header.PixelDepth != 0 ||
+            header.LayerCount > 1 || header.FaceCount != 1) {
+            fail("not a single 2D image");
+        }
+        if (header.SupercompressionScheme != 0) {
+            fail("supercompressed");
+        }
+
+        const int width = static_cast<int>(header.PixelWidth);
+        const int height = static_cast<int>(header.PixelHeight);
+        // 0 asks the loader to generate mips; the stored level is all there is
+        const uint32_t levelCount = std::max(1u, header.LevelCount);
+        if (levelCount > static_cast<uint32_t>(TextureCompression::GetMipCount(width, height)) ||
+            sizeof(Header) + static_cast<uint64_t>(levelCount) * sizeof(LevelIndex) > size) {
+            fail("level index out of range");
+        }
+
+        std::vector<LevelIndex> levels(levelCount);
+        std::memcpy(levels.data(), base + sizeof(Header), levelCount * sizeof(LevelIndex));
+
+        TextureImage image;
+        image.Format = info->Format;
+        image.SRGB = info->SRGB;
+        image.Width = width;
+        image.Height = height;
+        for (uint32_t i = 0; i < levelCount; i++) {
+            const int levelWidth = std::max(1, width >> i);
+            const int levelHeight = std::max(1, height >> i);
+            const uint64_t expected = TextureCompression::GetLevelSize(info->Format, levelWidth, levelHeight);
+            if (levels[i].ByteLength != expected || levels[i].ByteOffset > size || expected > size - levels[i].ByteOffset) {
+                fail("level out of range");
+            }
+            image.Levels.push_back({ levelWidth, levelHeight, image.Data.size(), static_cast<size_t>(expected) });
+            image.Data.insert(image.Data.end(), base + levels[i].ByteOffset, base + levels[i].ByteOffset + expected);
+        }
+        return image;
+    }
+
+    bool Ktx2::IsKtx2Path(const std::string& path) {
+        std::string extension = std::filesystem::path(path).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension == ".ktx2";
+    }
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include "TextureCompression.h"
+
+namespace Circe {
+
+    // KTX 2.0 container for cooked textures: one 2D image with its mip chain, no
+    // supercompression. Covers the formats of TextureFormat in UNORM and sRGB flavors.
+    class Ktx2 {
+    public:
+        // Writes to a temporary and renames. Throws std::runtime_error on IO failure.
+        static void Write(const TextureImage& image, const std::string& path);
+
+        // Validates the header and level index and copies the levels out, level 0 first.
+        // Throws std::runtime_error on a malformed file or a format outside TextureFormat.
+        static TextureImage Read(const std::string& path);
+
+        static bool IsKtx2Path(const std::string& path);
+    };
+
+}
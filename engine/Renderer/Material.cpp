@@ -1,37 +1,243 @@
 #include "Material.h"
-#include "Shader.h"
 #include "Texture.h"
+#include "RenderState.h"
+#include "ShaderLibrary.h"
+#include "UniformBuffer.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
 
 namespace Circe {
 
+    static std::atomic<uint32_t> s_NextSortID{ 1 };
+
     Material::Material(std::shared_ptr<Shader> shader)
-        : m_Shader(shader) {
+        : m_Shader(shader), m_SortID(s_NextSortID.fetch_add(1, std::memory_order_relaxed)) {
+        SetColor(m_Color);
+    }
+
+    Material::Material(std::shared_ptr<ShaderVariantSet> variants, uint32_t features)
+        : m_Variants(std::move(variants)), m_SortID(s_NextSortID.fetch_add(1, std::memory_order_relaxed)) {
+        SetFeatures(features);
+        SetColor(m_Color);
     }
 
     Material::~Material() {
+        MaterialBlockPool::Free(m_BlockSlot);
+    }
+
+    void Material::Bind() {
+        if (!m_Shader) {
+            return;
+        }
+
+        if (m_ShaderRevision != m_Shader->GetRevision()) {
+            ResolveBindings();
+        }
+        m_Shader->Use();
+        if (PrepareBlock()) {
+            glBindBufferRange(GL_UNIFORM_BUFFER, UniformBinding::Material, m_BlockSlot.Buffer, m_BlockSlot.Offset, m_BlockSlot.Size);
+        } else {
+            for (const ParameterValue& parameter : m_Parameters) {
+                if (parameter.components == 1) {
+                    m_Shader->SetFloat(parameter.uniform, parameter.value.x);
+                } else {
+                    m_Shader->SetVec4(parameter.uniform, parameter.value);
+                }
+            }
+        }
+
+        for (const TextureBinding& binding : m_Textures) {
+            if (binding.unit >= 0 && binding.texture) {
+                binding.texture->Bind(binding.unit);
+            }
+        }
+    }
+
+    void Material::Bind(RenderState& state) {
+        if (!m_Shader) {
+            return;
+        }
+
+        if (m_ShaderRevision != m_Shader->GetRevision()) {
+            ResolveBindings();
+        }
+        state.UseProgram(m_Shader->GetID());
+        if (PrepareBlock()) {
+            state.BindUniformRange(UniformBinding::Material, m_BlockSlot.Buffer, m_BlockSlot.Offset, m_BlockSlot.Size);
+        } else {
+            // Plain uniforms are program state shared by every material using the program
+            for (const ParameterValue& parameter : m_Parameters) {
+                if (parameter.components == 1) {
+                    m_Shader->SetFloat(parameter.uniform, parameter.value.x);
+                } else {
+                    m_Shader->SetVec4(parameter.uniform, parameter.value);
+                }
+            }
+        }
+
+        for (const TextureBinding& binding : m_Textures) {
+            if (binding.unit >= 0 && binding.texture) {
+                state.BindTexture(binding.unit, binding.texture->GetID());
+            }
+        }
     }
 
-    void Material::Bind() const {
-        if (m_Shader) {
-            m_Shader->Use();
-            m_Shader->SetVec4("color", m_Color);
+    bool Material::PrepareBlock() {
+        if (!m_BlockSlot.IsValid()) {
+            return false;
         }
 
-        // Bind textures
-        int textureUnit = 0;
-        for (const auto& [name, texture] : m_Textures) {
-            if (texture) {
-                texture->Bind(textureUnit);
-                if (m_Shader) {
-                    m_Shader->SetInt(name.c_str(), textureUnit);
+        // Handles change when a bindless texture is re-uploaded (streaming, hot reload)
+        if (m_Bindless) {
+            for (TextureBinding& binding : m_Textures) {
+                if (binding.handleOffset < 0 || !binding.texture) {
+                    continue;
+                }
+                const uint64_t handle = binding.texture->GetBindlessHandle();
+                if (handle != binding.handle) {
+                    std::memcpy(m_BlockData.data() + binding.handleOffset, &handle, sizeof(handle));
+                    binding.handle = handle;
+                    m_BlockDirty = true;
                 }
-                textureUnit++;
             }
         }
+
+        if (m_BlockDirty) {
+            MaterialBlockPool::Upload(m_BlockSlot, m_BlockData.data());
+            m_BlockDirty = false;
+        }
+        return true;
     }
 
     void Material::SetTexture(const std::string& name, std::shared_ptr<Texture> texture) {
-        m_Textures[name] = texture;
+        auto it = std::find_if(m_Textures.begin(), m_Textures.end(), [&](const TextureBinding& binding) { return binding.name == name; });
+        if (it == m_Textures.end()) {
+            m_Textures.push_back({ name });
+            it = m_Textures.end() - 1;
+        }
+        it->texture = texture;
+
+        if (m_Variants) {
+            std::string feature = "HAS_";
+            for (char c : name) {
+                feature += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            }
+            const uint32_t bit = m_Variants->GetFeatureMask(feature);
+            const uint32_t features = texture ? m_Features | bit : m_Features & ~bit;
+            if (m_Variants->GetCanonicalMask(features) != m_Features) {
+                // Resolves every slot against the new permutation
+                SetFeatures(features);
+                return;
+            }
+        }
+
+        // Only this slot needs resolving; the handle is written at the next bind
+        it->unit = m_Shader ? m_Shader->GetTextureUnit(name) : -1;
+        it->handleOffset = -1;
+        it->handle = 0;
+        if (m_Bindless) {
+            const MaterialParameter* slot = m_Shader->GetMaterialBlock().Find(name);
+            it->handleOffset = slot ? static_cast<int>(slot->Offset) : -1;
+        }
+    }
+
+    void Material::SetColor(const glm::vec4& color) {
+        m_Color = color;
+        SetParameter("color", color, 4);
+    }
+
+    void Material::SetFloat(const std::string& name, float value) {
+        SetParameter(name, glm::vec4(value, 0.0f, 0.0f, 0.0f), 1);
+    }
+
+    void Material::SetVec4(const std::string& name, const glm::vec4& value) {
+        SetParameter(name, value, 4);
+    }
+
+    void Material::SetParameter(const std::string& name, const glm::vec4& value, int components) {
+        auto it = std::find_if(m_Parameters.begin(), m_Parameters.end(), [&](const ParameterValue& parameter) { return parameter.name == name; });
+        if (it == m_Parameters.end()) {
+            m_Parameters.push_back({ name, value, components, m_Shader ? m_Shader->GetUniform(name) : UniformHandle{} });
+            it = m_Parameters.end() - 1;
+        }
+        it->value = value;
+        it->components = components;
+        if (m_ShaderRevision != (m_Shader ? m_Shader->GetRevision() : 0) || (m_Shader && !m_BlockSlot.IsValid() && m_Shader->HasMaterialBlock())) {
+            ResolveBindings();
+            return;
+        }
+        WriteParameter(*it);
+    }
+
+    void Material::WriteParameter(const ParameterValue& parameter) {
+        if (!m_BlockSlot.IsValid()) {
+            return;
+        }
+        const MaterialParameter* member = m_Shader->GetMaterialBlock().Find(parameter.name);
+        const size_t size = sizeof(float) * parameter.components;
+        if (!member || member->Offset + size > m_BlockData.size()) {
+            return;
+        }
+        std::memcpy(m_BlockData.data() + member->Offset, &parameter.value.x, size);
+        m_BlockDirty = true;
+    }
+
+    void Material::SetFeatures(uint32_t features) {
+        if (!m_Variants) {
+            return;
+        }
+        features = m_Variants->GetCanonicalMask(features);
+        if (m_Shader && features == m_Features) {
+            return;
+        }
+        m_Features = features;
+        m_Shader = m_Variants->Get(features);
+        ResolveBindings();
+    }
+
+    void Material::ResolveBindings() {
+        // Layouts and units differ between permutations and between revisions of a reloaded program
+        m_ShaderRevision = m_Shader ? m_Shader->GetRevision() : 0;
+        const bool hasBlock = m_Shader && m_Shader->HasMaterialBlock();
+        const MaterialBlockLayout* layout = hasBlock ? &m_Shader->GetMaterialBlock() : nullptr;
+
+        if (hasBlock) {
+            if (m_BlockSlot.Size != layout->Size) {
+                MaterialBlockPool::Free(m_BlockSlot);
+                m_BlockSlot = MaterialBlockPool::Allocate(layout->Size);
+            }
+            m_BlockData.assign(layout->Size, 0);
+            m_BlockDirty = true;
+        } else {
+            MaterialBlockPool::Free(m_BlockSlot);
+            m_BlockSlot = {};
+            m_BlockData.clear();
+        }
+
+        m_Bindless = false;
+        for (TextureBinding& binding : m_Textures) {
+            binding.unit = m_Shader ? m_Shader->GetTextureUnit(binding.name) : -1;
+            binding.handleOffset = -1;
+            binding.handle = 0;
+            const MaterialParameter* slot = layout ? layout->Find(binding.name) : nullptr;
+            if (slot && binding.unit < 0) {
+                binding.handleOffset = static_cast<int>(slot->Offset);
+                m_Bindless = true;
+            }
+        }
+        // A bindless program may get its first texture later
+        if (layout && !m_Bindless) {
+            m_Bindless = std::any_of(layout->Parameters.begin(), layout->Parameters.end(),
+                [](const MaterialParameter& parameter) { return parameter.Type == GL_SAMPLER_2D; });
+        }
+
+        for (ParameterValue& parameter : m_Parameters) {
+            parameter.uniform = hasBlock || !m_Shader ? UniformHandle{} : m_Shader->GetUniform(parameter.name);
+            WriteParameter(parameter);
+        }
     }
 
 }
@@ -1,30 +1,100 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
-#include <map>
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
+#include "Shader.h"
+#include "MaterialBlockPool.h"
+#include "ResourcePool.h"
 
 namespace Circe {
 
-    class Shader;
     class Texture;
+    class RenderState;
+    class ShaderVariantSet;
 
-    class Material {
+    // Parameters live in a pre-laid-out block matching the program's "Material" uniform block,
+    // uploaded only when a value changes and bound with a single range bind. Textures form a
+    // slot table resolved against the program once, so binding touches no names or uniforms.
+    // Programs without the block fall back to plain uniforms, resolved once as well.
+    class Material : public PooledResource<Material> {
     public:
         Material(std::shared_ptr<Shader> shader);
+        // Shader picked from the set by feature bitmask, see SetFeatures()
+        Material(std::shared_ptr<ShaderVariantSet> variants, uint32_t features = 0);
         ~Material();
 
-        void Bind() const;
+        Material(const Material&) = delete;
+        Material& operator=(const Material&) = delete;
+
+        void Bind();
+        // Binds through the renderer's state tracker so redundant GL binds are skipped
+        void Bind(RenderState& state);
         void SetTexture(const std::string& name, std::shared_ptr<Texture> texture);
-        void SetColor(const glm::vec4& color) { m_Color = color; }
+        void SetColor(const glm::vec4& color);
         glm::vec4 GetColor() const { return m_Color; }
-        std::shared_ptr<Shader> GetShader() const { return m_Shader; }
+        // Named members of the Material block, or plain uniforms for programs without one
+        void SetFloat(const std::string& name, float value);
+        void SetVec4(const std::string& name, const glm::vec4& value);
+        const std::shared_ptr<Shader>& GetShader() const { return m_Shader; }
+
+        // Switches to the permutation for the mask; no-op for materials built from a plain shader.
+        // SetTexture("albedo", ...) also sets the set's HAS_ALBEDO feature when it declares one.
+        void SetFeatures(uint32_t features);
+        uint32_t GetFeatures() const { return m_Features; }
+        const std::shared_ptr<ShaderVariantSet>& GetVariants() const { return m_Variants; }
+
+        bool UsesParameterBlock() const { return m_BlockSlot.IsValid(); }
+        // Textures reach the program as ARB_bindless_texture handles inside the block
+        bool UsesBindlessTextures() const { return m_Bindless; }
+
+        bool IsTransparent() const { return m_Color.a < 1.0f; }
+        // Small per-material id used by the renderer's sort key
+        uint32_t GetSortID() const { return m_SortID; }
 
     private:
+        struct TextureBinding {
+            std::string name;
+            std::shared_ptr<Texture> texture;
+            // Unit fixed by the program at link time, -1 when it has no such sampler
+            int unit = -1;
+            // Handle slot in the block for bindless programs, -1 otherwise
+            int handleOffset = -1;
+            uint64_t handle = 0;
+        };
+
+        struct ParameterValue {
+            std::string name;
+            glm::vec4 value;
+            int components = 4;
+            // Plain uniform for programs without the block
+            UniformHandle uniform;
+        };
+
+        void SetParameter(const std::string& name, const glm::vec4& value, int components);
+        void WriteParameter(const ParameterValue& parameter);
+        // Lays the block out for the current program and resolves every slot and uniform again;
+        // Bind() does this after a hot reload changed the program
+        void ResolveBindings();
+        // Uploads the block when dirty (bindless handles first), false when there is no block
+        bool PrepareBlock();
+
         std::shared_ptr<Shader> m_Shader;
-        std::map<std::string, std::shared_ptr<Texture>> m_Textures;
+        std::shared_ptr<ShaderVariantSet> m_Variants;
+        uint32_t m_Features = 0;
+        uint32_t m_ShaderRevision = 0;
+
+        std::vector<TextureBinding> m_Textures;
+        std::vector<ParameterValue> m_Parameters;
+        std::vector<unsigned char> m_BlockData;
+        MaterialBlockSlot m_BlockSlot;
+        bool m_BlockDirty = false;
+        bool m_Bindless = false;
+
         glm::vec4 m_Color = glm::vec4(1.0f);
+        uint32_t m_SortID = 0;
     };
 
 }
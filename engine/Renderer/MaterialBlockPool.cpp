@@ -0,0 +1,113 @@
+#include "MaterialBlockPool.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Circe {
+
+    namespace {
+
+        struct Page {
+            GLuint Buffer = 0;
+            uint32_t Used = 0;
+        };
+
+        std::vector<Page> s_Pages;
+        // Freed slots by aligned size
+        std::unordered_map<uint32_t, std::vector<MaterialBlockSlot>> s_FreeSlots;
+        uint32_t s_Alignment = 0;
+        uint32_t s_LiveSlots = 0;
+        size_t s_BytesUsed = 0;
+        uint64_t s_Uploads = 0;
+
+        uint32_t GetAlignment() {
+            if (s_Alignment == 0) {
+                GLint alignment = 256;
+                glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+                s_Alignment = static_cast<uint32_t>(std::max(alignment, 16));
+            }
+            return s_Alignment;
+        }
+
+        bool OwnsBuffer(GLuint buffer) {
+            return std::any_of(s_Pages.begin(), s_Pages.end(), [buffer](const Page& page) { return page.Buffer == buffer; });
+        }
+
+    }
+
+    MaterialBlockSlot MaterialBlockPool::Allocate(uint32_t size) {
+        if (size == 0 || size > PageSize) {
+            throw std::runtime_error("Material block of " + std::to_string(size) + " bytes does not fit a pool page");
+        }
+        const uint32_t alignment = GetAlignment();
+        const uint32_t alignedSize = (size + alignment - 1) / alignment * alignment;
+
+        MaterialBlockSlot slot;
+        auto free = s_FreeSlots.find(alignedSize);
+        if (free != s_FreeSlots.end() && !free->second.empty()) {
+            slot = free->second.back();
+            free->second.pop_back();
+        } else {
+            if (s_Pages.empty() || s_Pages.back().Used + alignedSize > PageSize) {
+                Page page;
+                glGenBuffers(1, &page.Buffer);
+                glBindBuffer(GL_UNIFORM_BUFFER, page.Buffer);
+                glBufferData(GL_UNIFORM_BUFFER, PageSize, nullptr, GL_DYNAMIC_DRAW);
+                glBindBuffer(GL_UNIFORM_BUFFER, 0);
+                s_Pages.push_back(page);
+            }
+            Page& page = s_Pages.back();
+            slot = { page.Buffer, page.Used, alignedSize };
+            page.Used += alignedSize;
+        }
+
+        // Bind exactly the block, the padding stays with the slot for reuse
+        slot.Size = size;
+        s_LiveSlots++;
+        s_BytesUsed += alignedSize;
+        return slot;
+    }
+
+    void MaterialBlockPool::Free(const MaterialBlockSlot& slot) {
+        // Materials can outlive the pool at shutdown
+        if (!slot.IsValid() || !OwnsBuffer(slot.Buffer)) {
+            return;
+        }
+        const uint32_t alignment = GetAlignment();
+        const uint32_t alignedSize = (slot.Size + alignment - 1) / alignment * alignment;
+        s_FreeSlots[alignedSize].push_back(slot);
+        s_LiveSlots--;
+        s_BytesUsed -= alignedSize;
+    }
+
+    void MaterialBlockPool::Upload(const MaterialBlockSlot& slot, const void* data) {
+        glBindBuffer(GL_UNIFORM_BUFFER, slot.Buffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, slot.Offset, slot.Size, data);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        s_Uploads++;
+    }
+
+    void MaterialBlockPool::Shutdown() {
+        for (const Page& page : s_Pages) {
+            glDeleteBuffers(1, &page.Buffer);
+        }
+        s_Pages.clear();
+        s_FreeSlots.clear();
+        s_Alignment = 0;
+        s_LiveSlots = 0;
+        s_BytesUsed = 0;
+    }
+
+    MaterialBlockPoolStats MaterialBlockPool::GetStats() {
+        MaterialBlockPoolStats stats;
+        stats.Pages = static_cast<uint32_t>(s_Pages.size());
+        stats.Slots = s_LiveSlots;
+        stats.BytesUsed = s_BytesUsed;
+        stats.Uploads = s_Uploads;
+        return stats;
+    }
+
+}
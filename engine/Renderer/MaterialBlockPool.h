@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Circe {
+
+    // Region of a shared uniform buffer holding one material's parameter block
+    struct MaterialBlockSlot {
+        unsigned int Buffer = 0;
+        uint32_t Offset = 0;
+        uint32_t Size = 0;
+
+        bool IsValid() const { return Buffer != 0; }
+    };
+
+    struct MaterialBlockPoolStats {
+        uint32_t Pages = 0;
+        uint32_t Slots = 0;
+        size_t BytesUsed = 0;
+        // glBufferSubData calls, one per dirty material
+        uint64_t Uploads = 0;
+    };
+
+    // Sub-allocates material parameter blocks from a few large uniform buffers, so switching
+    // materials is one glBindBufferRange instead of a round of glUniform calls. Slots are
+    // aligned to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT and recycled by size. GL thread only.
+    class MaterialBlockPool {
+    public:
+        static constexpr uint32_t PageSize = 64 * 1024;
+
+        // size must not exceed PageSize
+        static MaterialBlockSlot Allocate(uint32_t size);
+        static void Free(const MaterialBlockSlot& slot);
+        static void Upload(const MaterialBlockSlot& slot, const void* data);
+
+        // Deletes every page; slots handed out before are dead afterwards
+        static void Shutdown();
+
+        static MaterialBlockPoolStats GetStats();
+    };
+
+}
@@ -1,43 +1,120 @@
 #include "Mesh.h"
+#include "VertexEncoding.h"
+#include "../Core/Profiling/Profiler.h"
 #include <glad/glad.h>
+#include <cmath>
 
 namespace Circe {
 
+    // VertexLayout::Standard() describes Vertex as is, so it can be uploaded without packing
+    static_assert(sizeof(Vertex) == 32 && offsetof(Vertex, normal) == 12 && offsetof(Vertex, texCoord) == 24);
+
     Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
-        : m_IndexCount(indices.size()) {
-        
+        : m_IndexCount(static_cast<unsigned int>(indices.size())) {
+        CIRCE_PROFILE_SCOPE("Mesh::Upload");
+        ComputeBounds(vertices.data(), vertices.size(), m_Bounds, m_BoundingSphere);
+        const void* streams[] = { vertices.data() };
+        Upload(VertexLayout::Standard(), streams, vertices.size(), indices.data(), indices.size());
+    }
+
+    Mesh::Mesh(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount)
+        : m_IndexCount(static_cast<unsigned int>(indexCount)) {
+        CIRCE_PROFILE_SCOPE("Mesh::Upload");
+        ComputeBounds(vertices, vertexCount, m_Bounds, m_BoundingSphere);
+        const void* streams[] = { vertices };
+        Upload(VertexLayout::Standard(), streams, vertexCount, indices, IndexFormat::UInt32, indexCount);
+    }
+
+    Mesh::Mesh(const Vertex* vertices, size_t vertexCount, const void* indices, IndexFormat indexFormat, size_t indexCount,
+        const AABB& bounds, const BoundingSphere& boundingSphere)
+        : m_IndexCount(static_cast<unsigned int>(indexCount)), m_Bounds(bounds), m_BoundingSphere(boundingSphere) {
+        CIRCE_PROFILE_SCOPE("Mesh::Upload");
+        const void* streams[] = { vertices };
+        Upload(VertexLayout::Standard(), streams, vertexCount, indices, indexFormat, indexCount);
+    }
+
+    Mesh::Mesh(const VertexSource& source, const unsigned int* indices, size_t indexCount, const VertexLayout& layout)
+        : m_IndexCount(static_cast<unsigned int>(indexCount)) {
+        CIRCE_PROFILE_SCOPE("Mesh::Upload");
+        ComputeBounds(source.Vertices, source.Count, m_Bounds, m_BoundingSphere);
+
+        const PackedVertices packed = VertexEncoding::Pack(source, layout);
+        const void* streams[VertexLayout::MaxStreams];
+        for (size_t stream = 0; stream < VertexLayout::MaxStreams; stream++) {
+            streams[stream] = packed.Streams[stream].data();
+        }
+        Upload(layout, streams, source.Count, indices, indexCount);
+    }
+
+    void Mesh::ComputeBounds(const Vertex* vertices, size_t vertexCount, AABB& bounds, BoundingSphere& boundingSphere) {
+        bounds = AABB();
+        boundingSphere = BoundingSphere();
+        for (size_t i = 0; i < vertexCount; i++) {
+            bounds.Expand(vertices[i].position);
+        }
+        if (bounds.IsValid()) {
+            boundingSphere.Center = bounds.GetCenter();
+            float radiusSquared = 0.0f;
+            for (size_t i = 0; i < vertexCount; i++) {
+                const glm::vec3 offset = vertices[i].position - boundingSphere.Center;
+                radiusSquared = glm::max(radiusSquared, glm::dot(offset, offset));
+            }
+            boundingSphere.Radius = std::sqrt(radiusSquared);
+        }
+    }
+
+    MeshMemoryStats Mesh::EstimateMemory(const VertexLayout& layout, size_t vertexCount, size_t indexCount) {
+        MeshMemoryStats stats;
+        stats.VertexBytes = layout.GetVertexSize() * vertexCount;
+        stats.IndexBytes = VertexLayout::GetIndexSize(VertexLayout::SelectIndexFormat(vertexCount)) * indexCount;
+        stats.StandardBytes = sizeof(Vertex) * vertexCount + sizeof(unsigned int) * indexCount;
+        return stats;
+    }
+
+    void Mesh::Upload(const VertexLayout& layout, const void* const* streams, size_t vertexCount,
+        const unsigned int* indices, size_t indexCount) {
+        if (VertexLayout::SelectIndexFormat(vertexCount) == IndexFormat::UInt16) {
+            std::vector<uint16_t> narrow(indexCount);
+            VertexEncoding::NarrowIndices(indices, narrow.data(), indexCount);
+            Upload(layout, streams, vertexCount, narrow.data(), IndexFormat::UInt16, indexCount);
+        } else {
+            Upload(layout, streams, vertexCount, indices, IndexFormat::UInt32, indexCount);
+        }
+    }
+
+    void Mesh::Upload(const VertexLayout& layout, const void* const* streams, size_t vertexCount,
+        const void* indices, IndexFormat indexFormat, size_t indexCount) {
+        m_Layout = layout;
+        m_VertexCount = vertexCount;
+        m_IndexFormat = indexFormat;
+        m_IndexType = m_IndexFormat == IndexFormat::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        m_MemoryStats = EstimateMemory(layout, vertexCount, indexCount);
+        m_MemoryStats.IndexBytes = VertexLayout::GetIndexSize(indexFormat) * indexCount;
+
         glGenVertexArrays(1, &m_VAO);
-        glGenBuffers(1, &m_VBO);
+        glGenBuffers(static_cast<GLsizei>(layout.GetStreamCount()), m_VertexBuffers.data());
         glGenBuffers(1, &m_EBO);
 
         glBindVertexArray(m_VAO);
 
-        // VBO
-        glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+        // One VBO per stream
+        for (size_t stream = 0; stream < layout.GetStreamCount(); stream++) {
+            glBindBuffer(GL_ARRAY_BUFFER, m_VertexBuffers[stream]);
+            glBufferData(GL_ARRAY_BUFFER, vertexCount * layout.GetStride(stream), streams[stream], GL_STATIC_DRAW);
+        }
 
         // EBO
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * VertexLayout::GetIndexSize(indexFormat), indices, GL_STATIC_DRAW);
 
         // Vertex attributes
-        // Position
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-
-        // Normal
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-
-        // TexCoord
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
+        layout.Apply(m_VertexBuffers.data());
 
         glBindVertexArray(0);
     }
 
     Mesh::~Mesh() {
-        glDeleteBuffers(1, &m_VBO);
+        glDeleteBuffers(static_cast<GLsizei>(m_Layout.GetStreamCount()), m_VertexBuffers.data());
         glDeleteBuffers(1, &m_EBO);
         glDeleteVertexArrays(1, &m_VAO);
     }
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <vector>
 #include <glm/glm.hpp>
+#include "Math/Bounds.h"
+#include "Renderer/ResourcePool.h"
+#include "Renderer/VertexLayout.h"
 
 namespace Circe {
 
@@ -11,20 +16,75 @@ namespace Circe {
         glm::vec2 texCoord;
     };
 
-    class Mesh {
+    struct VertexSource;
+
+    // GPU bytes of a mesh against the same data stored as Vertex + 32-bit indices
+    struct MeshMemoryStats {
+        size_t VertexBytes = 0;
+        size_t IndexBytes = 0;
+        size_t StandardBytes = 0;
+
+        size_t GetBytes() const { return VertexBytes + IndexBytes; }
+        size_t GetBytesSaved() const { return StandardBytes > GetBytes() ? StandardBytes - GetBytes() : 0; }
+    };
+
+    // Index buffers drop to 16 bits whenever the vertex count allows it. Indices uploaded
+    // straight from caller memory keep the format they are stored in.
+    class Mesh : public PooledResource<Mesh> {
     public:
         Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+        // Uploads straight from the given memory, no copies; the indices stay 32-bit
+        Mesh(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+        // Same, with indices already stored in indexFormat (e.g. a mapped cooked file) and
+        // bounds computed offline
+        Mesh(const Vertex* vertices, size_t vertexCount, const void* indices, IndexFormat indexFormat, size_t indexCount,
+            const AABB& bounds, const BoundingSphere& boundingSphere);
+        // Packs the source into the given layout (see VertexLayout::Compact)
+        Mesh(const VertexSource& source, const unsigned int* indices, size_t indexCount, const VertexLayout& layout);
         ~Mesh();
 
+        Mesh(const Mesh&) = delete;
+        Mesh& operator=(const Mesh&) = delete;
+
+        // Box from the extremes, sphere centered on the box enclosing every vertex
+        static void ComputeBounds(const Vertex* vertices, size_t vertexCount, AABB& bounds, BoundingSphere& boundingSphere);
+        static MeshMemoryStats EstimateMemory(const VertexLayout& layout, size_t vertexCount, size_t indexCount);
+
         void Bind() const;
         void Unbind() const;
         unsigned int GetIndexCount() const { return m_IndexCount; }
+        unsigned int GetVertexArray() const { return m_VAO; }
+        // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, for glDrawElements
+        unsigned int GetIndexType() const { return m_IndexType; }
+        IndexFormat GetIndexFormat() const { return m_IndexFormat; }
+        size_t GetVertexCount() const { return m_VertexCount; }
+        const VertexLayout& GetLayout() const { return m_Layout; }
+        const MeshMemoryStats& GetMemoryStats() const { return m_MemoryStats; }
+
+        // Object-space bounds computed from the vertex positions at construction
+        const AABB& GetBounds() const { return m_Bounds; }
+        const BoundingSphere& GetBoundingSphere() const { return m_BoundingSphere; }
 
     private:
+        // streams[i] holds vertexCount * layout.GetStride(i) bytes; the indices are uploaded as
+        // given in indexFormat
+        void Upload(const VertexLayout& layout, const void* const* streams, size_t vertexCount,
+            const void* indices, IndexFormat indexFormat, size_t indexCount);
+        // Narrows the indices to 16 bits first when the vertex count allows it
+        void Upload(const VertexLayout& layout, const void* const* streams, size_t vertexCount,
+            const unsigned int* indices, size_t indexCount);
+
         unsigned int m_VAO = 0;
-        unsigned int m_VBO = 0;
+        std::array<unsigned int, VertexLayout::MaxStreams> m_VertexBuffers{};
         unsigned int m_EBO = 0;
         unsigned int m_IndexCount = 0;
+        unsigned int m_IndexType = 0;
+        IndexFormat m_IndexFormat = IndexFormat::UInt32;
+        size_t m_VertexCount = 0;
+        VertexLayout m_Layout;
+        MeshMemoryStats m_MemoryStats;
+        AABB m_Bounds;
+        BoundingSphere m_BoundingSphere;
     };
 
 }
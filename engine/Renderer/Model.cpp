@@ -16,11 +16,24 @@ namespace Circe {
         return m_Transform.GetModelMatrix();
     }
 
+    AABB Model::GetWorldBounds(const glm::mat4& parentMatrix) const {
+        if (!m_Mesh) {
+            return AABB();
+        }
+        return m_Mesh->GetBounds().Transformed(parentMatrix * GetModelMatrix());
+    }
+
     void Model::Render(Renderer& renderer, const glm::mat4& parentMatrix) {
         if (!m_Mesh || !m_Material) {
             return;
         }
 
+        // Most models carry no local offset, skip the extra 4x4 product for them
+        if (m_Transform.IsIdentity()) {
+            renderer.SubmitMesh(m_Mesh, m_Material, parentMatrix);
+            return;
+        }
+
         glm::mat4 finalMatrix = parentMatrix * GetModelMatrix();
         renderer.SubmitMesh(m_Mesh, m_Material, finalMatrix);
     }
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include "Math/Transform.h"
+#include "Math/Bounds.h"
 
 namespace Circe {
 
@@ -26,6 +27,9 @@ namespace Circe {
 
         glm::mat4 GetModelMatrix() const;
 
+        // World-space box of the mesh under parentMatrix * local transform
+        AABB GetWorldBounds(const glm::mat4& parentMatrix = glm::mat4(1.0f)) const;
+
         Transform& GetTransform() { return m_Transform; }
         const Transform& GetTransform() const { return m_Transform; }
 
@@ -0,0 +1,68 @@
+#include "RenderState.h"
+#include <glad/glad.h>
+
+namespace Circe {
+
+    void RenderState::Reset() {
+        // Forget everything so the next bind of each kind always reaches GL
+        m_Program = 0;
+        m_VertexArray = 0;
+        m_ActiveUnit = -1;
+        m_Textures.fill(0);
+        m_UniformRanges.fill({});
+    }
+
+    bool RenderState::UseProgram(unsigned int program) {
+        if (program == m_Program) {
+            return false;
+        }
+        glUseProgram(program);
+        m_Program = program;
+        m_Stats.ProgramBinds++;
+        return true;
+    }
+
+    bool RenderState::BindTexture(int unit, unsigned int texture) {
+        if (unit < 0 || unit >= MaxTextureUnits) {
+            return false;
+        }
+        if (m_Textures[unit] == texture) {
+            return false;
+        }
+        if (m_ActiveUnit != unit) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            m_ActiveUnit = unit;
+        }
+        glBindTexture(GL_TEXTURE_2D, texture);
+        m_Textures[unit] = texture;
+        m_Stats.TextureBinds++;
+        return true;
+    }
+
+    bool RenderState::BindVertexArray(unsigned int vertexArray) {
+        if (vertexArray == m_VertexArray) {
+            return false;
+        }
+        glBindVertexArray(vertexArray);
+        m_VertexArray = vertexArray;
+        if (vertexArray != 0) {
+            m_Stats.VertexArrayBinds++;
+        }
+        return true;
+    }
+
+    bool RenderState::BindUniformRange(unsigned int binding, unsigned int buffer, size_t offset, size_t size) {
+        if (binding >= MaxUniformBindings) {
+            return false;
+        }
+        UniformRange& range = m_UniformRanges[binding];
+        if (range.Buffer == buffer && range.Offset == offset && range.Size == size) {
+            return false;
+        }
+        glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+        range = { buffer, offset, size };
+        m_Stats.UniformBlockBinds++;
+        return true;
+    }
+
+}
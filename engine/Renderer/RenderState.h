@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Circe {
+
+    // Per-frame counters used to verify how much GL state churn a frame causes
+    struct RenderStats {
+        uint32_t DrawCalls = 0;
+        uint32_t Instances = 0;
+        uint32_t ProgramBinds = 0;
+        uint32_t TextureBinds = 0;
+        uint32_t VertexArrayBinds = 0;
+        uint32_t UniformBlockBinds = 0;
+        // Outcome of the frustum test, over commands that resolved and have bounds
+        uint32_t Visible = 0;
+        uint32_t Culled = 0;
+    };
+
+    // Shadows the bound program, textures and VAO so redundant GL binds can be skipped
+    class RenderState {
+    public:
+        static constexpr int MaxTextureUnits = 32;
+        static constexpr int MaxUniformBindings = 8;
+
+        void Reset();
+
+        // Each returns true when the GL call was actually issued
+        bool UseProgram(unsigned int program);
+        bool BindTexture(int unit, unsigned int texture);
+        bool BindVertexArray(unsigned int vertexArray);
+        // glBindBufferRange on GL_UNIFORM_BUFFER, skipped when the same range is bound already
+        bool BindUniformRange(unsigned int binding, unsigned int buffer, size_t offset, size_t size);
+
+        unsigned int GetProgram() const { return m_Program; }
+        unsigned int GetVertexArray() const { return m_VertexArray; }
+
+        void CountDrawCall(uint32_t instances = 1) { m_Stats.DrawCalls++; m_Stats.Instances += instances; }
+        void CountCulling(uint32_t visible, uint32_t culled) { m_Stats.Visible += visible; m_Stats.Culled += culled; }
+        const RenderStats& GetStats() const { return m_Stats; }
+        void ResetStats() { m_Stats = {}; }
+
+    private:
+        unsigned int m_Program = 0;
+        unsigned int m_VertexArray = 0;
+        // Unknown until the first bind, as after Reset()
+        int m_ActiveUnit = -1;
+        std::array<unsigned int, MaxTextureUnits> m_Textures{};
+
+        struct UniformRange {
+            unsigned int Buffer = 0;
+            size_t Offset = 0;
+            size_t Size = 0;
+        };
+        std::array<UniformRange, MaxUniformBindings> m_UniformRanges{};
+        RenderStats m_Stats;
+    };
+
+}
@@ -3,17 +3,70 @@
 #include "Mesh.h"
 #include "Material.h"
 #include "Shader.h"
+#include "UniformBuffer.h"
+#include "../Core/Time.h"
+#include "../Core/Jobs/JobSystem.h"
+#include "../Core/Profiling/Profiler.h"
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 
 namespace Circe {
 
-    Renderer::Renderer()
-        : m_ClearColor(0.1f, 0.1f, 0.1f, 1.0f) {
+    CommandBucket::CommandBucket()
+        : m_Allocator(64 * 1024)
+        , m_Commands(m_Allocator) {
+    }
+
+    void CommandBucket::Submit(const std::shared_ptr<Mesh>& mesh, const std::shared_ptr<Material>& material, const glm::mat4& modelMatrix) {
+        if (mesh && material && material->GetShader()) {
+            m_Commands.Push({ mesh->GetHandle(), material->GetHandle(), modelMatrix });
+        }
+    }
+
+    void CommandBucket::BeginFrame() {
+        m_Allocator.BeginFrame();
+        m_Commands.Reset();
+        m_Commands.Reserve(m_LastSize);
+    }
+
+    Renderer::Renderer(uint32_t framesInFlight)
+        : m_ClearColor(0.1f, 0.1f, 0.1f, 1.0f)
+        , m_FrameCount(std::clamp<uint32_t>(framesInFlight, 1, MaxFramesInFlight))
+        , m_FrameAllocator(1 << 20, m_FrameCount)
+        , m_FlushAllocator(1 << 20, 1)
+        , m_Batches(m_FlushAllocator)
+        , m_InstanceData(m_FlushAllocator) {
+        for (FramePacket& frame : m_Frames) {
+            frame.Commands = FrameArray<RenderCommand>(m_FrameAllocator);
+        }
+        // Thread 0 and outside threads until BeginFrame sees the job system
+        m_Buckets.push_back(std::make_unique<CommandBucket>());
+        m_Buckets.push_back(std::make_unique<CommandBucket>());
     }
 
     Renderer::~Renderer() {
+        for (GLsync fence : m_FrameFences) {
+            if (fence) {
+                glDeleteSync(fence);
+            }
+        }
+        if (m_InstanceBuffer) {
+            glDeleteBuffers(1, &m_InstanceBuffer);
+        }
+    }
+
+    // Points the four vec4 columns of the instance matrix attribute at the instance buffer
+    static void BindInstanceAttributes(unsigned int buffer, size_t byteOffset, int location) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        for (int column = 0; column < 4; ++column) {
+            const size_t offset = byteOffset + column * sizeof(glm::vec4);
+            glEnableVertexAttribArray(location + column);
+            glVertexAttribPointer(location + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)offset);
+            glVertexAttribDivisor(location + column, 1);
+        }
     }
 
     void Renderer::Initialize() {
@@ -25,9 +78,28 @@ namespace Circe {
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+        glGenBuffers(1, &m_InstanceBuffer);
+        m_CameraBuffer = std::make_unique<UniformBuffer>(sizeof(CameraUniforms), UniformBinding::Camera);
+
         m_Initialized = true;
     }
 
+    void Renderer::BeginFrame() {
+        // Earlier frames stay readable in the other arenas while they are drawn; this one starts empty
+        m_FrameAllocator.BeginFrame();
+        m_RecordFrame = (m_RecordFrame + 1) % m_FrameCount;
+        FrameArray<RenderCommand>& commands = m_Frames[m_RecordFrame].Commands;
+        commands.Reset();
+        commands.Reserve(m_LastQueueSize);
+
+        while (m_Buckets.size() < JobSystem::GetThreadCount() + 1) {
+            m_Buckets.push_back(std::make_unique<CommandBucket>());
+        }
+        for (const std::unique_ptr<CommandBucket>& bucket : m_Buckets) {
+            bucket->BeginFrame();
+        }
+    }
+
     void Renderer::Clear(const glm::vec4& color) {
         glClearColor(color.r, color.g, color.b, color.a);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -35,12 +107,61 @@ namespace Circe {
 
     void Renderer::Present() {
         // Swap is handled by Window, this is for future post-processing
+        m_LastFrameStats = m_State.GetStats();
+        m_State.ResetStats();
+
+        if (m_GpuFrameLatency == 0) {
+            return;
+        }
+        // Keeps the GPU within m_GpuFrameLatency frames of the CPU
+        GLsync& fence = m_FrameFences[m_PresentCount % MaxFramesInFlight];
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_PresentCount++;
+        if (m_PresentCount <= m_GpuFrameLatency) {
+            return;
+        }
+        GLsync& oldest = m_FrameFences[(m_PresentCount - 1 - m_GpuFrameLatency) % MaxFramesInFlight];
+        if (oldest) {
+            CIRCE_PROFILE_SCOPE("Renderer::WaitForGpu");
+            GLenum status = GL_TIMEOUT_EXPIRED;
+            while (status == GL_TIMEOUT_EXPIRED) {
+                status = glClientWaitSync(oldest, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);
+            }
+            glDeleteSync(oldest);
+            oldest = nullptr;
+        }
+    }
+
+    void Renderer::SetGpuFrameLatency(uint32_t frames) {
+        frames = std::min(frames, MaxFramesInFlight - 1);
+        if (frames == m_GpuFrameLatency) {
+            return;
+        }
+        // Present indexes the fences by the latency, so the ones it would no longer reach
+        // (or overwrite) are settled here and the count starts over
+        for (GLsync& fence : m_FrameFences) {
+            if (fence) {
+                GLenum status = GL_TIMEOUT_EXPIRED;
+                while (status == GL_TIMEOUT_EXPIRED) {
+                    status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);
+                }
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+        m_PresentCount = 0;
+        m_GpuFrameLatency = frames;
     }
 
     void Renderer::SetViewport(int x, int y, int width, int height) {
         glViewport(x, y, width, height);
     }
 
+    void Renderer::ReadPixels(int x, int y, int width, int height, void* pixels) {
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+
     void Renderer::SetClearColor(const glm::vec4& color) {
         m_ClearColor = color;
     }
@@ -53,31 +174,241 @@ namespace Circe {
         // TODO: Implement with VAO/VBO
     }
 
-    void Renderer::SubmitMesh(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material, const glm::mat4& modelMatrix) {
-        if (mesh && material) {
-            m_RenderQueue.push_back({ mesh, material, modelMatrix });
+    void Renderer::SubmitMesh(const std::shared_ptr<Mesh>& mesh, const std::shared_ptr<Material>& material, const glm::mat4& modelMatrix) {
+        GetCommandBucket().Submit(mesh, material, modelMatrix);
+    }
+
+    void Renderer::SubmitMesh(MeshHandle mesh, MaterialHandle material, const glm::mat4& modelMatrix) {
+        GetCommandBucket().Submit(mesh, material, modelMatrix);
+    }
+
+    CommandBucket& Renderer::GetCommandBucket() {
+        const int thread = JobSystem::GetThreadIndex();
+        const size_t outside = m_Buckets.size() - 1;
+        return *m_Buckets[thread >= 0 && static_cast<size_t>(thread) < outside ? thread : outside];
+    }
+
+    uint64_t Renderer::GetCommandBucketHeapAllocations() const {
+        uint64_t allocations = 0;
+        for (const std::unique_ptr<CommandBucket>& bucket : m_Buckets) {
+            allocations += bucket->GetHeapAllocations();
         }
+        return allocations;
+    }
+
+    RenderCommand* Renderer::AppendCommands(size_t count) {
+        return m_Frames[m_RecordFrame].Commands.Append(count);
+    }
+
+    uint32_t Renderer::EndFrame() {
+        MergeBuckets();
+
+        FramePacket& frame = m_Frames[m_RecordFrame];
+        m_LastQueueSize = std::max(m_LastQueueSize, frame.Commands.Size());
+        frame.HasCamera = m_Camera != nullptr;
+        if (m_Camera) {
+            // Frame-global data goes through the Camera block once instead of per program
+            frame.Camera.view = m_Camera->GetViewMatrix();
+            frame.Camera.projection = m_Camera->GetProjectionMatrix();
+            frame.Camera.viewProjection = frame.Camera.projection * frame.Camera.view;
+            frame.Camera.cameraPosition = m_Camera->GetPosition();
+            frame.Camera.time = Time::GetTime();
+        }
+        return m_RecordFrame;
     }
 
     void Renderer::Flush() {
-        if (!m_Camera) {
+        Flush(EndFrame());
+    }
+
+    void Renderer::Flush(uint32_t frame) {
+        FrameArray<RenderCommand>& queue = m_Frames[frame].Commands;
+        if (!m_Frames[frame].HasCamera) {
+            queue.Clear();
+            return;
+        }
+        CIRCE_PROFILE_SCOPE("Renderer::Flush");
+        CIRCE_PROFILE_GPU_SCOPE("Renderer::Flush");
+
+        const CameraUniforms& cameraUniforms = m_Frames[frame].Camera;
+        const glm::mat4& projection = cameraUniforms.projection;
+        const glm::mat4& view = cameraUniforms.view;
+        const glm::vec3 cameraPosition = cameraUniforms.cameraPosition;
+        m_CameraBuffer->SetData(&cameraUniforms, sizeof(cameraUniforms));
+
+        // Resolve handles and compute world bounds for every command, spread over the job
+        // system for large queues. Commands whose resources are gone resolve to null.
+        m_FlushAllocator.BeginFrame();
+        const size_t commandCount = queue.Size();
+        DrawTarget* targets = m_FlushAllocator.Allocate<DrawTarget>(commandCount);
+        m_QueueBounds.Resize(commandCount);
+        JobSystem::ParallelFor(0, commandCount, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                const RenderCommand& cmd = queue[i];
+                const Mesh* mesh = ResourcePool<Mesh>::Get(cmd.mesh);
+                Material* material = ResourcePool<Material>::Get(cmd.material);
+                if (!mesh || !material || !material->GetShader()) {
+                    targets[i] = { nullptr, nullptr };
+                    m_QueueBounds.Set(i, BoundingSphere{});
+                    continue;
+                }
+                targets[i] = { mesh, material };
+                m_QueueBounds.Set(i, mesh->GetBoundingSphere().Transformed(cmd.modelMatrix));
+            }
+        }, 1024);
+
+        // Cull against the camera frustum before anything else touches the commands
+        uint8_t* visibility = m_FlushAllocator.Allocate<uint8_t>(commandCount);
+        std::fill_n(visibility, commandCount, uint8_t(1));
+        if (m_FrustumCulling) {
+            const Frustum frustum(cameraUniforms.viewProjection);
+            frustum.CullSpheres(m_QueueBounds, visibility);
+        }
+
+        // Build sort keys and order the queue by pass, shader, material, mesh and depth.
+        // Only resolved commands with bounds count as tested; one without bounds (an empty
+        // mesh) is never culled.
+        uint32_t testedCount = 0;
+        uint32_t visibleCount = 0;
+        m_SortItems.clear();
+        m_SortItems.reserve(commandCount);
+        for (uint32_t i = 0; i < commandCount; ++i) {
+            RenderCommand& cmd = queue[i];
+            const DrawTarget& target = targets[i];
+            if (!target.mesh) {
+                continue;
+            }
+            if (m_QueueBounds.Radius[i] >= 0.0f) {
+                testedCount++;
+                if (!visibility[i]) {
+                    continue;
+                }
+                visibleCount++;
+            }
+            const glm::vec3 offset = glm::vec3(cmd.modelMatrix[3]) - cameraPosition;
+            const RenderPass pass = target.material->IsTransparent() ? RenderPass::Transparent : RenderPass::Opaque;
+
+            cmd.sortKey = SortKey::Make(pass,
+                target.material->GetShader()->GetID(),
+                target.material->GetSortID(),
+                target.mesh->GetVertexArray(),
+                glm::dot(offset, offset));
+            m_SortItems.push_back({ cmd.sortKey, i });
+        }
+        m_State.CountCulling(visibleCount, testedCount - visibleCount);
+        RadixSort(m_SortItems, m_SortScratch);
+
+        // Coalesce runs of the same mesh and material, gathering their matrices for instancing
+        m_Batches.Reset();
+        m_Batches.Reserve(m_SortItems.size());
+        m_InstanceData.Reset();
+        m_InstanceData.Reserve(m_SortItems.size());
+        for (uint32_t i = 0; i < m_SortItems.size();) {
+            const RenderCommand& first = queue[m_SortItems[i].index];
+            uint32_t end = i + 1;
+            while (end < m_SortItems.size()) {
+                const RenderCommand& next = queue[m_SortItems[end].index];
+                if (next.mesh != first.mesh || next.material != first.material) {
+                    break;
+                }
+                ++end;
+            }
+
+            DrawBatch batch{ i, end - i, 0, targets[m_SortItems[i].index].material->GetShader()->SupportsInstancing() };
+            if (batch.instanced) {
+                batch.instanceOffset = static_cast<uint32_t>(m_InstanceData.Size());
+                for (uint32_t j = i; j < end; ++j) {
+                    m_InstanceData.Push(queue[m_SortItems[j].index].modelMatrix);
+                }
+            }
+            m_Batches.Push(batch);
+            i = end;
+        }
+        UploadInstanceData();
+
+        // GL state may have been touched outside the renderer since the last flush
+        m_State.Reset();
+
+        const Material* boundMaterial = nullptr;
+        for (const DrawBatch& batch : m_Batches) {
+            const DrawTarget& target = targets[m_SortItems[batch.first].index];
+            const Mesh& mesh = *target.mesh;
+            const Shader& shader = *target.material->GetShader();
+
+            if (target.material != boundMaterial) {
+                // Programs without the Camera block still take the matrices as plain uniforms
+                if (m_State.UseProgram(shader.GetID()) && !shader.HasCameraBlock()) {
+                    shader.SetMat4("projection", projection);
+                    shader.SetMat4("view", view);
+                }
+                target.material->Bind(m_State);
+                boundMaterial = target.material;
+            }
+
+            m_State.BindVertexArray(mesh.GetVertexArray());
+
+            if (batch.instanced) {
+                BindInstanceAttributes(m_InstanceBuffer, batch.instanceOffset * sizeof(glm::mat4), shader.GetInstanceModelLocation());
+                glDrawElementsInstanced(GL_TRIANGLES, mesh.GetIndexCount(), mesh.GetIndexType(), 0, batch.count);
+                m_State.CountDrawCall(batch.count);
+                continue;
+            }
+
+            // Fallback for shaders without the instance attribute: one draw per command
+            const UniformHandle modelUniform = shader.GetModelUniform();
+            for (uint32_t i = batch.first; i < batch.first + batch.count; ++i) {
+                shader.SetMat4(modelUniform, queue[m_SortItems[i].index].modelMatrix);
+                glDrawElements(GL_TRIANGLES, mesh.GetIndexCount(), mesh.GetIndexType(), 0);
+                m_State.CountDrawCall();
+            }
+        }
+        m_State.BindVertexArray(0);
+
+        queue.Clear();
+        m_QueueBounds.Clear();
+    }
+
+    void Renderer::MergeBuckets() {
+        // Bucket i lands after the appended commands and buckets 0..i-1; the copies run in parallel
+        FrameArray<RenderCommand>& queue = m_Frames[m_RecordFrame].Commands;
+        size_t* offsets = m_FrameAllocator.Allocate<size_t>(m_Buckets.size());
+        size_t total = queue.Size();
+        for (size_t i = 0; i < m_Buckets.size(); ++i) {
+            offsets[i] = total;
+            total += m_Buckets[i]->Size();
+        }
+        if (total == queue.Size()) {
             return;
         }
 
-        for (const auto& cmd : m_RenderQueue) {
-            cmd.material->Bind();
-            
-            // Set matrix uniforms
-            cmd.material->GetShader()->SetMat4("projection", m_Camera->GetProjectionMatrix());
-            cmd.material->GetShader()->SetMat4("view", m_Camera->GetViewMatrix());
-            cmd.material->GetShader()->SetMat4("model", cmd.modelMatrix);
+        queue.AppendUninitialized(total - queue.Size());
+        RenderCommand* commands = queue.Data();
+        JobSystem::ParallelFor(0, m_Buckets.size(), [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                CommandBucket& bucket = *m_Buckets[i];
+                const size_t count = bucket.m_Commands.Size();
+                if (count > 0) {
+                    std::memcpy(static_cast<void*>(commands + offsets[i]), bucket.m_Commands.Data(), count * sizeof(RenderCommand));
+                }
+                bucket.m_LastSize = std::max(bucket.m_LastSize, count);
+                bucket.m_Commands.Clear();
+            }
+        }, 1);
+    }
 
-            cmd.mesh->Bind();
-            glDrawElements(GL_TRIANGLES, cmd.mesh->GetIndexCount(), GL_UNSIGNED_INT, 0);
-            cmd.mesh->Unbind();
+    void Renderer::UploadInstanceData() {
+        if (m_InstanceData.Empty()) {
+            return;
         }
 
-        m_RenderQueue.clear();
+        glBindBuffer(GL_ARRAY_BUFFER, m_InstanceBuffer);
+
+        // The buffer only ever grows; re-specifying the store each frame orphans last frame's data
+        if (m_InstanceData.Size() > m_InstanceCapacity) {
+            m_InstanceCapacity = std::max(m_InstanceData.Size(), m_InstanceCapacity * 2);
+        }
+        glBufferData(GL_ARRAY_BUFFER, m_InstanceCapacity * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, m_InstanceData.Size() * sizeof(glm::mat4), m_InstanceData.Data());
     }
 
 }
\ No newline at end of file
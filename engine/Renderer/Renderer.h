@@ -1,48 +1,185 @@
 #pragma once
 
+#include "RenderState.h"
+#include "ResourcePool.h"
+#include "SortKey.h"
+#include "UniformBuffer.h"
+#include "Core/Memory/FrameAllocator.h"
+#include "Math/Frustum.h"
 #include <glm/glm.hpp>
+#include <algorithm>
 #include <memory>
 #include <vector>
 
+// GLsync is a pointer to this, declared here so the header does not need glad
+struct __GLsync;
+
 namespace Circe {
 
     class Camera;
     class Mesh;
     class Material;
 
+    // Resources are referenced by handle so queueing a draw copies no reference counts;
+    // commands whose mesh or material was destroyed before Flush are skipped
     struct RenderCommand {
-        std::shared_ptr<Mesh> mesh;
-        std::shared_ptr<Material> material;
+        MeshHandle mesh;
+        MaterialHandle material;
         glm::mat4 modelMatrix;
+        uint64_t sortKey = 0;
+    };
+
+    // Commands recorded by one thread into its own arena. A bucket is only touched by its
+    // thread until EndFrame merges every bucket on the recording thread, so recording takes no locks.
+    class alignas(64) CommandBucket {
+    public:
+        CommandBucket();
+
+        void Submit(const std::shared_ptr<Mesh>& mesh, const std::shared_ptr<Material>& material, const glm::mat4& modelMatrix);
+        void Submit(MeshHandle mesh, MaterialHandle material, const glm::mat4& modelMatrix) {
+            if (mesh.IsValid() && material.IsValid()) {
+                m_Commands.Push({ mesh, material, modelMatrix });
+            }
+        }
+
+        size_t Size() const { return m_Commands.Size(); }
+        // Blocks the bucket's arena took from the heap so far
+        uint64_t GetHeapAllocations() const { return m_Allocator.GetHeapAllocations(); }
+
+    private:
+        friend class Renderer;
+
+        void BeginFrame();
+
+        FrameAllocator m_Allocator;
+        FrameArray<RenderCommand> m_Commands;
+        // Largest frame so far, reserved up front
+        size_t m_LastSize = 0;
     };
 
     class Renderer {
     public:
-        Renderer();
+        static constexpr uint32_t MaxFramesInFlight = 4;
+
+        // framesInFlight frames are recorded into separate packets, so frame N can be drawn
+        // on the GL thread while frames up to N + framesInFlight - 1 are being recorded
+        explicit Renderer(uint32_t framesInFlight = 2);
         ~Renderer();
 
         void Initialize();
+        // Starts recording into the next frame packet, whose previous contents must have been
+        // drawn by then (the pipelined engine waits for that)
+        void BeginFrame();
         void Clear(const glm::vec4& color = glm::vec4(0.1f, 0.1f, 0.1f, 1.0f));
+        // GL thread. With a GPU frame latency set, fences the frame and waits for the GPU to
+        // finish the frame that many presents ago.
         void Present();
 
+        uint32_t GetFramesInFlight() const { return m_FrameCount; }
+        // Frames the GPU may fall behind Present, 0 leaves queueing to the driver. GL thread:
+        // a change waits for the frames still fenced and deletes their fences.
+        void SetGpuFrameLatency(uint32_t frames);
+
         void SetViewport(int x, int y, int width, int height);
+        // RGBA8 from the currently bound read framebuffer
+        void ReadPixels(int x, int y, int width, int height, void* pixels);
         void SetClearColor(const glm::vec4& color);
         void SetCamera(std::shared_ptr<Camera> camera) { m_Camera = camera; }
         std::shared_ptr<Camera> GetCamera() const { return m_Camera; }
 
-        // Render submission
-        void SubmitMesh(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material, const glm::mat4& modelMatrix);
+        // Render submission. Commands live in frame memory, call BeginFrame() once per frame.
+        // SubmitMesh records into the calling thread's bucket and is safe from job threads.
+        // The camera is read at EndFrame, so the recording thread owns it.
+        void SubmitMesh(const std::shared_ptr<Mesh>& mesh, const std::shared_ptr<Material>& material, const glm::mat4& modelMatrix);
+        void SubmitMesh(MeshHandle mesh, MaterialHandle material, const glm::mat4& modelMatrix);
+        // Bucket of the calling job thread; fetch it once per job when recording many commands.
+        // Threads outside the job system share one extra bucket, so only one of them may
+        // record at a time.
+        CommandBucket& GetCommandBucket();
+        // Appends count default commands and returns the first. The range may be filled from
+        // several threads before Flush; commands left without mesh, material or shader are skipped.
+        RenderCommand* AppendCommands(size_t count);
+        // Ends recording: merges the buckets behind the appended commands and captures the
+        // camera. Returns the frame packet to pass to Flush, which may happen on another thread.
+        uint32_t EndFrame();
+        // Culls, sorts and draws a packet from EndFrame, then empties it. GL thread.
+        void Flush(uint32_t frame);
+        // Flush(EndFrame()), for recording and drawing on the same thread
         void Flush();
 
+        // Transient storage of the frame being recorded, reset by BeginFrame(). Stays valid
+        // until the frame has been drawn.
+        FrameAllocator& GetFrameAllocator() { return m_FrameAllocator; }
+        // Heap blocks taken by the command bucket arenas so far; recording thread
+        uint64_t GetCommandBucketHeapAllocations() const;
+
+        void SetFrustumCulling(bool enabled) { m_FrustumCulling = enabled; }
+        bool IsFrustumCullingEnabled() const { return m_FrustumCulling; }
+
+        // Counters of the last presented frame, written on the GL thread
+        const RenderStats& GetStats() const { return m_LastFrameStats; }
+
         // Drawing primitives
         void DrawTriangle(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3);
         void DrawQuad(const glm::vec3& position, const glm::vec2& size);
 
     private:
+        // Everything Flush needs from one recorded frame, so drawing it never reads state
+        // the recording thread is changing for the next one
+        struct FramePacket {
+            FrameArray<RenderCommand> Commands;
+            CameraUniforms Camera;
+            bool HasCamera = false;
+        };
+
         glm::vec4 m_ClearColor;
         bool m_Initialized = false;
         std::shared_ptr<Camera> m_Camera;
-        std::vector<RenderCommand> m_RenderQueue;
+        uint32_t m_FrameCount;
+        // Recording side: one arena and packet per frame in flight
+        FrameAllocator m_FrameAllocator;
+        FramePacket m_Frames[MaxFramesInFlight];
+        uint32_t m_RecordFrame = 0;
+        // Largest queue so far, reserved up front so the queue never regrows
+        size_t m_LastQueueSize = 0;
+        // Drawing side: scratch memory of a single Flush
+        FrameAllocator m_FlushAllocator;
+        // World-space bounding spheres, parallel to the packet's commands during Flush
+        PackedSpheres m_QueueBounds;
+        bool m_FrustumCulling = true;
+        std::vector<SortItem> m_SortItems;
+        std::vector<SortItem> m_SortScratch;
+        // Consecutive sorted commands sharing a mesh and material
+        struct DrawBatch {
+            uint32_t first;
+            uint32_t count;
+            uint32_t instanceOffset;
+            bool instanced;
+        };
+        // Command resources resolved once per Flush, both null when the command is skipped
+        struct DrawTarget {
+            const Mesh* mesh;
+            Material* material;
+        };
+
+        void MergeBuckets();
+        void UploadInstanceData();
+
+        // One per job thread plus one for outside threads (last), grown at BeginFrame when
+        // the job system has more threads
+        std::vector<std::unique_ptr<CommandBucket>> m_Buckets;
+
+        FrameArray<DrawBatch> m_Batches;
+        FrameArray<glm::mat4> m_InstanceData;
+        std::unique_ptr<UniformBuffer> m_CameraBuffer;
+        unsigned int m_InstanceBuffer = 0;
+        size_t m_InstanceCapacity = 0;
+        RenderState m_State;
+        RenderStats m_LastFrameStats;
+        // Present fences (GLsync), one per frame in flight
+        uint32_t m_GpuFrameLatency = 0;
+        uint64_t m_PresentCount = 0;
+        ::__GLsync* m_FrameFences[MaxFramesInFlight] = {};
     };
 
 }
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace Circe {
+
+    class Mesh;
+    class Material;
+    class Shader;
+    class Texture;
+
+    // 32-bit reference to a live resource: 20 bits of slot index and 12 bits of generation.
+    // The generation changes every time a slot is reused, so a handle to a destroyed
+    // resource resolves to null instead of to whatever took its place. Copying one is a
+    // plain integer copy, no reference count.
+    template<typename T>
+    struct ResourceHandle {
+        static constexpr uint32_t IndexBits = 20;
+        static constexpr uint32_t IndexMask = (1u << IndexBits) - 1;
+
+        // 0 is never handed out: generations start at 1
+        uint32_t Value = 0;
+
+        uint32_t GetIndex() const { return Value & IndexMask; }
+        uint32_t GetGeneration() const { return Value >> IndexBits; }
+        bool IsValid() const { return Value != 0; }
+
+        bool operator==(const ResourceHandle&) const = default;
+    };
+
+    using MeshHandle = ResourceHandle<Mesh>;
+    using MaterialHandle = ResourceHandle<Material>;
+    using ShaderHandle = ResourceHandle<Shader>;
+    using TextureHandle = ResourceHandle<Texture>;
+
+    // Slot table mapping handles to the live resources of one type. Resources register
+    // themselves on construction and drop out on destruction (see PooledResource), so the
+    // pool never owns anything; ownership stays with whoever holds the shared_ptr.
+    // GL thread only, like the resources themselves.
+    template<typename T>
+    class ResourcePool {
+    public:
+        static ResourceHandle<T> Register(T* resource) {
+            uint32_t index = s_FreeList;
+            if (index != InvalidSlot) {
+                s_FreeList = s_Slots[index].NextFree;
+            } else {
+                index = static_cast<uint32_t>(s_Slots.size());
+                if (index > ResourceHandle<T>::IndexMask) {
+                    throw std::runtime_error("ResourcePool: out of handles");
+                }
+                s_Slots.push_back({ nullptr, 1, InvalidSlot });
+            }
+            Slot& slot = s_Slots[index];
+            slot.Resource = resource;
+            s_Count++;
+            return { (slot.Generation << ResourceHandle<T>::IndexBits) | index };
+        }
+
+        static void Release(ResourceHandle<T> handle) {
+            if (!Get(handle)) {
+                return;
+            }
+            Slot& slot = s_Slots[handle.GetIndex()];
+            slot.Resource = nullptr;
+            // Wraps within 12 bits, skipping 0 so no handle ever has value 0
+            slot.Generation = (slot.Generation + 1) & GenerationMask;
+            slot.Generation += slot.Generation == 0 ? 1 : 0;
+            slot.NextFree = s_FreeList;
+            s_FreeList = handle.GetIndex();
+            s_Count--;
+        }
+
+        // Null for invalid handles and resources destroyed since
+        static T* Get(ResourceHandle<T> handle) {
+            const uint32_t index = handle.GetIndex();
+            if (index >= s_Slots.size()) {
+                return nullptr;
+            }
+            const Slot& slot = s_Slots[index];
+            return slot.Generation == handle.GetGeneration() ? slot.Resource : nullptr;
+        }
+
+        static uint32_t GetCount() { return s_Count; }
+
+    private:
+        static constexpr uint32_t InvalidSlot = 0xFFFFFFFF;
+        static constexpr uint32_t GenerationMask = (1u << (32 - ResourceHandle<T>::IndexBits)) - 1;
+
+        struct Slot {
+            T* Resource;
+            uint32_t Generation;
+            uint32_t NextFree;
+        };
+
+        static inline std::vector<Slot> s_Slots;
+        static inline uint32_t s_FreeList = InvalidSlot;
+        static inline uint32_t s_Count = 0;
+    };
+
+    // Base of the pooled resource types: holds the handle for the object's lifetime
+    template<typename T>
+    class PooledResource {
+    public:
+        ResourceHandle<T> GetHandle() const { return m_Handle; }
+
+        PooledResource(const PooledResource&) = delete;
+        PooledResource& operator=(const PooledResource&) = delete;
+
+    protected:
+        PooledResource()
+            : m_Handle(ResourcePool<T>::Register(static_cast<T*>(this))) {
+        }
+        ~PooledResource() {
+            ResourcePool<T>::Release(m_Handle);
+        }
+
+    private:
+        ResourceHandle<T> m_Handle;
+    };
+
+}
@@ -1,100 +1,362 @@
 #include "Shader.h"
+#include "ShaderCache.h"
+#include "ShaderLibrary.h"
+#include "UniformBuffer.h"
+#include "../Core/Profiling/Profiler.h"
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
-#include <fstream>
-#include <sstream>
 #include <stdexcept>
+#include <utility>
 
 namespace Circe {
 
+    static bool IsSamplerType(GLenum type) {
+        switch (type) {
+        case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_1D_SHADOW: case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_CUBE_SHADOW:
+        case GL_SAMPLER_1D_ARRAY: case GL_SAMPLER_2D_ARRAY: case GL_SAMPLER_2D_ARRAY_SHADOW:
+        case GL_SAMPLER_2D_MULTISAMPLE: case GL_SAMPLER_2D_MULTISAMPLE_ARRAY: case GL_SAMPLER_BUFFER:
+        case GL_SAMPLER_2D_RECT: case GL_SAMPLER_2D_RECT_SHADOW:
+        case GL_INT_SAMPLER_2D: case GL_INT_SAMPLER_3D: case GL_INT_SAMPLER_CUBE: case GL_INT_SAMPLER_2D_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_2D: case GL_UNSIGNED_INT_SAMPLER_3D: case GL_UNSIGNED_INT_SAMPLER_CUBE:
+        case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static std::string_view StripArraySuffix(std::string_view name) {
+        return name.ends_with("[0]") ? name.substr(0, name.size() - 3) : name;
+    }
+
+    // FNV-1a, names are short so this is cheaper than std::hash's setup
+    static uint32_t HashUniformName(std::string_view name) {
+        uint32_t hash = 2166136261u;
+        for (char c : name) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
     Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath) {
-        // Read vertex shader source
-        std::ifstream vFile(vertexPath);
-        if (!vFile.is_open()) {
-            throw std::runtime_error("Failed to open vertex shader: " + vertexPath);
-        }
-        std::stringstream vBuffer;
-        vBuffer << vFile.rdbuf();
-        std::string vCode = vBuffer.str();
-        const char* vCodeCStr = vCode.c_str();
-
-        // Read fragment shader source
-        std::ifstream fFile(fragmentPath);
-        if (!fFile.is_open()) {
-            throw std::runtime_error("Failed to open fragment shader: " + fragmentPath);
-        }
-        std::stringstream fBuffer;
-        fBuffer << fFile.rdbuf();
-        std::string fCode = fBuffer.str();
-        const char* fCodeCStr = fCode.c_str();
-
-        // Compile vertex shader
-        unsigned int vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vCodeCStr, nullptr);
-        glCompileShader(vertex);
-
-        // Check for vertex compile errors
-        int success;
-        char infoLog[512];
-        glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            glGetShaderInfoLog(vertex, 512, nullptr, infoLog);
-            throw std::runtime_error("Vertex shader compilation failed: " + std::string(infoLog));
-        }
-
-        // Compile fragment shader
-        unsigned int fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fCodeCStr, nullptr);
-        glCompileShader(fragment);
-
-        // Check for fragment compile errors
-        glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            glGetShaderInfoLog(fragment, 512, nullptr, infoLog);
-            throw std::runtime_error("Fragment shader compilation failed: " + std::string(infoLog));
+        m_Origin.VertexPath = vertexPath;
+        m_Origin.FragmentPath = fragmentPath;
+        BeginCompile(ShaderLibrary::BuildSources(m_Origin));
+        FinishCompile();
+        ShaderLibrary::Track(*this);
+    }
+
+    Shader::Shader(const ShaderSources& sources)
+        : Shader(sources, DeferredTag{}) {
+        FinishCompile();
+    }
+
+    Shader::Shader(const ShaderSources& sources, DeferredTag) {
+        BeginCompile(sources);
+    }
+
+    void Shader::BeginCompile(const ShaderSources& sources) {
+        CIRCE_PROFILE_SCOPE("Shader::BeginCompile");
+
+        // A cached binary skips compile and link entirely
+        m_CacheKey = ShaderCache::ComputeKey({ sources.Vertex, sources.Fragment });
+        m_ID = glCreateProgram();
+        if (ShaderCache::Load(m_CacheKey, m_ID)) {
+            return;
         }
 
+        const char* vCodeCStr = sources.Vertex.c_str();
+        const char* fCodeCStr = sources.Fragment.c_str();
+
+        // Compile both stages; status checks wait until FinishCompile
+        m_PendingVertex = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(m_PendingVertex, 1, &vCodeCStr, nullptr);
+        glCompileShader(m_PendingVertex);
+
+        m_PendingFragment = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(m_PendingFragment, 1, &fCodeCStr, nullptr);
+        glCompileShader(m_PendingFragment);
+
         // Link shaders
-        m_ID = glCreateProgram();
-        glAttachShader(m_ID, vertex);
-        glAttachShader(m_ID, fragment);
+        ShaderCache::PrepareProgram(m_ID);
+        glAttachShader(m_ID, m_PendingVertex);
+        glAttachShader(m_ID, m_PendingFragment);
         glLinkProgram(m_ID);
+    }
 
-        // Check for linking errors
-        glGetProgramiv(m_ID, GL_LINK_STATUS, &success);
-        if (!success) {
-            glGetProgramInfoLog(m_ID, 512, nullptr, infoLog);
-            throw std::runtime_error("Shader program linking failed: " + std::string(infoLog));
+    void Shader::FinishCompile() {
+        CIRCE_PROFILE_SCOPE("Shader::FinishCompile");
+
+        if (m_PendingVertex) {
+            int success;
+            char infoLog[512];
+
+            // Check for compile errors, stage by stage so the log names the culprit
+            glGetShaderiv(m_PendingVertex, GL_COMPILE_STATUS, &success);
+            if (!success) {
+                glGetShaderInfoLog(m_PendingVertex, 512, nullptr, infoLog);
+                Release();
+                throw std::runtime_error("Vertex shader compilation failed: " + std::string(infoLog));
+            }
+            glGetShaderiv(m_PendingFragment, GL_COMPILE_STATUS, &success);
+            if (!success) {
+                glGetShaderInfoLog(m_PendingFragment, 512, nullptr, infoLog);
+                Release();
+                throw std::runtime_error("Fragment shader compilation failed: " + std::string(infoLog));
+            }
+
+            // Check for linking errors
+            glGetProgramiv(m_ID, GL_LINK_STATUS, &success);
+            if (!success) {
+                glGetProgramInfoLog(m_ID, 512, nullptr, infoLog);
+                Release();
+                throw std::runtime_error("Shader program linking failed: " + std::string(infoLog));
+            }
+
+            // The program keeps the linked code, the stage objects can go
+            glDetachShader(m_ID, m_PendingVertex);
+            glDetachShader(m_ID, m_PendingFragment);
+            glDeleteShader(m_PendingVertex);
+            glDeleteShader(m_PendingFragment);
+            m_PendingVertex = 0;
+            m_PendingFragment = 0;
+
+            ShaderCache::Store(m_CacheKey, m_ID);
         }
 
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
+        m_InstanceModelLocation = glGetAttribLocation(m_ID, InstanceModelAttribute);
+
+        unsigned int cameraBlock = glGetUniformBlockIndex(m_ID, CameraBlockName);
+        if (cameraBlock != GL_INVALID_INDEX) {
+            glUniformBlockBinding(m_ID, cameraBlock, UniformBinding::Camera);
+            m_HasCameraBlock = true;
+        }
+
+        ReflectUniforms();
+        ReflectMaterialBlock();
     }
 
-    Shader::~Shader() {
+    bool Shader::IsCompileComplete() const {
+        if (!m_PendingVertex || !ShaderLibrary::SupportsParallelCompile()) {
+            return true;
+        }
+        // Non-blocking query from KHR_parallel_shader_compile, same enum as the ARB version
+        int complete = GL_FALSE;
+        glGetProgramiv(m_ID, GL_COMPLETION_STATUS_KHR, &complete);
+        return complete == GL_TRUE;
+    }
+
+    void Shader::SwapProgram(Shader& other) {
+        std::swap(m_ID, other.m_ID);
+        std::swap(m_PendingVertex, other.m_PendingVertex);
+        std::swap(m_PendingFragment, other.m_PendingFragment);
+        std::swap(m_CacheKey, other.m_CacheKey);
+        std::swap(m_InstanceModelLocation, other.m_InstanceModelLocation);
+        std::swap(m_ModelUniform, other.m_ModelUniform);
+        std::swap(m_HasCameraBlock, other.m_HasCameraBlock);
+        std::swap(m_Uniforms, other.m_Uniforms);
+        std::swap(m_MaterialBlock, other.m_MaterialBlock);
+        std::swap(m_TextureSlots, other.m_TextureSlots);
+        m_Revision++;
+    }
+
+    void Shader::Release() {
+        if (m_PendingVertex) {
+            glDeleteShader(m_PendingVertex);
+            glDeleteShader(m_PendingFragment);
+            m_PendingVertex = 0;
+            m_PendingFragment = 0;
+        }
         if (m_ID) {
             glDeleteProgram(m_ID);
+            m_ID = 0;
         }
     }
 
+    Shader::~Shader() {
+        if (!m_Origin.VertexPath.empty()) {
+            ShaderLibrary::Untrack(*this);
+        }
+        Release();
+    }
+
     void Shader::Use() const {
         glUseProgram(m_ID);
     }
 
+    void Shader::ReflectUniforms() {
+        int count = 0;
+        int maxNameLength = 0;
+        glGetProgramiv(m_ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(m_ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+        // Arrays register both "name[0]" and "name", keep the load factor at or below one half
+        size_t capacity = 8;
+        while (capacity < static_cast<size_t>(count) * 4) {
+            capacity *= 2;
+        }
+        m_Uniforms.assign(capacity, UniformEntry{});
+
+        m_TextureSlots.clear();
+        int nextUnit = 0;
+        GLint previousProgram = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+        glUseProgram(m_ID);
+
+        std::string name(static_cast<size_t>(maxNameLength > 0 ? maxNameLength : 1), '\0');
+        for (int i = 0; i < count; ++i) {
+            int length = 0;
+            int size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(m_ID, static_cast<GLuint>(i), maxNameLength, &length, &size, &type, name.data());
+
+            std::string_view uniformName(name.data(), static_cast<size_t>(length));
+            int location = glGetUniformLocation(m_ID, name.c_str());
+            if (location < 0) {
+                // Uniform block members have no location
+                continue;
+            }
+
+            InsertUniform(uniformName, location);
+            if (uniformName.ends_with("[0]")) {
+                InsertUniform(StripArraySuffix(uniformName), location);
+            }
+
+            // Fixed units for the program's lifetime, arrays take consecutive ones
+            if (IsSamplerType(type)) {
+                std::vector<GLint> units(static_cast<size_t>(size));
+                for (GLint& unit : units) {
+                    unit = nextUnit++;
+                }
+                glUniform1iv(location, size, units.data());
+                m_TextureSlots.push_back({ std::string(StripArraySuffix(uniformName)), units.front() });
+            }
+        }
+
+        glUseProgram(static_cast<GLuint>(previousProgram));
+        m_ModelUniform = GetUniform(ModelUniformName);
+    }
+
+    void Shader::ReflectMaterialBlock() {
+        m_MaterialBlock = {};
+        const GLuint block = glGetUniformBlockIndex(m_ID, MaterialBlockName);
+        if (block == GL_INVALID_INDEX) {
+            return;
+        }
+        glUniformBlockBinding(m_ID, block, UniformBinding::Material);
+
+        GLint size = 0;
+        GLint count = 0;
+        glGetActiveUniformBlockiv(m_ID, block, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+        glGetActiveUniformBlockiv(m_ID, block, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &count);
+        if (size <= 0 || count <= 0) {
+            return;
+        }
+
+        std::vector<GLint> members(static_cast<size_t>(count));
+        glGetActiveUniformBlockiv(m_ID, block, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, members.data());
+        std::vector<GLuint> indices(members.begin(), members.end());
+        std::vector<GLint> offsets(indices.size());
+        std::vector<GLint> types(indices.size());
+        glGetActiveUniformsiv(m_ID, count, indices.data(), GL_UNIFORM_OFFSET, offsets.data());
+        glGetActiveUniformsiv(m_ID, count, indices.data(), GL_UNIFORM_TYPE, types.data());
+
+        int maxNameLength = 0;
+        glGetProgramiv(m_ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+        std::string name(static_cast<size_t>(maxNameLength > 0 ? maxNameLength : 1), '\0');
+        for (size_t i = 0; i < indices.size(); i++) {
+            GLsizei length = 0;
+            glGetActiveUniformName(m_ID, indices[i], maxNameLength, &length, name.data());
+            const std::string_view memberName = StripArraySuffix(std::string_view(name.data(), static_cast<size_t>(length)));
+            m_MaterialBlock.Parameters.push_back({ std::string(memberName), static_cast<uint32_t>(offsets[i]), static_cast<unsigned int>(types[i]) });
+        }
+        m_MaterialBlock.Size = static_cast<uint32_t>(size);
+    }
+
+    const MaterialParameter* MaterialBlockLayout::Find(std::string_view name) const {
+        for (const MaterialParameter& parameter : Parameters) {
+            if (parameter.Name == name) {
+                return &parameter;
+            }
+        }
+        return nullptr;
+    }
+
+    int Shader::GetTextureUnit(std::string_view name) const {
+        for (const TextureSlot& slot : m_TextureSlots) {
+            if (slot.Name == name) {
+                return slot.Unit;
+            }
+        }
+        return -1;
+    }
+
+    void Shader::InsertUniform(std::string_view name, int location) {
+        const uint32_t hash = HashUniformName(name);
+        const size_t mask = m_Uniforms.size() - 1;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            UniformEntry& entry = m_Uniforms[slot];
+            if (entry.Location < 0) {
+                entry = { hash, location, std::string(name) };
+                return;
+            }
+            if (entry.Hash == hash && entry.Name == name) {
+                return;
+            }
+        }
+    }
+
+    UniformHandle Shader::GetUniform(std::string_view name) const {
+        if (m_Uniforms.empty()) {
+            return {};
+        }
+
+        const uint32_t hash = HashUniformName(name);
+        const size_t mask = m_Uniforms.size() - 1;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            const UniformEntry& entry = m_Uniforms[slot];
+            if (entry.Location < 0) {
+                return {};
+            }
+            if (entry.Hash == hash && entry.Name == name) {
+                return { entry.Location };
+            }
+        }
+    }
+
     void Shader::SetInt(const char* name, int value) const {
-        glUniform1i(glGetUniformLocation(m_ID, name), value);
+        SetInt(GetUniform(name), value);
     }
 
     void Shader::SetFloat(const char* name, float value) const {
-        glUniform1f(glGetUniformLocation(m_ID, name), value);
+        SetFloat(GetUniform(name), value);
     }
 
     void Shader::SetVec4(const char* name, const glm::vec4& value) const {
-        glUniform4f(glGetUniformLocation(m_ID, name), value.x, value.y, value.z, value.w);
+        SetVec4(GetUniform(name), value);
     }
 
     void Shader::SetMat4(const char* name, const glm::mat4& value) const {
-        glUniformMatrix4fv(glGetUniformLocation(m_ID, name), 1, GL_FALSE, glm::value_ptr(value));
+        SetMat4(GetUniform(name), value);
+    }
+
+    // Location -1 is silently ignored by GL, matching the old glGetUniformLocation behaviour
+    void Shader::SetInt(UniformHandle handle, int value) const {
+        glUniform1i(handle.Location, value);
+    }
+
+    void Shader::SetFloat(UniformHandle handle, float value) const {
+        glUniform1f(handle.Location, value);
+    }
+
+    void Shader::SetVec4(UniformHandle handle, const glm::vec4& value) const {
+        glUniform4f(handle.Location, value.x, value.y, value.z, value.w);
+    }
+
+    void Shader::SetMat4(UniformHandle handle, const glm::mat4& value) const {
+        glUniformMatrix4fv(handle.Location, 1, GL_FALSE, glm::value_ptr(value));
     }
 
 }
@@ -1,23 +1,154 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <glm/glm.hpp>
+#include "ResourcePool.h"
 
 namespace Circe {
 
-    class Shader {
+    // Pre-resolved uniform location, hold one to skip the name lookup on hot paths
+    struct UniformHandle {
+        int Location = -1;
+
+        bool IsValid() const { return Location >= 0; }
+    };
+
+    // Member of the program's "Material" uniform block. With ARB_bindless_texture a sampler
+    // declared inside the block is a 64-bit handle slot.
+    struct MaterialParameter {
+        std::string Name;
+        uint32_t Offset = 0;
+        unsigned int Type = 0;
+    };
+
+    // std140 layout of the "Material" block, reflected at link time
+    struct MaterialBlockLayout {
+        uint32_t Size = 0;
+        std::vector<MaterialParameter> Parameters;
+
+        const MaterialParameter* Find(std::string_view name) const;
+    };
+
+    // Default-block sampler with the texture unit it was given at link time
+    struct TextureSlot {
+        std::string Name;
+        int Unit = -1;
+    };
+
+    // Final GLSL text of both stages: includes resolved, defines injected
+    struct ShaderSources {
+        std::string Vertex;
+        std::string Fragment;
+    };
+
+    // Where a program's sources came from, so it can be rebuilt when one of the files changes
+    struct ShaderOrigin {
+        std::string VertexPath;
+        std::string FragmentPath;
+        std::vector<std::string> Defines;
+        // Every file read to build the sources, includes too
+        std::vector<std::string> Files;
+    };
+
+    class Shader : public PooledResource<Shader> {
     public:
+        // Resolves #include directives through ShaderLibrary::Preprocess. Programs loaded from
+        // files are rebuilt in place by ShaderLibrary when hot reload is enabled.
         Shader(const std::string& vertexPath, const std::string& fragmentPath);
+        explicit Shader(const ShaderSources& sources);
         ~Shader();
 
+        Shader(const Shader&) = delete;
+        Shader& operator=(const Shader&) = delete;
+
         void Use() const;
+        unsigned int GetID() const { return m_ID; }
+
+        // Empty paths for programs built straight from sources
+        const ShaderOrigin& GetOrigin() const { return m_Origin; }
+        // Bumped every time a reload swaps in a new program; uniform handles from an older
+        // revision must be looked up again
+        uint32_t GetRevision() const { return m_Revision; }
+
+        // Per-instance model matrix attribute, -1 when the program only has the "model" uniform
+        static constexpr const char* InstanceModelAttribute = "aInstanceModel";
+        int GetInstanceModelLocation() const { return m_InstanceModelLocation; }
+        bool SupportsInstancing() const { return m_InstanceModelLocation >= 0; }
+        // Model matrix uniform for per-draw submission, resolved at link time and on reload
+        static constexpr const char* ModelUniformName = "model";
+        UniformHandle GetModelUniform() const { return m_ModelUniform; }
+
+        // True when the program declares the per-frame "Camera" uniform block
+        static constexpr const char* CameraBlockName = "Camera";
+        bool HasCameraBlock() const { return m_HasCameraBlock; }
+
+        // Per-material parameters, bound to UniformBinding::Material by Material::Bind
+        static constexpr const char* MaterialBlockName = "Material";
+        bool HasMaterialBlock() const { return m_MaterialBlock.Size > 0; }
+        const MaterialBlockLayout& GetMaterialBlock() const { return m_MaterialBlock; }
+
+        // Samplers get consecutive units once at link time, so binding a material only binds textures
+        const std::vector<TextureSlot>& GetTextureSlots() const { return m_TextureSlots; }
+        // -1 when the program has no such sampler
+        int GetTextureUnit(std::string_view name) const;
+
+        // Looks the name up in the uniform table reflected at link time, no GL call involved
+        UniformHandle GetUniform(std::string_view name) const;
+
         void SetInt(const char* name, int value) const;
         void SetFloat(const char* name, float value) const;
         void SetVec4(const char* name, const glm::vec4& value) const;
         void SetMat4(const char* name, const glm::mat4& value) const;
 
+        void SetInt(UniformHandle handle, int value) const;
+        void SetFloat(UniformHandle handle, float value) const;
+        void SetVec4(UniformHandle handle, const glm::vec4& value) const;
+        void SetMat4(UniformHandle handle, const glm::mat4& value) const;
+
     private:
+        struct UniformEntry {
+            uint32_t Hash = 0;
+            int Location = -1;
+            std::string Name;
+        };
+
+        friend class ShaderLibrary;
+        friend class ShaderVariantSet;
+        struct DeferredTag {};
+
+        // Issues compile and link without waiting on them, so a batch of programs can be built
+        // by the driver's compiler threads (GL_KHR_parallel_shader_compile); FinishCompile() collects
+        Shader(const ShaderSources& sources, DeferredTag);
+        void BeginCompile(const ShaderSources& sources);
+        // Throws std::runtime_error with the info log when compiling or linking failed
+        void FinishCompile();
+        // False while the driver's compiler threads are still busy with this program
+        bool IsCompileComplete() const;
+        // Takes over the other program and its reflection data, the other gets ours
+        void SwapProgram(Shader& other);
+        void Release();
+        void ReflectUniforms();
+        void ReflectMaterialBlock();
+        void InsertUniform(std::string_view name, int location);
+
         unsigned int m_ID = 0;
+        // Stage objects of a compile still in flight, 0 once finished or restored from the cache
+        unsigned int m_PendingVertex = 0;
+        unsigned int m_PendingFragment = 0;
+        uint64_t m_CacheKey = 0;
+        uint32_t m_Revision = 0;
+        ShaderOrigin m_Origin;
+        int m_InstanceModelLocation = -1;
+        UniformHandle m_ModelUniform;
+        bool m_HasCameraBlock = false;
+        MaterialBlockLayout m_MaterialBlock;
+        std::vector<TextureSlot> m_TextureSlots;
+
+        // Open-addressed table, power-of-two sized, empty slots have Location == -1
+        std::vector<UniformEntry> m_Uniforms;
     };
 
 }
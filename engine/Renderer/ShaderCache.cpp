@@ -0,0 +1,222 @@
+#include "ShaderCache.h"
+#include "../Core/Profiling/Profiler.h"
+#include <glad/glad.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+namespace Circe {
+
+    namespace {
+
+        constexpr uint32_t CacheMagic = 0x43485343; // "CSHC"
+        constexpr uint32_t CacheVersion = 1;
+
+        struct CacheHeader {
+            uint32_t Magic;
+            uint32_t Version;
+            uint64_t Key;
+            uint32_t BinaryFormat;
+            uint32_t BinaryLength;
+        };
+
+        bool s_Enabled = false;
+        std::string s_Directory;
+        // Vendor, renderer and version strings folded into every key
+        uint64_t s_DriverHash = 0;
+        ShaderCacheStats s_Stats;
+
+        // 64-bit FNV-1a, each part length-prefixed so ("ab", "c") and ("a", "bc") differ
+        uint64_t Hash(uint64_t hash, std::string_view data) {
+            const uint64_t length = data.size();
+            for (int i = 0; i < 8; i++) {
+                hash ^= (length >> (i * 8)) & 0xFF;
+                hash *= 1099511628211ull;
+            }
+            for (char c : data) {
+                hash ^= static_cast<uint8_t>(c);
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        std::string GetString(GLenum name) {
+            const GLubyte* value = glGetString(name);
+            return value ? reinterpret_cast<const char*>(value) : "";
+        }
+
+        std::filesystem::path GetEntryPath(uint64_t key) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+            return std::filesystem::path(s_Directory) / name;
+        }
+
+    }
+
+    void ShaderCache::Initialize(const std::string& directory) {
+        s_Enabled = false;
+        s_Directory = directory;
+        s_Stats = {};
+        if (directory.empty()) {
+            return;
+        }
+
+        // Core since 4.1, ARB_get_program_binary before that
+        GLint formats = 0;
+        if (glGetProgramBinary && glProgramBinary && glProgramParameteri) {
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        }
+        if (formats <= 0) {
+            std::cerr << "Shader cache disabled: the driver exposes no program binary formats" << std::endl;
+            return;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            std::cerr << "Shader cache disabled: cannot create " << directory << ": " << error.message() << std::endl;
+            return;
+        }
+
+        uint64_t hash = 14695981039346656037ull;
+        hash = Hash(hash, GetString(GL_VENDOR));
+        hash = Hash(hash, GetString(GL_RENDERER));
+        hash = Hash(hash, GetString(GL_VERSION));
+        hash = Hash(hash, GetString(GL_SHADING_LANGUAGE_VERSION));
+        s_DriverHash = hash;
+        s_Enabled = true;
+    }
+
+    void ShaderCache::Shutdown() {
+        s_Enabled = false;
+    }
+
+    bool ShaderCache::IsEnabled() {
+        return s_Enabled;
+    }
+
+    const std::string& ShaderCache::GetDirectory() {
+        return s_Directory;
+    }
+
+    uint64_t ShaderCache::ComputeKey(std::initializer_list<std::string_view> parts) {
+        uint64_t hash = s_DriverHash ^ CacheVersion;
+        for (std::string_view part : parts) {
+            hash = Hash(hash, part);
+        }
+        return hash;
+    }
+
+    bool ShaderCache::Load(uint64_t key, unsigned int program) {
+        if (!s_Enabled) {
+            return false;
+        }
+        CIRCE_PROFILE_SCOPE("ShaderCache::Load");
+
+        const std::filesystem::path path = GetEntryPath(key);
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            s_Stats.Misses++;
+            return false;
+        }
+
+        std::error_code sizeError;
+        const uintmax_t fileSize = std::filesystem::file_size(path, sizeError);
+
+        CacheHeader header{};
+        std::vector<char> binary;
+        bool valid = !sizeError && file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+            header.Magic == CacheMagic && header.Version == CacheVersion && header.Key == key &&
+            header.BinaryLength > 0 && header.BinaryLength <= fileSize - sizeof(header);
+        if (valid) {
+            // Bounded by the file size above, so a damaged length cannot ask for gigabytes
+            binary.resize(header.BinaryLength);
+            valid = static_cast<bool>(file.read(binary.data(), static_cast<std::streamsize>(binary.size())));
+        }
+
+        GLint linked = GL_FALSE;
+        if (valid) {
+            glProgramBinary(program, header.BinaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        }
+        if (!linked) {
+            // Stale or damaged, drop it so the fresh compile replaces it
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(path, error);
+            s_Stats.Rejected++;
+            return false;
+        }
+
+        s_Stats.Hits++;
+        return true;
+    }
+
+    void ShaderCache::Store(uint64_t key, unsigned int program) {
+        if (!s_Enabled) {
+            return;
+        }
+        CIRCE_PROFILE_SCOPE("ShaderCache::Store");
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) {
+            return;
+        }
+
+        std::vector<char> binary(static_cast<size_t>(length));
+        GLenum format = 0;
+        glGetProgramBinary(program, length, &length, &format, binary.data());
+
+        const CacheHeader header{ CacheMagic, CacheVersion, key, format, static_cast<uint32_t>(length) };
+
+        // Temporary + rename, so a concurrent or interrupted run never reads half a binary
+        const std::filesystem::path path = GetEntryPath(key);
+        std::filesystem::path temporary = path;
+        temporary += ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(binary.data(), length);
+        }
+        std::error_code error;
+        if (std::filesystem::file_size(temporary, error) != sizeof(header) + static_cast<size_t>(length)) {
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+        std::filesystem::rename(temporary, path, error);
+        if (!error) {
+            s_Stats.Stores++;
+        }
+    }
+
+    void ShaderCache::PrepareProgram(unsigned int program) {
+        if (s_Enabled) {
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+    }
+
+    void ShaderCache::Clear() {
+        if (s_Directory.empty()) {
+            return;
+        }
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(s_Directory, error)) {
+            if (entry.path().extension() == ".bin" || entry.path().extension() == ".tmp") {
+                std::filesystem::remove(entry.path(), error);
+            }
+        }
+    }
+
+    ShaderCacheStats ShaderCache::GetStats() {
+        return s_Stats;
+    }
+
+    void ShaderCache::ResetStats() {
+        s_Stats = {};
+    }
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+namespace Circe {
+
+    struct ShaderCacheStats {
+        // Programs restored with glProgramBinary
+        uint32_t Hits = 0;
+        // No cached binary for the key
+        uint32_t Misses = 0;
+        // Cached binary refused by the driver (update, different GPU) or a damaged file
+        uint32_t Rejected = 0;
+        uint32_t Stores = 0;
+    };
+
+    // On-disk cache of linked program binaries (glGetProgramBinary / glProgramBinary).
+    // Entries are keyed by the shader sources, defines and the driver identity, so editing
+    // a shader or updating the driver simply misses and the program is compiled again.
+    class ShaderCache {
+    public:
+        // GL thread, after the context exists. An empty directory, or a driver without binary
+        // formats, leaves the cache disabled and every call below a no-op.
+        static void Initialize(const std::string& directory);
+        static void Shutdown();
+
+        static bool IsEnabled();
+        static const std::string& GetDirectory();
+
+        // Hash of the parts (sources, defines) combined with the driver identity
+        static uint64_t ComputeKey(std::initializer_list<std::string_view> parts);
+
+        // GL thread. True when the program was restored and links; otherwise the caller compiles.
+        static bool Load(uint64_t key, unsigned int program);
+        // GL thread, after a successful link of a program created with PrepareProgram()
+        static void Store(uint64_t key, unsigned int program);
+        // Sets the retrievable hint so the driver keeps the binary around; call before linking
+        static void PrepareProgram(unsigned int program);
+
+        // Deletes every cached binary
+        static void Clear();
+
+        static ShaderCacheStats GetStats();
+        static void ResetStats();
+    };
+
+}
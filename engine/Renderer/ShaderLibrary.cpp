@@ -0,0 +1,542 @@
+#include "ShaderLibrary.h"
+#include "ShaderCache.h"
+#include "../Core/FileWatcher.h"
+#include "../Core/Jobs/JobSystem.h"
+#include "../Core/Profiling/Profiler.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace Circe {
+
+    namespace {
+
+        bool s_ParallelCompile = false;
+        std::vector<std::filesystem::path> s_IncludeDirectories;
+        std::vector<std::string> s_GlobalDefines;
+        // Programs by final-source hash; weak so unused permutations are freed with their last user
+        std::unordered_map<uint64_t, std::weak_ptr<Shader>> s_Programs;
+        std::map<std::string, std::shared_ptr<ShaderVariantSet>> s_VariantSets;
+        ShaderLibraryStats s_Stats;
+
+        // Sources read on a background job for a hot reload
+        struct ReloadJob {
+            ShaderOrigin Origin;
+            ShaderSources Sources;
+            std::string Error;
+            std::atomic<bool> Done{ false };
+        };
+
+        struct PendingReload {
+            Shader* Target = nullptr;
+            std::shared_ptr<ReloadJob> Job;
+            // Compiling on the driver's threads once the job is done
+            std::unique_ptr<Shader> Replacement;
+        };
+
+        // Programs built from files, candidates for hot reload
+        std::unordered_set<Shader*> s_Tracked;
+        std::vector<PendingReload> s_Reloads;
+
+        bool DependsOn(const std::vector<std::string>& files, const std::unordered_set<std::string>& changed) {
+            return std::any_of(files.begin(), files.end(), [&](const std::string& file) { return changed.count(file) > 0; });
+        }
+
+        void WatchFiles(const std::vector<std::string>& files) {
+            for (const auto& file : files) {
+                FileWatcher::Watch(file);
+            }
+        }
+
+        void UnwatchFiles(const std::vector<std::string>& files) {
+            for (const auto& file : files) {
+                FileWatcher::Unwatch(file);
+            }
+        }
+
+        struct PreprocessContext {
+            std::unordered_set<std::string> Included;
+            // Index in this list is the GLSL source-string number used in #line directives
+            std::vector<std::string> Files;
+        };
+
+        std::string ReadFile(const std::filesystem::path& path) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("Failed to read shader file: " + path.string());
+            }
+            std::stringstream stream;
+            stream << file.rdbuf();
+            return stream.str();
+        }
+
+        bool IsIdentifierChar(char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        }
+
+        bool ContainsToken(std::string_view source, std::string_view token) {
+            for (size_t pos = source.find(token); pos != std::string_view::npos; pos = source.find(token, pos + 1)) {
+                const bool startOk = pos == 0 || !IsIdentifierChar(source[pos - 1]);
+                const size_t end = pos + token.size();
+                const bool endOk = end == source.size() || !IsIdentifierChar(source[end]);
+                if (startOk && endOk) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Name of an #include "name" directive, empty when the line is something else
+        std::string_view ParseInclude(std::string_view line) {
+            size_t pos = line.find_first_not_of(" \t");
+            if (pos == std::string_view::npos || line[pos] != '#') {
+                return {};
+            }
+            pos = line.find_first_not_of(" \t", pos + 1);
+            if (pos == std::string_view::npos || line.compare(pos, 7, "include") != 0) {
+                return {};
+            }
+            const size_t open = line.find('"', pos + 7);
+            const size_t close = open == std::string_view::npos ? open : line.find('"', open + 1);
+            if (close == std::string_view::npos) {
+                return {};
+            }
+            return line.substr(open + 1, close - open - 1);
+        }
+
+        std::filesystem::path ResolveInclude(const std::filesystem::path& includer, std::string_view name) {
+            std::filesystem::path candidate = includer.parent_path() / name;
+            if (std::filesystem::exists(candidate)) {
+                return candidate;
+            }
+            for (const auto& directory : s_IncludeDirectories) {
+                candidate = directory / name;
+                if (std::filesystem::exists(candidate)) {
+                    return candidate;
+                }
+            }
+            return {};
+        }
+
+        void ExpandFile(const std::filesystem::path& path, PreprocessContext& context, std::string& output) {
+            const std::string key = std::filesystem::weakly_canonical(path).string();
+            if (!context.Included.insert(key).second) {
+                return;
+            }
+            const size_t fileIndex = context.Files.size();
+            context.Files.push_back(path.string());
+
+            const std::string source = ReadFile(path);
+            std::string_view remaining = source;
+            size_t lineNumber = 0;
+            while (!remaining.empty()) {
+                const size_t end = remaining.find('\n');
+                const std::string_view line = remaining.substr(0, end);
+                remaining = end == std::string_view::npos ? std::string_view{} : remaining.substr(end + 1);
+                lineNumber++;
+
+                const std::string_view name = ParseInclude(line);
+                if (name.empty()) {
+                    output.append(line);
+                    output.push_back('\n');
+                    continue;
+                }
+
+                const std::filesystem::path resolved = ResolveInclude(path, name);
+                if (resolved.empty()) {
+                    throw std::runtime_error(path.string() + ":" + std::to_string(lineNumber) +
+                        ": cannot find include \"" + std::string(name) + "\"");
+                }
+                output += "// include " + std::to_string(context.Files.size()) + ": " + resolved.string() + "\n";
+                output += "#line 1 " + std::to_string(context.Files.size()) + "\n";
+                ExpandFile(resolved, context, output);
+                output += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+            }
+        }
+
+    }
+
+    void ShaderLibrary::Initialize() {
+        s_Stats = {};
+        s_ParallelCompile = false;
+
+        // Let the driver pick its thread count; without this, compiles are serialized
+        if (GLAD_GL_KHR_parallel_shader_compile && glMaxShaderCompilerThreadsKHR) {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+            s_ParallelCompile = true;
+        } else if (GLAD_GL_ARB_parallel_shader_compile && glMaxShaderCompilerThreadsARB) {
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+            s_ParallelCompile = true;
+        }
+    }
+
+    void ShaderLibrary::Shutdown() {
+        s_Reloads.clear();
+        s_VariantSets.clear();
+        s_Programs.clear();
+        s_IncludeDirectories.clear();
+        s_GlobalDefines.clear();
+    }
+
+    bool ShaderLibrary::SupportsParallelCompile() {
+        return s_ParallelCompile;
+    }
+
+    void ShaderLibrary::AddIncludeDirectory(const std::string& directory) {
+        s_IncludeDirectories.emplace_back(directory);
+    }
+
+    void ShaderLibrary::AddGlobalDefine(const std::string& name) {
+        if (std::find(s_GlobalDefines.begin(), s_GlobalDefines.end(), name) == s_GlobalDefines.end()) {
+            s_GlobalDefines.push_back(name);
+        }
+    }
+
+    const std::vector<std::string>& ShaderLibrary::GetGlobalDefines() {
+        return s_GlobalDefines;
+    }
+
+    std::string ShaderLibrary::Preprocess(const std::string& path, std::vector<std::string>* files) {
+        PreprocessContext context;
+        std::string output;
+        ExpandFile(path, context, output);
+        if (files) {
+            files->insert(files->end(), context.Files.begin(), context.Files.end());
+        }
+        return output;
+    }
+
+    std::string ShaderLibrary::InjectDefines(const std::string& source, const std::vector<std::string>& defines) {
+        if (defines.empty()) {
+            return source;
+        }
+
+        // #version has to stay the first directive, so the defines go on the line after it
+        size_t insertAt = 0;
+        size_t versionLine = 0;
+        size_t lineStart = 0;
+        for (size_t line = 1; lineStart < source.size(); line++) {
+            const size_t end = source.find('\n', lineStart);
+            const size_t first = source.find_first_not_of(" \t", lineStart);
+            if (first != std::string::npos && source.compare(first, 8, "#version") == 0) {
+                insertAt = end == std::string::npos ? source.size() : end + 1;
+                versionLine = line;
+                break;
+            }
+            if (end == std::string::npos) {
+                break;
+            }
+            lineStart = end + 1;
+        }
+
+        std::string block;
+        if (versionLine && insertAt == source.size() && source.back() != '\n') {
+            block += '\n';
+        }
+        for (const auto& define : defines) {
+            block += "#define " + define + " 1\n";
+        }
+        if (versionLine) {
+            block += "#line " + std::to_string(versionLine + 1) + " 0\n";
+        }
+
+        std::string result = source;
+        result.insert(insertAt, block);
+        return result;
+    }
+
+    std::shared_ptr<ShaderVariantSet> ShaderLibrary::LoadVariants(const std::string& vertexPath, const std::string& fragmentPath,
+        const std::vector<std::string>& features) {
+        if (features.size() > ShaderVariantSet::MaxFeatures) {
+            throw std::runtime_error("Too many shader features for " + vertexPath + ": " + std::to_string(features.size()));
+        }
+
+        std::string key = vertexPath + '\n' + fragmentPath;
+        for (const auto& feature : features) {
+            key += '\n' + feature;
+        }
+        auto it = s_VariantSets.find(key);
+        if (it != s_VariantSets.end()) {
+            return it->second;
+        }
+
+        auto set = std::make_shared<ShaderVariantSet>();
+        set->m_VertexPath = vertexPath;
+        set->m_FragmentPath = fragmentPath;
+        set->m_Sources = { Preprocess(vertexPath, &set->m_Files), Preprocess(fragmentPath, &set->m_Files) };
+        set->m_Features = features;
+        for (size_t i = 0; i < features.size(); i++) {
+            if (ContainsToken(set->m_Sources.Vertex, features[i]) || ContainsToken(set->m_Sources.Fragment, features[i])) {
+                set->m_UsedFeatures |= 1u << i;
+            }
+        }
+        s_VariantSets.emplace(std::move(key), set);
+        return set;
+    }
+
+    std::vector<std::shared_ptr<Shader>> ShaderLibrary::Compile(const std::vector<ShaderSources>& sources) {
+        CIRCE_PROFILE_SCOPE("ShaderLibrary::Compile");
+
+        std::vector<std::shared_ptr<Shader>> result(sources.size());
+        std::vector<uint64_t> keys(sources.size());
+        // Programs started by this call, finished only once all of them are queued
+        std::vector<size_t> pending;
+        std::unordered_map<uint64_t, size_t> batch;
+
+        s_Stats.Requested += static_cast<uint32_t>(sources.size());
+        for (size_t i = 0; i < sources.size(); i++) {
+            keys[i] = ShaderCache::ComputeKey({ sources[i].Vertex, sources[i].Fragment });
+
+            auto existing = s_Programs.find(keys[i]);
+            if (existing != s_Programs.end()) {
+                result[i] = existing->second.lock();
+                if (result[i]) {
+                    s_Stats.Deduplicated++;
+                    continue;
+                }
+                s_Programs.erase(existing);
+            }
+            auto sibling = batch.find(keys[i]);
+            if (sibling != batch.end()) {
+                result[i] = result[sibling->second];
+                s_Stats.Deduplicated++;
+                continue;
+            }
+
+            result[i].reset(new Shader(sources[i], Shader::DeferredTag{}));
+            batch.emplace(keys[i], i);
+            pending.push_back(i);
+        }
+
+        // The first status query of each program blocks until the driver thread handling it is done
+        for (size_t i : pending) {
+            result[i]->FinishCompile();
+        }
+        for (size_t i : pending) {
+            s_Programs[keys[i]] = result[i];
+            s_Stats.Compiled++;
+        }
+        return result;
+    }
+
+    std::shared_ptr<Shader> ShaderLibrary::Compile(const ShaderSources& sources) {
+        return Compile(std::vector<ShaderSources>{ sources }).front();
+    }
+
+    ShaderSources ShaderLibrary::BuildSources(ShaderOrigin& origin) {
+        origin.Files.clear();
+        const std::string vertex = Preprocess(origin.VertexPath, &origin.Files);
+        const std::string fragment = Preprocess(origin.FragmentPath, &origin.Files);
+        std::vector<std::string> defines = s_GlobalDefines;
+        defines.insert(defines.end(), origin.Defines.begin(), origin.Defines.end());
+        return { InjectDefines(vertex, defines), InjectDefines(fragment, defines) };
+    }
+
+    void ShaderLibrary::Track(Shader& shader) {
+        if (shader.m_Origin.VertexPath.empty() || !s_Tracked.insert(&shader).second) {
+            return;
+        }
+        WatchFiles(shader.m_Origin.Files);
+    }
+
+    void ShaderLibrary::Untrack(Shader& shader) {
+        if (!s_Tracked.erase(&shader)) {
+            return;
+        }
+        UnwatchFiles(shader.m_Origin.Files);
+        std::erase_if(s_Reloads, [&](const PendingReload& reload) { return reload.Target == &shader; });
+    }
+
+    void ShaderLibrary::OnFilesChanged(const std::vector<std::string>& paths) {
+        const std::unordered_set<std::string> changed(paths.begin(), paths.end());
+
+        // Permutations compiled from now on must see the new text as well
+        for (auto& [key, set] : s_VariantSets) {
+            set->m_Stale = set->m_Stale || DependsOn(set->m_Files, changed);
+        }
+
+        for (Shader* shader : s_Tracked) {
+            if (!DependsOn(shader->m_Origin.Files, changed)) {
+                continue;
+            }
+
+            // A newer edit supersedes a rebuild still in flight
+            std::erase_if(s_Reloads, [&](const PendingReload& reload) { return reload.Target == shader; });
+
+            auto job = std::make_shared<ReloadJob>();
+            job->Origin = shader->m_Origin;
+            JobSystem::RunBackground([job]() {
+                try {
+                    job->Sources = BuildSources(job->Origin);
+                } catch (const std::exception& error) {
+                    job->Error = error.what();
+                }
+                job->Done.store(true, std::memory_order_release);
+            });
+            s_Reloads.push_back({ shader, std::move(job), nullptr });
+        }
+    }
+
+    void ShaderLibrary::UpdateReloads() {
+        if (s_Reloads.empty()) {
+            return;
+        }
+        CIRCE_PROFILE_FUNCTION();
+
+        for (auto it = s_Reloads.begin(); it != s_Reloads.end();) {
+            PendingReload& reload = *it;
+            Shader& target = *reload.Target;
+            const std::string name = target.m_Origin.VertexPath + " + " + target.m_Origin.FragmentPath;
+
+            if (!reload.Replacement) {
+                if (!reload.Job->Done.load(std::memory_order_acquire)) {
+                    ++it;
+                    continue;
+                }
+                if (!reload.Job->Error.empty()) {
+                    std::cerr << "Shader reload failed, keeping the previous program (" << name << "): " << reload.Job->Error << std::endl;
+                    s_Stats.ReloadsFailed++;
+                    it = s_Reloads.erase(it);
+                    continue;
+                }
+                reload.Replacement.reset(new Shader(reload.Job->Sources, Shader::DeferredTag{}));
+            }
+
+            // Polled each frame so a slow compile never stalls one
+            if (!reload.Replacement->IsCompileComplete()) {
+                ++it;
+                continue;
+            }
+
+            try {
+                reload.Replacement->FinishCompile();
+
+                // The old sources no longer map to this program
+                auto existing = s_Programs.find(target.m_CacheKey);
+                if (existing != s_Programs.end() && existing->second.lock().get() == &target) {
+                    s_Programs.erase(existing);
+                }
+                target.SwapProgram(*reload.Replacement);
+
+                WatchFiles(reload.Job->Origin.Files);
+                UnwatchFiles(target.m_Origin.Files);
+                target.m_Origin.Files = std::move(reload.Job->Origin.Files);
+
+                std::cout << "Reloaded shader " << name << std::endl;
+                s_Stats.Reloaded++;
+            } catch (const std::exception& error) {
+                std::cerr << "Shader reload failed, keeping the previous program (" << name << "): " << error.what() << std::endl;
+                s_Stats.ReloadsFailed++;
+            }
+            it = s_Reloads.erase(it);
+        }
+    }
+
+    bool ShaderLibrary::IsReloading() {
+        return !s_Reloads.empty();
+    }
+
+    ShaderLibraryStats ShaderLibrary::GetStats() {
+        return s_Stats;
+    }
+
+    void ShaderLibrary::ResetStats() {
+        s_Stats = {};
+    }
+
+    std::shared_ptr<Shader> ShaderVariantSet::Get(uint32_t features) {
+        const uint32_t mask = GetCanonicalMask(features);
+        auto it = m_Variants.find(mask);
+        if (it != m_Variants.end()) {
+            return it->second;
+        }
+        std::shared_ptr<Shader> shader = ShaderLibrary::Compile(GetSources(mask));
+        Track(*shader, mask);
+        m_Variants.emplace(mask, shader);
+        return shader;
+    }
+
+    void ShaderVariantSet::Compile(const std::vector<uint32_t>& masks) {
+        std::vector<uint32_t> missing;
+        std::vector<ShaderSources> sources;
+        for (uint32_t features : masks) {
+            const uint32_t mask = GetCanonicalMask(features);
+            if (m_Variants.count(mask) || std::find(missing.begin(), missing.end(), mask) != missing.end()) {
+                continue;
+            }
+            missing.push_back(mask);
+            sources.push_back(GetSources(mask));
+        }
+
+        std::vector<std::shared_ptr<Shader>> shaders = ShaderLibrary::Compile(sources);
+        for (size_t i = 0; i < missing.size(); i++) {
+            Track(*shaders[i], missing[i]);
+            m_Variants.emplace(missing[i], std::move(shaders[i]));
+        }
+    }
+
+    void ShaderVariantSet::CompileAll() {
+        // Walk the subsets of the used-feature mask
+        std::vector<uint32_t> masks;
+        uint32_t subset = 0;
+        do {
+            masks.push_back(subset);
+            subset = (subset - m_UsedFeatures) & m_UsedFeatures;
+        } while (subset != 0);
+        Compile(masks);
+    }
+
+    uint32_t ShaderVariantSet::GetFeatureMask(std::string_view name) const {
+        for (size_t i = 0; i < m_Features.size(); i++) {
+            if (m_Features[i] == name) {
+                return 1u << i;
+            }
+        }
+        return 0;
+    }
+
+    std::vector<std::string> ShaderVariantSet::GetDefines(uint32_t canonicalMask) const {
+        std::vector<std::string> defines;
+        for (size_t i = 0; i < m_Features.size(); i++) {
+            if (canonicalMask & (1u << i)) {
+                defines.push_back(m_Features[i]);
+            }
+        }
+        return defines;
+    }
+
+    ShaderSources ShaderVariantSet::GetSources(uint32_t canonicalMask) {
+        // The used-feature mask stays as loaded, features first referenced by an edit need a restart
+        if (m_Stale) {
+            std::vector<std::string> files;
+            m_Sources = { ShaderLibrary::Preprocess(m_VertexPath, &files), ShaderLibrary::Preprocess(m_FragmentPath, &files) };
+            m_Files = std::move(files);
+            m_Stale = false;
+        }
+        std::vector<std::string> defines = ShaderLibrary::GetGlobalDefines();
+        const std::vector<std::string> features = GetDefines(canonicalMask);
+        defines.insert(defines.end(), features.begin(), features.end());
+        return { ShaderLibrary::InjectDefines(m_Sources.Vertex, defines), ShaderLibrary::InjectDefines(m_Sources.Fragment, defines) };
+    }
+
+    void ShaderVariantSet::Track(Shader& shader, uint32_t canonicalMask) const {
+        // Deduplicated programs keep the origin they were first built with
+        if (!shader.m_Origin.VertexPath.empty()) {
+            return;
+        }
+        shader.m_Origin.VertexPath = m_VertexPath;
+        shader.m_Origin.FragmentPath = m_FragmentPath;
+        shader.m_Origin.Defines = GetDefines(canonicalMask);
+        shader.m_Origin.Files = m_Files;
+        ShaderLibrary::Track(shader);
+    }
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Renderer/Shader.h"
+
+namespace Circe {
+
+    struct ShaderLibraryStats {
+        // Programs asked for, through variant sets or Compile()
+        uint32_t Requested = 0;
+        // Programs actually built (compiled, or restored from the ShaderCache)
+        uint32_t Compiled = 0;
+        // Requests answered by an existing program with identical final sources
+        uint32_t Deduplicated = 0;
+        // Hot reloads swapped in, and those that failed and kept the previous program
+        uint32_t Reloaded = 0;
+        uint32_t ReloadsFailed = 0;
+    };
+
+    // Permutations of one vertex/fragment pair, selected by a bitmask of feature defines.
+    // Bit i of a mask enables "#define Features[i] 1". Features a source never mentions
+    // are dropped from the mask, so masks that differ only in those share a program.
+    class ShaderVariantSet {
+    public:
+        static constexpr size_t MaxFeatures = 32;
+
+        // Compiled lazily on first use, throws std::runtime_error when the program fails to build
+        std::shared_ptr<Shader> Get(uint32_t features);
+        // Builds every listed permutation in one parallel batch
+        void Compile(const std::vector<uint32_t>& masks);
+        // Every combination of the used features, 2^n programs
+        void CompileAll();
+
+        const std::vector<std::string>& GetFeatures() const { return m_Features; }
+        // Bit for the named feature, 0 when the set has no such feature
+        uint32_t GetFeatureMask(std::string_view name) const;
+        // Features referenced by the sources; bits outside this mask have no effect
+        uint32_t GetUsedFeatures() const { return m_UsedFeatures; }
+        uint32_t GetCanonicalMask(uint32_t features) const { return features & m_UsedFeatures; }
+        size_t GetVariantCount() const { return m_Variants.size(); }
+
+    private:
+        friend class ShaderLibrary;
+
+        // Re-reads the files first when one of them changed since they were preprocessed
+        ShaderSources GetSources(uint32_t canonicalMask);
+        std::vector<std::string> GetDefines(uint32_t canonicalMask) const;
+        // Gives a freshly built program its origin so it takes part in hot reload
+        void Track(Shader& shader, uint32_t canonicalMask) const;
+
+        std::string m_VertexPath;
+        std::string m_FragmentPath;
+        std::vector<std::string> m_Files;
+        bool m_Stale = false;
+        ShaderSources m_Sources;
+        std::vector<std::string> m_Features;
+        uint32_t m_UsedFeatures = 0;
+        std::unordered_map<uint32_t, std::shared_ptr<Shader>> m_Variants;
+    };
+
+    // Shader front end: #include resolution, define injection, permutation deduplication and
+    // batched compilation on the driver's compiler threads when GL_KHR_parallel_shader_compile
+    // (or the ARB version) is exposed.
+    class ShaderLibrary {
+    public:
+        // GL thread, after the context exists
+        static void Initialize();
+        // Drops every cached program, call while the context is still alive
+        static void Shutdown();
+
+        static bool SupportsParallelCompile();
+
+        // Searched after the including file's own directory
+        static void AddIncludeDirectory(const std::string& directory);
+        // Defined in every program built from files afterwards, ahead of the variant features
+        // (e.g. CIRCE_BINDLESS). Set these before loading shaders.
+        static void AddGlobalDefine(const std::string& name);
+        static const std::vector<std::string>& GetGlobalDefines();
+
+        // Reads the file and splices in #include "file" directives recursively. Each file is
+        // included at most once per source; "#line" directives keep compiler messages pointing
+        // at the right line. Throws std::runtime_error on unreadable files or missing includes.
+        // Every file read is appended to files when given. Safe to call from any thread.
+        static std::string Preprocess(const std::string& path, std::vector<std::string>* files = nullptr);
+        // Inserts "#define NAME 1" lines right after the #version directive
+        static std::string InjectDefines(const std::string& source, const std::vector<std::string>& defines);
+
+        // Same feature list and paths return the same set
+        static std::shared_ptr<ShaderVariantSet> LoadVariants(const std::string& vertexPath, const std::string& fragmentPath,
+            const std::vector<std::string>& features);
+
+        // Issues every compile and link before waiting on any of them. Identical sources share
+        // one program, also with programs built by earlier calls that are still alive.
+        static std::vector<std::shared_ptr<Shader>> Compile(const std::vector<ShaderSources>& sources);
+        static std::shared_ptr<Shader> Compile(const ShaderSources& sources);
+
+        // Preprocesses both stages of the origin and injects its defines; fills origin.Files
+        static ShaderSources BuildSources(ShaderOrigin& origin);
+
+        // Registers a program built from files for hot reload and watches those files.
+        // Shader calls these itself; programs without an origin are ignored.
+        static void Track(Shader& shader);
+        static void Untrack(Shader& shader);
+
+        // GL thread. Rebuilds tracked programs that depend on any of the paths: sources are
+        // read on a background job, then compiled without blocking the frame.
+        static void OnFilesChanged(const std::vector<std::string>& paths);
+        // GL thread, once per frame before drawing. Swaps finished rebuilds into their Shader
+        // objects, so every holder sees the new program; a failed build keeps the old one.
+        static void UpdateReloads();
+        static bool IsReloading();
+
+        static ShaderLibraryStats GetStats();
+        static void ResetStats();
+    };
+
+}
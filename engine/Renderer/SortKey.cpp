@@ -0,0 +1,89 @@
+#include "SortKey.h"
+#include <array>
+#include <bit>
+#include <cmath>
+
+namespace Circe {
+
+    namespace SortKey {
+
+        uint32_t QuantizeDepth(float distance) {
+            if (!(distance > 0.0f)) {
+                return 0;
+            }
+            if (std::isinf(distance)) {
+                return (1u << DepthBits) - 1;
+            }
+            // Sign bit is always clear here, keep exponent and the leading mantissa bits
+            uint32_t bits = std::bit_cast<uint32_t>(distance);
+            return (bits >> (31 - DepthBits)) & ((1u << DepthBits) - 1);
+        }
+
+        uint64_t Make(RenderPass pass, uint32_t shader, uint32_t material, uint32_t mesh, float distance) {
+            const uint64_t shaderField = shader & ((1ull << ShaderBits) - 1);
+            const uint64_t materialField = material & ((1ull << MaterialBits) - 1);
+            const uint64_t meshField = mesh & ((1ull << MeshBits) - 1);
+            const uint64_t depthField = QuantizeDepth(distance);
+
+            uint64_t key = static_cast<uint64_t>(pass) << 62;
+            if (pass == RenderPass::Transparent) {
+                const uint64_t farFirst = ~depthField & ((1ull << DepthBits) - 1);
+                key |= farFirst << 44;
+                key |= shaderField << 32;
+                key |= materialField << 16;
+                key |= meshField;
+            } else {
+                key |= shaderField << 50;
+                key |= materialField << 34;
+                key |= meshField << 18;
+                key |= depthField;
+            }
+            return key;
+        }
+
+    }
+
+    void RadixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch) {
+        const size_t count = items.size();
+        if (count < 2) {
+            return;
+        }
+        scratch.resize(count);
+
+        // One pass over the data builds all eight byte histograms
+        std::array<std::array<uint32_t, 256>, 8> histograms{};
+        for (const SortItem& item : items) {
+            for (int pass = 0; pass < 8; ++pass) {
+                histograms[pass][(item.key >> (pass * 8)) & 0xFF]++;
+            }
+        }
+
+        SortItem* src = items.data();
+        SortItem* dst = scratch.data();
+        for (int pass = 0; pass < 8; ++pass) {
+            auto& histogram = histograms[pass];
+
+            // Every key has the same byte here, the pass would be an identity permutation
+            if (histogram[(src[0].key >> (pass * 8)) & 0xFF] == count) {
+                continue;
+            }
+
+            uint32_t offset = 0;
+            for (uint32_t& bucket : histogram) {
+                uint32_t bucketCount = bucket;
+                bucket = offset;
+                offset += bucketCount;
+            }
+
+            for (size_t i = 0; i < count; ++i) {
+                dst[histogram[(src[i].key >> (pass * 8)) & 0xFF]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+
+        if (src != items.data()) {
+            items.swap(scratch);
+        }
+    }
+
+}
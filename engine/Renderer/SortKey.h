@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Circe {
+
+    enum class RenderPass : uint8_t {
+        Opaque = 0,
+        Transparent = 1
+    };
+
+    // 64-bit draw sort key. Opaque draws are grouped by shader, material and mesh and
+    // then ordered front to back; transparent draws are ordered back to front first.
+    //   opaque:      [63:62] pass | [61:50] shader | [49:34] material | [33:18] mesh | [17:0] depth
+    //   transparent: [63:62] pass | [61:44] ~depth | [43:32] shader   | [31:16] material | [15:0] mesh
+    namespace SortKey {
+
+        constexpr uint64_t ShaderBits = 12;
+        constexpr uint64_t MaterialBits = 16;
+        constexpr uint64_t MeshBits = 16;
+        constexpr uint64_t DepthBits = 18;
+
+        // Quantizes a non-negative distance keeping its ordering (IEEE exponent + top mantissa bits)
+        uint32_t QuantizeDepth(float distance);
+
+        uint64_t Make(RenderPass pass, uint32_t shader, uint32_t material, uint32_t mesh, float distance);
+
+        inline RenderPass GetPass(uint64_t key) { return static_cast<RenderPass>(key >> 62); }
+
+    }
+
+    struct SortItem {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    // Stable LSD radix sort on SortItem::key, byte passes shared by every key are skipped
+    void RadixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch);
+
+}
@@ -1,17 +1,114 @@
 #include "Texture.h"
+#include "Ktx2.h"
+#include "../Core/Profiling/Profiler.h"
 #include <glad/glad.h>
 #include <stb_image.h>
 #include <stdexcept>
 
 namespace Circe {
 
+    namespace {
+
+        // Linear flavors even for sRGB data: the renderer outputs to a non-sRGB framebuffer and
+        // treats texel values as display values, as it does for uncompressed textures
+        GLenum GetInternalFormat(TextureFormat format) {
+            switch (format) {
+                case TextureFormat::BC1: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+                case TextureFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                case TextureFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+                case TextureFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+                case TextureFormat::RGBA8: break;
+            }
+            return GL_RGBA8;
+        }
+
+    }
+
     Texture::Texture(const std::string& path) {
+        CIRCE_PROFILE_SCOPE("Texture::Load");
+        if (Ktx2::IsKtx2Path(path)) {
+            TextureImage image = Ktx2::Read(path);
+            if (!SupportsFormat(image.Format)) {
+                image = TextureCompression::Decompress(image);
+            }
+            Recreate();
+            Upload(image, image.Data.data());
+            return;
+        }
+
         int nrChannels;
         unsigned char* data = stbi_load(path.c_str(), &m_Width, &m_Height, &nrChannels, 0);
         if (!data) {
             throw std::runtime_error("Failed to load texture: " + path);
         }
 
+        // Determine format
+        GLenum format = GL_RGB;
+        if (nrChannels == 1) format = GL_RED;
+        else if (nrChannels == 3) format = GL_RGB;
+        else if (nrChannels == 4) format = GL_RGBA;
+
+        Create(m_Width, m_Height, format, data);
+        stbi_image_free(data);
+    }
+
+    Texture::Texture(int width, int height, const unsigned char* pixels) {
+        Create(width, height, GL_RGBA, pixels);
+    }
+
+    Texture::Texture(const TextureImage& image) {
+        Recreate();
+        if (SupportsFormat(image.Format)) {
+            Upload(image, image.Data.data());
+        } else {
+            const TextureImage decoded = TextureCompression::Decompress(image);
+            Upload(decoded, decoded.Data.data());
+        }
+    }
+
+    void Texture::Create(int width, int height, unsigned int format, const void* pixels) {
+        m_Width = width;
+        m_Height = height;
+        m_BytesPerPixel = format == GL_RED ? 1 : format == GL_RGB ? 3 : 4;
+        m_Format = TextureFormat::RGBA8;
+        m_LevelCount = 0;
+
+        Recreate();
+
+        // Rows of 1 and 3 channel images are not 4-byte aligned
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    void Texture::Upload(const TextureImage& image, const unsigned char* data) {
+        CIRCE_PROFILE_FUNCTION();
+        const GLenum internalFormat = GetInternalFormat(image.Format);
+        const int levelCount = static_cast<int>(image.Levels.size());
+
+        glBindTexture(GL_TEXTURE_2D, m_ID);
+        // Cooked chains may stop short of 1x1; sampling must not reach past the last level
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        for (int i = 0; i < levelCount; i++) {
+            const TextureLevel& level = image.Levels[i];
+            const unsigned char* source = data ? data + level.Offset : reinterpret_cast<const unsigned char*>(level.Offset);
+            if (TextureCompression::IsCompressed(image.Format)) {
+                glCompressedTexImage2D(GL_TEXTURE_2D, i, internalFormat, level.Width, level.Height, 0, static_cast<GLsizei>(level.Size), source);
+            } else {
+                glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, level.Width, level.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, source);
+            }
+        }
+
+        m_Width = image.Width;
+        m_Height = image.Height;
+        m_BytesPerPixel = 4;
+        m_Format = image.Format;
+        m_LevelCount = levelCount;
+    }
+
+    void Texture::Recreate() {
+        Destroy();
         glGenTextures(1, &m_ID);
         glBindTexture(GL_TEXTURE_2D, m_ID);
 
@@ -20,23 +117,68 @@ namespace Circe {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
 
-        // Determine format
-        GLenum format = GL_RGB;
-        if (nrChannels == 1) format = GL_RED;
-        else if (nrChannels == 3) format = GL_RGB;
-        else if (nrChannels == 4) format = GL_RGBA;
+    void Texture::Destroy() {
+        if (m_BindlessHandle) {
+            glMakeTextureHandleNonResidentARB(m_BindlessHandle);
+            m_BindlessHandle = 0;
+        }
+        if (m_ID) {
+            glDeleteTextures(1, &m_ID);
+            m_ID = 0;
+        }
+    }
 
-        glTexImage2D(GL_TEXTURE_2D, 0, format, m_Width, m_Height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+    Texture::~Texture() {
+        Destroy();
+    }
 
-        stbi_image_free(data);
+    bool Texture::SupportsBindless() {
+        return GLAD_GL_ARB_bindless_texture && glGetTextureHandleARB && glMakeTextureHandleResidentARB;
     }
 
-    Texture::~Texture() {
-        if (m_ID) {
-            glDeleteTextures(1, &m_ID);
+    uint64_t Texture::GetBindlessHandle() {
+        if (!m_BindlessHandle && m_ID && SupportsBindless()) {
+            m_BindlessHandle = glGetTextureHandleARB(m_ID);
+            glMakeTextureHandleResidentARB(m_BindlessHandle);
+        }
+        return m_BindlessHandle;
+    }
+
+    bool Texture::SupportsFormat(TextureFormat format) {
+        switch (format) {
+            case TextureFormat::BC1:
+            case TextureFormat::BC3:
+                return GLAD_GL_EXT_texture_compression_s3tc != 0;
+            case TextureFormat::BC7:
+                return GLAD_GL_VERSION_4_2 || GLAD_GL_ARB_texture_compression_bptc;
+            case TextureFormat::BC5:
+            case TextureFormat::RGBA8:
+                break;
+        }
+        // RGTC is core since GL 3.0
+        return true;
+    }
+
+    size_t Texture::GetMemorySize() const {
+        size_t size = 0;
+        int width = m_Width;
+        int height = m_Height;
+        for (int level = 0; width > 0 && height > 0; level++) {
+            if (m_LevelCount > 0 && level == m_LevelCount) {
+                break;
+            }
+            size += TextureCompression::IsCompressed(m_Format)
+                ? TextureCompression::GetLevelSize(m_Format, width, height)
+                : static_cast<size_t>(width) * height * m_BytesPerPixel;
+            if (width == 1 && height == 1) {
+                break;
+            }
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
         }
+        return size;
     }
 
     void Texture::Bind(int unit) const {
@@ -1,25 +1,66 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include "Renderer/ResourcePool.h"
+#include "Renderer/TextureCompression.h"
 
 namespace Circe {
 
-    class Texture {
+    class Texture : public PooledResource<Texture> {
     public:
+        // .ktx2 files are uploaded as stored, other formats are decoded and mipmapped at runtime
         Texture(const std::string& path);
+        // RGBA8 pixels, rows bottom first
+        Texture(int width, int height, const unsigned char* pixels);
+        // Precomputed mip chain, compressed levels go up as is. Decoded to RGBA8 first when the
+        // driver lacks the format.
+        explicit Texture(const TextureImage& image);
         ~Texture();
 
         void Bind(int unit = 0) const;
         void Unbind() const;
 
         unsigned int GetID() const { return m_ID; }
+
+        // ARB_bindless_texture: handle of the texture, created and made resident on first use.
+        // A texture with a handle is immutable, so re-uploads go to a fresh GL name and the
+        // handle changes with it. 0 without the extension.
+        static bool SupportsBindless();
+        uint64_t GetBindlessHandle();
+        static bool SupportsFormat(TextureFormat format);
+        TextureFormat GetFormat() const { return m_Format; }
         int GetWidth() const { return m_Width; }
         int GetHeight() const { return m_Height; }
+        // False while an async load still shows the placeholder image, or a reload the old one
+        bool IsReady() const { return m_Ready; }
+        // An async load whose file could not be decoded; the texture keeps showing the checker
+        bool IsLoadFailed() const { return m_LoadFailed; }
+        // Every level the texture has, compressed sizes for compressed formats
+        size_t GetMemorySize() const;
 
     private:
+        friend class TextureLoader;
+
+        void Create(int width, int height, unsigned int format, const void* pixels);
+        // Specifies every level of the image on the current GL name. With data null the levels
+        // are read from the bound pixel unpack buffer at their offsets.
+        void Upload(const TextureImage& image, const unsigned char* data);
+        // New GL name with the default sampling state; drops the bindless handle
+        void Recreate();
+        void Destroy();
+
         unsigned int m_ID = 0;
+        uint64_t m_BindlessHandle = 0;
         int m_Width = 0;
         int m_Height = 0;
+        int m_BytesPerPixel = 4;
+        TextureFormat m_Format = TextureFormat::RGBA8;
+        // 0 for a full chain generated by the driver
+        int m_LevelCount = 0;
+        bool m_Ready = true;
+        bool m_LoadFailed = false;
     };
 
 }
@@ -0,0 +1,956 @@
+#include "TextureCompression.h"
+#include "../Core/Jobs/JobSystem.h"
+#include "../Core/Profiling/Profiler.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define CIRCE_TEXTURE_SSE2 1
+#endif
+
+namespace Circe::TextureCompression {
+
+    namespace {
+
+        // Block texels as floats, one array per channel, so four texels fill an SSE register
+        struct BlockTexels {
+            alignas(16) float Channels[4][16];
+        };
+
+        // BC7 4-bit index weights, out of 64
+        constexpr int BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        void LoadBlock(const unsigned char* texels, BlockTexels& block) {
+            for (int i = 0; i < 16; i++) {
+                for (int c = 0; c < 4; c++) {
+                    block.Channels[c][i] = texels[i * 4 + c];
+                }
+            }
+        }
+
+        // Position of every texel along start->end, clamped to the segment, scaled to [0, steps]
+        // and rounded. Interpolated palettes are evenly spaced along that segment, so the step is
+        // the nearest palette entry.
+        void ProjectTexels(const float* const* channels, int channelCount, const float* start, const float* end, float steps, int* result) {
+            float direction[4] = {};
+            float lengthSquared = 0.0f;
+            for (int c = 0; c < channelCount; c++) {
+                direction[c] = end[c] - start[c];
+                lengthSquared += direction[c] * direction[c];
+            }
+            if (lengthSquared <= 0.0f) {
+                std::fill(result, result + 16, 0);
+                return;
+            }
+            const float scale = steps / lengthSquared;
+
+#if defined(CIRCE_TEXTURE_SSE2)
+            for (int i = 0; i < 16; i += 4) {
+                __m128 dot = _mm_setzero_ps();
+                for (int c = 0; c < channelCount; c++) {
+                    const __m128 offset = _mm_sub_ps(_mm_loadu_ps(channels[c] + i), _mm_set1_ps(start[c]));
+                    dot = _mm_add_ps(dot, _mm_mul_ps(offset, _mm_set1_ps(direction[c])));
+                }
+                __m128 t = _mm_mul_ps(dot, _mm_set1_ps(scale));
+                t = _mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), _mm_set1_ps(steps));
+                // Round to nearest even, as nearbyint does in the default rounding mode
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), _mm_cvtps_epi32(t));
+            }
+#else
+            for (int i = 0; i < 16; i++) {
+                float dot = 0.0f;
+                for (int c = 0; c < channelCount; c++) {
+                    dot += (channels[c][i] - start[c]) * direction[c];
+                }
+                const float t = std::min(std::max(dot * scale, 0.0f), steps);
+                result[i] = static_cast<int>(std::nearbyint(t));
+            }
+#endif
+        }
+
+        // Mean and dominant direction of the weighted texels, by power iteration on the covariance.
+        // The axis is zero when the texels are all the same.
+        void PrincipalAxis(const BlockTexels& block, int channelCount, const float* weights, float* mean, float* axis) {
+            float total = 0.0f;
+            for (int c = 0; c < channelCount; c++) {
+                mean[c] = 0.0f;
+                axis[c] = 0.0f;
+            }
+            for (int i = 0; i < 16; i++) {
+                const float weight = weights ? weights[i] : 1.0f;
+                total += weight;
+                for (int c = 0; c < channelCount; c++) {
+                    mean[c] += block.Channels[c][i] * weight;
+                }
+            }
+            if (total <= 0.0f) {
+                return;
+            }
+            for (int c = 0; c < channelCount; c++) {
+                mean[c] /= total;
+            }
+
+            float covariance[4][4] = {};
+            for (int i = 0; i < 16; i++) {
+                const float weight = weights ? weights[i] : 1.0f;
+                for (int a = 0; a < channelCount; a++) {
+                    const float da = block.Channels[a][i] - mean[a];
+                    for (int b = a; b < channelCount; b++) {
+                        covariance[a][b] += da * (block.Channels[b][i] - mean[b]) * weight;
+                    }
+                }
+            }
+            for (int a = 0; a < channelCount; a++) {
+                for (int b = 0; b < a; b++) {
+                    covariance[a][b] = covariance[b][a];
+                }
+            }
+
+            // Start from the covariance row of the widest channel, which leans towards the principal axis
+            int widest = 0;
+            for (int c = 1; c < channelCount; c++) {
+                if (covariance[c][c] > covariance[widest][widest]) {
+                    widest = c;
+                }
+            }
+            if (covariance[widest][widest] <= 1e-6f) {
+                return;
+            }
+            float vector[4] = {};
+            for (int c = 0; c < channelCount; c++) {
+                vector[c] = covariance[widest][c];
+            }
+            for (int iteration = 0; iteration < 8; iteration++) {
+                float next[4] = {};
+                float length = 0.0f;
+                for (int a = 0; a < channelCount; a++) {
+                    for (int b = 0; b < channelCount; b++) {
+                        next[a] += covariance[a][b] * vector[b];
+                    }
+                    length += next[a] * next[a];
+                }
+                if (length <= 0.0f) {
+                    return;
+                }
+                const float inverse = 1.0f / std::sqrt(length);
+                for (int c = 0; c < channelCount; c++) {
+                    vector[c] = next[c] * inverse;
+                }
+            }
+            for (int c = 0; c < channelCount; c++) {
+                axis[c] = vector[c];
+            }
+        }
+
+        // Extremes of the weighted texels along the principal axis
+        void FindEndpoints(const BlockTexels& block, int channelCount, const float* weights, float* start, float* end) {
+            float mean[4];
+            float axis[4];
+            PrincipalAxis(block, channelCount, weights, mean, axis);
+
+            float low = std::numeric_limits<float>::max();
+            float high = std::numeric_limits<float>::lowest();
+            for (int i = 0; i < 16; i++) {
+                if (weights && weights[i] <= 0.0f) {
+                    continue;
+                }
+                float dot = 0.0f;
+                for (int c = 0; c < channelCount; c++) {
+                    dot += (block.Channels[c][i] - mean[c]) * axis[c];
+                }
+                low = std::min(low, dot);
+                high = std::max(high, dot);
+            }
+            if (low > high) {
+                low = high = 0.0f;
+            }
+            for (int c = 0; c < channelCount; c++) {
+                start[c] = std::clamp(mean[c] + axis[c] * low, 0.0f, 255.0f);
+                end[c] = std::clamp(mean[c] + axis[c] * high, 0.0f, 255.0f);
+            }
+        }
+
+        // Endpoints minimising the squared error for fixed interpolation fractions,
+        // texel ~ start + (end - start) * fraction. False when the fractions are degenerate.
+        bool FitEndpoints(const BlockTexels& block, int channelCount, const float* fractions, const float* weights, float* start, float* end) {
+            float aa = 0.0f;
+            float bb = 0.0f;
+            float ab = 0.0f;
+            float ax[4] = {};
+            float bx[4] = {};
+            for (int i = 0; i < 16; i++) {
+                const float weight = weights ? weights[i] : 1.0f;
+                const float b = fractions[i];
+                const float a = 1.0f - b;
+                aa += a * a * weight;
+                bb += b * b * weight;
+                ab += a * b * weight;
+                for (int c = 0; c < channelCount; c++) {
+                    ax[c] += a * block.Channels[c][i] * weight;
+                    bx[c] += b * block.Channels[c][i] * weight;
+                }
+            }
+            const float determinant = aa * bb - ab * ab;
+            if (std::fabs(determinant) < 1e-6f) {
+                return false;
+            }
+            const float inverse = 1.0f / determinant;
+            for (int c = 0; c < channelCount; c++) {
+                start[c] = std::clamp((ax[c] * bb - bx[c] * ab) * inverse, 0.0f, 255.0f);
+                end[c] = std::clamp((bx[c] * aa - ax[c] * ab) * inverse, 0.0f, 255.0f);
+            }
+            return true;
+        }
+
+        uint32_t BlockError(const unsigned char* reference, const unsigned char* texels, int channelCount, const bool* skip = nullptr) {
+            uint32_t error = 0;
+            for (int i = 0; i < 16; i++) {
+                if (skip && skip[i]) {
+                    continue;
+                }
+                for (int c = 0; c < channelCount; c++) {
+                    const int difference = static_cast<int>(reference[i * 4 + c]) - texels[i * 4 + c];
+                    error += static_cast<uint32_t>(difference * difference);
+                }
+            }
+            return error;
+        }
+
+        class BitWriter {
+        public:
+            explicit BitWriter(unsigned char* data, size_t size) : m_Data(data) { std::memset(data, 0, size); }
+
+            void Write(uint32_t value, int bits) {
+                for (int i = 0; i < bits; i++, m_Position++) {
+                    if ((value >> i) & 1u) {
+                        m_Data[m_Position >> 3] |= static_cast<unsigned char>(1u << (m_Position & 7));
+                    }
+                }
+            }
+
+        private:
+            unsigned char* m_Data;
+            int m_Position = 0;
+        };
+
+        class BitReader {
+        public:
+            explicit BitReader(const unsigned char* data) : m_Data(data) {}
+
+            uint32_t Read(int bits) {
+                uint32_t value = 0;
+                for (int i = 0; i < bits; i++, m_Position++) {
+                    value |= static_cast<uint32_t>((m_Data[m_Position >> 3] >> (m_Position & 7)) & 1u) << i;
+                }
+                return value;
+            }
+
+        private:
+            const unsigned char* m_Data;
+            int m_Position = 0;
+        };
+
+        // BC1 color block (also the color half of BC3)
+
+        uint16_t To565(const float* color) {
+            const uint32_t r = static_cast<uint32_t>(std::lround(color[0] * 31.0f / 255.0f));
+            const uint32_t g = static_cast<uint32_t>(std::lround(color[1] * 63.0f / 255.0f));
+            const uint32_t b = static_cast<uint32_t>(std::lround(color[2] * 31.0f / 255.0f));
+            return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+        }
+
+        void From565(uint16_t packed, int* color) {
+            const int r = (packed >> 11) & 31;
+            const int g = (packed >> 5) & 63;
+            const int b = packed & 31;
+            color[0] = (r << 3) | (r >> 2);
+            color[1] = (g << 2) | (g >> 4);
+            color[2] = (b << 3) | (b >> 2);
+        }
+
+        // BC3 color is always decoded in 4-color mode, BC1 picks the mode from the endpoint order
+        void DecodeColor(const unsigned char* block, unsigned char* texels, bool allowThreeColor) {
+            const uint16_t c0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+            const uint16_t c1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+            int palette[4][4];
+            From565(c0, palette[0]);
+            From565(c1, palette[1]);
+            palette[0][3] = palette[1][3] = 255;
+            if (c0 > c1 || !allowThreeColor) {
+                for (int c = 0; c < 3; c++) {
+                    palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+                    palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+                }
+                palette[2][3] = palette[3][3] = 255;
+            } else {
+                for (int c = 0; c < 3; c++) {
+                    palette[2][c] = (palette[0][c] + palette[1][c] + 1) / 2;
+                    palette[3][c] = 0;
+                }
+                palette[2][3] = 255;
+                palette[3][3] = 0;
+            }
+
+            const uint32_t indices = static_cast<uint32_t>(block[4] | (block[5] << 8) | (block[6] << 16)) | (static_cast<uint32_t>(block[7]) << 24);
+            for (int i = 0; i < 16; i++) {
+                const int index = (indices >> (i * 2)) & 3;
+                for (int c = 0; c < 4; c++) {
+                    texels[i * 4 + c] = static_cast<unsigned char>(palette[index][c]);
+                }
+            }
+        }
+
+        // Steps run from c0 to c1; the palette order interleaves them
+        void WriteColor(uint16_t c0, uint16_t c1, const int* steps, const bool* transparent, bool threeColor, unsigned char* block) {
+            constexpr int FourColorIndex[4] = { 0, 2, 3, 1 };
+            constexpr int ThreeColorIndex[3] = { 0, 2, 1 };
+            const int maxStep = threeColor ? 2 : 3;
+            // 4-color mode needs c0 > c1 and 3-color mode c0 <= c1, reversing the steps when swapping
+            const bool swap = threeColor ? c0 > c1 : c0 < c1;
+            if (swap) {
+                std::swap(c0, c1);
+            }
+
+            uint32_t indices = 0;
+            for (int i = 0; i < 16; i++) {
+                int index = 0;
+                if (transparent && transparent[i]) {
+                    index = 3;
+                } else if (c0 != c1 || threeColor) {
+                    const int step = swap ? maxStep - steps[i] : steps[i];
+                    index = threeColor ? ThreeColorIndex[step] : FourColorIndex[step];
+                }
+                indices |= static_cast<uint32_t>(index) << (i * 2);
+            }
+            block[0] = static_cast<unsigned char>(c0);
+            block[1] = static_cast<unsigned char>(c0 >> 8);
+            block[2] = static_cast<unsigned char>(c1);
+            block[3] = static_cast<unsigned char>(c1 >> 8);
+            for (int i = 0; i < 4; i++) {
+                block[4 + i] = static_cast<unsigned char>(indices >> (i * 8));
+            }
+        }
+
+        void EncodeColor(const unsigned char* texels, bool allowTransparent, unsigned char* block) {
+            BlockTexels source;
+            LoadBlock(texels, source);
+
+            float weights[16];
+            bool transparent[16];
+            bool anyTransparent = false;
+            bool anyOpaque = false;
+            for (int i = 0; i < 16; i++) {
+                transparent[i] = allowTransparent && texels[i * 4 + 3] < 128;
+                weights[i] = transparent[i] ? 0.0f : 1.0f;
+                anyTransparent |= transparent[i];
+                anyOpaque |= !transparent[i];
+            }
+            if (!anyOpaque) {
+                const int steps[16] = {};
+                WriteColor(0, 0, steps, transparent, true, block);
+                return;
+            }
+
+            const bool threeColor = anyTransparent;
+            const float maxStep = threeColor ? 2.0f : 3.0f;
+            const float* channels[3] = { source.Channels[0], source.Channels[1], source.Channels[2] };
+            float start[3];
+            float end[3];
+            FindEndpoints(source, 3, weights, start, end);
+
+            uint32_t bestError = std::numeric_limits<uint32_t>::max();
+            unsigned char candidate[8];
+            unsigned char decoded[64];
+            for (int iteration = 0; iteration < 2; iteration++) {
+                const uint16_t c0 = To565(start);
+                const uint16_t c1 = To565(end);
+                int quantized[2][3];
+                From565(c0, quantized[0]);
+                From565(c1, quantized[1]);
+                const float from[3] = { float(quantized[0][0]), float(quantized[0][1]), float(quantized[0][2]) };
+                const float to[3] = { float(quantized[1][0]), float(quantized[1][1]), float(quantized[1][2]) };
+
+                int steps[16];
+                ProjectTexels(channels, 3, from, to, maxStep, steps);
+                WriteColor(c0, c1, steps, transparent, threeColor, candidate);
+                DecodeColor(candidate, decoded, allowTransparent);
+                const uint32_t error = BlockError(texels, decoded, 3, transparent);
+                if (error < bestError) {
+                    bestError = error;
+                    std::memcpy(block, candidate, sizeof(candidate));
+                }
+                if (error == 0) {
+                    break;
+                }
+
+                float fractions[16];
+                for (int i = 0; i < 16; i++) {
+                    fractions[i] = static_cast<float>(steps[i]) / maxStep;
+                }
+                if (!FitEndpoints(source, 3, fractions, weights, start, end)) {
+                    break;
+                }
+            }
+        }
+
+        // BC4 channel block (BC3 alpha, BC5 red and green)
+
+        void EncodeChannel(const unsigned char* texels, int channel, unsigned char* block) {
+            float values[16];
+            float low = 255.0f;
+            float high = 0.0f;
+            for (int i = 0; i < 16; i++) {
+                values[i] = texels[i * 4 + channel];
+                low = std::min(low, values[i]);
+                high = std::max(high, values[i]);
+            }
+
+            // 8-value mode (a0 > a1); steps run from a1 up to a0
+            block[0] = static_cast<unsigned char>(high);
+            block[1] = static_cast<unsigned char>(low);
+            uint64_t indices = 0;
+            if (high > low) {
+                int steps[16];
+                const float* channels[1] = { values };
+                ProjectTexels(channels, 1, &low, &high, 7.0f, steps);
+                for (int i = 0; i < 16; i++) {
+                    const int step = steps[i];
+                    const uint64_t index = step == 7 ? 0 : step == 0 ? 1 : static_cast<uint64_t>(8 - step);
+                    indices |= index << (i * 3);
+                }
+            }
+            for (int i = 0; i < 6; i++) {
+                block[2 + i] = static_cast<unsigned char>(indices >> (i * 8));
+            }
+        }
+
+        void DecodeChannel(const unsigned char* block, unsigned char* texels, int channel) {
+            const int a0 = block[0];
+            const int a1 = block[1];
+            int palette[8] = { a0, a1 };
+            if (a0 > a1) {
+                for (int i = 2; i < 8; i++) {
+                    palette[i] = ((8 - i) * a0 + (i - 1) * a1 + 3) / 7;
+                }
+            } else {
+                for (int i = 2; i < 6; i++) {
+                    palette[i] = ((6 - i) * a0 + (i - 1) * a1 + 2) / 5;
+                }
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+
+            uint64_t indices = 0;
+            for (int i = 0; i < 6; i++) {
+                indices |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+            }
+            for (int i = 0; i < 16; i++) {
+                texels[i * 4 + channel] = static_cast<unsigned char>(palette[(indices >> (i * 3)) & 7]);
+            }
+        }
+
+        // BC7 mode 6
+
+        // 7 bits per channel plus one shared low bit per endpoint, picked for the smaller error
+        void QuantizeBC7Endpoint(const float* color, uint32_t* quantized, uint32_t& pbit) {
+            float bestError = std::numeric_limits<float>::max();
+            for (uint32_t p = 0; p < 2; p++) {
+                uint32_t candidate[4];
+                float error = 0.0f;
+                for (int c = 0; c < 4; c++) {
+                    const long q = std::lround((color[c] - static_cast<float>(p)) * 0.5f);
+                    candidate[c] = static_cast<uint32_t>(std::clamp(q, 0l, 127l));
+                    const float difference = static_cast<float>((candidate[c] << 1) | p) - color[c];
+                    error += difference * difference;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    pbit = p;
+                    std::copy(candidate, candidate + 4, quantized);
+                }
+            }
+        }
+
+        void WriteBC7Mode6(uint32_t* q0, uint32_t* q1, uint32_t p0, uint32_t p1, int* indices, unsigned char* block) {
+            // The anchor texel's index drops its top bit, so it has to be below 8
+            if (indices[0] >= 8) {
+                for (int c = 0; c < 4; c++) {
+                    std::swap(q0[c], q1[c]);
+                }
+                std::swap(p0, p1);
+                for (int i = 0; i < 16; i++) {
+                    indices[i] = 15 - indices[i];
+                }
+            }
+
+            BitWriter writer(block, 16);
+            writer.Write(1u << 6, 7);
+            for (int c = 0; c < 4; c++) {
+                writer.Write(q0[c], 7);
+                writer.Write(q1[c], 7);
+            }
+            writer.Write(p0, 1);
+            writer.Write(p1, 1);
+            writer.Write(static_cast<uint32_t>(indices[0]), 3);
+            for (int i = 1; i < 16; i++) {
+                writer.Write(static_cast<uint32_t>(indices[i]), 4);
+            }
+        }
+
+        void DecodeBC7(const unsigned char* block, unsigned char* texels) {
+            if ((block[0] & 0x7F) != 0x40) {
+                for (int i = 0; i < 16; i++) {
+                    texels[i * 4 + 0] = 255;
+                    texels[i * 4 + 1] = 0;
+                    texels[i * 4 + 2] = 255;
+                    texels[i * 4 + 3] = 255;
+                }
+                return;
+            }
+
+            BitReader reader(block);
+            reader.Read(7);
+            uint32_t endpoints[2][4];
+            for (int c = 0; c < 4; c++) {
+                endpoints[0][c] = reader.Read(7);
+                endpoints[1][c] = reader.Read(7);
+            }
+            const uint32_t p0 = reader.Read(1);
+            const uint32_t p1 = reader.Read(1);
+            for (int c = 0; c < 4; c++) {
+                endpoints[0][c] = (endpoints[0][c] << 1) | p0;
+                endpoints[1][c] = (endpoints[1][c] << 1) | p1;
+            }
+            for (int i = 0; i < 16; i++) {
+                const int weight = BC7Weights[reader.Read(i == 0 ? 3 : 4)];
+                for (int c = 0; c < 4; c++) {
+                    texels[i * 4 + c] = static_cast<unsigned char>(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+                }
+            }
+        }
+
+        void EncodeBlock(TextureFormat format, const unsigned char* texels, unsigned char* block) {
+            switch (format) {
+                case TextureFormat::BC1: EncodeBC1Block(texels, block); break;
+                case TextureFormat::BC3: EncodeBC3Block(texels, block); break;
+                case TextureFormat::BC5: EncodeBC5Block(texels, block); break;
+                case TextureFormat::BC7: EncodeBC7Block(texels, block); break;
+                case TextureFormat::RGBA8: std::memcpy(block, texels, 64); break;
+            }
+        }
+
+        // Mip filtering
+
+        float SRGBToLinear(float value) {
+            return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+
+        float LinearToSRGB(float value) {
+            return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        }
+
+        // Zeroth order modified Bessel function of the first kind, by its power series
+        float Bessel0(float x) {
+            float sum = 1.0f;
+            float term = 1.0f;
+            const float quarterSquare = x * x * 0.25f;
+            for (int k = 1; k < 32 && term > sum * 1e-8f; k++) {
+                term *= quarterSquare / static_cast<float>(k * k);
+                sum += term;
+            }
+            return sum;
+        }
+
+        // Kaiser-windowed sinc with the usual texture tool parameters: 3 lobes, alpha 4
+        float KaiserSinc(float x) {
+            constexpr float Width = 3.0f;
+            constexpr float Alpha = 4.0f;
+            constexpr float Pi = 3.14159265358979f;
+            if (std::fabs(x) >= Width) {
+                return 0.0f;
+            }
+            const float sinc = x == 0.0f ? 1.0f : std::sin(Pi * x) / (Pi * x);
+            const float ratio = x / Width;
+            return sinc * Bessel0(Alpha * std::sqrt(1.0f - ratio * ratio)) / Bessel0(Alpha);
+        }
+
+        struct FilterTaps {
+            // Per output texel: taps [First[i], First[i + 1]) of Sources and Weights
+            std::vector<int> First;
+            std::vector<int> Sources;
+            std::vector<float> Weights;
+        };
+
+        FilterTaps ComputeTaps(int sourceSize, int targetSize, MipFilter filter) {
+            const float scale = static_cast<float>(sourceSize) / static_cast<float>(targetSize);
+            const float support = filter == MipFilter::Box ? 0.5f * scale : 3.0f * scale;
+
+            FilterTaps taps;
+            taps.First.push_back(0);
+            for (int target = 0; target < targetSize; target++) {
+                const float center = (static_cast<float>(target) + 0.5f) * scale;
+                const int first = static_cast<int>(std::floor(center - support));
+                const int last = static_cast<int>(std::ceil(center + support));
+                const size_t begin = taps.Weights.size();
+                float total = 0.0f;
+                for (int source = first; source < last; source++) {
+                    float weight;
+                    if (filter == MipFilter::Box) {
+                        // Overlap of the source texel with the target's footprint
+                        const float low = std::max(static_cast<float>(source), center - support);
+                        const float high = std::min(static_cast<float>(source + 1), center + support);
+                        weight = std::max(0.0f, high - low);
+                    } else {
+                        weight = KaiserSinc((static_cast<float>(source) + 0.5f - center) / scale);
+                    }
+                    if (weight == 0.0f) {
+                        continue;
+                    }
+                    taps.Sources.push_back(std::clamp(source, 0, sourceSize - 1));
+                    taps.Weights.push_back(weight);
+                    total += weight;
+                }
+                for (size_t i = begin; i < taps.Weights.size(); i++) {
+                    taps.Weights[i] /= total;
+                }
+                taps.First.push_back(static_cast<int>(taps.Weights.size()));
+            }
+            return taps;
+        }
+
+        // RGBA floats, separable: rows first into a target-width image, then columns
+        std::vector<float> Resample(const std::vector<float>& source, int width, int height, int targetWidth, int targetHeight, MipFilter filter) {
+            const FilterTaps horizontal = ComputeTaps(width, targetWidth, filter);
+            const FilterTaps vertical = ComputeTaps(height, targetHeight, filter);
+
+            std::vector<float> rows(static_cast<size_t>(targetWidth) * height * 4);
+            JobSystem::ParallelFor(0, static_cast<size_t>(height), [&](size_t first, size_t last) {
+                for (size_t y = first; y < last; y++) {
+                    const float* input = source.data() + y * width * 4;
+                    float* output = rows.data() + y * targetWidth * 4;
+                    for (int x = 0; x < targetWidth; x++) {
+                        float sum[4] = {};
+                        for (int tap = horizontal.First[x]; tap < horizontal.First[x + 1]; tap++) {
+                            const float* texel = input + horizontal.Sources[tap] * 4;
+                            const float weight = horizontal.Weights[tap];
+                            for (int c = 0; c < 4; c++) {
+                                sum[c] += texel[c] * weight;
+                            }
+                        }
+                        std::copy(sum, sum + 4, output + x * 4);
+                    }
+                }
+            });
+
+            std::vector<float> result(static_cast<size_t>(targetWidth) * targetHeight * 4);
+            JobSystem::ParallelFor(0, static_cast<size_t>(targetHeight), [&](size_t first, size_t last) {
+                for (size_t y = first; y < last; y++) {
+                    float* output = result.data() + y * targetWidth * 4;
+                    for (int x = 0; x < targetWidth; x++) {
+                        float sum[4] = {};
+                        for (int tap = vertical.First[y]; tap < vertical.First[y + 1]; tap++) {
+                            const float* texel = rows.data() + (static_cast<size_t>(vertical.Sources[tap]) * targetWidth + x) * 4;
+                            const float weight = vertical.Weights[tap];
+                            for (int c = 0; c < 4; c++) {
+                                sum[c] += texel[c] * weight;
+                            }
+                        }
+                        // Negative lobes overshoot at hard edges
+                        for (int c = 0; c < 4; c++) {
+                            output[x * 4 + c] = std::clamp(sum[c], 0.0f, 1.0f);
+                        }
+                    }
+                }
+            });
+            return result;
+        }
+
+        void AppendLevel(TextureImage& image, int width, int height, const unsigned char* data, size_t size) {
+            TextureLevel level;
+            level.Width = width;
+            level.Height = height;
+            level.Offset = image.Data.size();
+            level.Size = size;
+            image.Levels.push_back(level);
+            image.Data.insert(image.Data.end(), data, data + size);
+        }
+
+    }
+
+    const char* GetFormatName(TextureFormat format) {
+        switch (format) {
+            case TextureFormat::RGBA8: return "RGBA8";
+            case TextureFormat::BC1: return "BC1";
+            case TextureFormat::BC3: return "BC3";
+            case TextureFormat::BC5: return "BC5";
+            case TextureFormat::BC7: return "BC7";
+        }
+        return "unknown";
+    }
+
+    bool IsCompressed(TextureFormat format) {
+        return format != TextureFormat::RGBA8;
+    }
+
+    size_t GetBlockSize(TextureFormat format) {
+        return format == TextureFormat::BC1 ? 8 : format == TextureFormat::RGBA8 ? 4 : 16;
+    }
+
+    size_t GetLevelSize(TextureFormat format, int width, int height) {
+        if (!IsCompressed(format)) {
+            return static_cast<size_t>(width) * height * 4;
+        }
+        return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+    }
+
+    int GetMipCount(int width, int height) {
+        int count = 1;
+        while (width > 1 || height > 1) {
+            width = std::max(1, width / 2);
+            height = std::max(1, height / 2);
+            count++;
+        }
+        return count;
+    }
+
+    void EncodeBC1Block(const unsigned char* texels, unsigned char* block) {
+        EncodeColor(texels, true, block);
+    }
+
+    void EncodeBC3Block(const unsigned char* texels, unsigned char* block) {
+        EncodeChannel(texels, 3, block);
+        EncodeColor(texels, false, block + 8);
+    }
+
+    void EncodeBC5Block(const unsigned char* texels, unsigned char* block) {
+        EncodeChannel(texels, 0, block);
+        EncodeChannel(texels, 1, block + 8);
+    }
+
+    void EncodeBC7Block(const unsigned char* texels, unsigned char* block) {
+        BlockTexels source;
+        LoadBlock(texels, source);
+        const float* channels[4] = { source.Channels[0], source.Channels[1], source.Channels[2], source.Channels[3] };
+
+        // Index for every weight out of 64, so projected positions map straight to the nearest index
+        static const auto NearestIndex = [] {
+            std::array<int, 65> table{};
+            for (int weight = 0; weight <= 64; weight++) {
+                int best = 0;
+                for (int i = 1; i < 16; i++) {
+                    if (std::abs(BC7Weights[i] - weight) < std::abs(BC7Weights[best] - weight)) {
+                        best = i;
+                    }
+                }
+                table[weight] = best;
+            }
+            return table;
+        }();
+
+        float start[4];
+        float end[4];
+        FindEndpoints(source, 4, nullptr, start, end);
+
+        uint32_t bestError = std::numeric_limits<uint32_t>::max();
+        unsigned char candidate[16];
+        unsigned char decoded[64];
+        for (int iteration = 0; iteration < 2; iteration++) {
+            uint32_t q0[4];
+            uint32_t q1[4];
+            uint32_t p0 = 0;
+            uint32_t p1 = 0;
+            QuantizeBC7Endpoint(start, q0, p0);
+            QuantizeBC7Endpoint(end, q1, p1);
+            float from[4];
+            float to[4];
+            for (int c = 0; c < 4; c++) {
+                from[c] = static_cast<float>((q0[c] << 1) | p0);
+                to[c] = static_cast<float>((q1[c] << 1) | p1);
+            }
+
+            int indices[16];
+            ProjectTexels(channels, 4, from, to, 64.0f, indices);
+            float fractions[16];
+            for (int i = 0; i < 16; i++) {
+                indices[i] = NearestIndex[indices[i]];
+                fractions[i] = static_cast<float>(BC7Weights[indices[i]]) / 64.0f;
+            }
+
+            WriteBC7Mode6(q0, q1, p0, p1, indices, candidate);
+            DecodeBC7(candidate, decoded);
+            const uint32_t error = BlockError(texels, decoded, 4);
+            if (error < bestError) {
+                bestError = error;
+                std::memcpy(block, candidate, sizeof(candidate));
+            }
+            if (error == 0 || !FitEndpoints(source, 4, fractions, nullptr, start, end)) {
+                break;
+            }
+        }
+    }
+
+    void DecodeBlock(TextureFormat format, const unsigned char* block, unsigned char* texels) {
+        switch (format) {
+            case TextureFormat::BC1:
+                DecodeColor(block, texels, true);
+                break;
+            case TextureFormat::BC3:
+                DecodeColor(block + 8, texels, false);
+                DecodeChannel(block, texels, 3);
+                break;
+            case TextureFormat::BC5:
+                DecodeChannel(block, texels, 0);
+                DecodeChannel(block + 8, texels, 1);
+                for (int i = 0; i < 16; i++) {
+                    texels[i * 4 + 2] = 0;
+                    texels[i * 4 + 3] = 255;
+                }
+                break;
+            case TextureFormat::BC7:
+                DecodeBC7(block, texels);
+                break;
+            case TextureFormat::RGBA8:
+                std::memcpy(texels, block, 64);
+                break;
+        }
+    }
+
+    std::vector<unsigned char> Compress(const unsigned char* pixels, int width, int height, TextureFormat format) {
+        CIRCE_PROFILE_FUNCTION();
+        if (!IsCompressed(format)) {
+            return std::vector<unsigned char>(pixels, pixels + GetLevelSize(format, width, height));
+        }
+
+        const int blocksX = (width + 3) / 4;
+        const int blocksY = (height + 3) / 4;
+        const size_t blockSize = GetBlockSize(format);
+        std::vector<unsigned char> result(static_cast<size_t>(blocksX) * blocksY * blockSize);
+        JobSystem::ParallelFor(0, static_cast<size_t>(blocksY), [&](size_t first, size_t last) {
+            unsigned char texels[64];
+            for (size_t by = first; by < last; by++) {
+                for (int bx = 0; bx < blocksX; bx++) {
+                    for (int i = 0; i < 16; i++) {
+                        const int x = std::min(bx * 4 + (i & 3), width - 1);
+                        const int y = std::min(static_cast<int>(by) * 4 + (i >> 2), height - 1);
+                        std::memcpy(texels + i * 4, pixels + (static_cast<size_t>(y) * width + x) * 4, 4);
+                    }
+                    EncodeBlock(format, texels, result.data() + (by * blocksX + bx) * blockSize);
+                }
+            }
+        });
+        return result;
+    }
+
+    std::vector<unsigned char> Decompress(const unsigned char* data, int width, int height, TextureFormat format) {
+        if (!IsCompressed(format)) {
+            return std::vector<unsigned char>(data, data + GetLevelSize(format, width, height));
+        }
+
+        const int blocksX = (width + 3) / 4;
+        const int blocksY = (height + 3) / 4;
+        const size_t blockSize = GetBlockSize(format);
+        std::vector<unsigned char> result(static_cast<size_t>(width) * height * 4);
+        JobSystem::ParallelFor(0, static_cast<size_t>(blocksY), [&](size_t first, size_t last) {
+            unsigned char texels[64];
+            for (size_t by = first; by < last; by++) {
+                for (int bx = 0; bx < blocksX; bx++) {
+                    DecodeBlock(format, data + (by * blocksX + bx) * blockSize, texels);
+                    for (int i = 0; i < 16; i++) {
+                        const int x = bx * 4 + (i & 3);
+                        const int y = static_cast<int>(by) * 4 + (i >> 2);
+                        if (x < width && y < height) {
+                            std::memcpy(result.data() + (static_cast<size_t>(y) * width + x) * 4, texels + i * 4, 4);
+                        }
+                    }
+                }
+            }
+        });
+        return result;
+    }
+
+    TextureImage GenerateMips(const unsigned char* pixels, int width, int height, bool srgb, MipFilter filter) {
+        CIRCE_PROFILE_FUNCTION();
+        TextureImage image;
+        image.Format = TextureFormat::RGBA8;
+        image.SRGB = srgb;
+        image.Width = width;
+        image.Height = height;
+        AppendLevel(image, width, height, pixels, GetLevelSize(TextureFormat::RGBA8, width, height));
+
+        float decode[256];
+        for (int i = 0; i < 256; i++) {
+            decode[i] = srgb ? SRGBToLinear(static_cast<float>(i) / 255.0f) : static_cast<float>(i) / 255.0f;
+        }
+        std::vector<float> current(static_cast<size_t>(width) * height * 4);
+        for (size_t i = 0; i < current.size(); i++) {
+            current[i] = (i & 3) == 3 ? static_cast<float>(pixels[i]) / 255.0f : decode[pixels[i]];
+        }
+
+        std::vector<unsigned char> level;
+        while (width > 1 || height > 1) {
+            const int targetWidth = std::max(1, width / 2);
+            const int targetHeight = std::max(1, height / 2);
+            current = Resample(current, width, height, targetWidth, targetHeight, filter);
+            width = targetWidth;
+            height = targetHeight;
+
+            level.resize(current.size());
+            for (size_t i = 0; i < current.size(); i++) {
+                const float value = (i & 3) != 3 && srgb ? LinearToSRGB(current[i]) : current[i];
+                level[i] = static_cast<unsigned char>(std::lround(value * 255.0f));
+            }
+            AppendLevel(image, width, height, level.data(), level.size());
+        }
+        return image;
+    }
+
+    TextureImage Compress(const TextureImage& image, TextureFormat format) {
+        TextureImage result;
+        result.Format = format;
+        result.SRGB = image.SRGB;
+        result.Width = image.Width;
+        result.Height = image.Height;
+        for (size_t i = 0; i < image.Levels.size(); i++) {
+            const TextureLevel& level = image.Levels[i];
+            const std::vector<unsigned char> data = Compress(image.GetLevelData(i), level.Width, level.Height, format);
+            AppendLevel(result, level.Width, level.Height, data.data(), data.size());
+        }
+        return result;
+    }
+
+    TextureImage Decompress(const TextureImage& image) {
+        TextureImage result;
+        result.Format = TextureFormat::RGBA8;
+        result.SRGB = image.SRGB;
+        result.Width = image.Width;
+        result.Height = image.Height;
+        for (size_t i = 0; i < image.Levels.size(); i++) {
+            const TextureLevel& level = image.Levels[i];
+            const std::vector<unsigned char> data = Decompress(image.GetLevelData(i), level.Width, level.Height, image.Format);
+            AppendLevel(result, level.Width, level.Height, data.data(), data.size());
+        }
+        return result;
+    }
+
+    double ComputePSNR(const unsigned char* reference, const unsigned char* pixels, int width, int height, int channels) {
+        double sum = 0.0;
+        const size_t count = static_cast<size_t>(width) * height;
+        for (size_t i = 0; i < count; i++) {
+            for (int c = 0; c < channels; c++) {
+                const double difference = static_cast<double>(reference[i * 4 + c]) - pixels[i * 4 + c];
+                sum += difference * difference;
+            }
+        }
+        if (sum == 0.0) {
+            return std::numeric_limits<double>::infinity();
+        }
+        const double mse = sum / (static_cast<double>(count) * channels);
+        return 10.0 * std::log10(255.0 * 255.0 / mse);
+    }
+
+}
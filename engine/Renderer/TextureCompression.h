@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Circe {
+
+    enum class TextureFormat : uint8_t {
+        // Uncompressed, four bytes per texel
+        RGBA8,
+        // RGB at 4 bits per texel, 1-bit alpha
+        BC1,
+        // BC1 color plus interpolated alpha, 8 bits per texel
+        BC3,
+        // Two independent channels (normal map xy), 8 bits per texel
+        BC5,
+        // RGBA at 8 bits per texel, highest quality
+        BC7
+    };
+
+    struct TextureLevel {
+        int Width = 0;
+        int Height = 0;
+        // Into TextureImage::Data
+        size_t Offset = 0;
+        size_t Size = 0;
+    };
+
+    // A texture and its mip chain in one buffer, level 0 first. Rows run top to bottom, the
+    // same order stb_image hands out, and compressed levels are 4x4 blocks in the same order.
+    struct TextureImage {
+        TextureFormat Format = TextureFormat::RGBA8;
+        // Color data encoded with the sRGB curve, mips were filtered in linear light
+        bool SRGB = false;
+        int Width = 0;
+        int Height = 0;
+        std::vector<TextureLevel> Levels;
+        std::vector<unsigned char> Data;
+
+        const unsigned char* GetLevelData(size_t level) const { return Data.data() + Levels[level].Offset; }
+    };
+
+    enum class MipFilter {
+        // Average of the covered texels
+        Box,
+        // Windowed sinc, sharper mips without the ringing of a plain sinc
+        Kaiser
+    };
+
+    // CPU texture processing for the cooker: mip generation and BCn block codecs. Whole-image
+    // operations split their rows over the job system when it is running; the block kernels
+    // use SSE2 when the target has it, with results bit-identical to the scalar path.
+    namespace TextureCompression {
+
+        const char* GetFormatName(TextureFormat format);
+        bool IsCompressed(TextureFormat format);
+        // Bytes per 4x4 block, or per texel for RGBA8
+        size_t GetBlockSize(TextureFormat format);
+        size_t GetLevelSize(TextureFormat format, int width, int height);
+        // Levels down to 1x1
+        int GetMipCount(int width, int height);
+
+        // Block kernels, 16 RGBA8 texels row by row in, one block out. BC1 switches to its
+        // 3-color mode with a transparent index when any texel has alpha below 128.
+        void EncodeBC1Block(const unsigned char* texels, unsigned char* block);
+        void EncodeBC3Block(const unsigned char* texels, unsigned char* block);
+        // Red and green only
+        void EncodeBC5Block(const unsigned char* texels, unsigned char* block);
+        // Mode 6: one RGBA endpoint pair with 16 interpolation steps
+        void EncodeBC7Block(const unsigned char* texels, unsigned char* block);
+        // BC5 decodes to (r, g, 0, 255). BC7 blocks in modes other than 6 decode to magenta.
+        void DecodeBlock(TextureFormat format, const unsigned char* block, unsigned char* texels);
+
+        // RGBA8 level in, blocks out; edge blocks repeat the last row and column
+        std::vector<unsigned char> Compress(const unsigned char* pixels, int width, int height, TextureFormat format);
+        std::vector<unsigned char> Decompress(const unsigned char* data, int width, int height, TextureFormat format);
+
+        // RGBA8 image with the full mip chain. Each level is resampled from the previous one,
+        // in linear light for sRGB color; alpha is always linear.
+        TextureImage GenerateMips(const unsigned char* pixels, int width, int height, bool srgb, MipFilter filter);
+        // Every level of an RGBA8 image encoded to the format
+        TextureImage Compress(const TextureImage& image, TextureFormat format);
+        // Back to RGBA8, for drivers without the format and for measuring quality
+        TextureImage Decompress(const TextureImage& image);
+
+        // Over the first channels of each RGBA8 texel; infinity for identical images
+        double ComputePSNR(const unsigned char* reference, const unsigned char* pixels, int width, int height, int channels = 4);
+
+    }
+
+}
@@ -0,0 +1,258 @@
+#include "TextureLoader.h"
+#include "Texture.h"
+#include "Ktx2.h"
+#include "../Core/Jobs/JobSystem.h"
+#include "../Core/Profiling/Profiler.h"
+#include <glad/glad.h>
+#include <stb_image.h>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+
+namespace Circe {
+
+    namespace {
+
+        struct DecodedImage {
+            std::weak_ptr<Texture> Target;
+            std::unique_ptr<unsigned char, void (*)(void*)> Pixels{ nullptr, stbi_image_free };
+            int Width = 0;
+            int Height = 0;
+            // Cooked .ktx2 levels, uploaded as they are instead of Pixels
+            TextureImage Cooked;
+            // Hot reload of a texture that already shows a real image
+            bool Reload = false;
+
+            bool IsCooked() const { return !Cooked.Levels.empty(); }
+            bool IsValid() const { return Pixels || IsCooked(); }
+            const unsigned char* GetData() const { return IsCooked() ? Cooked.Data.data() : Pixels.get(); }
+            size_t GetSize() const { return IsCooked() ? Cooked.Data.size() : static_cast<size_t>(Width) * Height * 4; }
+        };
+
+        std::mutex s_ReadyMutex;
+        std::deque<DecodedImage> s_Ready;
+
+        JobCounter s_DecodeCounter;
+        std::atomic<bool> s_Cancelled{ false };
+        std::atomic<uint32_t> s_Decoding{ 0 };
+        std::atomic<uint32_t> s_Failed{ 0 };
+        uint32_t s_Loaded = 0;
+
+        GLuint s_UploadBuffer = 0;
+        size_t s_BytesLastFrame = 0;
+        uint64_t s_TotalBytes = 0;
+
+        // 2x2 magenta/black checker, stretched over whatever the texture is mapped to
+        constexpr unsigned char PlaceholderPixels[] = {
+            255, 0, 255, 255,   0, 0, 0, 255,
+            0, 0, 0, 255,       255, 0, 255, 255
+        };
+
+        void Decode(std::weak_ptr<Texture> target, const std::string& path, bool reload) {
+            CIRCE_PROFILE_SCOPE("TextureLoader::Decode");
+
+            if (!s_Cancelled.load(std::memory_order_relaxed) && !target.expired()) {
+                DecodedImage image;
+                image.Target = std::move(target);
+                image.Reload = reload;
+                if (Ktx2::IsKtx2Path(path)) {
+                    try {
+                        image.Cooked = Ktx2::Read(path);
+                        if (!Texture::SupportsFormat(image.Cooked.Format)) {
+                            image.Cooked = TextureCompression::Decompress(image.Cooked);
+                        }
+                    } catch (const std::exception& error) {
+                        std::cerr << error.what() << std::endl;
+                    }
+                } else {
+                    int channels = 0;
+                    image.Pixels.reset(stbi_load(path.c_str(), &image.Width, &image.Height, &channels, STBI_rgb_alpha));
+                }
+
+                if (!image.IsValid()) {
+                    std::cerr << (reload ? "Texture reload failed, keeping the previous image: " : "Failed to load texture: ") << path << std::endl;
+                    s_Failed.fetch_add(1, std::memory_order_relaxed);
+                }
+                // Failures are still queued, without pixels, so Update settles the texture: a
+                // reload keeps its image, a first load falls back to the checker
+                {
+                    std::lock_guard<std::mutex> lock(s_ReadyMutex);
+                    s_Ready.push_back(std::move(image));
+                }
+            }
+
+            // After the push so the request is always visible in one of the two queues
+            s_Decoding.fetch_sub(1, std::memory_order_release);
+        }
+
+        // Copies the image into the upload buffer and leaves it bound. Returns what to hand GL as
+        // the data pointer: null, an offset into the buffer, or the image itself when the buffer
+        // could not be used.
+        const unsigned char* Stage(const DecodedImage& image) {
+            const size_t size = image.GetSize();
+
+            // Orphan the previous storage so the copy never waits on the last transfer
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s_UploadBuffer);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_DRAW);
+            if (void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(size), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT)) {
+                std::memcpy(mapped, image.GetData(), size);
+                if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER)) {
+                    return nullptr;
+                }
+                // Buffer contents were lost, upload from client memory instead
+            }
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return image.GetData();
+        }
+
+        void UploadPixels(Texture& texture, const DecodedImage& image, const unsigned char* source) {
+            glBindTexture(GL_TEXTURE_2D, texture.GetID());
+            // A cooked image may have limited the chain before
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image.Width, image.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, source);
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+
+        // The checker for good, for a first load whose file could not be decoded. Specified
+        // again since a reload may have replaced the placeholder meanwhile.
+        void UploadFallback(Texture& texture) {
+            glBindTexture(GL_TEXTURE_2D, texture.GetID());
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, PlaceholderPixels);
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+
+    }
+
+    size_t TextureLoader::s_UploadBudget = 8 * 1024 * 1024;
+
+    void TextureLoader::Initialize() {
+        s_Cancelled = false;
+        if (!s_UploadBuffer) {
+            glGenBuffers(1, &s_UploadBuffer);
+        }
+    }
+
+    void TextureLoader::Shutdown() {
+        s_Cancelled = true;
+        JobSystem::Wait(s_DecodeCounter);
+
+        {
+            std::lock_guard<std::mutex> lock(s_ReadyMutex);
+            s_Ready.clear();
+        }
+
+        if (s_UploadBuffer) {
+            glDeleteBuffers(1, &s_UploadBuffer);
+            s_UploadBuffer = 0;
+        }
+    }
+
+    std::shared_ptr<Texture> TextureLoader::Load(const std::string& path) {
+        auto texture = std::make_shared<Texture>(2, 2, PlaceholderPixels);
+        texture->m_Ready = false;
+
+        s_Decoding.fetch_add(1, std::memory_order_relaxed);
+        std::weak_ptr<Texture> target = texture;
+        JobSystem::RunBackground([target, path]() { Decode(target, path, false); }, &s_DecodeCounter);
+        return texture;
+    }
+
+    void TextureLoader::Reload(const std::shared_ptr<Texture>& texture, const std::string& path) {
+        if (!texture) {
+            return;
+        }
+        // Not ready until the new image is in, so size bookkeeping waits for it as for a first load
+        texture->m_Ready = false;
+
+        s_Decoding.fetch_add(1, std::memory_order_relaxed);
+        std::weak_ptr<Texture> target = texture;
+        JobSystem::RunBackground([target, path]() { Decode(target, path, true); }, &s_DecodeCounter);
+    }
+
+    void TextureLoader::Update() {
+        CIRCE_PROFILE_FUNCTION();
+        s_BytesLastFrame = 0;
+
+        while (s_BytesLastFrame == 0 || s_BytesLastFrame < s_UploadBudget) {
+            DecodedImage image;
+            {
+                std::lock_guard<std::mutex> lock(s_ReadyMutex);
+                if (s_Ready.empty()) {
+                    break;
+                }
+                image = std::move(s_Ready.front());
+                s_Ready.pop_front();
+            }
+
+            // Nobody holds the texture anymore, drop the pixels
+            std::shared_ptr<Texture> texture = image.Target.lock();
+            if (!texture) {
+                continue;
+            }
+            if (!image.IsValid()) {
+                if (!image.Reload) {
+                    if (texture->m_BindlessHandle) {
+                        texture->Recreate();
+                    }
+                    UploadFallback(*texture);
+                    texture->m_Width = 2;
+                    texture->m_Height = 2;
+                    texture->m_BytesPerPixel = 4;
+                    texture->m_Format = TextureFormat::RGBA8;
+                    texture->m_LevelCount = 0;
+                    texture->m_LoadFailed = true;
+                }
+                texture->m_Ready = true;
+                continue;
+            }
+
+            // Storage of a texture with a bindless handle is immutable
+            if (texture->m_BindlessHandle) {
+                texture->Recreate();
+            }
+            const unsigned char* source = Stage(image);
+            if (image.IsCooked()) {
+                texture->Upload(image.Cooked, source);
+            } else {
+                UploadPixels(*texture, image, source);
+                texture->m_Width = image.Width;
+                texture->m_Height = image.Height;
+                texture->m_BytesPerPixel = 4;
+                texture->m_Format = TextureFormat::RGBA8;
+                texture->m_LevelCount = 0;
+            }
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            texture->m_Ready = true;
+            texture->m_LoadFailed = false;
+
+            s_BytesLastFrame += image.GetSize();
+            s_TotalBytes += image.GetSize();
+            s_Loaded++;
+        }
+    }
+
+    bool TextureLoader::IsIdle() {
+        std::lock_guard<std::mutex> lock(s_ReadyMutex);
+        return s_Ready.empty() && s_Decoding.load(std::memory_order_acquire) == 0;
+    }
+
+    TextureLoaderStats TextureLoader::GetStats() {
+        TextureLoaderStats stats;
+        {
+            std::lock_guard<std::mutex> lock(s_ReadyMutex);
+            stats.PendingUploads = static_cast<uint32_t>(s_Ready.size());
+        }
+        stats.QueueDepth = stats.PendingUploads + s_Decoding.load(std::memory_order_acquire);
+        stats.BytesUploadedLastFrame = s_BytesLastFrame;
+        stats.TotalBytesUploaded = s_TotalBytes;
+        stats.Loaded = s_Loaded;
+        stats.Failed = s_Failed.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+}
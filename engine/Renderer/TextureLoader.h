@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Circe {
+
+    class Texture;
+
+    struct TextureLoaderStats {
+        // Requests not uploaded yet (decoding or waiting for upload budget)
+        uint32_t QueueDepth = 0;
+        // Decoded images waiting for upload budget
+        uint32_t PendingUploads = 0;
+        size_t BytesUploadedLastFrame = 0;
+        uint64_t TotalBytesUploaded = 0;
+        uint32_t Loaded = 0;
+        uint32_t Failed = 0;
+    };
+
+    // Streams textures in without stalling the frame: files are decoded by background jobs
+    // and uploaded on the GL thread through a pixel buffer object, at most UploadBudget
+    // bytes per frame. Load() hands back a texture showing a checker placeholder which the
+    // real image replaces in place, so materials can bind it right away. Cooked .ktx2 files
+    // skip decoding and upload their blocks and mips as stored.
+    class TextureLoader {
+    public:
+        // GL thread, after the context exists
+        static void Initialize();
+        // Cancels queued decodes and waits for running ones
+        static void Shutdown();
+
+        // GL thread. Returns immediately. When the file cannot be decoded the texture settles
+        // on the checker as a fallback: ready, with Texture::IsLoadFailed() set.
+        static std::shared_ptr<Texture> Load(const std::string& path);
+        // GL thread. Decodes the file again and re-specifies the texture in place, same GL name,
+        // so existing holders and bindings pick the new image up. The current image stays
+        // visible until then, and also when decoding fails.
+        static void Reload(const std::shared_ptr<Texture>& texture, const std::string& path);
+
+        // GL thread, once per frame (Engine::Render does this)
+        static void Update();
+
+        // At least one image is uploaded per frame even if it exceeds the budget
+        static void SetUploadBudget(size_t bytesPerFrame) { s_UploadBudget = bytesPerFrame; }
+        static size_t GetUploadBudget() { return s_UploadBudget; }
+
+        static bool IsIdle();
+        static TextureLoaderStats GetStats();
+
+    private:
+        static size_t s_UploadBudget;
+    };
+
+}
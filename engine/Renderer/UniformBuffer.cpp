@@ -0,0 +1,28 @@
+#include "UniformBuffer.h"
+#include <glad/glad.h>
+
+namespace Circe {
+
+    UniformBuffer::UniformBuffer(size_t size, unsigned int binding)
+        : m_Binding(binding), m_Size(size) {
+        glGenBuffers(1, &m_ID);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_ID);
+        glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_ID);
+    }
+
+    UniformBuffer::~UniformBuffer() {
+        if (m_ID) {
+            glDeleteBuffers(1, &m_ID);
+        }
+    }
+
+    void UniformBuffer::SetData(const void* data, size_t size, size_t offset) {
+        glBindBuffer(GL_UNIFORM_BUFFER, m_ID);
+        glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+}
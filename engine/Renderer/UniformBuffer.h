@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+namespace Circe {
+
+    // Fixed binding points shared by every program that declares the matching block
+    namespace UniformBinding {
+        constexpr unsigned int Camera = 0;
+        constexpr unsigned int Material = 1;
+    }
+
+    // std140 layout of the "Camera" block, filled once per frame by the renderer:
+    //   layout (std140) uniform Camera {
+    //       mat4 view; mat4 projection; mat4 viewProjection; vec3 cameraPosition; float time;
+    //   };
+    struct CameraUniforms {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::mat4 viewProjection;
+        glm::vec3 cameraPosition;
+        float time;
+    };
+    static_assert(sizeof(CameraUniforms) == 208, "CameraUniforms must match the std140 Camera block");
+
+    class UniformBuffer {
+    public:
+        UniformBuffer(size_t size, unsigned int binding);
+        ~UniformBuffer();
+
+        UniformBuffer(const UniformBuffer&) = delete;
+        UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+        void SetData(const void* data, size_t size, size_t offset = 0);
+
+        unsigned int GetID() const { return m_ID; }
+        unsigned int GetBinding() const { return m_Binding; }
+        size_t GetSize() const { return m_Size; }
+
+    private:
+        unsigned int m_ID = 0;
+        unsigned int m_Binding = 0;
+        size_t m_Size = 0;
+    };
+
+}
@@ -0,0 +1,434 @@
+#include "VertexEncoding.h"
+#include "../Core/Profiling/Profiler.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define CIRCE_VERTEX_SSE2 1
+    #if defined(__F16C__)
+        #include <immintrin.h>
+        #define CIRCE_VERTEX_F16C 1
+    #endif
+#endif
+
+namespace Circe::VertexEncoding {
+
+    namespace {
+
+        // The scalar helpers mirror the SIMD lanes operation for operation, NaNs included
+        float Saturate(float value, float low, float high) {
+            return value > low ? (value < high ? value : high) : low;
+        }
+
+        int32_t Round(float value) {
+            return static_cast<int32_t>(std::lrint(value));
+        }
+
+        float SignNotZero(float value) {
+            return std::signbit(value) ? -1.0f : 1.0f;
+        }
+
+        // Fabian Giesen's float_to_half_fast3_rtne
+        uint16_t FloatToHalf(float value) {
+            uint32_t bits = std::bit_cast<uint32_t>(value);
+            const uint32_t sign = bits & 0x80000000u;
+            bits ^= sign;
+
+            uint32_t half;
+            if (bits >= 0x47800000u) {
+                // Overflow to infinity, NaNs stay quiet NaNs
+                half = bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+            } else if (bits < 0x38800000u) {
+                // Subnormal or zero: let the FPU round by adding 0.5
+                half = std::bit_cast<uint32_t>(std::bit_cast<float>(bits) + 0.5f) - 0x3F000000u;
+            } else {
+                const uint32_t mantissaOdd = (bits >> 13) & 1u;
+                bits += 0xC8000FFFu;
+                bits += mantissaOdd;
+                half = bits >> 13;
+            }
+            return static_cast<uint16_t>(half | (sign >> 16));
+        }
+
+        float HalfToFloat(uint16_t half) {
+            const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+            const uint32_t exponent = (half >> 10) & 0x1Fu;
+            const uint32_t mantissa = half & 0x3FFu;
+            float magnitude;
+            if (exponent == 0) {
+                magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+            } else if (exponent == 31) {
+                magnitude = mantissa ? std::numeric_limits<float>::quiet_NaN() : std::numeric_limits<float>::infinity();
+            } else {
+                magnitude = std::bit_cast<float>(((exponent + 112u) << 23) | (mantissa << 13));
+            }
+            return std::bit_cast<float>(std::bit_cast<uint32_t>(magnitude) | sign);
+        }
+
+        uint32_t PackSNorm10x3_2(const float* v) {
+            const uint32_t x = static_cast<uint32_t>(Round(Saturate(v[0], -1.0f, 1.0f) * 511.0f)) & 0x3FFu;
+            const uint32_t y = static_cast<uint32_t>(Round(Saturate(v[1], -1.0f, 1.0f) * 511.0f)) & 0x3FFu;
+            const uint32_t z = static_cast<uint32_t>(Round(Saturate(v[2], -1.0f, 1.0f) * 511.0f)) & 0x3FFu;
+            const uint32_t w = static_cast<uint32_t>(Round(Saturate(v[3], -1.0f, 1.0f))) & 0x3u;
+            return x | (y << 10) | (z << 20) | (w << 30);
+        }
+
+        void PackOctahedral(const float* v, int16_t* output) {
+            float sum = std::fabs(v[0]) + std::fabs(v[1]) + std::fabs(v[2]);
+            sum = sum > 1e-20f ? sum : 1e-20f;
+            const float inverse = 1.0f / sum;
+            float x = v[0] * inverse;
+            float y = v[1] * inverse;
+            if (v[2] < 0.0f) {
+                const float foldedX = (1.0f - std::fabs(y)) * SignNotZero(x);
+                const float foldedY = (1.0f - std::fabs(x)) * SignNotZero(y);
+                x = foldedX;
+                y = foldedY;
+            }
+            output[0] = static_cast<int16_t>(Round(Saturate(x, -1.0f, 1.0f) * 32767.0f));
+            output[1] = static_cast<int16_t>(Round(Saturate(y, -1.0f, 1.0f) * 32767.0f));
+        }
+
+#if defined(CIRCE_VERTEX_SSE2)
+        // Narrows four int32 lanes holding 0..65535 to uint16 without SSE4.1's packus_epi32
+        __m128i PackLow16(__m128i low, __m128i high) {
+            low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+            high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+            return _mm_packs_epi32(low, high);
+        }
+
+        __m128 SaturatePs(__m128 value, __m128 low, __m128 high) {
+            // max returns the second operand for NaN, matching Saturate()
+            return _mm_min_ps(_mm_max_ps(value, low), high);
+        }
+
+    #if !defined(CIRCE_VERTEX_F16C)
+        __m128i FloatToHalf4(__m128 value) {
+            const __m128i signMask = _mm_set1_epi32(static_cast<int>(0x80000000u));
+            __m128i bits = _mm_castps_si128(value);
+            const __m128i sign = _mm_and_si128(bits, signMask);
+            bits = _mm_xor_si128(bits, sign);
+
+            const __m128i infNan = _mm_cmpgt_epi32(bits, _mm_set1_epi32(0x477FFFFF));
+            const __m128i isNan = _mm_cmpgt_epi32(bits, _mm_set1_epi32(0x7F800000));
+            const __m128i infNanValue = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(isNan, _mm_set1_epi32(0x0200)));
+
+            const __m128i subnormal = _mm_cmplt_epi32(bits, _mm_set1_epi32(0x38800000));
+            const __m128i subnormalValue = _mm_sub_epi32(
+                _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(bits), _mm_set1_ps(0.5f))), _mm_set1_epi32(0x3F000000));
+
+            const __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(1));
+            const __m128i normalValue = _mm_srli_epi32(
+                _mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32(static_cast<int>(0xC8000FFFu))), mantissaOdd), 13);
+
+            __m128i half = _mm_or_si128(_mm_and_si128(subnormal, subnormalValue), _mm_andnot_si128(subnormal, normalValue));
+            half = _mm_or_si128(_mm_and_si128(infNan, infNanValue), _mm_andnot_si128(infNan, half));
+            return _mm_or_si128(half, _mm_srli_epi32(sign, 16));
+        }
+    #endif
+#endif
+
+    }
+
+    void EncodeHalf(const float* input, uint16_t* output, size_t count) {
+        size_t i = 0;
+#if defined(CIRCE_VERTEX_F16C)
+        for (; i + 8 <= count; i += 8) {
+            const __m128i low = _mm_cvtps_ph(_mm_loadu_ps(input + i), _MM_FROUND_TO_NEAREST_INT);
+            const __m128i high = _mm_cvtps_ph(_mm_loadu_ps(input + i + 4), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_unpacklo_epi64(low, high));
+        }
+#elif defined(CIRCE_VERTEX_SSE2)
+        for (; i + 8 <= count; i += 8) {
+            const __m128i low = FloatToHalf4(_mm_loadu_ps(input + i));
+            const __m128i high = FloatToHalf4(_mm_loadu_ps(input + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), PackLow16(low, high));
+        }
+#endif
+        for (; i < count; ++i) {
+            output[i] = FloatToHalf(input[i]);
+        }
+    }
+
+    void DecodeHalf(const uint16_t* input, float* output, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            output[i] = HalfToFloat(input[i]);
+        }
+    }
+
+    void EncodeUNorm16(const float* input, uint16_t* output, size_t count) {
+        size_t i = 0;
+#if defined(CIRCE_VERTEX_SSE2)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(65535.0f);
+        for (; i + 8 <= count; i += 8) {
+            const __m128i low = _mm_cvtps_epi32(_mm_mul_ps(SaturatePs(_mm_loadu_ps(input + i), zero, one), scale));
+            const __m128i high = _mm_cvtps_epi32(_mm_mul_ps(SaturatePs(_mm_loadu_ps(input + i + 4), zero, one), scale));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), PackLow16(low, high));
+        }
+#endif
+        for (; i < count; ++i) {
+            output[i] = static_cast<uint16_t>(Round(Saturate(input[i], 0.0f, 1.0f) * 65535.0f));
+        }
+    }
+
+    void EncodeUNorm8(const float* input, uint8_t* output, size_t count) {
+        size_t i = 0;
+#if defined(CIRCE_VERTEX_SSE2)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(255.0f);
+        for (; i + 16 <= count; i += 16) {
+            __m128i lanes[4];
+            for (int j = 0; j < 4; ++j) {
+                lanes[j] = _mm_cvtps_epi32(_mm_mul_ps(SaturatePs(_mm_loadu_ps(input + i + j * 4), zero, one), scale));
+            }
+            const __m128i words = _mm_packus_epi16(_mm_packs_epi32(lanes[0], lanes[1]), _mm_packs_epi32(lanes[2], lanes[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), words);
+        }
+#endif
+        for (; i < count; ++i) {
+            output[i] = static_cast<uint8_t>(Round(Saturate(input[i], 0.0f, 1.0f) * 255.0f));
+        }
+    }
+
+    void EncodeSNorm10x3_2(const float* input, uint32_t* output, size_t count) {
+        size_t i = 0;
+#if defined(CIRCE_VERTEX_SSE2)
+        const __m128 low = _mm_set1_ps(-1.0f);
+        const __m128 high = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(511.0f);
+        const __m128i mask10 = _mm_set1_epi32(0x3FF);
+        const __m128i mask2 = _mm_set1_epi32(0x3);
+        for (; i + 4 <= count; i += 4) {
+            // Four xyzw vectors, transposed so each register holds one component
+            __m128 x = _mm_loadu_ps(input + i * 4);
+            __m128 y = _mm_loadu_ps(input + i * 4 + 4);
+            __m128 z = _mm_loadu_ps(input + i * 4 + 8);
+            __m128 w = _mm_loadu_ps(input + i * 4 + 12);
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+
+            const __m128i qx = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(SaturatePs(x, low, high), scale)), mask10);
+            const __m128i qy = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(SaturatePs(y, low, high), scale)), mask10);
+            const __m128i qz = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(SaturatePs(z, low, high), scale)), mask10);
+            const __m128i qw = _mm_and_si128(_mm_cvtps_epi32(SaturatePs(w, low, high)), mask2);
+            const __m128i packed = _mm_or_si128(_mm_or_si128(qx, _mm_slli_epi32(qy, 10)),
+                _mm_or_si128(_mm_slli_epi32(qz, 20), _mm_slli_epi32(qw, 30)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), packed);
+        }
+#endif
+        for (; i < count; ++i) {
+            output[i] = PackSNorm10x3_2(input + i * 4);
+        }
+    }
+
+    glm::vec4 DecodeSNorm10x3_2(uint32_t packed) {
+        // Sign-extend each field, then the GL 4.2+ rule max(c / (2^(b-1) - 1), -1). GL 3.3 drivers
+        // may use (2c + 1) / (2^b - 1) instead, which differs by at most 1/1023.
+        auto field = [packed](int shift, int bits) {
+            const int32_t value = static_cast<int32_t>(packed << (32 - shift - bits)) >> (32 - bits);
+            return std::max(static_cast<float>(value) / static_cast<float>((1 << (bits - 1)) - 1), -1.0f);
+        };
+        return glm::vec4(field(0, 10), field(10, 10), field(20, 10), field(30, 2));
+    }
+
+    void EncodeOctahedral(const float* input, int16_t* output, size_t count) {
+        size_t i = 0;
+#if defined(CIRCE_VERTEX_SSE2)
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 minusOne = _mm_set1_ps(-1.0f);
+        const __m128 epsilon = _mm_set1_ps(1e-20f);
+        const __m128 scale = _mm_set1_ps(32767.0f);
+        for (; i + 4 <= count; i += 4) {
+            const float* v = input + i * 3;
+            const __m128 x = _mm_setr_ps(v[0], v[3], v[6], v[9]);
+            const __m128 y = _mm_setr_ps(v[1], v[4], v[7], v[10]);
+            const __m128 z = _mm_setr_ps(v[2], v[5], v[8], v[11]);
+
+            const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, x), _mm_andnot_ps(signMask, y)), _mm_andnot_ps(signMask, z));
+            const __m128 inverse = _mm_div_ps(one, _mm_max_ps(sum, epsilon));
+            const __m128 px = _mm_mul_ps(x, inverse);
+            const __m128 py = _mm_mul_ps(y, inverse);
+
+            // Lower hemisphere folds over the diagonals
+            const __m128 foldedX = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, py)), _mm_or_ps(_mm_and_ps(px, signMask), one));
+            const __m128 foldedY = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, px)), _mm_or_ps(_mm_and_ps(py, signMask), one));
+            const __m128 lower = _mm_cmplt_ps(z, _mm_setzero_ps());
+            const __m128 ox = _mm_or_ps(_mm_and_ps(lower, foldedX), _mm_andnot_ps(lower, px));
+            const __m128 oy = _mm_or_ps(_mm_and_ps(lower, foldedY), _mm_andnot_ps(lower, py));
+
+            const __m128i qx = _mm_cvtps_epi32(_mm_mul_ps(SaturatePs(ox, minusOne, one), scale));
+            const __m128i qy = _mm_cvtps_epi32(_mm_mul_ps(SaturatePs(oy, minusOne, one), scale));
+            const __m128i packed = _mm_packs_epi32(_mm_unpacklo_epi32(qx, qy), _mm_unpackhi_epi32(qx, qy));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * 2), packed);
+        }
+#endif
+        for (; i < count; ++i) {
+            PackOctahedral(input + i * 3, output + i * 2);
+        }
+    }
+
+    glm::vec3 DecodeOctahedral(const int16_t* encoded) {
+        float x = std::max(encoded[0] / 32767.0f, -1.0f);
+        float y = std::max(encoded[1] / 32767.0f, -1.0f);
+        const float z = 1.0f - std::fabs(x) - std::fabs(y);
+        if (z < 0.0f) {
+            const float unfoldedX = (1.0f - std::fabs(y)) * SignNotZero(x);
+            const float unfoldedY = (1.0f - std::fabs(x)) * SignNotZero(y);
+            x = unfoldedX;
+            y = unfoldedY;
+        }
+        return glm::normalize(glm::vec3(x, y, z));
+    }
+
+    void NarrowIndices(const uint32_t* input, uint16_t* output, size_t count) {
+        size_t i = 0;
+#if defined(CIRCE_VERTEX_SSE2)
+        for (; i + 8 <= count; i += 8) {
+            const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+            const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), PackLow16(low, high));
+        }
+#endif
+        for (; i < count; ++i) {
+            output[i] = static_cast<uint16_t>(input[i]);
+        }
+    }
+
+    PackedVertices Pack(const VertexSource& source, const VertexLayout& layout) {
+        CIRCE_PROFILE_SCOPE("VertexEncoding::Pack");
+
+        PackedVertices packed;
+        for (size_t stream = 0; stream < VertexLayout::MaxStreams; ++stream) {
+            packed.Streams[stream].resize(layout.GetStride(stream) * source.Count);
+        }
+
+        // Gather -> encode -> scatter in chunks small enough to stay in L1
+        constexpr size_t Chunk = 256;
+        float gathered[Chunk * 4];
+        alignas(16) unsigned char encoded[Chunk * 16];
+
+        for (const VertexElement& element : layout.GetElements()) {
+            const size_t size = VertexLayout::GetFormatSize(element.Format);
+            const size_t stride = layout.GetStride(element.Stream);
+            unsigned char* destination = packed.Streams[element.Stream].data() + element.Offset;
+
+            // Source components and padding for the wider formats (w = 1 for positions)
+            const float* floats = nullptr;
+            size_t sourceComponents = 0;
+            size_t sourceStride = 0;
+            switch (element.Attribute) {
+                case VertexAttribute::Position:
+                    floats = source.Vertices ? &source.Vertices[0].position.x : nullptr;
+                    sourceComponents = 3;
+                    sourceStride = sizeof(Vertex) / sizeof(float);
+                    break;
+                case VertexAttribute::Normal:
+                    floats = source.Vertices ? &source.Vertices[0].normal.x : nullptr;
+                    sourceComponents = 3;
+                    sourceStride = sizeof(Vertex) / sizeof(float);
+                    break;
+                case VertexAttribute::TexCoord:
+                    floats = source.Vertices ? &source.Vertices[0].texCoord.x : nullptr;
+                    sourceComponents = 2;
+                    sourceStride = sizeof(Vertex) / sizeof(float);
+                    break;
+                case VertexAttribute::Tangent:
+                    floats = source.Tangents ? &source.Tangents[0].x : nullptr;
+                    sourceComponents = 4;
+                    sourceStride = 4;
+                    break;
+                case VertexAttribute::Color:
+                    floats = source.Colors ? &source.Colors[0].x : nullptr;
+                    sourceComponents = 4;
+                    sourceStride = 4;
+                    break;
+                case VertexAttribute::BoneWeights:
+                    floats = source.BoneWeights ? &source.BoneWeights[0].x : nullptr;
+                    sourceComponents = 4;
+                    sourceStride = 4;
+                    break;
+                case VertexAttribute::BoneIndices:
+                    break;
+            }
+            if (source.Count > 0 && !floats && !(element.Attribute == VertexAttribute::BoneIndices && source.BoneIndices)) {
+                throw std::runtime_error("Vertex source is missing attribute " + std::to_string(static_cast<int>(element.Attribute)));
+            }
+            const float padding = element.Attribute == VertexAttribute::Position ? 1.0f : 0.0f;
+
+            size_t components = 0;
+            switch (element.Format) {
+                case VertexFormat::Float2: case VertexFormat::Half2: case VertexFormat::UNorm16x2: components = 2; break;
+                case VertexFormat::Float3: case VertexFormat::Octahedral16: components = 3; break;
+                default: components = 4; break;
+            }
+
+            for (size_t first = 0; first < source.Count; first += Chunk) {
+                const size_t count = std::min(Chunk, source.Count - first);
+
+                if (element.Format == VertexFormat::UInt8x4) {
+                    std::memcpy(encoded, source.BoneIndices + first * 4, count * 4);
+                } else {
+                    for (size_t v = 0; v < count; ++v) {
+                        const float* input = floats + (first + v) * sourceStride;
+                        float* output = gathered + v * components;
+                        for (size_t c = 0; c < components; ++c) {
+                            output[c] = c < sourceComponents ? input[c] : padding;
+                        }
+                    }
+
+                    const size_t scalars = count * components;
+                    switch (element.Format) {
+                        case VertexFormat::Float2:
+                        case VertexFormat::Float3:
+                        case VertexFormat::Float4:
+                            std::memcpy(encoded, gathered, scalars * sizeof(float));
+                            break;
+                        case VertexFormat::Half2:
+                        case VertexFormat::Half4:
+                            EncodeHalf(gathered, reinterpret_cast<uint16_t*>(encoded), scalars);
+                            break;
+                        case VertexFormat::SNorm10x3_2:
+                            EncodeSNorm10x3_2(gathered, reinterpret_cast<uint32_t*>(encoded), count);
+                            break;
+                        case VertexFormat::Octahedral16:
+                            EncodeOctahedral(gathered, reinterpret_cast<int16_t*>(encoded), count);
+                            break;
+                        case VertexFormat::UNorm16x2:
+                            EncodeUNorm16(gathered, reinterpret_cast<uint16_t*>(encoded), scalars);
+                            break;
+                        case VertexFormat::UNorm8x4:
+                            EncodeUNorm8(gathered, encoded, scalars);
+                            break;
+                        case VertexFormat::UInt8x4:
+                            break;
+                    }
+                }
+
+                for (size_t v = 0; v < count; ++v) {
+                    std::memcpy(destination + (first + v) * stride, encoded + v * size, size);
+                }
+            }
+        }
+        return packed;
+    }
+
+    bool TexCoordsInUnitRange(const Vertex* vertices, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            const glm::vec2& uv = vertices[i].texCoord;
+            if (!(uv.x >= 0.0f && uv.x <= 1.0f && uv.y >= 0.0f && uv.y <= 1.0f)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Renderer/Mesh.h"
+#include "Renderer/VertexLayout.h"
+
+namespace Circe {
+
+    // Per-vertex inputs for packing; the optional arrays are null when a mesh has none
+    struct VertexSource {
+        const Vertex* Vertices = nullptr;
+        size_t Count = 0;
+        // xyz + handedness in w
+        const glm::vec4* Tangents = nullptr;
+        const glm::vec4* Colors = nullptr;
+        // Four per vertex
+        const uint8_t* BoneIndices = nullptr;
+        const glm::vec4* BoneWeights = nullptr;
+    };
+
+    struct PackedVertices {
+        std::array<std::vector<unsigned char>, VertexLayout::MaxStreams> Streams;
+    };
+
+    // CPU-side attribute encoders. The kernels take tightly packed input and use SSE2 (and F16C
+    // for halves) when the target has it; results are bit-identical to the scalar path.
+    namespace VertexEncoding {
+
+        // IEEE binary16, round to nearest even, overflow to infinity
+        void EncodeHalf(const float* input, uint16_t* output, size_t count);
+        void DecodeHalf(const uint16_t* input, float* output, size_t count);
+
+        // Clamped to [0, 1], rounded to nearest
+        void EncodeUNorm16(const float* input, uint16_t* output, size_t count);
+        void EncodeUNorm8(const float* input, uint8_t* output, size_t count);
+
+        // Four floats (xyz in [-1, 1], w in {-1, 0, 1}) per output
+        void EncodeSNorm10x3_2(const float* input, uint32_t* output, size_t count);
+        glm::vec4 DecodeSNorm10x3_2(uint32_t packed);
+
+        // Three floats per unit vector in, two SNORM16 out. In GLSL:
+        //   vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+        //   if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * mix(vec2(-1.0), vec2(1.0), greaterThanEqual(n.xy, vec2(0.0)));
+        //   n = normalize(n);
+        void EncodeOctahedral(const float* input, int16_t* output, size_t count);
+        glm::vec3 DecodeOctahedral(const int16_t* encoded);
+
+        // Every index must be below 65536
+        void NarrowIndices(const uint32_t* input, uint16_t* output, size_t count);
+
+        // Interleaves the source into the layout's streams. Throws std::runtime_error when the
+        // layout asks for an attribute the source does not have.
+        PackedVertices Pack(const VertexSource& source, const VertexLayout& layout);
+
+        bool TexCoordsInUnitRange(const Vertex* vertices, size_t count);
+
+    }
+
+}
@@ -0,0 +1,148 @@
+#include "VertexLayout.h"
+#include <glad/glad.h>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace Circe {
+
+    namespace {
+
+        struct FormatInfo {
+            int Components;
+            GLenum Type;
+            GLboolean Normalized;
+            size_t Size;
+        };
+
+        FormatInfo GetFormatInfo(VertexFormat format) {
+            switch (format) {
+                case VertexFormat::Float2:       return { 2, GL_FLOAT, GL_FALSE, 8 };
+                case VertexFormat::Float3:       return { 3, GL_FLOAT, GL_FALSE, 12 };
+                case VertexFormat::Float4:       return { 4, GL_FLOAT, GL_FALSE, 16 };
+                case VertexFormat::Half2:        return { 2, GL_HALF_FLOAT, GL_FALSE, 4 };
+                case VertexFormat::Half4:        return { 4, GL_HALF_FLOAT, GL_FALSE, 8 };
+                case VertexFormat::SNorm10x3_2:  return { 4, GL_INT_2_10_10_10_REV, GL_TRUE, 4 };
+                case VertexFormat::Octahedral16: return { 2, GL_SHORT, GL_TRUE, 4 };
+                case VertexFormat::UNorm16x2:    return { 2, GL_UNSIGNED_SHORT, GL_TRUE, 4 };
+                case VertexFormat::UNorm8x4:     return { 4, GL_UNSIGNED_BYTE, GL_TRUE, 4 };
+                case VertexFormat::UInt8x4:      return { 4, GL_UNSIGNED_BYTE, GL_FALSE, 4 };
+            }
+            throw std::runtime_error("Unknown vertex format");
+        }
+
+        bool IsSupported(VertexAttribute attribute, VertexFormat format) {
+            if (attribute == VertexAttribute::BoneIndices || format == VertexFormat::UInt8x4) {
+                return attribute == VertexAttribute::BoneIndices && format == VertexFormat::UInt8x4;
+            }
+            switch (format) {
+                case VertexFormat::Octahedral16:
+                    // No room for the tangent handedness
+                    return attribute == VertexAttribute::Normal;
+                case VertexFormat::SNorm10x3_2:
+                    return attribute == VertexAttribute::Normal || attribute == VertexAttribute::Tangent;
+                case VertexFormat::UNorm16x2:
+                    return attribute == VertexAttribute::TexCoord;
+                case VertexFormat::UNorm8x4:
+                    return attribute == VertexAttribute::Color || attribute == VertexAttribute::BoneWeights;
+                case VertexFormat::Float2:
+                case VertexFormat::Half2:
+                    return attribute == VertexAttribute::TexCoord;
+                default:
+                    // Wider formats are padded (w = 1 for positions, 0 otherwise)
+                    return attribute != VertexAttribute::TexCoord;
+            }
+        }
+
+    }
+
+    VertexLayout& VertexLayout::Add(VertexAttribute attribute, VertexFormat format, uint8_t stream) {
+        if (stream >= MaxStreams) {
+            throw std::runtime_error("Vertex stream index out of range");
+        }
+        if (!IsSupported(attribute, format)) {
+            throw std::runtime_error("Unsupported vertex format for attribute " + std::to_string(static_cast<int>(attribute)));
+        }
+        if (Find(attribute)) {
+            throw std::runtime_error("Vertex attribute added twice: " + std::to_string(static_cast<int>(attribute)));
+        }
+
+        // Every format is a multiple of 4 bytes, so elements stay aligned for the vertex fetch
+        const size_t offset = m_Strides[stream];
+        if (offset + GetFormatSize(format) > std::numeric_limits<uint8_t>::max()) {
+            throw std::runtime_error("Vertex stream too wide");
+        }
+        m_Elements.push_back({ attribute, format, stream, static_cast<uint8_t>(offset) });
+        m_Strides[stream] += GetFormatSize(format);
+        return *this;
+    }
+
+    const VertexElement* VertexLayout::Find(VertexAttribute attribute) const {
+        for (const VertexElement& element : m_Elements) {
+            if (element.Attribute == attribute) {
+                return &element;
+            }
+        }
+        return nullptr;
+    }
+
+    size_t VertexLayout::GetStreamCount() const {
+        size_t count = 0;
+        for (size_t stream = 0; stream < MaxStreams; stream++) {
+            if (m_Strides[stream] > 0) {
+                count = stream + 1;
+            }
+        }
+        return count;
+    }
+
+    size_t VertexLayout::GetVertexSize() const {
+        size_t size = 0;
+        for (size_t stride : m_Strides) {
+            size += stride;
+        }
+        return size;
+    }
+
+    void VertexLayout::Apply(const unsigned int* buffers) const {
+        for (const VertexElement& element : m_Elements) {
+            const FormatInfo info = GetFormatInfo(element.Format);
+            const GLuint location = static_cast<GLuint>(element.Attribute);
+            const GLsizei stride = static_cast<GLsizei>(m_Strides[element.Stream]);
+            const void* offset = reinterpret_cast<const void*>(static_cast<uintptr_t>(element.Offset));
+
+            glBindBuffer(GL_ARRAY_BUFFER, buffers[element.Stream]);
+            glEnableVertexAttribArray(location);
+            if (element.Format == VertexFormat::UInt8x4) {
+                glVertexAttribIPointer(location, info.Components, info.Type, stride, offset);
+            } else {
+                glVertexAttribPointer(location, info.Components, info.Type, info.Normalized, stride, offset);
+            }
+        }
+    }
+
+    VertexLayout VertexLayout::Standard() {
+        VertexLayout layout;
+        layout.Add(VertexAttribute::Position, VertexFormat::Float3)
+            .Add(VertexAttribute::Normal, VertexFormat::Float3)
+            .Add(VertexAttribute::TexCoord, VertexFormat::Float2);
+        return layout;
+    }
+
+    VertexLayout VertexLayout::Compact(bool texCoordsInUnitRange) {
+        VertexLayout layout;
+        layout.Add(VertexAttribute::Position, VertexFormat::Half4, 0)
+            .Add(VertexAttribute::Normal, VertexFormat::SNorm10x3_2, 1)
+            .Add(VertexAttribute::TexCoord, texCoordsInUnitRange ? VertexFormat::UNorm16x2 : VertexFormat::Half2, 1);
+        return layout;
+    }
+
+    size_t VertexLayout::GetFormatSize(VertexFormat format) {
+        return GetFormatInfo(format).Size;
+    }
+
+    IndexFormat VertexLayout::SelectIndexFormat(size_t vertexCount) {
+        return vertexCount <= 65536 ? IndexFormat::UInt16 : IndexFormat::UInt32;
+    }
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Circe {
+
+    // Shader input locations. 3-6 are taken by the instance matrix (see Renderer).
+    enum class VertexAttribute : uint8_t {
+        Position = 0,
+        Normal = 1,
+        TexCoord = 2,
+        Tangent = 7,
+        Color = 8,
+        BoneIndices = 9,
+        BoneWeights = 10
+    };
+
+    // Storage formats. Everything except Octahedral16 is expanded to floats by the vertex fetch,
+    // so shaders declaring vec2/vec3/vec4 inputs work unchanged with any of them.
+    enum class VertexFormat : uint8_t {
+        Float2,
+        Float3,
+        Float4,
+        Half2,
+        Half4,
+        // Signed normalized 10-10-10 xyz + 2-bit w (GL_INT_2_10_10_10_REV)
+        SNorm10x3_2,
+        // Unit vector folded onto an octahedron, two SNORM16; the shader has to unfold it
+        Octahedral16,
+        // [0, 1] only, use Half2 for repeating texture coordinates
+        UNorm16x2,
+        UNorm8x4,
+        // Integer input (ivec4/uvec4), bone indices only
+        UInt8x4
+    };
+
+    enum class IndexFormat : uint8_t {
+        UInt16,
+        UInt32
+    };
+
+    struct VertexElement {
+        VertexAttribute Attribute;
+        VertexFormat Format;
+        uint8_t Stream;
+        uint8_t Offset;
+    };
+
+    // How the attributes of a mesh are packed into up to MaxStreams interleaved vertex buffers
+    class VertexLayout {
+    public:
+        static constexpr size_t MaxStreams = 4;
+
+        // Appends to the end of the stream. Throws std::runtime_error on an attribute/format
+        // combination the encoder cannot produce or a duplicate attribute.
+        VertexLayout& Add(VertexAttribute attribute, VertexFormat format, uint8_t stream = 0);
+
+        const std::vector<VertexElement>& GetElements() const { return m_Elements; }
+        const VertexElement* Find(VertexAttribute attribute) const;
+        size_t GetStride(size_t stream) const { return m_Strides[stream]; }
+        size_t GetStreamCount() const;
+        size_t GetVertexSize() const;
+
+        // Points every attribute at buffers[element.Stream]; expects the target VAO to be bound
+        void Apply(const unsigned int* buffers) const;
+
+        // Matches Circe::Vertex: float position, normal and texCoord in one 32-byte stream
+        static VertexLayout Standard();
+        // 16 bytes: half positions alone in stream 0 (depth-only passes fetch 8 bytes),
+        // 10-10-10-2 normals and UNORM16 (or half, when they repeat) texCoords in stream 1
+        static VertexLayout Compact(bool texCoordsInUnitRange = true);
+
+        static size_t GetFormatSize(VertexFormat format);
+        static IndexFormat SelectIndexFormat(size_t vertexCount);
+        static size_t GetIndexSize(IndexFormat format) { return format == IndexFormat::UInt16 ? 2 : 4; }
+
+    private:
+        std::vector<VertexElement> m_Elements;
+        std::array<size_t, MaxStreams> m_Strides{};
+    };
+
+}
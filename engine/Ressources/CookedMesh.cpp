@@ -0,0 +1,306 @@
+#include "CookedMesh.h"
+#include "../Core/Profiling/Profiler.h"
+#include "../Renderer/VertexEncoding.h"
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace Circe {
+
+    // The streams are memcpy'd in and mapped back out, so the in-memory layout is the file layout
+    static_assert(std::endian::native == std::endian::little, "Cooked meshes are stored little-endian");
+    static_assert(std::is_trivially_copyable_v<Vertex> && sizeof(Vertex) == 32, "Vertex layout changed, bump CookedMeshVersion");
+    static_assert(sizeof(CookedMeshHeader) == 56 && sizeof(CookedMeshEntry) == 80 && sizeof(CookedMaterialEntry) == 32);
+
+    namespace {
+
+        uint64_t Align(uint64_t offset) {
+            return (offset + CookedMeshAlignment - 1) & ~(CookedMeshAlignment - 1);
+        }
+
+        // offset + count * stride <= size, without overflowing
+        bool InRange(uint64_t offset, uint64_t count, uint64_t stride, uint64_t size) {
+            return offset <= size && count <= (size - offset) / stride;
+        }
+
+        void WritePadding(std::ofstream& file, uint64_t& position, uint64_t target) {
+            static const char zeros[CookedMeshAlignment] = {};
+            while (position < target) {
+                const uint64_t count = std::min<uint64_t>(target - position, sizeof(zeros));
+                file.write(zeros, static_cast<std::streamsize>(count));
+                position += count;
+            }
+        }
+
+        void WriteBytes(std::ofstream& file, uint64_t& position, const void* data, uint64_t size) {
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            position += size;
+        }
+
+        // Texture paths are stored relative to the cooked file so the output can be moved as a folder
+        std::string MakeRelative(const std::string& texture, const std::filesystem::path& directory) {
+            if (texture.empty()) {
+                return texture;
+            }
+            const std::filesystem::path absolute = std::filesystem::absolute(texture).lexically_normal();
+            const std::filesystem::path relative = absolute.lexically_relative(std::filesystem::absolute(directory).lexically_normal());
+            return (relative.empty() ? absolute : relative).generic_string();
+        }
+
+    }
+
+    void CookedMesh::Write(const ModelData& data, const std::string& path) {
+        CIRCE_PROFILE_SCOPE("CookedMesh::Write");
+
+        const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+
+        // String table
+        std::string strings;
+        auto addString = [&strings](const std::string& text, uint32_t& offset, uint32_t& length) {
+            offset = static_cast<uint32_t>(strings.size());
+            length = static_cast<uint32_t>(text.size());
+            strings += text;
+        };
+
+        std::vector<CookedMaterialEntry> materials(data.Materials.size());
+        for (size_t i = 0; i < data.Materials.size(); i++) {
+            const MaterialData& source = data.Materials[i];
+            CookedMaterialEntry& entry = materials[i];
+            for (int c = 0; c < 4; c++) {
+                entry.BaseColor[c] = source.BaseColor[c];
+            }
+            addString(source.Name, entry.NameOffset, entry.NameLength);
+            addString(MakeRelative(source.DiffuseTexture, directory), entry.TextureOffset, entry.TextureLength);
+        }
+
+        // Layout
+        CookedMeshHeader header{};
+        header.Magic = CookedMeshMagic;
+        header.Version = CookedMeshVersion;
+        header.MeshCount = static_cast<uint32_t>(data.Meshes.size());
+        header.MaterialCount = static_cast<uint32_t>(materials.size());
+        header.MeshTableOffset = Align(sizeof(CookedMeshHeader));
+        header.MaterialTableOffset = Align(header.MeshTableOffset + data.Meshes.size() * sizeof(CookedMeshEntry));
+        header.StringTableOffset = Align(header.MaterialTableOffset + materials.size() * sizeof(CookedMaterialEntry));
+        header.StringTableSize = strings.size();
+
+        std::vector<CookedMeshEntry> meshes(data.Meshes.size());
+        std::vector<std::vector<uint16_t>> narrowIndices(data.Meshes.size());
+        uint64_t offset = header.StringTableOffset + header.StringTableSize;
+        for (size_t i = 0; i < data.Meshes.size(); i++) {
+            const MeshData& source = data.Meshes[i];
+            CookedMeshEntry& entry = meshes[i];
+            entry.VertexCount = static_cast<uint32_t>(source.Vertices.size());
+            entry.IndexCount = static_cast<uint32_t>(source.Indices.size());
+            entry.MaterialIndex = source.MaterialIndex;
+            entry.VertexStride = sizeof(Vertex);
+            entry.IndexSize = static_cast<uint32_t>(VertexLayout::GetIndexSize(VertexLayout::SelectIndexFormat(source.Vertices.size())));
+            entry.VertexOffset = Align(offset);
+            entry.IndexOffset = Align(entry.VertexOffset + source.Vertices.size() * sizeof(Vertex));
+            offset = entry.IndexOffset + source.Indices.size() * entry.IndexSize;
+            if (entry.IndexSize == sizeof(uint16_t)) {
+                narrowIndices[i].resize(source.Indices.size());
+                VertexEncoding::NarrowIndices(source.Indices.data(), narrowIndices[i].data(), source.Indices.size());
+            }
+
+            AABB bounds;
+            BoundingSphere sphere;
+            Mesh::ComputeBounds(source.Vertices.data(), source.Vertices.size(), bounds, sphere);
+            for (int c = 0; c < 3; c++) {
+                entry.BoundsMin[c] = bounds.Min[c];
+                entry.BoundsMax[c] = bounds.Max[c];
+                entry.SphereCenter[c] = sphere.Center[c];
+            }
+            entry.SphereRadius = sphere.Radius;
+        }
+        header.FileSize = offset;
+
+        // Write to a temporary and rename, so a failed cook never leaves a truncated file behind
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                throw std::runtime_error("Failed to create cooked mesh: " + path);
+            }
+
+            uint64_t position = 0;
+            WriteBytes(file, position, &header, sizeof(header));
+            WritePadding(file, position, header.MeshTableOffset);
+            WriteBytes(file, position, meshes.data(), meshes.size() * sizeof(CookedMeshEntry));
+            WritePadding(file, position, header.MaterialTableOffset);
+            WriteBytes(file, position, materials.data(), materials.size() * sizeof(CookedMaterialEntry));
+            WritePadding(file, position, header.StringTableOffset);
+            WriteBytes(file, position, strings.data(), strings.size());
+            for (size_t i = 0; i < data.Meshes.size(); i++) {
+                const MeshData& source = data.Meshes[i];
+                WritePadding(file, position, meshes[i].VertexOffset);
+                WriteBytes(file, position, source.Vertices.data(), source.Vertices.size() * sizeof(Vertex));
+                WritePadding(file, position, meshes[i].IndexOffset);
+                if (meshes[i].IndexSize == sizeof(uint16_t)) {
+                    WriteBytes(file, position, narrowIndices[i].data(), narrowIndices[i].size() * sizeof(uint16_t));
+                } else {
+                    WriteBytes(file, position, source.Indices.data(), source.Indices.size() * sizeof(unsigned int));
+                }
+            }
+
+            if (!file.good()) {
+                file.close();
+                std::filesystem::remove(temporary);
+                throw std::runtime_error("Failed to write cooked mesh: " + path);
+            }
+        }
+        std::filesystem::rename(temporary, path);
+    }
+
+    void CookedMesh::Open(const std::string& path) {
+        CIRCE_PROFILE_SCOPE("CookedMesh::Open");
+
+        Close();
+        m_File.Open(path);
+
+        const unsigned char* base = m_File.GetData();
+        const uint64_t size = m_File.GetSize();
+        auto fail = [&](const char* reason) {
+            Close();
+            throw std::runtime_error(std::string("Invalid cooked mesh (") + reason + "): " + path);
+        };
+
+        if (size < sizeof(CookedMeshHeader)) {
+            fail("truncated header");
+        }
+        const auto* header = reinterpret_cast<const CookedMeshHeader*>(base);
+        if (header->Magic != CookedMeshMagic) {
+            fail("bad magic");
+        }
+        if (header->Version != CookedMeshVersion) {
+            fail("version mismatch, re-cook the source");
+        }
+        if (header->FileSize != size) {
+            fail("size mismatch");
+        }
+        if (header->MeshTableOffset % CookedMeshAlignment != 0 || header->MaterialTableOffset % CookedMeshAlignment != 0 ||
+            !InRange(header->MeshTableOffset, header->MeshCount, sizeof(CookedMeshEntry), size) ||
+            !InRange(header->MaterialTableOffset, header->MaterialCount, sizeof(CookedMaterialEntry), size) ||
+            !InRange(header->StringTableOffset, header->StringTableSize, 1, size)) {
+            fail("table out of range");
+        }
+
+        const auto* meshes = reinterpret_cast<const CookedMeshEntry*>(base + header->MeshTableOffset);
+        const auto* materials = reinterpret_cast<const CookedMaterialEntry*>(base + header->MaterialTableOffset);
+
+        // Only the tables are checked; index values are trusted, reading them all would fault in every page
+        for (uint32_t i = 0; i < header->MeshCount; i++) {
+            const CookedMeshEntry& entry = meshes[i];
+            if (entry.VertexStride != sizeof(Vertex)) {
+                fail("vertex layout mismatch");
+            }
+            if (entry.IndexSize != VertexLayout::GetIndexSize(VertexLayout::SelectIndexFormat(entry.VertexCount))) {
+                fail("index format mismatch");
+            }
+            if (entry.VertexOffset % CookedMeshAlignment != 0 || entry.IndexOffset % CookedMeshAlignment != 0 ||
+                !InRange(entry.VertexOffset, entry.VertexCount, sizeof(Vertex), size) ||
+                !InRange(entry.IndexOffset, entry.IndexCount, entry.IndexSize, size) ||
+                entry.IndexCount % 3 != 0) {
+                fail("stream out of range");
+            }
+            if (entry.MaterialIndex < -1 || entry.MaterialIndex >= static_cast<int32_t>(header->MaterialCount)) {
+                fail("material index out of range");
+            }
+        }
+        for (uint32_t i = 0; i < header->MaterialCount; i++) {
+            const CookedMaterialEntry& entry = materials[i];
+            if (!InRange(entry.NameOffset, entry.NameLength, 1, header->StringTableSize) ||
+                !InRange(entry.TextureOffset, entry.TextureLength, 1, header->StringTableSize)) {
+                fail("string out of range");
+            }
+        }
+
+        m_Header = header;
+        m_Meshes = meshes;
+        m_Materials = materials;
+        m_Strings = reinterpret_cast<const char*>(base + header->StringTableOffset);
+        m_Directory = std::filesystem::path(path).parent_path().string();
+    }
+
+    void CookedMesh::Close() {
+        m_File.Close();
+        m_Directory.clear();
+        m_Header = nullptr;
+        m_Meshes = nullptr;
+        m_Materials = nullptr;
+        m_Strings = nullptr;
+    }
+
+    const Vertex* CookedMesh::GetVertices(size_t index) const {
+        return reinterpret_cast<const Vertex*>(m_File.GetData() + m_Meshes[index].VertexOffset);
+    }
+
+    const void* CookedMesh::GetIndices(size_t index) const {
+        return m_File.GetData() + m_Meshes[index].IndexOffset;
+    }
+
+    IndexFormat CookedMesh::GetIndexFormat(size_t index) const {
+        return m_Meshes[index].IndexSize == sizeof(uint16_t) ? IndexFormat::UInt16 : IndexFormat::UInt32;
+    }
+
+    AABB CookedMesh::GetBounds(size_t index) const {
+        const CookedMeshEntry& entry = m_Meshes[index];
+        return AABB(glm::vec3(entry.BoundsMin[0], entry.BoundsMin[1], entry.BoundsMin[2]),
+            glm::vec3(entry.BoundsMax[0], entry.BoundsMax[1], entry.BoundsMax[2]));
+    }
+
+    BoundingSphere CookedMesh::GetBoundingSphere(size_t index) const {
+        const CookedMeshEntry& entry = m_Meshes[index];
+        BoundingSphere sphere;
+        sphere.Center = glm::vec3(entry.SphereCenter[0], entry.SphereCenter[1], entry.SphereCenter[2]);
+        sphere.Radius = entry.SphereRadius;
+        return sphere;
+    }
+
+    MaterialData CookedMesh::GetMaterial(size_t index) const {
+        const CookedMaterialEntry& entry = m_Materials[index];
+        MaterialData material;
+        material.Name = std::string(GetString(entry.NameOffset, entry.NameLength));
+        material.BaseColor = glm::vec4(entry.BaseColor[0], entry.BaseColor[1], entry.BaseColor[2], entry.BaseColor[3]);
+        const std::string_view texture = GetString(entry.TextureOffset, entry.TextureLength);
+        if (!texture.empty()) {
+            material.DiffuseTexture = (std::filesystem::path(m_Directory) / texture).lexically_normal().string();
+        }
+        return material;
+    }
+
+    ModelData CookedMesh::ToModelData() const {
+        CIRCE_PROFILE_SCOPE("CookedMesh::ToModelData");
+
+        ModelData data;
+        data.SourceBytes = GetFileSize();
+        data.Materials.reserve(GetMaterialCount());
+        for (size_t i = 0; i < GetMaterialCount(); i++) {
+            data.Materials.push_back(GetMaterial(i));
+        }
+        data.Meshes.resize(GetMeshCount());
+        for (size_t i = 0; i < GetMeshCount(); i++) {
+            const CookedMeshEntry& entry = m_Meshes[i];
+            MeshData& mesh = data.Meshes[i];
+            mesh.Vertices.assign(GetVertices(i), GetVertices(i) + entry.VertexCount);
+            if (GetIndexFormat(i) == IndexFormat::UInt16) {
+                const auto* indices = static_cast<const uint16_t*>(GetIndices(i));
+                mesh.Indices.assign(indices, indices + entry.IndexCount);
+            } else {
+                const auto* indices = static_cast<const unsigned int*>(GetIndices(i));
+                mesh.Indices.assign(indices, indices + entry.IndexCount);
+            }
+            mesh.MaterialIndex = entry.MaterialIndex;
+        }
+        return data;
+    }
+
+    std::string_view CookedMesh::GetString(uint32_t offset, uint32_t length) const {
+        return std::string_view(m_Strings + offset, length);
+    }
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "Core/MappedFile.h"
+#include "ModelLoader.h"
+
+namespace Circe {
+
+    // On-disk layout of a cooked mesh file (.cmesh), little-endian:
+    //   CookedMeshHeader
+    //   CookedMeshEntry[MeshCount]
+    //   CookedMaterialEntry[MaterialCount]
+    //   string table (material names and texture paths, not null-terminated)
+    //   per mesh: Vertex[VertexCount], then index[IndexCount] of IndexSize bytes each
+    // Every table and stream starts on a CookedMeshAlignment boundary so the mapped
+    // data can be handed to the GPU as is. Indices are stored in the format Mesh would pick
+    // (16 bits up to 65536 vertices), so they are uploaded without narrowing them first.
+    constexpr uint32_t CookedMeshMagic = 0x48534D43; // "CMSH"
+    constexpr uint32_t CookedMeshVersion = 2;
+    constexpr uint64_t CookedMeshAlignment = 64;
+
+    struct CookedMeshHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t MeshCount;
+        uint32_t MaterialCount;
+        uint64_t FileSize;
+        uint64_t MeshTableOffset;
+        uint64_t MaterialTableOffset;
+        uint64_t StringTableOffset;
+        uint64_t StringTableSize;
+    };
+
+    struct CookedMeshEntry {
+        uint64_t VertexOffset;
+        uint64_t IndexOffset;
+        uint32_t VertexCount;
+        uint32_t IndexCount;
+        int32_t MaterialIndex;
+        uint32_t VertexStride;
+        // 2 or 4, VertexLayout::SelectIndexFormat(VertexCount)
+        uint32_t IndexSize;
+        float BoundsMin[3];
+        float BoundsMax[3];
+        float SphereCenter[3];
+        float SphereRadius;
+        uint32_t Reserved;
+    };
+
+    struct CookedMaterialEntry {
+        float BaseColor[4];
+        uint32_t NameOffset;
+        uint32_t NameLength;
+        // Relative to the cooked file's directory
+        uint32_t TextureOffset;
+        uint32_t TextureLength;
+    };
+
+    // Read side keeps the file mapped; vertex and index pointers stay valid until Close().
+    class CookedMesh {
+    public:
+        // Optimize/normals are applied by the source loaders, the cooked data is written as is
+        static void Write(const ModelData& data, const std::string& path);
+
+        // Maps the file and validates header, tables and stream ranges without touching the
+        // streams themselves. Throws std::runtime_error on a malformed or outdated file.
+        void Open(const std::string& path);
+        void Close();
+        // Read-ahead for callers about to consume every stream (e.g. uploading them all)
+        void Prefetch() const { m_File.PrefetchSequential(); }
+
+        size_t GetMeshCount() const { return m_Header ? m_Header->MeshCount : 0; }
+        size_t GetMaterialCount() const { return m_Header ? m_Header->MaterialCount : 0; }
+        size_t GetFileSize() const { return m_File.GetSize(); }
+
+        const CookedMeshEntry& GetEntry(size_t index) const { return m_Meshes[index]; }
+        const Vertex* GetVertices(size_t index) const;
+        // IndexCount indices of GetIndexFormat(index)
+        const void* GetIndices(size_t index) const;
+        IndexFormat GetIndexFormat(size_t index) const;
+        AABB GetBounds(size_t index) const;
+        BoundingSphere GetBoundingSphere(size_t index) const;
+
+        // Texture path resolved against the cooked file's directory
+        MaterialData GetMaterial(size_t index) const;
+
+        // Copies everything out, for callers that want to keep or edit the data
+        ModelData ToModelData() const;
+
+    private:
+        std::string_view GetString(uint32_t offset, uint32_t length) const;
+
+        MappedFile m_File;
+        std::string m_Directory;
+        const CookedMeshHeader* m_Header = nullptr;
+        const CookedMeshEntry* m_Meshes = nullptr;
+        const CookedMaterialEntry* m_Materials = nullptr;
+        const char* m_Strings = nullptr;
+    };
+
+}
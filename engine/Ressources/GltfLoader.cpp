@@ -0,0 +1,533 @@
+#include "GltfLoader.h"
+#include "Json.h"
+#include "MeshOptimizer.h"
+#include "../Core/Jobs/JobSystem.h"
+#include "../Core/Profiling/Profiler.h"
+#include "Math/Transform.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+
+namespace Circe {
+
+    namespace {
+
+        constexpr uint32_t GlbMagic = 0x46546C67;     // "glTF"
+        constexpr uint32_t GlbChunkJson = 0x4E4F534A; // "JSON"
+        constexpr uint32_t GlbChunkBin = 0x004E4942;  // "BIN\0"
+
+        enum ComponentType {
+            Byte = 5120,
+            UnsignedByte = 5121,
+            Short = 5122,
+            UnsignedShort = 5123,
+            UnsignedInt = 5125,
+            Float = 5126
+        };
+
+        constexpr int TrianglesMode = 4;
+        constexpr int MaxNodeDepth = 64;
+
+        struct Asset {
+            JsonValue Document;
+            std::vector<std::string> Buffers;
+            std::filesystem::path Directory;
+            std::string Path;
+        };
+
+        // Validated typed view into a buffer
+        struct Accessor {
+            const unsigned char* Data = nullptr;
+            size_t Count = 0;
+            size_t Stride = 0;
+            int ComponentType = Float;
+            int Components = 1;
+            bool Normalized = false;
+        };
+
+        [[noreturn]] void Fail(const Asset& asset, const std::string& message) {
+            throw std::runtime_error("Invalid glTF file " + asset.Path + ": " + message);
+        }
+
+        uint32_t ReadU32(const std::string& data, size_t offset) {
+            uint32_t value;
+            std::memcpy(&value, data.data() + offset, sizeof(value));
+            return value;
+        }
+
+        std::string DecodeBase64(std::string_view text) {
+            static constexpr auto Table = []() {
+                std::array<int8_t, 256> table{};
+                table.fill(-1);
+                const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+                for (int i = 0; i < 64; i++) {
+                    table[static_cast<unsigned char>(alphabet[i])] = static_cast<int8_t>(i);
+                }
+                return table;
+            }();
+
+            std::string out;
+            out.reserve(text.size() / 4 * 3);
+            uint32_t accumulator = 0;
+            int bits = 0;
+            for (char c : text) {
+                const int8_t value = Table[static_cast<unsigned char>(c)];
+                if (value < 0) {
+                    continue;
+                }
+                accumulator = (accumulator << 6) | static_cast<uint32_t>(value);
+                bits += 6;
+                if (bits >= 8) {
+                    bits -= 8;
+                    out += static_cast<char>((accumulator >> bits) & 0xFF);
+                }
+            }
+            return out;
+        }
+
+        // Relative URIs may be percent-encoded
+        std::string DecodeUri(std::string_view uri) {
+            std::string out;
+            for (size_t i = 0; i < uri.size(); i++) {
+                if (uri[i] == '%' && i + 2 < uri.size()) {
+                    unsigned int value = 0;
+                    if (std::from_chars(uri.data() + i + 1, uri.data() + i + 3, value, 16).ptr == uri.data() + i + 3) {
+                        out += static_cast<char>(value);
+                        i += 2;
+                        continue;
+                    }
+                }
+                out += uri[i];
+            }
+            return out;
+        }
+
+        Asset OpenAsset(const std::string& path) {
+            Asset asset;
+            asset.Path = path;
+            asset.Directory = std::filesystem::path(path).parent_path();
+
+            std::string file = ModelLoader::ReadFile(path);
+            std::string binaryChunk;
+            bool hasBinaryChunk = false;
+
+            if (file.size() >= 12 && ReadU32(file, 0) == GlbMagic) {
+                // Header, then length-prefixed chunks: JSON first, optional BIN second
+                size_t offset = 12;
+                std::string_view json;
+                while (offset + 8 <= file.size()) {
+                    const uint32_t length = ReadU32(file, offset);
+                    const uint32_t type = ReadU32(file, offset + 4);
+                    offset += 8;
+                    if (offset + length > file.size()) {
+                        Fail(asset, "truncated chunk");
+                    }
+                    if (type == GlbChunkJson) {
+                        json = std::string_view(file).substr(offset, length);
+                    } else if (type == GlbChunkBin && !hasBinaryChunk) {
+                        binaryChunk = file.substr(offset, length);
+                        hasBinaryChunk = true;
+                    }
+                    offset += (length + 3) & ~3u;
+                }
+                if (json.empty()) {
+                    Fail(asset, "missing JSON chunk");
+                }
+                asset.Document = JsonValue::Parse(json);
+            } else {
+                asset.Document = JsonValue::Parse(file);
+            }
+
+            const JsonValue& buffers = asset.Document["buffers"];
+            for (size_t i = 0; i < buffers.Size(); i++) {
+                const JsonValue& buffer = buffers[i];
+                const std::string& uri = buffer["uri"].AsString();
+                std::string data;
+                if (uri.empty()) {
+                    if (i != 0 || !hasBinaryChunk) {
+                        Fail(asset, "buffer without uri");
+                    }
+                    data = std::move(binaryChunk);
+                } else if (uri.rfind("data:", 0) == 0) {
+                    const size_t comma = uri.find(',');
+                    if (comma == std::string::npos || uri.find(";base64") > comma) {
+                        Fail(asset, "unsupported data uri");
+                    }
+                    data = DecodeBase64(std::string_view(uri).substr(comma + 1));
+                } else {
+                    data = ModelLoader::ReadFile((asset.Directory / DecodeUri(uri)).string());
+                }
+
+                if (data.size() < static_cast<size_t>(buffer["byteLength"].AsNumber())) {
+                    Fail(asset, "buffer shorter than byteLength");
+                }
+                asset.Buffers.push_back(std::move(data));
+            }
+            return asset;
+        }
+
+        int ComponentSize(int type) {
+            switch (type) {
+            case Byte:
+            case UnsignedByte: return 1;
+            case Short:
+            case UnsignedShort: return 2;
+            case UnsignedInt:
+            case Float: return 4;
+            default: return 0;
+            }
+        }
+
+        int ComponentCount(const std::string& type) {
+            if (type == "SCALAR") return 1;
+            if (type == "VEC2") return 2;
+            if (type == "VEC3") return 3;
+            if (type == "VEC4") return 4;
+            if (type == "MAT4") return 16;
+            return 0;
+        }
+
+        Accessor GetAccessor(const Asset& asset, int index) {
+            const JsonValue& accessor = asset.Document["accessors"][static_cast<size_t>(index)];
+            if (!accessor.IsObject()) {
+                Fail(asset, "accessor index out of range");
+            }
+            if (accessor.Has("sparse")) {
+                Fail(asset, "sparse accessors are not supported");
+            }
+
+            Accessor view;
+            view.Count = static_cast<size_t>(accessor["count"].AsNumber());
+            view.ComponentType = accessor["componentType"].AsInt();
+            view.Components = ComponentCount(accessor["type"].AsString());
+            view.Normalized = accessor["normalized"].AsBool();
+            const size_t elementSize = static_cast<size_t>(ComponentSize(view.ComponentType)) * view.Components;
+            if (elementSize == 0) {
+                Fail(asset, "unsupported accessor type");
+            }
+
+            const JsonValue& bufferView = asset.Document["bufferViews"][static_cast<size_t>(accessor["bufferView"].AsInt(-1))];
+            if (!bufferView.IsObject()) {
+                Fail(asset, "accessor without buffer view");
+            }
+            const size_t bufferIndex = static_cast<size_t>(bufferView["buffer"].AsInt(-1));
+            if (bufferIndex >= asset.Buffers.size()) {
+                Fail(asset, "buffer index out of range");
+            }
+
+            const std::string& buffer = asset.Buffers[bufferIndex];
+            const size_t offset = static_cast<size_t>(bufferView["byteOffset"].AsNumber()) + static_cast<size_t>(accessor["byteOffset"].AsNumber());
+            view.Stride = bufferView.Has("byteStride") ? static_cast<size_t>(bufferView["byteStride"].AsNumber()) : elementSize;
+            if (view.Count > 0 && offset + (view.Count - 1) * view.Stride + elementSize > buffer.size()) {
+                Fail(asset, "accessor reads past its buffer");
+            }
+            view.Data = reinterpret_cast<const unsigned char*>(buffer.data()) + offset;
+            return view;
+        }
+
+        float ReadComponent(const Accessor& accessor, const unsigned char* data, int component) {
+            switch (accessor.ComponentType) {
+            case Float: {
+                float value;
+                std::memcpy(&value, data + component * 4, 4);
+                return value;
+            }
+            case UnsignedByte: {
+                const float value = data[component];
+                return accessor.Normalized ? value / 255.0f : value;
+            }
+            case Byte: {
+                const float value = static_cast<int8_t>(data[component]);
+                return accessor.Normalized ? std::max(value / 127.0f, -1.0f) : value;
+            }
+            case UnsignedShort: {
+                uint16_t value;
+                std::memcpy(&value, data + component * 2, 2);
+                return accessor.Normalized ? value / 65535.0f : static_cast<float>(value);
+            }
+            case Short: {
+                int16_t value;
+                std::memcpy(&value, data + component * 2, 2);
+                return accessor.Normalized ? std::max(value / 32767.0f, -1.0f) : static_cast<float>(value);
+            }
+            default:
+                return 0.0f;
+            }
+        }
+
+        uint32_t ReadIndex(const Accessor& accessor, size_t i) {
+            const unsigned char* data = accessor.Data + i * accessor.Stride;
+            switch (accessor.ComponentType) {
+            case UnsignedByte:
+                return data[0];
+            case UnsignedShort: {
+                uint16_t value;
+                std::memcpy(&value, data, 2);
+                return value;
+            }
+            default: {
+                uint32_t value;
+                std::memcpy(&value, data, 4);
+                return value;
+            }
+            }
+        }
+
+        glm::mat4 GetNodeMatrix(const JsonValue& node) {
+            const JsonValue& matrix = node["matrix"];
+            if (matrix.Size() == 16) {
+                glm::mat4 result(1.0f);
+                for (int column = 0; column < 4; column++) {
+                    for (int row = 0; row < 4; row++) {
+                        result[column][row] = static_cast<float>(matrix[static_cast<size_t>(column * 4 + row)].AsNumber());
+                    }
+                }
+                return result;
+            }
+
+            Transform transform;
+            const JsonValue& translation = node["translation"];
+            const JsonValue& rotation = node["rotation"];
+            const JsonValue& scale = node["scale"];
+            if (translation.Size() == 3) {
+                transform.Position = glm::vec3(translation[0].AsNumber(), translation[1].AsNumber(), translation[2].AsNumber());
+            }
+            if (rotation.Size() == 4) {
+                // glTF stores x, y, z, w
+                transform.Rotation = glm::quat(
+                    static_cast<float>(rotation[3].AsNumber()), static_cast<float>(rotation[0].AsNumber()),
+                    static_cast<float>(rotation[1].AsNumber()), static_cast<float>(rotation[2].AsNumber()));
+            }
+            if (scale.Size() == 3) {
+                transform.Scale = glm::vec3(scale[0].AsNumber(1.0), scale[1].AsNumber(1.0), scale[2].AsNumber(1.0));
+            }
+            return transform.GetModelMatrix();
+        }
+
+        // One triangle primitive at one place in the scene, accessors validated up front
+        // so the parallel build cannot throw
+        struct Placement {
+            glm::mat4 World;
+            Accessor Positions;
+            Accessor Normals;
+            Accessor TexCoords;
+            Accessor Indices;
+            bool HasNormals = false;
+            bool HasTexCoords = false;
+            bool HasIndices = false;
+            int Material = -1;
+        };
+
+        void CollectNode(const Asset& asset, size_t nodeIndex, const glm::mat4& parent, int depth,
+            std::vector<Placement>& placements) {
+            const JsonValue& node = asset.Document["nodes"][nodeIndex];
+            if (!node.IsObject() || depth > MaxNodeDepth) {
+                Fail(asset, "invalid node hierarchy");
+            }
+
+            const glm::mat4 world = parent * GetNodeMatrix(node);
+            if (node.Has("mesh")) {
+                const JsonValue& mesh = asset.Document["meshes"][static_cast<size_t>(node["mesh"].AsInt(-1))];
+                const JsonValue& primitives = mesh["primitives"];
+                for (size_t p = 0; p < primitives.Size(); p++) {
+                    const JsonValue& primitive = primitives[p];
+                    if (primitive["mode"].AsInt(TrianglesMode) != TrianglesMode) {
+                        continue;
+                    }
+
+                    const JsonValue& attributes = primitive["attributes"];
+                    if (!attributes.Has("POSITION")) {
+                        continue;
+                    }
+
+                    Placement placement;
+                    placement.World = world;
+                    placement.Positions = GetAccessor(asset, attributes["POSITION"].AsInt());
+                    if (placement.Positions.Components != 3) {
+                        Fail(asset, "POSITION must be VEC3");
+                    }
+                    if (attributes.Has("NORMAL")) {
+                        placement.Normals = GetAccessor(asset, attributes["NORMAL"].AsInt());
+                        placement.HasNormals = placement.Normals.Components == 3 && placement.Normals.Count == placement.Positions.Count;
+                    }
+                    if (attributes.Has("TEXCOORD_0")) {
+                        placement.TexCoords = GetAccessor(asset, attributes["TEXCOORD_0"].AsInt());
+                        placement.HasTexCoords = placement.TexCoords.Components == 2 && placement.TexCoords.Count == placement.Positions.Count;
+                    }
+                    if (primitive.Has("indices")) {
+                        placement.Indices = GetAccessor(asset, primitive["indices"].AsInt());
+                        const int type = placement.Indices.ComponentType;
+                        if (placement.Indices.Components != 1 || (type != UnsignedByte && type != UnsignedShort && type != UnsignedInt)) {
+                            Fail(asset, "indices must be unsigned byte, short or int scalars");
+                        }
+                        placement.HasIndices = true;
+                    }
+                    placement.Material = primitive["material"].AsInt(-1);
+                    placements.push_back(placement);
+                }
+            }
+
+            const JsonValue& children = node["children"];
+            for (size_t c = 0; c < children.Size(); c++) {
+                CollectNode(asset, static_cast<size_t>(children[c].AsInt()), world, depth + 1, placements);
+            }
+        }
+
+        bool BuildMesh(const Placement& placement, MeshData& mesh) {
+            const size_t vertexCount = placement.Positions.Count;
+            const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(placement.World)));
+
+            mesh.Vertices.resize(vertexCount);
+            for (size_t i = 0; i < vertexCount; i++) {
+                Vertex& vertex = mesh.Vertices[i];
+                const unsigned char* position = placement.Positions.Data + i * placement.Positions.Stride;
+                vertex.position = glm::vec3(placement.World * glm::vec4(
+                    ReadComponent(placement.Positions, position, 0),
+                    ReadComponent(placement.Positions, position, 1),
+                    ReadComponent(placement.Positions, position, 2), 1.0f));
+
+                if (placement.HasNormals) {
+                    const unsigned char* normal = placement.Normals.Data + i * placement.Normals.Stride;
+                    const glm::vec3 n = normalMatrix * glm::vec3(
+                        ReadComponent(placement.Normals, normal, 0),
+                        ReadComponent(placement.Normals, normal, 1),
+                        ReadComponent(placement.Normals, normal, 2));
+                    const float length = glm::length(n);
+                    vertex.normal = length > 0.0f ? n / length : n;
+                } else {
+                    vertex.normal = glm::vec3(0.0f);
+                }
+
+                if (placement.HasTexCoords) {
+                    const unsigned char* texCoord = placement.TexCoords.Data + i * placement.TexCoords.Stride;
+                    vertex.texCoord = glm::vec2(
+                        ReadComponent(placement.TexCoords, texCoord, 0),
+                        ReadComponent(placement.TexCoords, texCoord, 1));
+                } else {
+                    vertex.texCoord = glm::vec2(0.0f);
+                }
+            }
+
+            if (placement.HasIndices) {
+                mesh.Indices.resize(placement.Indices.Count - placement.Indices.Count % 3);
+                for (size_t i = 0; i < mesh.Indices.size(); i++) {
+                    const uint32_t index = ReadIndex(placement.Indices, i);
+                    if (index >= vertexCount) {
+                        return false;
+                    }
+                    mesh.Indices[i] = index;
+                }
+            } else {
+                // Unindexed triangle soup, the dedup below recovers the sharing
+                mesh.Indices.resize(vertexCount - vertexCount % 3);
+                for (size_t i = 0; i < mesh.Indices.size(); i++) {
+                    mesh.Indices[i] = static_cast<unsigned int>(i);
+                }
+                MeshOptimizer::DeduplicateVertices(mesh.Vertices, mesh.Indices);
+            }
+
+            // A mirroring transform turns the triangles inside out, flip them back
+            if (glm::determinant(glm::mat3(placement.World)) < 0.0f) {
+                for (size_t i = 0; i + 2 < mesh.Indices.size(); i += 3) {
+                    std::swap(mesh.Indices[i + 1], mesh.Indices[i + 2]);
+                }
+            }
+            return true;
+        }
+
+        void LoadMaterials(const Asset& asset, ModelData& model) {
+            const JsonValue& materials = asset.Document["materials"];
+            for (size_t i = 0; i < materials.Size(); i++) {
+                const JsonValue& source = materials[i];
+                MaterialData& material = model.Materials.emplace_back();
+                material.Name = source["name"].AsString();
+
+                const JsonValue& pbr = source["pbrMetallicRoughness"];
+                const JsonValue& factor = pbr["baseColorFactor"];
+                if (factor.Size() == 4) {
+                    material.BaseColor = glm::vec4(factor[0].AsNumber(1.0), factor[1].AsNumber(1.0),
+                        factor[2].AsNumber(1.0), factor[3].AsNumber(1.0));
+                }
+
+                const JsonValue& baseColorTexture = pbr["baseColorTexture"];
+                if (baseColorTexture.IsObject()) {
+                    const JsonValue& texture = asset.Document["textures"][static_cast<size_t>(baseColorTexture["index"].AsInt(-1))];
+                    const JsonValue& image = asset.Document["images"][static_cast<size_t>(texture["source"].AsInt(-1))];
+                    const std::string& uri = image["uri"].AsString();
+                    // Images inside buffer views or data uris have no path for the texture cache
+                    if (!uri.empty() && uri.rfind("data:", 0) != 0) {
+                        material.DiffuseTexture = (asset.Directory / DecodeUri(uri)).lexically_normal().generic_string();
+                    }
+                }
+            }
+        }
+
+    }
+
+    ModelData GltfLoader::Load(const std::string& path, const ModelLoadOptions& options) {
+        const Asset asset = OpenAsset(path);
+
+        ModelData model;
+        for (const std::string& buffer : asset.Buffers) {
+            model.SourceBytes += buffer.size();
+        }
+        LoadMaterials(asset, model);
+
+        std::vector<Placement> placements;
+        const JsonValue& scenes = asset.Document["scenes"];
+        if (scenes.Size() > 0) {
+            const JsonValue& scene = scenes[static_cast<size_t>(asset.Document["scene"].AsInt(0))];
+            const JsonValue& roots = scene["nodes"];
+            for (size_t i = 0; i < roots.Size(); i++) {
+                CollectNode(asset, static_cast<size_t>(roots[i].AsInt()), glm::mat4(1.0f), 0, placements);
+            }
+        } else {
+            // No scene: every node without a parent is a root
+            const JsonValue& nodes = asset.Document["nodes"];
+            std::vector<uint8_t> isChild(nodes.Size(), 0);
+            for (size_t n = 0; n < nodes.Size(); n++) {
+                const JsonValue& children = nodes[n]["children"];
+                for (size_t c = 0; c < children.Size(); c++) {
+                    const size_t child = static_cast<size_t>(children[c].AsInt());
+                    if (child < isChild.size()) {
+                        isChild[child] = 1;
+                    }
+                }
+            }
+            for (size_t n = 0; n < nodes.Size(); n++) {
+                if (!isChild[n]) {
+                    CollectNode(asset, n, glm::mat4(1.0f), 0, placements);
+                }
+            }
+        }
+
+        model.Meshes.resize(placements.size());
+        std::vector<uint8_t> valid(placements.size(), 1);
+        JobSystem::ParallelFor(0, placements.size(), [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                CIRCE_PROFILE_SCOPE("GltfLoader::BuildMesh");
+                MeshData& mesh = model.Meshes[i];
+                mesh.MaterialIndex = placements[i].Material < static_cast<int>(model.Materials.size()) ? placements[i].Material : -1;
+                if (!BuildMesh(placements[i], mesh)) {
+                    valid[i] = 0;
+                    continue;
+                }
+                ModelLoader::FinalizeMesh(mesh, options, placements[i].HasNormals);
+            }
+        }, 1);
+
+        for (uint8_t ok : valid) {
+            if (!ok) {
+                throw std::runtime_error("Invalid glTF file " + path + ": index out of range");
+            }
+        }
+
+        std::erase_if(model.Meshes, [](const MeshData& mesh) { return mesh.Indices.empty(); });
+        return model;
+    }
+
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include "ModelLoader.h"
+
+namespace Circe {
+
+    // glTF 2.0, both .gltf (external or base64 buffers) and binary .glb. Triangle primitives
+    // are placed with their node transforms baked into the vertices, one mesh per placement.
+    // Skins, morph targets, sparse accessors and embedded images are not imported.
+    class GltfLoader {
+    public:
+        static ModelData Load(const std::string& path, const ModelLoadOptions& options);
+    };
+
+}
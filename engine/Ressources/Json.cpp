@@ -0,0 +1,230 @@
+#include "Json.h"
+#include <charconv>
+#include <stdexcept>
+
+namespace Circe {
+
+    class JsonValue::Parser {
+    public:
+        explicit Parser(std::string_view text)
+            : m_Text(text) {
+        }
+
+        JsonValue ParseDocument() {
+            JsonValue value = ParseValue(0);
+            SkipWhitespace();
+            if (m_Position != m_Text.size()) {
+                Fail("trailing characters");
+            }
+            return value;
+        }
+
+    private:
+        static constexpr int MaxDepth = 256;
+
+        [[noreturn]] void Fail(const char* message) const {
+            throw std::runtime_error("JSON parse error at byte " + std::to_string(m_Position) + ": " + message);
+        }
+
+        void SkipWhitespace() {
+            while (m_Position < m_Text.size()) {
+                const char c = m_Text[m_Position];
+                if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                    break;
+                }
+                m_Position++;
+            }
+        }
+
+        bool Consume(char c) {
+            SkipWhitespace();
+            if (m_Position < m_Text.size() && m_Text[m_Position] == c) {
+                m_Position++;
+                return true;
+            }
+            return false;
+        }
+
+        void Expect(char c) {
+            if (!Consume(c)) {
+                Fail("unexpected character");
+            }
+        }
+
+        bool ConsumeLiteral(std::string_view literal) {
+            if (m_Text.substr(m_Position, literal.size()) == literal) {
+                m_Position += literal.size();
+                return true;
+            }
+            return false;
+        }
+
+        JsonValue ParseValue(int depth) {
+            if (depth > MaxDepth) {
+                Fail("nesting too deep");
+            }
+
+            SkipWhitespace();
+            if (m_Position >= m_Text.size()) {
+                Fail("unexpected end of input");
+            }
+
+            JsonValue value;
+            const char c = m_Text[m_Position];
+            if (c == '{') {
+                m_Position++;
+                value.m_Type = Type::Object;
+                if (!Consume('}')) {
+                    do {
+                        SkipWhitespace();
+                        std::string key = ParseString();
+                        Expect(':');
+                        value.m_Members.emplace_back(std::move(key), ParseValue(depth + 1));
+                    } while (Consume(','));
+                    Expect('}');
+                }
+            } else if (c == '[') {
+                m_Position++;
+                value.m_Type = Type::Array;
+                if (!Consume(']')) {
+                    do {
+                        value.m_Elements.push_back(ParseValue(depth + 1));
+                    } while (Consume(','));
+                    Expect(']');
+                }
+            } else if (c == '"') {
+                value.m_Type = Type::String;
+                value.m_String = ParseString();
+            } else if (ConsumeLiteral("true")) {
+                value.m_Type = Type::Bool;
+                value.m_Bool = true;
+            } else if (ConsumeLiteral("false")) {
+                value.m_Type = Type::Bool;
+            } else if (ConsumeLiteral("null")) {
+                value.m_Type = Type::Null;
+            } else {
+                value.m_Type = Type::Number;
+                const char* begin = m_Text.data() + m_Position;
+                const char* end = m_Text.data() + m_Text.size();
+                const auto result = std::from_chars(begin, end, value.m_Number);
+                if (result.ec != std::errc()) {
+                    Fail("invalid value");
+                }
+                m_Position += static_cast<size_t>(result.ptr - begin);
+            }
+            return value;
+        }
+
+        void AppendUtf8(std::string& out, uint32_t codepoint) {
+            if (codepoint < 0x80) {
+                out += static_cast<char>(codepoint);
+            } else if (codepoint < 0x800) {
+                out += static_cast<char>(0xC0 | (codepoint >> 6));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            } else if (codepoint < 0x10000) {
+                out += static_cast<char>(0xE0 | (codepoint >> 12));
+                out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (codepoint >> 18));
+                out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            }
+        }
+
+        uint32_t ParseHex4() {
+            if (m_Position + 4 > m_Text.size()) {
+                Fail("truncated escape");
+            }
+            uint32_t value = 0;
+            const auto result = std::from_chars(m_Text.data() + m_Position, m_Text.data() + m_Position + 4, value, 16);
+            if (result.ptr != m_Text.data() + m_Position + 4) {
+                Fail("invalid escape");
+            }
+            m_Position += 4;
+            return value;
+        }
+
+        std::string ParseString() {
+            if (m_Position >= m_Text.size() || m_Text[m_Position] != '"') {
+                Fail("expected string");
+            }
+            m_Position++;
+
+            std::string out;
+            while (true) {
+                if (m_Position >= m_Text.size()) {
+                    Fail("unterminated string");
+                }
+                const char c = m_Text[m_Position++];
+                if (c == '"') {
+                    return out;
+                }
+                if (c != '\\') {
+                    out += c;
+                    continue;
+                }
+
+                if (m_Position >= m_Text.size()) {
+                    Fail("unterminated string");
+                }
+                const char escape = m_Text[m_Position++];
+                switch (escape) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t codepoint = ParseHex4();
+                    // Surrogate pair
+                    if (codepoint >= 0xD800 && codepoint < 0xDC00 && ConsumeLiteral("\\u")) {
+                        const uint32_t low = ParseHex4();
+                        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    AppendUtf8(out, codepoint);
+                    break;
+                }
+                default:
+                    Fail("invalid escape");
+                }
+            }
+        }
+
+        std::string_view m_Text;
+        size_t m_Position = 0;
+    };
+
+    JsonValue JsonValue::Parse(std::string_view text) {
+        return Parser(text).ParseDocument();
+    }
+
+    bool JsonValue::Has(std::string_view key) const {
+        for (const auto& [name, value] : m_Members) {
+            if (name == key) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const JsonValue& JsonValue::operator[](std::string_view key) const {
+        static const JsonValue null;
+        for (const auto& [name, value] : m_Members) {
+            if (name == key) {
+                return value;
+            }
+        }
+        return null;
+    }
+
+    const JsonValue& JsonValue::operator[](size_t index) const {
+        static const JsonValue null;
+        return index < m_Elements.size() ? m_Elements[index] : null;
+    }
+
+}
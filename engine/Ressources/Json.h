@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Circe {
+
+    // Read-only JSON document tree, enough for glTF. Lookups of missing keys or indices
+    // return a shared null value so chained access never throws.
+    class JsonValue {
+    public:
+        enum class Type { Null, Bool, Number, String, Array, Object };
+
+        // Throws std::runtime_error with the byte offset on malformed input
+        static JsonValue Parse(std::string_view text);
+
+        Type GetType() const { return m_Type; }
+        bool IsNull() const { return m_Type == Type::Null; }
+        bool IsNumber() const { return m_Type == Type::Number; }
+        bool IsString() const { return m_Type == Type::String; }
+        bool IsArray() const { return m_Type == Type::Array; }
+        bool IsObject() const { return m_Type == Type::Object; }
+
+        bool AsBool(bool fallback = false) const { return m_Type == Type::Bool ? m_Bool : fallback; }
+        double AsNumber(double fallback = 0.0) const { return m_Type == Type::Number ? m_Number : fallback; }
+        int AsInt(int fallback = 0) const { return m_Type == Type::Number ? static_cast<int>(m_Number) : fallback; }
+        const std::string& AsString() const { return m_String; }
+
+        // Array length or object member count
+        size_t Size() const { return m_Type == Type::Object ? m_Members.size() : m_Elements.size(); }
+        bool Has(std::string_view key) const;
+
+        const JsonValue& operator[](std::string_view key) const;
+        const JsonValue& operator[](size_t index) const;
+
+        const std::vector<JsonValue>& GetElements() const { return m_Elements; }
+
+    private:
+        class Parser;
+
+        Type m_Type = Type::Null;
+        bool m_Bool = false;
+        double m_Number = 0.0;
+        std::string m_String;
+        std::vector<JsonValue> m_Elements;
+        std::vector<std::pair<std::string, JsonValue>> m_Members;
+    };
+
+}
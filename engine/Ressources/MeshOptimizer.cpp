@@ -0,0 +1,273 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <numeric>
+
+namespace Circe::MeshOptimizer {
+
+    namespace {
+
+        uint64_t HashVertex(const Vertex& vertex) {
+            // FNV-1a over the raw bits, -0.0f and 0.0f stay distinct which is harmless
+            unsigned char bytes[sizeof(Vertex)];
+            std::memcpy(bytes, &vertex, sizeof(Vertex));
+            uint64_t hash = 14695981039346656037ull;
+            for (unsigned char byte : bytes) {
+                hash ^= byte;
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        bool SameVertex(const Vertex& a, const Vertex& b) {
+            return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+        }
+
+    }
+
+    void DeduplicateVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+        if (vertices.empty()) {
+            return;
+        }
+
+        // Open addressing at <= 50% load, slots hold unique vertex index + 1
+        const size_t capacity = std::bit_ceil(vertices.size() * 2);
+        std::vector<uint32_t> table(capacity, 0);
+        std::vector<unsigned int> remap(vertices.size());
+        std::vector<Vertex> unique;
+        unique.reserve(vertices.size());
+
+        for (size_t i = 0; i < vertices.size(); i++) {
+            size_t slot = HashVertex(vertices[i]) & (capacity - 1);
+            while (table[slot] != 0 && !SameVertex(unique[table[slot] - 1], vertices[i])) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            if (table[slot] == 0) {
+                unique.push_back(vertices[i]);
+                table[slot] = static_cast<uint32_t>(unique.size());
+            }
+            remap[i] = table[slot] - 1;
+        }
+
+        for (unsigned int& index : indices) {
+            index = remap[index];
+        }
+        vertices.swap(unique);
+    }
+
+    void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount,
+        std::vector<uint32_t>* clusters, unsigned int cacheSize) {
+        const size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0) {
+            return;
+        }
+
+        // Vertex -> triangle adjacency in CSR form
+        std::vector<uint32_t> liveTriangles(vertexCount, 0);
+        for (unsigned int index : indices) {
+            liveTriangles[index]++;
+        }
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; v++) {
+            offsets[v + 1] = offsets[v] + liveTriangles[v];
+        }
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t t = 0; t < triangleCount; t++) {
+                for (size_t k = 0; k < 3; k++) {
+                    adjacency[cursor[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+                }
+            }
+        }
+
+        std::vector<uint32_t> cacheTime(vertexCount, 0);
+        std::vector<uint8_t> emitted(triangleCount, 0);
+        std::vector<uint32_t> deadEnds;
+        std::vector<uint32_t> candidates;
+        std::vector<unsigned int> output;
+        output.reserve(indices.size());
+        if (clusters) {
+            clusters->clear();
+        }
+
+        uint32_t time = cacheSize + 1;
+        size_t scanCursor = 0;
+        int64_t fanning = 0;
+        bool flushed = true;
+
+        while (fanning >= 0) {
+            if (flushed && clusters) {
+                clusters->push_back(static_cast<uint32_t>(output.size() / 3));
+            }
+
+            candidates.clear();
+            const uint32_t vertex = static_cast<uint32_t>(fanning);
+            for (uint32_t a = offsets[vertex]; a < offsets[vertex + 1]; a++) {
+                const uint32_t triangle = adjacency[a];
+                if (emitted[triangle]) {
+                    continue;
+                }
+                for (size_t k = 0; k < 3; k++) {
+                    const unsigned int v = indices[triangle * 3 + k];
+                    output.push_back(v);
+                    deadEnds.push_back(v);
+                    candidates.push_back(v);
+                    liveTriangles[v]--;
+                    if (time - cacheTime[v] > cacheSize) {
+                        cacheTime[v] = time++;
+                    }
+                }
+                emitted[triangle] = 1;
+            }
+
+            // Prefer the candidate that is in cache and still will be after its fan is emitted
+            int64_t next = -1;
+            int64_t bestPriority = -1;
+            for (uint32_t v : candidates) {
+                if (liveTriangles[v] == 0) {
+                    continue;
+                }
+                int64_t priority = 0;
+                if (time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize) {
+                    priority = time - cacheTime[v];
+                }
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    next = v;
+                }
+            }
+
+            flushed = next < 0;
+            if (next < 0) {
+                while (!deadEnds.empty()) {
+                    const uint32_t v = deadEnds.back();
+                    deadEnds.pop_back();
+                    if (liveTriangles[v] > 0) {
+                        next = v;
+                        break;
+                    }
+                }
+            }
+            if (next < 0) {
+                while (scanCursor < vertexCount && liveTriangles[scanCursor] == 0) {
+                    scanCursor++;
+                }
+                next = scanCursor < vertexCount ? static_cast<int64_t>(scanCursor) : -1;
+            }
+            fanning = next;
+        }
+
+        indices.swap(output);
+    }
+
+    void OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices,
+        const std::vector<uint32_t>& clusters) {
+        const size_t triangleCount = indices.size() / 3;
+        if (clusters.size() < 2 || triangleCount == 0) {
+            return;
+        }
+
+        // Area-weighted centroid of the whole mesh
+        glm::vec3 meshCentroid(0.0f);
+        float meshArea = 0.0f;
+        for (size_t t = 0; t < triangleCount; t++) {
+            const glm::vec3& a = vertices[indices[t * 3 + 0]].position;
+            const glm::vec3& b = vertices[indices[t * 3 + 1]].position;
+            const glm::vec3& c = vertices[indices[t * 3 + 2]].position;
+            const float area = glm::length(glm::cross(b - a, c - a));
+            meshCentroid += (a + b + c) * (area / 3.0f);
+            meshArea += area;
+        }
+        if (meshArea > 0.0f) {
+            meshCentroid /= meshArea;
+        }
+
+        struct Cluster {
+            uint32_t First;
+            uint32_t Last;
+            float Sort;
+        };
+        std::vector<Cluster> sorted(clusters.size());
+
+        for (size_t i = 0; i < clusters.size(); i++) {
+            Cluster& cluster = sorted[i];
+            cluster.First = clusters[i];
+            cluster.Last = i + 1 < clusters.size() ? clusters[i + 1] : static_cast<uint32_t>(triangleCount);
+
+            glm::vec3 centroid(0.0f);
+            glm::vec3 normal(0.0f);
+            float area = 0.0f;
+            for (uint32_t t = cluster.First; t < cluster.Last; t++) {
+                const glm::vec3& a = vertices[indices[t * 3 + 0]].position;
+                const glm::vec3& b = vertices[indices[t * 3 + 1]].position;
+                const glm::vec3& c = vertices[indices[t * 3 + 2]].position;
+                const glm::vec3 cross = glm::cross(b - a, c - a);
+                const float triangleArea = glm::length(cross);
+                centroid += (a + b + c) * (triangleArea / 3.0f);
+                normal += cross;
+                area += triangleArea;
+            }
+            if (area > 0.0f) {
+                centroid /= area;
+            }
+            const float normalLength = glm::length(normal);
+            cluster.Sort = normalLength > 0.0f ? glm::dot(centroid - meshCentroid, normal / normalLength) : 0.0f;
+        }
+
+        // Clusters facing away from the center are on the outside and tend to occlude
+        std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster& a, const Cluster& b) {
+            return a.Sort > b.Sort;
+        });
+
+        std::vector<unsigned int> output;
+        output.reserve(indices.size());
+        for (const Cluster& cluster : sorted) {
+            output.insert(output.end(), indices.begin() + cluster.First * 3, indices.begin() + cluster.Last * 3);
+        }
+        indices.swap(output);
+    }
+
+    void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+        constexpr unsigned int Unused = ~0u;
+        std::vector<unsigned int> remap(vertices.size(), Unused);
+        std::vector<Vertex> ordered;
+        ordered.reserve(vertices.size());
+
+        for (unsigned int& index : indices) {
+            if (remap[index] == Unused) {
+                remap[index] = static_cast<unsigned int>(ordered.size());
+                ordered.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+        // Vertices no triangle references are dropped
+        vertices.swap(ordered);
+    }
+
+    void Optimize(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+        std::vector<uint32_t> clusters;
+        OptimizeVertexCache(indices, vertices.size(), &clusters);
+        OptimizeOverdraw(indices, vertices, clusters);
+        OptimizeVertexFetch(vertices, indices);
+    }
+
+    float ComputeACMR(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize) {
+        if (indices.size() < 3) {
+            return 0.0f;
+        }
+
+        // FIFO: a vertex is cached while fewer than cacheSize misses happened since it entered
+        std::vector<uint32_t> entered(vertexCount, 0);
+        uint32_t misses = 0;
+        for (unsigned int index : indices) {
+            if (entered[index] == 0 || misses - (entered[index] - 1) >= cacheSize) {
+                misses++;
+                entered[index] = misses;
+            }
+        }
+        return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    }
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Renderer/Mesh.h"
+
+namespace Circe {
+
+    // Index/vertex reordering run on imported meshes before upload
+    namespace MeshOptimizer {
+
+        // Post-transform cache size the orderings are tuned for
+        constexpr unsigned int DefaultCacheSize = 16;
+
+        // Merges bitwise identical vertices and rewrites the indices to match
+        void DeduplicateVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+        // Tipsify (Sander et al. 2007): fans triangles around vertices so they hit the vertex
+        // cache. When clusters is given it receives the first triangle of every run that
+        // started after a cache flush; those runs can be reordered freely afterwards.
+        void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount,
+            std::vector<uint32_t>* clusters = nullptr, unsigned int cacheSize = DefaultCacheSize);
+
+        // Reorders the Tipsify clusters so outward-facing ones draw first and occlude the rest
+        void OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices,
+            const std::vector<uint32_t>& clusters);
+
+        // Renumbers vertices in first-use order so fetches walk the buffer linearly
+        void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+        // Vertex cache, overdraw and fetch passes in that order
+        void Optimize(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+        // Average cache misses per triangle under a FIFO cache (0.5 is ideal for grids, 3 worst)
+        float ComputeACMR(const std::vector<unsigned int>& indices, size_t vertexCount,
+            unsigned int cacheSize = DefaultCacheSize);
+
+    }
+
+}
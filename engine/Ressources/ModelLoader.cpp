@@ -0,0 +1,191 @@
+#include "ModelLoader.h"
+#include "CookedMesh.h"
+#include "ObjLoader.h"
+#include "GltfLoader.h"
+#include "MeshOptimizer.h"
+#include "TextureManager.h"
+#include "../Renderer/Material.h"
+#include "../Renderer/Model.h"
+#include "../Renderer/VertexEncoding.h"
+#include "../Core/Profiling/Profiler.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace Circe {
+
+    namespace {
+
+        std::string GetExtension(const std::string& path) {
+            std::string extension = std::filesystem::path(path).extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(),
+                [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return extension;
+        }
+
+        std::vector<std::shared_ptr<Material>> CreateMaterials(const std::vector<MaterialData>& sources, const std::shared_ptr<Shader>& shader) {
+            std::vector<std::shared_ptr<Material>> materials;
+            materials.reserve(sources.size());
+            for (const MaterialData& source : sources) {
+                auto material = std::make_shared<Material>(shader);
+                material->SetColor(source.BaseColor);
+                if (!source.DiffuseTexture.empty()) {
+                    material->SetTexture("albedo", TextureManager::LoadAsync(source.DiffuseTexture));
+                }
+                materials.push_back(std::move(material));
+            }
+            return materials;
+        }
+
+        // Falls back to a shared untextured material for meshes without one
+        std::shared_ptr<Material> SelectMaterial(const std::vector<std::shared_ptr<Material>>& materials, int index,
+            std::shared_ptr<Material>& defaultMaterial, const std::shared_ptr<Shader>& shader) {
+            if (index >= 0 && index < static_cast<int>(materials.size())) {
+                return materials[index];
+            }
+            if (!defaultMaterial) {
+                defaultMaterial = std::make_shared<Material>(shader);
+            }
+            return defaultMaterial;
+        }
+
+    }
+
+    size_t ModelData::GetTriangleCount() const {
+        size_t count = 0;
+        for (const MeshData& mesh : Meshes) {
+            count += mesh.Indices.size() / 3;
+        }
+        return count;
+    }
+
+    ModelData ModelLoader::LoadData(const std::string& path, const ModelLoadOptions& options) {
+        CIRCE_PROFILE_SCOPE("ModelLoader::LoadData");
+
+        const std::string extension = GetExtension(path);
+        if (extension == ".obj") {
+            return ObjLoader::Load(path, options);
+        }
+        if (extension == ".gltf" || extension == ".glb") {
+            return GltfLoader::Load(path, options);
+        }
+        if (extension == ".cmesh") {
+            CookedMesh cooked;
+            cooked.Open(path);
+            return cooked.ToModelData();
+        }
+        throw std::runtime_error("Unsupported model format: " + path);
+    }
+
+    std::vector<std::shared_ptr<Model>> ModelLoader::Load(const std::string& path, std::shared_ptr<Shader> shader,
+        const ModelLoadOptions& options) {
+        if (GetExtension(path) == ".cmesh") {
+            return LoadCooked(path, std::move(shader));
+        }
+        return CreateModels(LoadData(path, options), std::move(shader), options);
+    }
+
+    std::vector<std::shared_ptr<Model>> ModelLoader::LoadCooked(const std::string& path, std::shared_ptr<Shader> shader) {
+        CIRCE_PROFILE_SCOPE("ModelLoader::LoadCooked");
+
+        CookedMesh cooked;
+        cooked.Open(path);
+        cooked.Prefetch();
+
+        std::vector<MaterialData> sources;
+        sources.reserve(cooked.GetMaterialCount());
+        for (size_t i = 0; i < cooked.GetMaterialCount(); i++) {
+            sources.push_back(cooked.GetMaterial(i));
+        }
+        const std::vector<std::shared_ptr<Material>> materials = CreateMaterials(sources, shader);
+        std::shared_ptr<Material> defaultMaterial;
+
+        // The mapped streams go straight into glBufferData, the mapping is dropped once uploaded
+        std::vector<std::shared_ptr<Model>> models;
+        models.reserve(cooked.GetMeshCount());
+        for (size_t i = 0; i < cooked.GetMeshCount(); i++) {
+            const CookedMeshEntry& entry = cooked.GetEntry(i);
+            if (entry.IndexCount == 0) {
+                continue;
+            }
+            auto mesh = std::make_shared<Mesh>(cooked.GetVertices(i), entry.VertexCount,
+                cooked.GetIndices(i), cooked.GetIndexFormat(i), entry.IndexCount,
+                cooked.GetBounds(i), cooked.GetBoundingSphere(i));
+            models.push_back(std::make_shared<Model>(std::move(mesh), SelectMaterial(materials, entry.MaterialIndex, defaultMaterial, shader)));
+        }
+        return models;
+    }
+
+    std::vector<std::shared_ptr<Model>> ModelLoader::CreateModels(const ModelData& data, std::shared_ptr<Shader> shader,
+        const ModelLoadOptions& options) {
+        CIRCE_PROFILE_SCOPE("ModelLoader::CreateModels");
+
+        const std::vector<std::shared_ptr<Material>> materials = CreateMaterials(data.Materials, shader);
+        std::shared_ptr<Material> defaultMaterial;
+
+        std::vector<std::shared_ptr<Model>> models;
+        models.reserve(data.Meshes.size());
+        for (const MeshData& source : data.Meshes) {
+            if (source.Indices.empty()) {
+                continue;
+            }
+
+            std::shared_ptr<Mesh> mesh;
+            if (options.CompactVertices) {
+                VertexSource vertices;
+                vertices.Vertices = source.Vertices.data();
+                vertices.Count = source.Vertices.size();
+                const VertexLayout layout = VertexLayout::Compact(VertexEncoding::TexCoordsInUnitRange(vertices.Vertices, vertices.Count));
+                mesh = std::make_shared<Mesh>(vertices, source.Indices.data(), source.Indices.size(), layout);
+            } else {
+                mesh = std::make_shared<Mesh>(source.Vertices, source.Indices);
+            }
+            models.push_back(std::make_shared<Model>(std::move(mesh), SelectMaterial(materials, source.MaterialIndex, defaultMaterial, shader)));
+        }
+        return models;
+    }
+
+    std::string ModelLoader::ReadFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open model file: " + path);
+        }
+
+        const std::streamsize size = file.tellg();
+        std::string contents(static_cast<size_t>(size), '\0');
+        file.seekg(0);
+        if (!file.read(contents.data(), size)) {
+            throw std::runtime_error("Failed to read model file: " + path);
+        }
+        return contents;
+    }
+
+    void ModelLoader::FinalizeMesh(MeshData& mesh, const ModelLoadOptions& options, bool hasNormals) {
+        if (!hasNormals && options.GenerateNormals) {
+            // Area-weighted face normals accumulated per vertex
+            for (Vertex& vertex : mesh.Vertices) {
+                vertex.normal = glm::vec3(0.0f);
+            }
+            for (size_t i = 0; i + 2 < mesh.Indices.size(); i += 3) {
+                Vertex& a = mesh.Vertices[mesh.Indices[i + 0]];
+                Vertex& b = mesh.Vertices[mesh.Indices[i + 1]];
+                Vertex& c = mesh.Vertices[mesh.Indices[i + 2]];
+                const glm::vec3 normal = glm::cross(b.position - a.position, c.position - a.position);
+                a.normal += normal;
+                b.normal += normal;
+                c.normal += normal;
+            }
+            for (Vertex& vertex : mesh.Vertices) {
+                const float length = glm::length(vertex.normal);
+                vertex.normal = length > 0.0f ? vertex.normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+        }
+
+        if (options.Optimize) {
+            MeshOptimizer::Optimize(mesh.Vertices, mesh.Indices);
+        }
+    }
+
+}
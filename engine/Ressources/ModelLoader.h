@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Renderer/Mesh.h"
+
+namespace Circe {
+
+    class Model;
+    class Shader;
+
+    struct ModelLoadOptions {
+        // Vertex cache order, overdraw cluster sort and fetch remap (MeshOptimizer::Optimize)
+        bool Optimize = true;
+        // Smooth normals for meshes that come without them
+        bool GenerateNormals = true;
+        // Upload with VertexLayout::Compact (half positions, 10-10-10-2 normals, 16-bit texCoords).
+        // Half positions keep about 1/1000 of the magnitude, so leave this off for large meshes.
+        bool CompactVertices = false;
+    };
+
+    struct MaterialData {
+        std::string Name;
+        glm::vec4 BaseColor = glm::vec4(1.0f);
+        // Resolved against the model's directory, empty when untextured
+        std::string DiffuseTexture;
+    };
+
+    // CPU-side geometry: one mesh per material for OBJ, per placed primitive for glTF
+    struct MeshData {
+        std::vector<Vertex> Vertices;
+        std::vector<unsigned int> Indices;
+        // Into ModelData::Materials, -1 for the default material
+        int MaterialIndex = -1;
+    };
+
+    struct ModelData {
+        std::vector<MeshData> Meshes;
+        std::vector<MaterialData> Materials;
+        size_t SourceBytes = 0;
+
+        size_t GetTriangleCount() const;
+    };
+
+    // Imports Wavefront OBJ (+MTL) and glTF 2.0 (.gltf/.glb). Parsing is spread over the job
+    // system; indices are deduplicated and reordered for the vertex cache before upload.
+    // Cooked .cmesh files (see CookedMesh, tools/MeshCooker) are mapped and uploaded without parsing.
+    class ModelLoader {
+    public:
+        // Any thread, no GL calls. Throws std::runtime_error on unreadable or malformed files.
+        static ModelData LoadData(const std::string& path, const ModelLoadOptions& options = {});
+
+        // GL thread: one Model per mesh, textures stream in through TextureManager
+        static std::vector<std::shared_ptr<Model>> Load(const std::string& path, std::shared_ptr<Shader> shader,
+            const ModelLoadOptions& options = {});
+        static std::vector<std::shared_ptr<Model>> CreateModels(const ModelData& data, std::shared_ptr<Shader> shader,
+            const ModelLoadOptions& options = {});
+        // GL thread: uploads straight from the mapped file, load options do not apply
+        static std::vector<std::shared_ptr<Model>> LoadCooked(const std::string& path, std::shared_ptr<Shader> shader);
+
+        // Shared by the format parsers
+        static std::string ReadFile(const std::string& path);
+        static void FinalizeMesh(MeshData& mesh, const ModelLoadOptions& options, bool hasNormals);
+    };
+
+}
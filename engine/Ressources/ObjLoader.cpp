@@ -0,0 +1,461 @@
+#include "ObjLoader.h"
+#include "../Core/Jobs/JobSystem.h"
+#include "../Core/Profiling/Profiler.h"
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+namespace Circe {
+
+    namespace {
+
+        // Indices after parsing: >= 0 absolute, Missing when the component was left out,
+        // below that a chunk-local relative index offset by RelativeBias
+        constexpr int32_t Missing = -1;
+        constexpr int32_t RelativeBias = 1 << 30;
+
+        struct Corner {
+            int32_t Position;
+            int32_t TexCoord;
+            int32_t Normal;
+
+            bool operator==(const Corner&) const = default;
+        };
+
+        struct MaterialSwitch {
+            size_t Corner;
+            std::string Name;
+        };
+
+        struct Chunk {
+            const char* Begin = nullptr;
+            const char* End = nullptr;
+            std::vector<glm::vec3> Positions;
+            std::vector<glm::vec3> Normals;
+            std::vector<glm::vec2> TexCoords;
+            std::vector<Corner> Corners;
+            std::vector<MaterialSwitch> Switches;
+            std::string Library;
+            bool Malformed = false;
+        };
+
+        constexpr size_t MinChunkSize = 1 << 20;
+
+        const char* SkipSpaces(const char* p, const char* end) {
+            while (p < end && (*p == ' ' || *p == '\t')) {
+                p++;
+            }
+            return p;
+        }
+
+        const char* ParseFloat(const char* p, const char* end, float& out) {
+            p = SkipSpaces(p, end);
+            if (p < end && *p == '+') {
+                p++;
+            }
+            const auto result = std::from_chars(p, end, out);
+            if (result.ec != std::errc()) {
+                out = 0.0f;
+                return p;
+            }
+            return result.ptr;
+        }
+
+        const char* ParseIndex(const char* p, const char* end, size_t localCount, int32_t& out) {
+            int value = 0;
+            const auto result = std::from_chars(p, end, value);
+            if (result.ec != std::errc() || value == 0) {
+                out = Missing;
+                return result.ec != std::errc() ? p : result.ptr;
+            }
+            out = value > 0 ? value - 1 : static_cast<int32_t>(localCount) + value - RelativeBias;
+            return result.ptr;
+        }
+
+        std::string_view Trim(const char* p, const char* end) {
+            p = SkipSpaces(p, end);
+            while (end > p && (end[-1] == ' ' || end[-1] == '\t')) {
+                end--;
+            }
+            return std::string_view(p, static_cast<size_t>(end - p));
+        }
+
+        bool StartsWith(const char* p, const char* end, std::string_view keyword) {
+            const size_t length = keyword.size();
+            return static_cast<size_t>(end - p) > length
+                && std::memcmp(p, keyword.data(), length) == 0
+                && (p[length] == ' ' || p[length] == '\t');
+        }
+
+        void ParseFace(Chunk& chunk, const char* p, const char* end, std::vector<Corner>& polygon) {
+            polygon.clear();
+            while (true) {
+                p = SkipSpaces(p, end);
+                if (p >= end) {
+                    break;
+                }
+
+                Corner corner{ Missing, Missing, Missing };
+                const char* next = ParseIndex(p, end, chunk.Positions.size(), corner.Position);
+                if (next == p) {
+                    chunk.Malformed = true;
+                    return;
+                }
+                p = next;
+                if (p < end && *p == '/') {
+                    p++;
+                    if (p < end && *p != '/') {
+                        p = ParseIndex(p, end, chunk.TexCoords.size(), corner.TexCoord);
+                    }
+                    if (p < end && *p == '/') {
+                        p = ParseIndex(p + 1, end, chunk.Normals.size(), corner.Normal);
+                    }
+                }
+                polygon.push_back(corner);
+
+                while (p < end && *p != ' ' && *p != '\t') {
+                    p++;
+                }
+            }
+
+            // Fan triangulation, fine for the convex polygons exporters write
+            for (size_t i = 1; i + 1 < polygon.size(); i++) {
+                chunk.Corners.push_back(polygon[0]);
+                chunk.Corners.push_back(polygon[i]);
+                chunk.Corners.push_back(polygon[i + 1]);
+            }
+        }
+
+        void ParseChunk(Chunk& chunk) {
+            CIRCE_PROFILE_SCOPE("ObjLoader::ParseChunk");
+
+            std::vector<Corner> polygon;
+            const char* p = chunk.Begin;
+            while (p < chunk.End) {
+                const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(chunk.End - p)));
+                if (!lineEnd) {
+                    lineEnd = chunk.End;
+                }
+                const char* end = lineEnd;
+                if (end > p && end[-1] == '\r') {
+                    end--;
+                }
+
+                const char* line = SkipSpaces(p, end);
+                const size_t length = static_cast<size_t>(end - line);
+                if (length >= 2 && line[0] == 'v') {
+                    if (line[1] == ' ' || line[1] == '\t') {
+                        glm::vec3 position;
+                        const char* q = ParseFloat(line + 2, end, position.x);
+                        q = ParseFloat(q, end, position.y);
+                        ParseFloat(q, end, position.z);
+                        chunk.Positions.push_back(position);
+                    } else if (line[1] == 'n') {
+                        glm::vec3 normal;
+                        const char* q = ParseFloat(line + 2, end, normal.x);
+                        q = ParseFloat(q, end, normal.y);
+                        ParseFloat(q, end, normal.z);
+                        chunk.Normals.push_back(normal);
+                    } else if (line[1] == 't') {
+                        glm::vec2 texCoord;
+                        const char* q = ParseFloat(line + 2, end, texCoord.x);
+                        ParseFloat(q, end, texCoord.y);
+                        // OBJ puts v = 0 at the bottom, images are uploaded top row first
+                        texCoord.y = 1.0f - texCoord.y;
+                        chunk.TexCoords.push_back(texCoord);
+                    }
+                } else if (length >= 2 && line[0] == 'f' && (line[1] == ' ' || line[1] == '\t')) {
+                    ParseFace(chunk, line + 2, end, polygon);
+                } else if (StartsWith(line, end, "usemtl")) {
+                    chunk.Switches.push_back({ chunk.Corners.size(), std::string(Trim(line + 6, end)) });
+                } else if (StartsWith(line, end, "mtllib") && chunk.Library.empty()) {
+                    chunk.Library = std::string(Trim(line + 6, end));
+                }
+
+                p = lineEnd + 1;
+            }
+        }
+
+        int32_t Resolve(int32_t index, size_t base) {
+            return index < Missing ? static_cast<int32_t>(index + RelativeBias + static_cast<int64_t>(base)) : index;
+        }
+
+        void LoadMaterials(const std::filesystem::path& path, ModelData& model,
+            std::unordered_map<std::string, int>& indices) {
+            std::string source;
+            try {
+                source = ModelLoader::ReadFile(path.string());
+            } catch (const std::runtime_error&) {
+                // Missing libraries are common in the wild, faces just use default materials
+                return;
+            }
+
+            const std::filesystem::path directory = path.parent_path();
+            MaterialData* current = nullptr;
+            const char* p = source.data();
+            const char* sourceEnd = source.data() + source.size();
+            while (p < sourceEnd) {
+                const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(sourceEnd - p)));
+                if (!lineEnd) {
+                    lineEnd = sourceEnd;
+                }
+                const char* end = lineEnd;
+                if (end > p && end[-1] == '\r') {
+                    end--;
+                }
+                const char* line = SkipSpaces(p, end);
+
+                if (StartsWith(line, end, "newmtl")) {
+                    MaterialData& material = model.Materials.emplace_back();
+                    material.Name = std::string(Trim(line + 6, end));
+                    indices[material.Name] = static_cast<int>(model.Materials.size() - 1);
+                    current = &material;
+                } else if (current && StartsWith(line, end, "Kd")) {
+                    const char* q = ParseFloat(line + 2, end, current->BaseColor.r);
+                    q = ParseFloat(q, end, current->BaseColor.g);
+                    ParseFloat(q, end, current->BaseColor.b);
+                } else if (current && StartsWith(line, end, "d")) {
+                    ParseFloat(line + 1, end, current->BaseColor.a);
+                } else if (current && StartsWith(line, end, "Tr")) {
+                    float transparency = 0.0f;
+                    ParseFloat(line + 2, end, transparency);
+                    current->BaseColor.a = 1.0f - transparency;
+                } else if (current && StartsWith(line, end, "map_Kd")) {
+                    // Options such as -s come first, the file name is the last token
+                    std::string_view value = Trim(line + 6, end);
+                    const size_t space = value.find_last_of(" \t");
+                    if (space != std::string_view::npos) {
+                        value = value.substr(space + 1);
+                    }
+                    current->DiffuseTexture = (directory / std::string(value)).lexically_normal().generic_string();
+                }
+
+                p = lineEnd + 1;
+            }
+        }
+
+        struct CornerHash {
+            size_t operator()(const Corner& corner) const {
+                uint64_t hash = static_cast<uint32_t>(corner.Position) * 0x9E3779B97F4A7C15ull;
+                hash ^= static_cast<uint32_t>(corner.TexCoord) * 0xC2B2AE3D27D4EB4Full + (hash >> 29);
+                hash ^= static_cast<uint32_t>(corner.Normal) * 0x165667B19E3779F9ull + (hash >> 32);
+                return static_cast<size_t>(hash ^ (hash >> 31));
+            }
+        };
+
+        struct Segment {
+            size_t Begin;
+            size_t End;
+        };
+
+        // Dedups the corners of one material into a vertex/index pair. Returns false when an
+        // index points outside the parsed arrays.
+        bool BuildMesh(MeshData& mesh, const std::vector<Segment>& segments, const std::vector<Corner>& corners,
+            const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals,
+            const std::vector<glm::vec2>& texCoords, bool& hasNormals) {
+            size_t cornerCount = 0;
+            for (const Segment& segment : segments) {
+                cornerCount += segment.End - segment.Begin;
+            }
+            mesh.Indices.reserve(cornerCount);
+
+            // Open addressing keyed on the corner triple, grown at 50% load
+            size_t capacity = std::bit_ceil(std::max<size_t>(64, cornerCount / 2));
+            std::vector<uint32_t> table(capacity, 0);
+            std::vector<Corner> keys;
+            hasNormals = true;
+
+            auto grow = [&]() {
+                capacity *= 2;
+                table.assign(capacity, 0);
+                for (uint32_t i = 0; i < keys.size(); i++) {
+                    size_t slot = CornerHash{}(keys[i]) & (capacity - 1);
+                    while (table[slot] != 0) {
+                        slot = (slot + 1) & (capacity - 1);
+                    }
+                    table[slot] = i + 1;
+                }
+            };
+
+            for (const Segment& segment : segments) {
+                for (size_t c = segment.Begin; c < segment.End; c++) {
+                    const Corner& corner = corners[c];
+                    size_t slot = CornerHash{}(corner) & (capacity - 1);
+                    while (table[slot] != 0 && !(keys[table[slot] - 1] == corner)) {
+                        slot = (slot + 1) & (capacity - 1);
+                    }
+
+                    if (table[slot] == 0) {
+                        if (corner.Position < 0 || static_cast<size_t>(corner.Position) >= positions.size()
+                            || (corner.TexCoord != Missing && (corner.TexCoord < 0 || static_cast<size_t>(corner.TexCoord) >= texCoords.size()))
+                            || (corner.Normal != Missing && (corner.Normal < 0 || static_cast<size_t>(corner.Normal) >= normals.size()))) {
+                            return false;
+                        }
+
+                        Vertex vertex;
+                        vertex.position = positions[corner.Position];
+                        vertex.texCoord = corner.TexCoord != Missing ? texCoords[corner.TexCoord] : glm::vec2(0.0f);
+                        vertex.normal = corner.Normal != Missing ? normals[corner.Normal] : glm::vec3(0.0f);
+                        hasNormals &= corner.Normal != Missing;
+
+                        mesh.Vertices.push_back(vertex);
+                        keys.push_back(corner);
+                        table[slot] = static_cast<uint32_t>(keys.size());
+                        mesh.Indices.push_back(static_cast<unsigned int>(keys.size() - 1));
+
+                        if (keys.size() * 2 > capacity) {
+                            grow();
+                        }
+                        continue;
+                    }
+                    mesh.Indices.push_back(table[slot] - 1);
+                }
+            }
+            return true;
+        }
+
+    }
+
+    ModelData ObjLoader::Load(const std::string& path, const ModelLoadOptions& options) {
+        const std::string source = ModelLoader::ReadFile(path);
+
+        ModelData model;
+        model.SourceBytes = source.size();
+
+        // Chunks end on line boundaries, a few per thread so stealing can even out the load
+        std::vector<Chunk> chunks;
+        {
+            const size_t target = std::max(MinChunkSize, source.size() / (static_cast<size_t>(JobSystem::GetThreadCount()) * 4));
+            const char* begin = source.data();
+            const char* end = source.data() + source.size();
+            while (begin < end) {
+                const char* split = begin + std::min(target, static_cast<size_t>(end - begin));
+                if (split < end) {
+                    const char* newline = static_cast<const char*>(std::memchr(split, '\n', static_cast<size_t>(end - split)));
+                    split = newline ? newline + 1 : end;
+                }
+                Chunk& chunk = chunks.emplace_back();
+                chunk.Begin = begin;
+                chunk.End = split;
+                begin = split;
+            }
+        }
+
+        JobSystem::ParallelFor(0, chunks.size(), [&chunks](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                ParseChunk(chunks[i]);
+            }
+        }, 1);
+
+        // Global offsets of every chunk's elements
+        struct Offsets {
+            size_t Position = 0;
+            size_t Normal = 0;
+            size_t TexCoord = 0;
+            size_t Corner = 0;
+        };
+        std::vector<Offsets> offsets(chunks.size() + 1);
+        for (size_t i = 0; i < chunks.size(); i++) {
+            if (chunks[i].Malformed) {
+                throw std::runtime_error("Malformed face in OBJ file: " + path);
+            }
+            offsets[i + 1].Position = offsets[i].Position + chunks[i].Positions.size();
+            offsets[i + 1].Normal = offsets[i].Normal + chunks[i].Normals.size();
+            offsets[i + 1].TexCoord = offsets[i].TexCoord + chunks[i].TexCoords.size();
+            offsets[i + 1].Corner = offsets[i].Corner + chunks[i].Corners.size();
+        }
+
+        std::vector<glm::vec3> positions(offsets.back().Position);
+        std::vector<glm::vec3> normals(offsets.back().Normal);
+        std::vector<glm::vec2> texCoords(offsets.back().TexCoord);
+        std::vector<Corner> corners(offsets.back().Corner);
+
+        JobSystem::ParallelFor(0, chunks.size(), [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                const Chunk& chunk = chunks[i];
+                const Offsets& base = offsets[i];
+                std::copy(chunk.Positions.begin(), chunk.Positions.end(), positions.begin() + base.Position);
+                std::copy(chunk.Normals.begin(), chunk.Normals.end(), normals.begin() + base.Normal);
+                std::copy(chunk.TexCoords.begin(), chunk.TexCoords.end(), texCoords.begin() + base.TexCoord);
+                for (size_t c = 0; c < chunk.Corners.size(); c++) {
+                    const Corner& corner = chunk.Corners[c];
+                    corners[base.Corner + c] = {
+                        Resolve(corner.Position, base.Position),
+                        Resolve(corner.TexCoord, base.TexCoord),
+                        Resolve(corner.Normal, base.Normal)
+                    };
+                }
+            }
+        }, 1);
+
+        std::unordered_map<std::string, int> materialIndices;
+        for (const Chunk& chunk : chunks) {
+            if (!chunk.Library.empty()) {
+                LoadMaterials(std::filesystem::path(path).parent_path() / chunk.Library, model, materialIndices);
+                break;
+            }
+        }
+
+        // Corner ranges per material, the active material carries across chunk borders
+        std::vector<std::vector<Segment>> groups(1);
+        std::vector<int> groupMaterials{ -1 };
+        std::unordered_map<int, size_t> groupOfMaterial{ { -1, 0 } };
+        size_t currentGroup = 0;
+        size_t segmentBegin = 0;
+        auto closeSegment = [&](size_t end) {
+            if (end > segmentBegin) {
+                groups[currentGroup].push_back({ segmentBegin, end });
+            }
+            segmentBegin = end;
+        };
+        for (size_t i = 0; i < chunks.size(); i++) {
+            for (const MaterialSwitch& change : chunks[i].Switches) {
+                closeSegment(offsets[i].Corner + change.Corner);
+
+                auto found = materialIndices.find(change.Name);
+                if (found == materialIndices.end()) {
+                    found = materialIndices.emplace(change.Name, static_cast<int>(model.Materials.size())).first;
+                    model.Materials.emplace_back().Name = change.Name;
+                }
+                auto [group, inserted] = groupOfMaterial.emplace(found->second, groups.size());
+                if (inserted) {
+                    groups.emplace_back();
+                    groupMaterials.push_back(found->second);
+                }
+                currentGroup = group->second;
+            }
+        }
+        closeSegment(corners.size());
+
+        model.Meshes.resize(groups.size());
+        std::vector<uint8_t> valid(groups.size(), 1);
+        JobSystem::ParallelFor(0, groups.size(), [&](size_t first, size_t last) {
+            for (size_t g = first; g < last; g++) {
+                CIRCE_PROFILE_SCOPE("ObjLoader::BuildMesh");
+                MeshData& mesh = model.Meshes[g];
+                mesh.MaterialIndex = groupMaterials[g];
+                bool hasNormals = true;
+                if (!BuildMesh(mesh, groups[g], corners, positions, normals, texCoords, hasNormals)) {
+                    valid[g] = 0;
+                    continue;
+                }
+                ModelLoader::FinalizeMesh(mesh, options, hasNormals);
+            }
+        }, 1);
+
+        for (uint8_t ok : valid) {
+            if (!ok) {
+                throw std::runtime_error("Face index out of range in OBJ file: " + path);
+            }
+        }
+
+        std::erase_if(model.Meshes, [](const MeshData& mesh) { return mesh.Indices.empty(); });
+        return model;
+    }
+
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include "ModelLoader.h"
+
+namespace Circe {
+
+    // Wavefront OBJ + MTL. The file is split at line boundaries into chunks parsed in
+    // parallel; relative (negative) indices are resolved once chunk offsets are known.
+    // Faces are grouped into one mesh per usemtl material.
+    class ObjLoader {
+    public:
+        static ModelData Load(const std::string& path, const ModelLoadOptions& options);
+    };
+
+}
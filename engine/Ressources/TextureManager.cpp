@@ -0,0 +1,176 @@
+#include "TextureManager.h"
+#include "../Renderer/Texture.h"
+#include "../Renderer/TextureLoader.h"
+#include "../Core/FileWatcher.h"
+#include "../Core/Profiling/Profiler.h"
+#include <algorithm>
+#include <filesystem>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace Circe {
+
+    namespace {
+
+        struct Entry {
+            std::string Path;
+            std::shared_ptr<Circe::Texture> Handle;
+            size_t Bytes = 0;
+        };
+
+        // Front is most recently used. The index keys view into Entry::Path, list nodes never move.
+        std::list<Entry> s_Entries;
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> s_Index;
+        // Streamed entries whose size is still the placeholder's
+        std::vector<std::string_view> s_Streaming;
+
+        size_t s_Budget = 512ull * 1024 * 1024;
+        size_t s_ResidentBytes = 0;
+        uint64_t s_Hits = 0;
+        uint64_t s_Misses = 0;
+        uint64_t s_Evictions = 0;
+
+        std::string Normalize(std::string_view path) {
+            return std::filesystem::path(path).lexically_normal().generic_string();
+        }
+
+        std::shared_ptr<Texture> Lookup(const std::string& key) {
+            auto it = s_Index.find(key);
+            if (it == s_Index.end()) {
+                s_Misses++;
+                return nullptr;
+            }
+            s_Hits++;
+            s_Entries.splice(s_Entries.begin(), s_Entries, it->second);
+            return it->second->Handle;
+        }
+
+        void Insert(std::string key, std::shared_ptr<Texture> texture) {
+            const size_t bytes = texture->GetMemorySize();
+            s_Entries.push_front({ std::move(key), std::move(texture), bytes });
+            s_Index.emplace(s_Entries.front().Path, s_Entries.begin());
+            s_ResidentBytes += bytes;
+            FileWatcher::Watch(s_Entries.front().Path);
+        }
+
+        void Refresh(Entry& entry) {
+            const size_t bytes = entry.Handle->GetMemorySize();
+            s_ResidentBytes = s_ResidentBytes - entry.Bytes + bytes;
+            entry.Bytes = bytes;
+        }
+
+    }
+
+    std::shared_ptr<Texture> TextureManager::Load(const std::string& path) {
+        CIRCE_PROFILE_FUNCTION();
+        std::string key = Normalize(path);
+        if (auto texture = Lookup(key)) {
+            return texture;
+        }
+
+        auto texture = std::make_shared<Texture>(key);
+        Insert(std::move(key), texture);
+        Trim();
+        return texture;
+    }
+
+    std::shared_ptr<Texture> TextureManager::LoadAsync(const std::string& path) {
+        std::string key = Normalize(path);
+        if (auto texture = Lookup(key)) {
+            return texture;
+        }
+
+        auto texture = TextureLoader::Load(key);
+        Insert(std::move(key), texture);
+        s_Streaming.push_back(s_Entries.front().Path);
+        return texture;
+    }
+
+    std::shared_ptr<Texture> TextureManager::Find(std::string_view path) {
+        auto it = s_Index.find(Normalize(path));
+        return it != s_Index.end() ? it->second->Handle : nullptr;
+    }
+
+    void TextureManager::OnFilesChanged(const std::vector<std::string>& paths) {
+        for (const auto& path : paths) {
+            auto it = s_Index.find(Normalize(path));
+            if (it == s_Index.end()) {
+                continue;
+            }
+            Entry& entry = *it->second;
+            TextureLoader::Reload(entry.Handle, entry.Path);
+            if (std::find(s_Streaming.begin(), s_Streaming.end(), std::string_view(entry.Path)) == s_Streaming.end()) {
+                s_Streaming.push_back(entry.Path);
+            }
+        }
+    }
+
+    void TextureManager::Update() {
+        for (size_t i = 0; i < s_Streaming.size();) {
+            auto it = s_Index.find(s_Streaming[i]);
+            if (it == s_Index.end() || it->second->Handle->IsReady()) {
+                if (it != s_Index.end()) {
+                    Refresh(*it->second);
+                }
+                s_Streaming[i] = s_Streaming.back();
+                s_Streaming.pop_back();
+                continue;
+            }
+            i++;
+        }
+
+        if (s_ResidentBytes > s_Budget) {
+            Trim();
+        }
+    }
+
+    void TextureManager::Trim() {
+        auto it = s_Entries.end();
+        while (s_ResidentBytes > s_Budget && it != s_Entries.begin()) {
+            --it;
+            // Still bound by a material or held by game code
+            if (it->Handle.use_count() > 1) {
+                continue;
+            }
+
+            s_ResidentBytes -= it->Bytes;
+            FileWatcher::Unwatch(it->Path);
+            s_Index.erase(it->Path);
+            std::erase(s_Streaming, std::string_view(it->Path));
+            it = s_Entries.erase(it);
+            s_Evictions++;
+        }
+    }
+
+    void TextureManager::Clear() {
+        for (const Entry& entry : s_Entries) {
+            FileWatcher::Unwatch(entry.Path);
+        }
+        s_Streaming.clear();
+        s_Index.clear();
+        s_Entries.clear();
+        s_ResidentBytes = 0;
+    }
+
+    void TextureManager::SetBudget(size_t bytes) {
+        s_Budget = bytes;
+        Trim();
+    }
+
+    size_t TextureManager::GetBudget() {
+        return s_Budget;
+    }
+
+    TextureCacheStats TextureManager::GetStats() {
+        TextureCacheStats stats;
+        stats.Hits = s_Hits;
+        stats.Misses = s_Misses;
+        stats.Evictions = s_Evictions;
+        stats.ResidentCount = static_cast<uint32_t>(s_Entries.size());
+        stats.ResidentBytes = s_ResidentBytes;
+        stats.Budget = s_Budget;
+        return stats;
+    }
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Circe {
+
+    class Texture;
+
+    struct TextureCacheStats {
+        uint64_t Hits = 0;
+        uint64_t Misses = 0;
+        uint64_t Evictions = 0;
+        uint32_t ResidentCount = 0;
+        size_t ResidentBytes = 0;
+        size_t Budget = 0;
+    };
+
+    // Path-keyed texture cache. Paths are normalized so "a/../b.png" and "b.png" share one
+    // entry, and a second request for a resident texture returns the same handle. When the
+    // resident size passes the budget, textures only the cache still references are evicted
+    // least recently used first. GL thread only.
+    class TextureManager {
+    public:
+        static std::shared_ptr<Texture> Load(const std::string& path);
+        // Streams through TextureLoader, the handle shows a placeholder until ready
+        static std::shared_ptr<Texture> LoadAsync(const std::string& path);
+        // Resident texture or null, does not count as a hit or miss
+        static std::shared_ptr<Texture> Find(std::string_view path);
+
+        // Re-decodes resident textures loaded from any of the paths, in place (hot reload).
+        // Resident files are watched while the FileWatcher runs.
+        static void OnFilesChanged(const std::vector<std::string>& paths);
+
+        // Once per frame: picks up the final size of streamed textures and enforces the budget
+        static void Update();
+        // Evicts unreferenced textures until under budget
+        static void Trim();
+        // Drops every cached reference. The engine calls this before the context goes away.
+        static void Clear();
+
+        static void SetBudget(size_t bytes);
+        static size_t GetBudget();
+        static TextureCacheStats GetStats();
+    };
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Circe {
+
+    class IComponentPool {
+    public:
+        virtual ~IComponentPool() = default;
+
+        virtual bool Has(uint32_t entity) const = 0;
+        virtual void Remove(uint32_t entity) = 0;
+        virtual size_t Size() const = 0;
+        virtual const uint32_t* Entities() const = 0;
+    };
+
+    // Sparse set: components of one type packed contiguously, indexed through a sparse
+    // entity -> dense slot table. Removal swaps the last element into the hole.
+    template<typename T>
+    class ComponentPool : public IComponentPool {
+    public:
+        template<typename... Args>
+        T& Emplace(uint32_t entity, Args&&... args) {
+            if (Has(entity)) {
+                return m_Components[m_Sparse[entity]] = T{ std::forward<Args>(args)... };
+            }
+            if (entity >= m_Sparse.size()) {
+                m_Sparse.resize(entity + 1, Tombstone);
+            }
+            m_Sparse[entity] = static_cast<uint32_t>(m_Dense.size());
+            m_Dense.push_back(entity);
+            return m_Components.emplace_back(T{ std::forward<Args>(args)... });
+        }
+
+        void Remove(uint32_t entity) override {
+            if (!Has(entity)) {
+                return;
+            }
+            const uint32_t slot = m_Sparse[entity];
+            const uint32_t last = static_cast<uint32_t>(m_Dense.size() - 1);
+            if (slot != last) {
+                m_Dense[slot] = m_Dense[last];
+                m_Components[slot] = std::move(m_Components[last]);
+                m_Sparse[m_Dense[slot]] = slot;
+            }
+            m_Dense.pop_back();
+            m_Components.pop_back();
+            m_Sparse[entity] = Tombstone;
+        }
+
+        bool Has(uint32_t entity) const override {
+            return entity < m_Sparse.size() && m_Sparse[entity] != Tombstone;
+        }
+
+        T& Get(uint32_t entity) { return m_Components[m_Sparse[entity]]; }
+        const T& Get(uint32_t entity) const { return m_Components[m_Sparse[entity]]; }
+
+        T* TryGet(uint32_t entity) { return Has(entity) ? &m_Components[m_Sparse[entity]] : nullptr; }
+        const T* TryGet(uint32_t entity) const { return Has(entity) ? &m_Components[m_Sparse[entity]] : nullptr; }
+
+        size_t Size() const override { return m_Dense.size(); }
+        const uint32_t* Entities() const override { return m_Dense.data(); }
+
+        // Dense component array, parallel to Entities()
+        T* Data() { return m_Components.data(); }
+        const T* Data() const { return m_Components.data(); }
+
+        void Reserve(size_t count) {
+            m_Dense.reserve(count);
+            m_Components.reserve(count);
+        }
+
+    private:
+        static constexpr uint32_t Tombstone = 0xFFFFFFFF;
+
+        std::vector<uint32_t> m_Sparse;
+        std::vector<uint32_t> m_Dense;
+        std::vector<T> m_Components;
+    };
+
+}
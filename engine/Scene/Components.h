@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../Math/Transform.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Circe {
+
+    class Mesh;
+    class Material;
+    class Entity;
+
+    // Registry entities use Circe::Transform directly as their transform component
+
+    struct NameComponent {
+        std::string Name;
+    };
+
+    struct RenderableComponent {
+        std::shared_ptr<Circe::Mesh> Mesh;
+        std::shared_ptr<Circe::Material> Material;
+    };
+
+    // Present on entities that take part in update and render systems
+    struct ActiveTag {};
+
+    // Entity whose transform lives in the scene's TransformHierarchy. Its local transform
+    // is edited through the hierarchy and it has no plain Transform component.
+    struct HierarchyNodeComponent {
+        uint32_t Node = 0xFFFFFFFF;
+    };
+
+    // Queued by Scene::DestroyEntity, hides the entity from lookups until it is destroyed
+    struct PendingDestroyTag {};
+
+    // Back-reference from the registry to an Entity object added through Scene::AddEntity
+    struct EntityRefComponent {
+        Entity* Instance = nullptr;
+    };
+
+}
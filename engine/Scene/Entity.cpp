@@ -1,9 +1,26 @@
 #include "Entity.h"
 #include "../Renderer/Model.h"
 #include "../Renderer/Renderer.h"
+#include "Scene.h"
 
 namespace Circe {
 
+    void Entity::SetName(const std::string& name) {
+        // A destroyed entity stays out of the name index while it waits for removal
+        if (m_Scene && !m_Scene->m_Registry.Has<PendingDestroyTag>(m_Handle)) {
+            m_Scene->UnindexName(m_Name, m_Handle);
+            m_Scene->IndexName(name, m_Handle);
+        }
+        m_Name = name;
+    }
+
+    AABB Entity::GetWorldBounds() const {
+        if (!m_Model) {
+            return AABB();
+        }
+        return m_Model->GetWorldBounds(m_Transform.GetModelMatrix());
+    }
+
     void Entity::OnRender(Renderer& renderer) {
         if (m_Model) {
             m_Model->Render(renderer, m_Transform.GetModelMatrix());
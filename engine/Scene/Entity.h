@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../Math/Transform.h"
+#include "../Math/Bounds.h"
+#include "EntityHandle.h"
 #include <string>
 #include <memory>
 
@@ -8,6 +10,7 @@ namespace Circe {
 
     class Renderer;
     class Model;
+    class Scene;
 
     class Entity {
     public:
@@ -23,19 +26,37 @@ namespace Circe {
         const Transform& GetTransform() const { return m_Transform; }
 
         const std::string& GetName() const { return m_Name; }
-        void SetName(const std::string& name) { m_Name = name; }
+        // Keeps the owning scene's name index in sync
+        void SetName(const std::string& name);
 
         bool IsActive() const { return m_Active; }
         void SetActive(bool active) { m_Active = active; }
 
+        // Opt-in for entities whose OnUpdate only touches the entity itself: Scene::Update
+        // then runs it on the job system alongside the others, before the serial ones
+        bool IsParallelUpdate() const { return m_ParallelUpdate; }
+        void SetParallelUpdate(bool parallel) { m_ParallelUpdate = parallel; }
+
         void SetModel(std::shared_ptr<Model> model) { m_Model = model; }
         std::shared_ptr<Model> GetModel() const { return m_Model; }
 
+        // Invalid (empty) box when the entity has no model
+        AABB GetWorldBounds() const;
+
+        // Registry identity, assigned when the entity is added to a Scene
+        EntityHandle GetHandle() const { return m_Handle; }
+
     protected:
         Transform m_Transform;
         std::string m_Name;
         bool m_Active;
+        bool m_ParallelUpdate = false;
         std::shared_ptr<Model> m_Model;
+
+    private:
+        friend class Scene;
+        EntityHandle m_Handle;
+        Scene* m_Scene = nullptr;
     };
 
 }
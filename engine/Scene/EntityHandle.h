@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace Circe {
+
+    // Stable reference to a registry entity. The generation changes every time an
+    // index is recycled, so handles to destroyed entities never alias new ones.
+    struct EntityHandle {
+        static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+        uint32_t Index = InvalidIndex;
+        uint32_t Generation = 0;
+
+        bool IsValid() const { return Index != InvalidIndex; }
+
+        bool operator==(const EntityHandle&) const = default;
+    };
+
+}
+
+template<>
+struct std::hash<Circe::EntityHandle> {
+    size_t operator()(const Circe::EntityHandle& handle) const noexcept {
+        return std::hash<uint64_t>()((static_cast<uint64_t>(handle.Generation) << 32) | handle.Index);
+    }
+};
@@ -0,0 +1,48 @@
+#include "Registry.h"
+#include <atomic>
+
+namespace Circe {
+
+    size_t Registry::NextTypeIndex() {
+        static std::atomic<size_t> s_NextIndex{ 0 };
+        return s_NextIndex.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    EntityHandle Registry::Create() {
+        if (!m_FreeList.empty()) {
+            const uint32_t index = m_FreeList.back();
+            m_FreeList.pop_back();
+            m_Alive[index] = 1;
+            return { index, m_Generations[index] };
+        }
+
+        const uint32_t index = static_cast<uint32_t>(m_Generations.size());
+        m_Generations.push_back(0);
+        m_Alive.push_back(1);
+        return { index, 0 };
+    }
+
+    void Registry::Destroy(EntityHandle entity) {
+        if (!IsAlive(entity)) {
+            return;
+        }
+
+        for (auto& pool : m_Pools) {
+            if (pool) {
+                pool->Remove(entity.Index);
+            }
+        }
+
+        // Bumping the generation invalidates every outstanding handle to this index
+        m_Generations[entity.Index]++;
+        m_Alive[entity.Index] = 0;
+        m_FreeList.push_back(entity.Index);
+    }
+
+    bool Registry::IsAlive(EntityHandle entity) const {
+        return entity.Index < m_Generations.size()
+            && m_Alive[entity.Index]
+            && m_Generations[entity.Index] == entity.Generation;
+    }
+
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "ComponentPool.h"
+#include "EntityHandle.h"
+#include "../Core/Jobs/JobSystem.h"
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace Circe {
+
+    class Registry {
+    public:
+        Registry() = default;
+        ~Registry() = default;
+
+        Registry(const Registry&) = delete;
+        Registry& operator=(const Registry&) = delete;
+
+        EntityHandle Create();
+        void Destroy(EntityHandle entity);
+        bool IsAlive(EntityHandle entity) const;
+        size_t GetAliveCount() const { return m_Generations.size() - m_FreeList.size(); }
+
+        // Handle of the live entity currently occupying index
+        EntityHandle GetHandle(uint32_t index) const { return { index, m_Generations[index] }; }
+
+        // Null for a stale handle, whose index may already belong to another entity
+        template<typename T, typename... Args>
+        T* Emplace(EntityHandle entity, Args&&... args) {
+            if (!IsAlive(entity)) {
+                return nullptr;
+            }
+            return &GetPool<T>().Emplace(entity.Index, std::forward<Args>(args)...);
+        }
+
+        template<typename T>
+        void Remove(EntityHandle entity) {
+            if (IsAlive(entity)) {
+                GetPool<T>().Remove(entity.Index);
+            }
+        }
+
+        template<typename T>
+        bool Has(EntityHandle entity) const {
+            const ComponentPool<T>* pool = FindPool<T>();
+            return pool && IsAlive(entity) && pool->Has(entity.Index);
+        }
+
+        template<typename T>
+        T& Get(EntityHandle entity) { return GetPool<T>().Get(entity.Index); }
+
+        template<typename T>
+        T* TryGet(EntityHandle entity) {
+            ComponentPool<T>* pool = FindPool<T>();
+            return pool && IsAlive(entity) ? pool->TryGet(entity.Index) : nullptr;
+        }
+
+        template<typename T>
+        ComponentPool<T>& GetPool() {
+            const size_t index = TypeIndex<T>();
+            if (index >= m_Pools.size()) {
+                m_Pools.resize(index + 1);
+            }
+            if (!m_Pools[index]) {
+                m_Pools[index] = std::make_unique<ComponentPool<T>>();
+            }
+            return static_cast<ComponentPool<T>&>(*m_Pools[index]);
+        }
+
+        // Calls func(EntityHandle, Ts&...) for every entity owning all of Ts. Drives the
+        // iteration from the smallest pool; components must not be added or removed inside.
+        template<typename... Ts, typename Func>
+        void Each(Func&& func) {
+            std::tuple<ComponentPool<Ts>&...> pools(GetPool<Ts>()...);
+            const IComponentPool* candidates[] = { &std::get<ComponentPool<Ts>&>(pools)... };
+            const IComponentPool* smallest = candidates[0];
+            for (const IComponentPool* pool : candidates) {
+                if (pool->Size() < smallest->Size()) {
+                    smallest = pool;
+                }
+            }
+
+            const uint32_t* entities = smallest->Entities();
+            const size_t count = smallest->Size();
+            for (size_t i = 0; i < count; ++i) {
+                const uint32_t entity = entities[i];
+                if ((std::get<ComponentPool<Ts>&>(pools).Has(entity) && ...)) {
+                    func(EntityHandle{ entity, m_Generations[entity] }, std::get<ComponentPool<Ts>&>(pools).Get(entity)...);
+                }
+            }
+        }
+
+        // Each() spread over the job system. func may write the components it is given but
+        // must not touch other entities, create or destroy entities, or add/remove components.
+        template<typename... Ts, typename Func>
+        void ParallelEach(Func&& func, size_t grainSize = 0) {
+            std::tuple<ComponentPool<Ts>&...> pools(GetPool<Ts>()...);
+            const IComponentPool* candidates[] = { &std::get<ComponentPool<Ts>&>(pools)... };
+            const IComponentPool* smallest = candidates[0];
+            for (const IComponentPool* pool : candidates) {
+                if (pool->Size() < smallest->Size()) {
+                    smallest = pool;
+                }
+            }
+
+            const uint32_t* entities = smallest->Entities();
+            JobSystem::ParallelFor(0, smallest->Size(), [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    const uint32_t entity = entities[i];
+                    if ((std::get<ComponentPool<Ts>&>(pools).Has(entity) && ...)) {
+                        func(EntityHandle{ entity, m_Generations[entity] }, std::get<ComponentPool<Ts>&>(pools).Get(entity)...);
+                    }
+                }
+            }, grainSize);
+        }
+
+    private:
+        static size_t NextTypeIndex();
+
+        template<typename T>
+        static size_t TypeIndex() {
+            static const size_t index = NextTypeIndex();
+            return index;
+        }
+
+        template<typename T>
+        ComponentPool<T>* FindPool() const {
+            const size_t index = TypeIndex<T>();
+            return index < m_Pools.size() ? static_cast<ComponentPool<T>*>(m_Pools[index].get()) : nullptr;
+        }
+
+        std::vector<uint32_t> m_Generations;
+        std::vector<uint8_t> m_Alive;
+        std::vector<uint32_t> m_FreeList;
+        std::vector<std::unique_ptr<IComponentPool>> m_Pools;
+    };
+
+}
@@ -1,19 +1,49 @@
 #include "Scene.h"
 #include "../Renderer/Renderer.h"
+#include "../Renderer/Material.h"
+#include "../Renderer/Mesh.h"
+#include "../Core/Profiling/Profiler.h"
+#include "../Math/BatchMath.h"
 
 namespace Circe {
 
     void Scene::Update(float deltaTime) {
+        CIRCE_PROFILE_FUNCTION();
         OnUpdate(deltaTime);
 
+        // Object entities that opted in only touch themselves and are spread over the job
+        // system. The rest run user code with free access to the scene, so they stay serial.
+        // Systems can use Registry::ParallelEach for data-parallel entity updates.
+        JobSystem::ParallelFor(0, m_Entities.size(), [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                Entity* entity = m_Entities[i].get();
+                if (entity && entity->IsActive() && entity->IsParallelUpdate()) {
+                    entity->OnUpdate(deltaTime);
+                }
+            }
+        }, 256);
         for (auto& entity : m_Entities) {
-            if (entity && entity->IsActive()) {
+            if (entity && entity->IsActive() && !entity->IsParallelUpdate()) {
                 entity->OnUpdate(deltaTime);
             }
         }
+
+        for (auto& system : m_Systems) {
+            system(m_Registry, deltaTime);
+        }
+
+        DestroyPendingEntities();
+        m_Hierarchy.Update();
     }
 
     void Scene::Render(Renderer& renderer) {
+        CIRCE_PROFILE_FUNCTION();
+        RecordCommands(renderer);
+        renderer.Flush();
+    }
+
+    void Scene::RecordCommands(Renderer& renderer) {
+        CIRCE_PROFILE_FUNCTION();
         OnRender(renderer);
 
         for (auto& entity : m_Entities) {
@@ -22,22 +52,254 @@ namespace Circe {
             }
         }
 
-        renderer.Flush();
+        // Picks up local transforms edited after Update, a no-op when nothing is dirty
+        m_Hierarchy.Update();
+
+        // Registry renderables, plain-transform and hierarchical alike, are recorded in
+        // parallel: each job writes into its own thread's command bucket
+        ComponentPool<RenderableComponent>& renderables = m_Registry.GetPool<RenderableComponent>();
+        ComponentPool<Transform>& transforms = m_Registry.GetPool<Transform>();
+        ComponentPool<HierarchyNodeComponent>& nodes = m_Registry.GetPool<HierarchyNodeComponent>();
+        ComponentPool<ActiveTag>& active = m_Registry.GetPool<ActiveTag>();
+        const uint32_t* entities = renderables.Entities();
+        const RenderableComponent* data = renderables.Data();
+        JobSystem::ParallelFor(0, renderables.Size(), [&](size_t first, size_t last) {
+            CommandBucket& bucket = renderer.GetCommandBucket();
+
+            // Plain transforms are gathered and composed in batches by the SIMD kernels
+            constexpr size_t BatchSize = 64;
+            Transform batchTransforms[BatchSize];
+            glm::mat4 batchMatrices[BatchSize];
+            MeshHandle batchMeshes[BatchSize];
+            MaterialHandle batchMaterials[BatchSize];
+            size_t batched = 0;
+            auto flushBatch = [&]() {
+                BatchMath::ComposeTRS(batchTransforms, batchMatrices, batched);
+                for (size_t j = 0; j < batched; ++j) {
+                    bucket.Submit(batchMeshes[j], batchMaterials[j], batchMatrices[j]);
+                }
+                batched = 0;
+            };
+
+            for (size_t i = first; i < last; ++i) {
+                const uint32_t entity = entities[i];
+                if (!data[i].Mesh || !data[i].Material || !active.Has(entity)) {
+                    continue;
+                }
+                const MeshHandle mesh = data[i].Mesh->GetHandle();
+                const MaterialHandle material = data[i].Material->GetHandle();
+                if (const Transform* transform = transforms.TryGet(entity)) {
+                    batchTransforms[batched] = *transform;
+                    batchMeshes[batched] = mesh;
+                    batchMaterials[batched] = material;
+                    if (++batched == BatchSize) {
+                        flushBatch();
+                    }
+                } else if (const HierarchyNodeComponent* node = nodes.TryGet(entity)) {
+                    bucket.Submit(mesh, material, m_Hierarchy.GetWorldMatrix(node->Node));
+                }
+            }
+            flushBatch();
+        }, 1024);
     }
 
-    void Scene::AddEntity(std::unique_ptr<Entity> entity) {
-        if (entity) {
-            m_Entities.push_back(std::move(entity));
+    EntityHandle Scene::AddEntity(std::unique_ptr<Entity> entity) {
+        if (!entity) {
+            return {};
         }
+
+        // Give the object a registry identity so it can be referenced by handle
+        EntityHandle handle = m_Registry.Create();
+        m_Registry.Emplace<EntityRefComponent>(handle, entity.get());
+        entity->m_Handle = handle;
+        entity->m_Scene = this;
+        IndexName(entity->GetName(), handle);
+
+        m_Entities.push_back(std::move(entity));
+        return handle;
     }
 
-    Entity* Scene::GetEntity(const std::string& name) {
-        for (auto& entity : m_Entities) {
-            if (entity && entity->GetName() == name) {
-                return entity.get();
+    Entity* Scene::GetEntity(std::string_view name) {
+        // Registry entities share the index and the default name, so skip past them
+        auto [first, last] = m_NameIndex.equal_range(name);
+        for (auto it = first; it != last; ++it) {
+            if (Entity* object = GetEntity(it->second)) {
+                return object;
             }
         }
         return nullptr;
     }
 
+    Entity* Scene::GetEntity(EntityHandle handle) {
+        if (m_Registry.Has<PendingDestroyTag>(handle)) {
+            return nullptr;
+        }
+        EntityRefComponent* ref = m_Registry.TryGet<EntityRefComponent>(handle);
+        return ref ? ref->Instance : nullptr;
+    }
+
+    EntityHandle Scene::FindEntity(std::string_view name) const {
+        auto it = m_NameIndex.find(name);
+        return it != m_NameIndex.end() ? it->second : EntityHandle{};
+    }
+
+    EntityHandle Scene::CreateEntity(const std::string& name) {
+        EntityHandle handle = m_Registry.Create();
+        m_Registry.Emplace<Transform>(handle);
+        m_Registry.Emplace<NameComponent>(handle, name);
+        m_Registry.Emplace<ActiveTag>(handle);
+        IndexName(name, handle);
+        return handle;
+    }
+
+    void Scene::SetEntityActive(EntityHandle entity, bool active) {
+        if (!m_Registry.IsAlive(entity)) {
+            return;
+        }
+        if (active) {
+            m_Registry.Emplace<ActiveTag>(entity);
+        } else {
+            m_Registry.Remove<ActiveTag>(entity);
+        }
+    }
+
+    void Scene::SetEntityName(EntityHandle entity, std::string_view name) {
+        if (m_Registry.Has<PendingDestroyTag>(entity)) {
+            return;
+        }
+        if (Entity* object = GetEntity(entity)) {
+            object->SetName(std::string(name));
+            return;
+        }
+        if (NameComponent* component = m_Registry.TryGet<NameComponent>(entity)) {
+            UnindexName(component->Name, entity);
+            component->Name = name;
+            IndexName(component->Name, entity);
+        }
+    }
+
+    void Scene::DestroyEntity(EntityHandle entity) {
+        if (!m_Registry.IsAlive(entity) || m_Registry.Has<PendingDestroyTag>(entity)) {
+            return;
+        }
+
+        if (Entity* object = GetEntity(entity)) {
+            UnindexName(object->GetName(), entity);
+        } else if (const NameComponent* component = m_Registry.TryGet<NameComponent>(entity)) {
+            UnindexName(component->Name, entity);
+        }
+        m_Registry.Emplace<PendingDestroyTag>(entity);
+        m_PendingDestroy.push_back(entity);
+    }
+
+    void Scene::DestroyEntity(Entity* entity) {
+        if (entity && entity->m_Scene == this) {
+            DestroyEntity(entity->m_Handle);
+        }
+    }
+
+    void Scene::DestroyPendingEntities() {
+        if (m_PendingDestroy.empty()) {
+            return;
+        }
+
+        // Object entities are erased in one pass so the survivors keep their update order
+        bool removedObjects = false;
+        for (EntityHandle handle : m_PendingDestroy) {
+            const EntityRefComponent* ref = m_Registry.TryGet<EntityRefComponent>(handle);
+            if (Entity* object = ref ? ref->Instance : nullptr) {
+                object->m_Scene = nullptr;
+                removedObjects = true;
+                if (m_DeferResourceRelease && object->m_Model) {
+                    m_ReleasedResources.push_back(std::move(object->m_Model));
+                }
+            }
+        }
+        if (removedObjects) {
+            std::erase_if(m_Entities, [](const std::unique_ptr<Entity>& entity) {
+                return !entity || entity->m_Scene == nullptr;
+            });
+        }
+
+        for (EntityHandle handle : m_PendingDestroy) {
+            if (const HierarchyNodeComponent* node = m_Registry.TryGet<HierarchyNodeComponent>(handle)) {
+                m_Hierarchy.DestroyNode(node->Node);
+            }
+            if (RenderableComponent* renderable = m_DeferResourceRelease ? m_Registry.TryGet<RenderableComponent>(handle) : nullptr) {
+                if (renderable->Mesh) {
+                    m_ReleasedResources.push_back(std::move(renderable->Mesh));
+                }
+                if (renderable->Material) {
+                    m_ReleasedResources.push_back(std::move(renderable->Material));
+                }
+            }
+            m_Registry.Destroy(handle);
+        }
+        m_PendingDestroy.clear();
+    }
+
+    void Scene::SetDeferResourceRelease(bool defer) {
+        m_DeferResourceRelease = defer;
+        if (!defer) {
+            m_ReleasedResources.clear();
+        }
+    }
+
+    TransformHierarchy::NodeID Scene::AttachToHierarchy(EntityHandle entity) {
+        if (const HierarchyNodeComponent* node = m_Registry.TryGet<HierarchyNodeComponent>(entity)) {
+            return node->Node;
+        }
+
+        Transform local;
+        if (const Transform* transform = m_Registry.TryGet<Transform>(entity)) {
+            local = *transform;
+            m_Registry.Remove<Transform>(entity);
+        }
+        TransformHierarchy::NodeID node = m_Hierarchy.CreateNode(local);
+        m_Registry.Emplace<HierarchyNodeComponent>(entity, node);
+        return node;
+    }
+
+    void Scene::SetParent(EntityHandle child, EntityHandle parent) {
+        // Object entities carry their own transform and are not part of the hierarchy
+        if (!m_Registry.IsAlive(child) || m_Registry.Has<EntityRefComponent>(child) || m_Registry.Has<EntityRefComponent>(parent)) {
+            return;
+        }
+
+        TransformHierarchy::NodeID childNode = AttachToHierarchy(child);
+        TransformHierarchy::NodeID parentNode = TransformHierarchy::InvalidNode;
+        if (m_Registry.IsAlive(parent)) {
+            parentNode = AttachToHierarchy(parent);
+        }
+        m_Hierarchy.SetParent(childNode, parentNode);
+    }
+
+    glm::mat4 Scene::GetWorldMatrix(EntityHandle entity) {
+        if (const HierarchyNodeComponent* node = m_Registry.TryGet<HierarchyNodeComponent>(entity)) {
+            m_Hierarchy.Update();
+            return m_Hierarchy.GetWorldMatrix(node->Node);
+        }
+        if (const Transform* transform = m_Registry.TryGet<Transform>(entity)) {
+            return transform->GetModelMatrix();
+        }
+        if (Entity* object = GetEntity(entity)) {
+            return object->GetTransform().GetModelMatrix();
+        }
+        return glm::mat4(1.0f);
+    }
+
+    void Scene::IndexName(std::string_view name, EntityHandle entity) {
+        m_NameIndex.emplace(std::string(name), entity);
+    }
+
+    void Scene::UnindexName(std::string_view name, EntityHandle entity) {
+        auto [first, last] = m_NameIndex.equal_range(name);
+        for (auto it = first; it != last; ++it) {
+            if (it->second == entity) {
+                m_NameIndex.erase(it);
+                return;
+            }
+        }
+    }
+
 }
@@ -1,6 +1,12 @@
 #pragma once
 
 #include "Entity.h"
+#include "Components.h"
+#include "Registry.h"
+#include "TransformHierarchy.h"
+#include <functional>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 
@@ -10,6 +16,8 @@ namespace Circe {
 
     class Scene {
     public:
+        using System = std::function<void(Registry&, float)>;
+
         Scene() = default;
         virtual ~Scene() = default;
 
@@ -19,13 +27,77 @@ namespace Circe {
         virtual void OnRender(Renderer& renderer) {}
 
         void Update(float deltaTime);
+        // RecordCommands() followed by Renderer::Flush()
         void Render(Renderer& renderer);
+        // Queues this frame's draws without flushing: OnRender, the object entities (serially,
+        // they run user code) and then every registry renderable in parallel
+        void RecordCommands(Renderer& renderer);
+
+        // Object entities, kept for Entity subclasses with their own OnUpdate/OnRender
+        EntityHandle AddEntity(std::unique_ptr<Entity> entity);
+        // First object entity with that name, registry entities of the same name are skipped
+        Entity* GetEntity(std::string_view name);
+        Entity* GetEntity(EntityHandle handle);
+
+        // Data-oriented entities: Transform, NameComponent and ActiveTag by default
+        EntityHandle CreateEntity(const std::string& name = "Entity");
+        void SetEntityActive(EntityHandle entity, bool active);
+        void SetEntityName(EntityHandle entity, std::string_view name);
+
+        // Any entity kind by name, invalid handle when there is none
+        EntityHandle FindEntity(std::string_view name) const;
+
+        // Deferred: the entity disappears from lookups immediately and is destroyed
+        // at the end of the next Update, so it is safe to call from inside updates
+        void DestroyEntity(EntityHandle entity);
+        void DestroyEntity(Entity* entity);
+
+        // Moves child (and parent, when valid) into the transform hierarchy, turning their
+        // Transform component into a hierarchy node. An invalid parent makes child a root.
+        void SetParent(EntityHandle child, EntityHandle parent);
+        TransformHierarchy& GetHierarchy() { return m_Hierarchy; }
+        // World matrix for registry entities, hierarchical or not
+        glm::mat4 GetWorldMatrix(EntityHandle entity);
 
-        void AddEntity(std::unique_ptr<Entity> entity);
-        Entity* GetEntity(const std::string& name);
+        // Systems run in registration order during Update, after the object entities
+        void AddSystem(System system) { m_Systems.push_back(std::move(system)); }
+
+        Registry& GetRegistry() { return m_Registry; }
+        const Registry& GetRegistry() const { return m_Registry; }
+
+        // Pipelined rendering: the meshes, materials and models that destroyed entities drop are
+        // held here instead of released on the update thread, where their GL cleanup would run
+        // without a context while queued frames still draw them. The engine hands them to the
+        // render thread with the next frame. Turning deferral off releases what is held.
+        void SetDeferResourceRelease(bool defer);
+        // Swaps the held references into resources, which should be empty
+        void SwapReleasedResources(std::vector<std::shared_ptr<void>>& resources) { resources.swap(m_ReleasedResources); }
 
     protected:
         std::vector<std::unique_ptr<Entity>> m_Entities;
+        Registry m_Registry;
+        TransformHierarchy m_Hierarchy;
+        std::vector<System> m_Systems;
+
+    private:
+        friend class Entity;
+
+        // Transparent hash so lookups take string_view without building a std::string
+        struct NameHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view name) const { return std::hash<std::string_view>()(name); }
+        };
+        using NameIndex = std::unordered_multimap<std::string, EntityHandle, NameHash, std::equal_to<>>;
+
+        void IndexName(std::string_view name, EntityHandle entity);
+        void UnindexName(std::string_view name, EntityHandle entity);
+        void DestroyPendingEntities();
+        TransformHierarchy::NodeID AttachToHierarchy(EntityHandle entity);
+
+        NameIndex m_NameIndex;
+        std::vector<EntityHandle> m_PendingDestroy;
+        bool m_DeferResourceRelease = false;
+        std::vector<std::shared_ptr<void>> m_ReleasedResources;
     };
 
 }
@@ -0,0 +1,246 @@
+#include "TransformHierarchy.h"
+#include "../Core/Jobs/JobSystem.h"
+#include "../Core/Profiling/Profiler.h"
+#include "../Math/BatchMath.h"
+#include <algorithm>
+
+namespace Circe {
+
+    TransformHierarchy::NodeID TransformHierarchy::CreateNode(const Transform& local, NodeID parent) {
+        NodeID node;
+        if (!m_FreeIDs.empty()) {
+            node = m_FreeIDs.back();
+            m_FreeIDs.pop_back();
+        } else {
+            node = static_cast<NodeID>(m_Slots.size());
+            m_Slots.push_back(InvalidSlot);
+            m_Parents.push_back(InvalidNode);
+            m_Dirty.push_back(0);
+        }
+
+        // Appended at the end; RebuildOrder moves it under its parent before the next update
+        m_Slots[node] = static_cast<uint32_t>(m_Order.size());
+        m_Parents[node] = IsValid(parent) ? parent : InvalidNode;
+        m_Order.push_back(node);
+        m_ParentSlots.push_back(InvalidSlot);
+        m_SubtreeSizes.push_back(1);
+        m_Local.push_back(local);
+        m_World.push_back(glm::mat4(1.0f));
+
+        m_StructureChanged = true;
+        return node;
+    }
+
+    void TransformHierarchy::DestroyNode(NodeID node) {
+        if (!IsValid(node)) {
+            return;
+        }
+
+        for (NodeID child = 0; child < m_Parents.size(); ++child) {
+            if (m_Parents[child] == node && IsValid(child)) {
+                m_Parents[child] = InvalidNode;
+            }
+        }
+
+        // Swap the last slot into the hole, the order is rebuilt before the next update anyway
+        const uint32_t slot = m_Slots[node];
+        const uint32_t last = static_cast<uint32_t>(m_Order.size() - 1);
+        if (slot != last) {
+            m_Order[slot] = m_Order[last];
+            m_Local[slot] = m_Local[last];
+            m_World[slot] = m_World[last];
+            m_Slots[m_Order[slot]] = slot;
+        }
+        m_Order.pop_back();
+        m_ParentSlots.pop_back();
+        m_SubtreeSizes.pop_back();
+        m_Local.pop_back();
+        m_World.pop_back();
+
+        m_Slots[node] = InvalidSlot;
+        m_Parents[node] = InvalidNode;
+        m_Dirty[node] = 0;
+        m_FreeIDs.push_back(node);
+        m_StructureChanged = true;
+    }
+
+    void TransformHierarchy::SetParent(NodeID node, NodeID parent) {
+        if (!IsValid(node) || node == parent) {
+            return;
+        }
+        if (!IsValid(parent)) {
+            parent = InvalidNode;
+        }
+
+        // Refuse to create a cycle
+        for (NodeID ancestor = parent; ancestor != InvalidNode; ancestor = m_Parents[ancestor]) {
+            if (ancestor == node) {
+                return;
+            }
+        }
+
+        m_Parents[node] = parent;
+        m_StructureChanged = true;
+    }
+
+    TransformHierarchy::NodeID TransformHierarchy::GetParent(NodeID node) const {
+        return IsValid(node) ? m_Parents[node] : InvalidNode;
+    }
+
+    void TransformHierarchy::SetLocal(NodeID node, const Transform& local) {
+        m_Local[m_Slots[node]] = local;
+        MarkDirty(node);
+    }
+
+    Transform& TransformHierarchy::EditLocal(NodeID node) {
+        MarkDirty(node);
+        return m_Local[m_Slots[node]];
+    }
+
+    void TransformHierarchy::MarkDirty(NodeID node) {
+        if (!m_Dirty[node]) {
+            m_Dirty[node] = 1;
+            m_DirtyNodes.push_back(node);
+        }
+    }
+
+    void TransformHierarchy::RebuildOrder() {
+        const size_t count = m_Order.size();
+
+        // Children lists by node id, then an iterative depth-first walk from every root
+        std::vector<uint32_t> childStart(m_Slots.size() + 1, 0);
+        for (NodeID node : m_Order) {
+            if (m_Parents[node] != InvalidNode) {
+                childStart[m_Parents[node] + 1]++;
+            }
+        }
+        for (size_t i = 1; i < childStart.size(); ++i) {
+            childStart[i] += childStart[i - 1];
+        }
+        std::vector<NodeID> children(childStart.back());
+        std::vector<uint32_t> fill(childStart.begin(), childStart.end() - 1);
+        for (NodeID node : m_Order) {
+            if (m_Parents[node] != InvalidNode) {
+                children[fill[m_Parents[node]]++] = node;
+            }
+        }
+
+        std::vector<NodeID> order;
+        std::vector<Transform> local;
+        order.reserve(count);
+        local.reserve(count);
+        std::vector<NodeID> stack;
+        for (NodeID root : m_Order) {
+            if (m_Parents[root] != InvalidNode) {
+                continue;
+            }
+            stack.push_back(root);
+            while (!stack.empty()) {
+                NodeID node = stack.back();
+                stack.pop_back();
+                order.push_back(node);
+                local.push_back(m_Local[m_Slots[node]]);
+                for (uint32_t c = childStart[node + 1]; c > childStart[node]; --c) {
+                    stack.push_back(children[c - 1]);
+                }
+            }
+        }
+
+        m_Order = std::move(order);
+        m_Local = std::move(local);
+        for (uint32_t slot = 0; slot < count; ++slot) {
+            m_Slots[m_Order[slot]] = slot;
+        }
+        for (uint32_t slot = 0; slot < count; ++slot) {
+            const NodeID parent = m_Parents[m_Order[slot]];
+            m_ParentSlots[slot] = parent != InvalidNode ? m_Slots[parent] : InvalidSlot;
+        }
+
+        // Subtree sizes accumulate bottom-up, children always sit after their parent
+        std::fill(m_SubtreeSizes.begin(), m_SubtreeSizes.end(), 1);
+        for (uint32_t slot = static_cast<uint32_t>(count); slot-- > 0;) {
+            if (m_ParentSlots[slot] != InvalidSlot) {
+                m_SubtreeSizes[m_ParentSlots[slot]] += m_SubtreeSizes[slot];
+            }
+        }
+    }
+
+    void TransformHierarchy::UpdateRange(const Range& range) {
+        // All local matrices in one batch, then the parent products a run of siblings at a
+        // time. Parents precede their children, so each parent is final by its children's run.
+        BatchMath::ComposeTRS(m_Local.data() + range.Begin, m_World.data() + range.Begin, range.End - range.Begin);
+        uint32_t slot = range.Begin;
+        while (slot < range.End) {
+            const uint32_t parentSlot = m_ParentSlots[slot];
+            uint32_t runEnd = slot + 1;
+            while (runEnd < range.End && m_ParentSlots[runEnd] == parentSlot) {
+                ++runEnd;
+            }
+            if (parentSlot != InvalidSlot) {
+                BatchMath::Multiply(m_World[parentSlot], m_World.data() + slot, m_World.data() + slot, runEnd - slot);
+            }
+            slot = runEnd;
+        }
+    }
+
+    void TransformHierarchy::Update() {
+        CIRCE_PROFILE_FUNCTION();
+        m_Ranges.clear();
+
+        if (m_StructureChanged) {
+            RebuildOrder();
+            m_StructureChanged = false;
+
+            // Every root subtree is independent
+            for (uint32_t slot = 0; slot < m_Order.size(); slot += m_SubtreeSizes[slot]) {
+                m_Ranges.push_back({ slot, slot + m_SubtreeSizes[slot] });
+            }
+        } else if (!m_DirtyNodes.empty()) {
+            // Dirty subtrees in slot order; a range nested inside the previous one is skipped
+            std::vector<uint32_t> dirtySlots;
+            dirtySlots.reserve(m_DirtyNodes.size());
+            for (NodeID node : m_DirtyNodes) {
+                if (IsValid(node)) {
+                    dirtySlots.push_back(m_Slots[node]);
+                }
+            }
+            std::sort(dirtySlots.begin(), dirtySlots.end());
+
+            uint32_t coveredEnd = 0;
+            for (uint32_t slot : dirtySlots) {
+                if (slot < coveredEnd) {
+                    continue;
+                }
+                coveredEnd = slot + m_SubtreeSizes[slot];
+                m_Ranges.push_back({ slot, coveredEnd });
+            }
+        }
+
+        for (NodeID node : m_DirtyNodes) {
+            m_Dirty[node] = 0;
+        }
+        m_DirtyNodes.clear();
+
+        m_LastUpdatedCount = 0;
+        for (const Range& range : m_Ranges) {
+            m_LastUpdatedCount += range.End - range.Begin;
+        }
+
+        // Ranges are disjoint and only read parents outside of them that are already final,
+        // so they can be spread over the job system once there is enough work
+        if (m_LastUpdatedCount < ParallelThreshold || m_Ranges.size() < 2) {
+            for (const Range& range : m_Ranges) {
+                UpdateRange(range);
+            }
+            return;
+        }
+
+        const size_t grain = std::max<size_t>(1, m_Ranges.size() / (JobSystem::GetThreadCount() * 4));
+        JobSystem::ParallelFor(0, m_Ranges.size(), [this](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                UpdateRange(m_Ranges[i]);
+            }
+        }, grain);
+    }
+
+}
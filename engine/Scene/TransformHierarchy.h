@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../Math/Transform.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Circe {
+
+    // Parent/child transforms in flat arrays kept in pre-order (depth-first), so every
+    // parent precedes its children and each subtree occupies one contiguous range.
+    // Changing a local transform only dirties that node; Update() recomputes the world
+    // matrices of dirty subtrees and nothing else.
+    class TransformHierarchy {
+    public:
+        using NodeID = uint32_t;
+        static constexpr NodeID InvalidNode = 0xFFFFFFFF;
+
+        NodeID CreateNode(const Transform& local = Transform(), NodeID parent = InvalidNode);
+        // Children of a destroyed node become roots and keep their local transforms
+        void DestroyNode(NodeID node);
+        bool IsValid(NodeID node) const { return node < m_Slots.size() && m_Slots[node] != InvalidSlot; }
+
+        void SetParent(NodeID node, NodeID parent);
+        NodeID GetParent(NodeID node) const;
+
+        const Transform& GetLocal(NodeID node) const { return m_Local[m_Slots[node]]; }
+        void SetLocal(NodeID node, const Transform& local);
+        // Marks the node dirty, the reference is only valid until the next structural change
+        Transform& EditLocal(NodeID node);
+
+        // Valid after Update()
+        const glm::mat4& GetWorldMatrix(NodeID node) const { return m_World[m_Slots[node]]; }
+
+        void Update();
+
+        size_t GetNodeCount() const { return m_Order.size(); }
+        // World matrices recomputed by the last Update()
+        size_t GetLastUpdatedCount() const { return m_LastUpdatedCount; }
+
+    private:
+        static constexpr uint32_t InvalidSlot = 0xFFFFFFFF;
+        // Below this many recomputed nodes the update stays on the calling thread
+        static constexpr size_t ParallelThreshold = 4096;
+
+        struct Range {
+            uint32_t Begin;
+            uint32_t End;
+        };
+
+        void MarkDirty(NodeID node);
+        void RebuildOrder();
+        void UpdateRange(const Range& range);
+
+        // Indexed by NodeID
+        std::vector<uint32_t> m_Slots;
+        std::vector<NodeID> m_Parents;
+        std::vector<NodeID> m_FreeIDs;
+
+        // Indexed by slot, in pre-order
+        std::vector<NodeID> m_Order;
+        std::vector<uint32_t> m_ParentSlots;
+        std::vector<uint32_t> m_SubtreeSizes;
+        std::vector<Transform> m_Local;
+        std::vector<glm::mat4> m_World;
+
+        std::vector<NodeID> m_DirtyNodes;
+        std::vector<uint8_t> m_Dirty;
+        std::vector<Range> m_Ranges;
+        bool m_StructureChanged = false;
+        size_t m_LastUpdatedCount = 0;
+    };
+
+}
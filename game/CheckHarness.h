@@ -0,0 +1,39 @@
+#pragma once
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Pass/fail reporting shared by the check programs in game/: one line per check, then a
+// summary from Finish() whose result is the exit code, so ctest can run them
+namespace CheckHarness {
+
+    inline int s_Failures = 0;
+
+    // Prints the check and counts it when it failed; returns passed
+    inline bool Check(const std::string& name, bool passed, const std::string& detail = {}) {
+        s_Failures += passed ? 0 : 1;
+        std::cout << (passed ? "[ok]   " : "[FAIL] ") << name;
+        if (!detail.empty()) {
+            std::cout << " | " << detail;
+        }
+        std::cout << std::endl;
+        return passed;
+    }
+
+    // Passes when maxError stays within bound
+    inline bool CheckError(const std::string& name, double maxError, double bound) {
+        std::ostringstream detail;
+        detail << "max error " << maxError << " (bound " << bound << ")";
+        return Check(name, maxError <= bound, detail.str());
+    }
+
+    inline int GetFailures() { return s_Failures; }
+
+    // Prints the failure count and returns the exit code for main
+    inline int Finish() {
+        std::cout << (s_Failures ? "[FAIL] " : "[ok]   ") << s_Failures << " failed checks" << std::endl;
+        return s_Failures ? 1 : 0;
+    }
+
+}
@@ -0,0 +1,239 @@
+#include <Math/BatchMath.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "CheckHarness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    namespace Batch = Circe::BatchMath;
+
+    // Largest difference relative to the magnitude of the expected value (at least 1)
+    double MaxError(const float* actual, const float* expected, size_t count) {
+        double maxError = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            const double scale = std::max(1.0, std::abs(static_cast<double>(expected[i])));
+            maxError = std::max(maxError, std::abs(static_cast<double>(actual[i]) - expected[i]) / scale);
+        }
+        return maxError;
+    }
+
+    // Box corners come out of a center +/- extent cancellation, so the error is relative to
+    // the box's largest coordinate rather than to each coordinate
+    double MaxBoxError(const std::vector<Circe::AABB>& actual, const std::vector<Circe::AABB>& expected) {
+        double maxError = 0.0;
+        for (size_t i = 0; i < actual.size(); ++i) {
+            const glm::vec3 magnitude = glm::max(glm::abs(expected[i].Min), glm::abs(expected[i].Max));
+            const double scale = std::max({ 1.0, double(magnitude.x), double(magnitude.y), double(magnitude.z) });
+            const glm::vec3 minError = glm::abs(actual[i].Min - expected[i].Min);
+            const glm::vec3 maxErrors = glm::abs(actual[i].Max - expected[i].Max);
+            maxError = std::max({ maxError, minError.x / scale, minError.y / scale, minError.z / scale,
+                maxErrors.x / scale, maxErrors.y / scale, maxErrors.z / scale });
+        }
+        return maxError;
+    }
+
+    template <typename T>
+    const float* Floats(const std::vector<T>& values) {
+        return reinterpret_cast<const float*>(values.data());
+    }
+
+    glm::quat RandomRotation(std::mt19937& random) {
+        std::normal_distribution<float> distribution;
+        return glm::normalize(glm::quat(distribution(random), distribution(random), distribution(random), distribution(random)));
+    }
+
+    struct Data {
+        std::vector<Circe::Transform> Transforms;
+        std::vector<glm::mat4> Left;
+        std::vector<glm::mat4> Right;
+        std::vector<glm::quat> QuatsA;
+        std::vector<glm::quat> QuatsB;
+        std::vector<Circe::AABB> Boxes;
+    };
+
+    Data MakeData(size_t count) {
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+        std::uniform_real_distribution<float> extent(0.0f, 10.0f);
+
+        Data data;
+        for (size_t i = 0; i < count; ++i) {
+            Circe::Transform transform;
+            transform.Position = glm::vec3(position(random), position(random), position(random));
+            transform.Rotation = RandomRotation(random);
+            transform.Scale = glm::vec3(scale(random), scale(random), scale(random));
+            data.Transforms.push_back(transform);
+
+            // Non-unit quaternions for Normalize, with an exact zero among them
+            data.QuatsA.push_back(i == 7 ? glm::quat(0.0f, 0.0f, 0.0f, 0.0f) : RandomRotation(random) * scale(random));
+            data.QuatsB.push_back(RandomRotation(random));
+
+            const glm::vec3 center(position(random), position(random), position(random));
+            const glm::vec3 half(extent(random), extent(random), extent(random));
+            // Every 50th box is invalid (empty) and has to come back unchanged
+            data.Boxes.push_back(i % 50 == 0 ? Circe::AABB() : Circe::AABB(center - half, center + half));
+        }
+        for (const Circe::Transform& transform : data.Transforms) {
+            data.Left.push_back(transform.GetModelMatrix());
+        }
+        data.Right = data.Left;
+        std::rotate(data.Right.begin(), data.Right.begin() + 1, data.Right.end());
+        return data;
+    }
+
+    // Independent glm formulations, not the engine's own scalar code
+    glm::mat4 ReferenceTRS(const Circe::Transform& transform) {
+        return glm::translate(glm::mat4(1.0f), transform.Position) * glm::mat4_cast(transform.Rotation) * glm::scale(glm::mat4(1.0f), transform.Scale);
+    }
+
+    Circe::AABB ReferenceBox(const Circe::AABB& box, const glm::mat4& matrix) {
+        if (!box.IsValid()) {
+            return box;
+        }
+        Circe::AABB result;
+        for (int corner = 0; corner < 8; ++corner) {
+            const glm::vec3 point((corner & 1) ? box.Max.x : box.Min.x, (corner & 2) ? box.Max.y : box.Min.y, (corner & 4) ? box.Max.z : box.Min.z);
+            result.Expand(glm::vec3(matrix * glm::vec4(point, 1.0f)));
+        }
+        return result;
+    }
+
+    void CheckLevel(Batch::SimdLevel level, const Data& data) {
+        Batch::SetLevel(level);
+        const size_t count = data.Transforms.size();
+        const std::string prefix = std::string(Batch::GetLevelName(level)) + " ";
+
+        std::vector<glm::mat4> matrices(count);
+        std::vector<glm::mat4> expectedMatrices(count);
+        Batch::ComposeTRS(data.Transforms.data(), matrices.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            expectedMatrices[i] = ReferenceTRS(data.Transforms[i]);
+        }
+        CheckHarness::CheckError(prefix + "ComposeTRS", MaxError(Floats(matrices), Floats(expectedMatrices), count * 16), 1e-5);
+
+        Batch::Multiply(data.Left.data(), data.Right.data(), matrices.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            expectedMatrices[i] = data.Left[i] * data.Right[i];
+        }
+        CheckHarness::CheckError(prefix + "Multiply", MaxError(Floats(matrices), Floats(expectedMatrices), count * 16), 1e-5);
+
+        // Broadcast form, in place as TransformHierarchy uses it
+        matrices = data.Right;
+        Batch::Multiply(data.Left[3], matrices.data(), matrices.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            expectedMatrices[i] = data.Left[3] * data.Right[i];
+        }
+        CheckHarness::CheckError(prefix + "Multiply (broadcast, in place)", MaxError(Floats(matrices), Floats(expectedMatrices), count * 16), 1e-5);
+
+        std::vector<glm::quat> quats = data.QuatsA;
+        std::vector<glm::quat> expectedQuats(count);
+        Batch::Normalize(quats.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            expectedQuats[i] = glm::normalize(data.QuatsA[i]);
+        }
+        CheckHarness::CheckError(prefix + "Normalize", MaxError(Floats(quats), Floats(expectedQuats), count * 4), 1e-6);
+
+        const std::vector<glm::quat> unitA = quats;
+        double slerpError = 0.0;
+        for (float t : { 0.0f, 0.1f, 0.37f, 0.5f, 0.9f, 1.0f }) {
+            Batch::Slerp(unitA.data(), data.QuatsB.data(), t, quats.data(), count);
+            for (size_t i = 0; i < count; ++i) {
+                expectedQuats[i] = glm::slerp(unitA[i], data.QuatsB[i], t);
+            }
+            slerpError = std::max(slerpError, MaxError(Floats(quats), Floats(expectedQuats), count * 4));
+        }
+        CheckHarness::CheckError(prefix + "Slerp", slerpError, 1e-6);
+
+        std::vector<Circe::AABB> boxes(count);
+        std::vector<Circe::AABB> expectedBoxes(count);
+        Batch::TransformAABBs(data.Boxes.data(), data.Left.data(), boxes.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            expectedBoxes[i] = ReferenceBox(data.Boxes[i], data.Left[i]);
+        }
+        size_t invalidMismatches = 0;
+        for (size_t i = 0; i < count; ++i) {
+            invalidMismatches += boxes[i].IsValid() != expectedBoxes[i].IsValid() ? 1 : 0;
+        }
+        CheckHarness::CheckError(prefix + "TransformAABBs", invalidMismatches ? 1.0 : MaxBoxError(boxes, expectedBoxes), 1e-5);
+    }
+
+    // Best of a few repetitions, in millions of elements per second
+    template <typename Kernel>
+    double Throughput(size_t count, Kernel kernel) {
+        double best = 0.0;
+        for (int repetition = 0; repetition < 5; ++repetition) {
+            const auto start = std::chrono::steady_clock::now();
+            for (int pass = 0; pass < 20; ++pass) {
+                kernel();
+            }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = std::max(best, count * 20 / seconds / 1e6);
+        }
+        return best;
+    }
+
+    void Benchmark(Batch::SimdLevel level, const Data& data, std::vector<double>& baseline) {
+        Batch::SetLevel(level);
+        const size_t count = data.Transforms.size();
+        const std::string prefix = std::string(Batch::GetLevelName(level)) + " ";
+        std::vector<glm::mat4> matrices(count);
+        std::vector<glm::quat> quats = data.QuatsB;
+        std::vector<Circe::AABB> boxes(count);
+
+        const double results[] = {
+            Throughput(count, [&]() { Batch::ComposeTRS(data.Transforms.data(), matrices.data(), count); }),
+            Throughput(count, [&]() { Batch::Multiply(data.Left.data(), data.Right.data(), matrices.data(), count); }),
+            Throughput(count, [&]() { Batch::Normalize(quats.data(), count); }),
+            Throughput(count, [&]() { Batch::Slerp(data.QuatsB.data(), data.QuatsB.data() + 1, 0.3f, quats.data(), count - 1); }),
+            Throughput(count, [&]() { Batch::TransformAABBs(data.Boxes.data(), data.Left.data(), boxes.data(), count); })
+        };
+        const char* names[] = { "ComposeTRS M matrices/s", "Multiply M matrices/s", "Normalize M quats/s", "Slerp M quats/s", "TransformAABBs M boxes/s" };
+        if (baseline.empty()) {
+            baseline.assign(std::begin(results), std::end(results));
+        }
+
+        std::cout << std::setw(6) << Batch::GetLevelName(level);
+        for (size_t i = 0; i < std::size(results); ++i) {
+            std::cout << " | " << names[i] << " " << std::fixed << std::setprecision(1) << results[i]
+                << " (" << std::setprecision(2) << results[i] / baseline[i] << "x)";
+        }
+        std::cout << std::defaultfloat << std::endl;
+    }
+
+}
+
+// Usage: BatchMath [benchmark element count]
+// Checks every supported BatchMath level against glm on an odd element count, so SIMD
+// bodies and scalar tails both run, then reports kernel throughput per level.
+int main(int argc, char** argv) {
+    const size_t count = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 100000;
+    const Batch::SimdLevel supported = Batch::GetSupportedLevel();
+    std::cout << "Supported level: " << Batch::GetLevelName(supported) << std::endl;
+
+    const Data checkData = MakeData(1003);
+    for (int level = 0; level <= static_cast<int>(supported); ++level) {
+        CheckLevel(static_cast<Batch::SimdLevel>(level), checkData);
+    }
+
+    const Data benchmarkData = MakeData(count);
+    std::vector<double> baseline;
+    for (int level = 0; level <= static_cast<int>(supported); ++level) {
+        Benchmark(static_cast<Batch::SimdLevel>(level), benchmarkData, baseline);
+    }
+    Batch::SetLevel(supported);
+
+    return CheckHarness::Finish();
+}
@@ -0,0 +1,115 @@
+#include <Core/Engine.h>
+#include <Core/Jobs/JobSystem.h>
+#include <Renderer/Camera.h>
+#include <Renderer/Material.h>
+#include <Renderer/Mesh.h>
+#include <Renderer/Renderer.h>
+#include <Renderer/Shader.h>
+#include <Scene/Scene.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    double Median(std::vector<double> values) {
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+
+}
+
+// Usage: CommandRecordingBenchmark [entity count] [frames per thread count]
+// Times Scene::RecordCommands (parallel recording into per-thread command buckets) against
+// the job system's thread count, and the Flush that merges, sorts and draws the result.
+int main(int argc, char** argv) {
+    const int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const int frames = argc > 2 ? std::atoi(argv[2]) : 30;
+
+    Circe::EngineSettings settings;
+    settings.Headless = true;
+    settings.VSync = false;
+    Circe::Engine engine(1280, 720, "Circe Command Recording Benchmark", settings);
+    Circe::Renderer& renderer = *engine.GetRenderer();
+
+    std::vector<Circe::Vertex> vertices = {
+        { { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } },
+        { {  0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f } },
+        { {  0.0f,  0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.5f, 1.0f } }
+    };
+    std::vector<unsigned int> indices = { 0, 1, 2 };
+    auto mesh = std::make_shared<Circe::Mesh>(vertices, indices);
+    auto shader = std::make_shared<Circe::Shader>("../../assets/shaders/instanced.vert", "../../assets/shaders/triangle.frag");
+    std::vector<std::shared_ptr<Circe::Material>> materials;
+    for (int i = 0; i < 8; ++i) {
+        materials.push_back(std::make_shared<Circe::Material>(shader));
+        materials.back()->SetColor(glm::vec4(i / 8.0f, 0.5f, 1.0f - i / 8.0f, 1.0f));
+    }
+
+    // A grid of registry entities; every eighth one hangs off its neighbour in the hierarchy
+    Circe::Scene scene;
+    Circe::Registry& registry = scene.GetRegistry();
+    const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+    Circe::EntityHandle previous;
+    for (int i = 0; i < count; ++i) {
+        Circe::EntityHandle entity = scene.CreateEntity();
+        registry.Get<Circe::Transform>(entity).Position = glm::vec3((i % side - side * 0.5f) * 1.2f, (i / side - side * 0.5f) * 1.2f, 0.0f);
+        registry.Emplace<Circe::RenderableComponent>(entity, mesh, materials[i % materials.size()]);
+        if (i % 8 == 7) {
+            scene.SetParent(entity, previous);
+        }
+        previous = entity;
+    }
+
+    auto camera = std::make_shared<Circe::Camera>(45.0f, 1280.0f / 720.0f, 0.1f, 5000.0f);
+    camera->SetPosition(glm::vec3(0.0f, 0.0f, side * 1.5f + 3.0f));
+    renderer.SetCamera(camera);
+
+    std::vector<unsigned int> threadCounts;
+    const unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int threads = 1; threads < hardwareThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(hardwareThreads);
+
+    std::cout << count << " entities, median of " << frames << " frames" << std::endl;
+    double baseline = 0.0;
+    for (unsigned int threads : threadCounts) {
+        Circe::JobSystem::Shutdown();
+        Circe::JobSystem::Initialize(threads);
+
+        std::vector<double> recordTimes;
+        std::vector<double> flushTimes;
+        // The first frames size the buckets and arenas for this thread count
+        for (int frame = -3; frame < frames; ++frame) {
+            renderer.BeginFrame();
+            const auto start = std::chrono::steady_clock::now();
+            scene.RecordCommands(renderer);
+            const auto recorded = std::chrono::steady_clock::now();
+            renderer.Flush();
+            const auto flushed = std::chrono::steady_clock::now();
+            renderer.Present();
+            if (frame >= 0) {
+                recordTimes.push_back(std::chrono::duration<double, std::milli>(recorded - start).count());
+                flushTimes.push_back(std::chrono::duration<double, std::milli>(flushed - recorded).count());
+            }
+        }
+
+        const double record = Median(recordTimes);
+        baseline = baseline > 0.0 ? baseline : record;
+        const Circe::RenderStats& stats = renderer.GetStats();
+        std::cout << std::fixed << std::setprecision(3)
+            << std::setw(3) << threads << " threads | record " << record << " ms"
+            << " (" << std::setprecision(2) << baseline / record << "x)"
+            << " | flush " << std::setprecision(3) << Median(flushTimes) << " ms"
+            << " | " << stats.Visible + stats.Culled << " commands, " << stats.DrawCalls << " draw calls" << std::endl;
+    }
+    return 0;
+}
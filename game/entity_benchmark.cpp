@@ -0,0 +1,231 @@
+#include <Core/Engine.h>
+#include <Renderer/Camera.h>
+#include <Renderer/Material.h>
+#include <Renderer/Mesh.h>
+#include <Renderer/Model.h>
+#include <Renderer/Renderer.h>
+#include <Renderer/Shader.h>
+#include <Scene/Scene.h>
+
+#include "CheckHarness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+
+    struct Velocity {
+        glm::vec3 Value;
+    };
+
+    // The same per-entity work on both paths: integrate a velocity and bounce inside a box
+    void Integrate(Circe::Transform& transform, glm::vec3& velocity, float deltaTime) {
+        transform.Position += velocity * deltaTime;
+        if (std::abs(transform.Position.z) > 1.0f) {
+            velocity.z = -velocity.z;
+        }
+    }
+
+    glm::vec3 GridPosition(int i, int side) {
+        return glm::vec3((i % side - side * 0.5f) * 1.2f, (i / side - side * 0.5f) * 1.2f, 0.0f);
+    }
+
+    glm::vec3 StartVelocity(int i) {
+        return glm::vec3(0.0f, 0.0f, 0.5f + (i % 7) * 0.25f);
+    }
+
+    // Entity subclass path: a virtual OnUpdate per object, run on the job system since it only
+    // moves the object itself, and Model::Render submitting one command per object serially
+    class MovingEntity : public Circe::Entity {
+    public:
+        MovingEntity(std::shared_ptr<Circe::Model> model, const glm::vec3& position, const glm::vec3& velocity)
+            : m_Velocity(velocity) {
+            SetModel(std::move(model));
+            m_Transform.Position = position;
+            SetParallelUpdate(true);
+        }
+
+        void OnUpdate(float deltaTime) override {
+            Integrate(m_Transform, m_Velocity, deltaTime);
+        }
+
+    private:
+        glm::vec3 m_Velocity;
+    };
+
+    struct Resources {
+        std::shared_ptr<Circe::Mesh> Mesh;
+        std::shared_ptr<Circe::Material> Material;
+        std::shared_ptr<Circe::Model> Model;
+    };
+
+    void PopulateObjects(Circe::Scene& scene, const Resources& resources, int count, int side) {
+        for (int i = 0; i < count; ++i) {
+            scene.AddEntity(std::make_unique<MovingEntity>(resources.Model, GridPosition(i, side), StartVelocity(i)));
+        }
+    }
+
+    // Registry path: components in pools, a ParallelEach system for the update and the
+    // parallel, batched recording in Scene::RecordCommands
+    void PopulateRegistry(Circe::Scene& scene, const Resources& resources, int count, int side) {
+        Circe::Registry& registry = scene.GetRegistry();
+        for (int i = 0; i < count; ++i) {
+            Circe::EntityHandle entity = scene.CreateEntity();
+            registry.Get<Circe::Transform>(entity).Position = GridPosition(i, side);
+            registry.Emplace<Velocity>(entity, Velocity{ StartVelocity(i) });
+            registry.Emplace<Circe::RenderableComponent>(entity, resources.Mesh, resources.Material);
+        }
+        scene.AddSystem([](Circe::Registry& registry, float deltaTime) {
+            registry.ParallelEach<Circe::Transform, Velocity>([deltaTime](Circe::EntityHandle, Circe::Transform& transform, Velocity& velocity) {
+                Integrate(transform, velocity.Value, deltaTime);
+            });
+        });
+    }
+
+    double Median(std::vector<double> values) {
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+
+    double Milliseconds(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    struct Result {
+        double Update = 0.0;
+        double Record = 0.0;
+        double Flush = 0.0;
+        uint32_t Commands = 0;
+    };
+
+    Result Measure(Circe::Renderer& renderer, Circe::Scene& scene, int frames) {
+        std::vector<double> updateTimes;
+        std::vector<double> recordTimes;
+        std::vector<double> flushTimes;
+        // The first frames size the command buckets and arenas
+        for (int frame = -2; frame < frames; ++frame) {
+            const auto start = std::chrono::steady_clock::now();
+            scene.Update(1.0f / 60.0f);
+            const auto updated = std::chrono::steady_clock::now();
+            renderer.BeginFrame();
+            const auto begun = std::chrono::steady_clock::now();
+            scene.RecordCommands(renderer);
+            const auto recorded = std::chrono::steady_clock::now();
+            renderer.Flush();
+            const auto flushed = std::chrono::steady_clock::now();
+            renderer.Present();
+            if (frame >= 0) {
+                updateTimes.push_back(Milliseconds(start, updated));
+                recordTimes.push_back(Milliseconds(begun, recorded));
+                flushTimes.push_back(Milliseconds(recorded, flushed));
+            }
+        }
+        const Circe::RenderStats& stats = renderer.GetStats();
+        return { Median(updateTimes), Median(recordTimes), Median(flushTimes), stats.Visible + stats.Culled };
+    }
+
+    // Both entity kinds default to "Entity" and share the name index: lookups by name must
+    // still find the object entity, and forget it once it is renamed or destroyed
+    void CheckNameLookup() {
+        Circe::Scene scene;
+        for (int i = 0; i < 3; ++i) {
+            scene.CreateEntity();
+        }
+        auto owned = std::make_unique<Circe::Entity>();
+        Circe::Entity* object = owned.get();
+        const Circe::EntityHandle handle = scene.AddEntity(std::move(owned));
+        for (int i = 0; i < 3; ++i) {
+            scene.CreateEntity();
+        }
+        CheckHarness::Check("GetEntity finds the object among registry entities of its name", scene.GetEntity("Entity") == object);
+
+        object->SetName("Renamed");
+        CheckHarness::Check("GetEntity follows a rename", scene.GetEntity("Renamed") == object && !scene.GetEntity("Entity"));
+
+        scene.DestroyEntity(handle);
+        CheckHarness::Check("GetEntity skips a destroyed object", !scene.GetEntity("Renamed") && scene.FindEntity("Entity").IsValid());
+    }
+
+    void Print(const char* name, int count, const Result& result, const Result* baseline) {
+        // Millions of entities per second
+        const double updateRate = count / result.Update / 1e3;
+        const double recordRate = count / result.Record / 1e3;
+        std::cout << std::fixed << std::setprecision(3) << std::setw(8) << count << " " << name
+            << " | update " << std::setw(8) << result.Update << " ms, " << std::setprecision(1) << std::setw(6) << updateRate << " M/s";
+        if (baseline) {
+            std::cout << " (" << std::setprecision(2) << baseline->Update / result.Update << "x)";
+        }
+        std::cout << std::setprecision(3) << " | record " << std::setw(8) << result.Record << " ms, "
+            << std::setprecision(1) << std::setw(6) << recordRate << " M/s";
+        if (baseline) {
+            std::cout << " (" << std::setprecision(2) << baseline->Record / result.Record << "x)";
+        }
+        std::cout << std::setprecision(3) << " | flush " << result.Flush << " ms | " << result.Commands << " commands"
+            << std::defaultfloat << std::endl;
+    }
+
+}
+
+// Usage: EntityBenchmark [largest entity count] [frames per run]
+// Headless update and render-submission throughput of the same moving, drawn entities as
+// Entity subclasses (virtual OnUpdate, Model::Render) and as registry entities (a ParallelEach
+// system, parallel batched recording) at 10k, 100k and 1M entities. Record is the time to fill
+// the command queue; flush (sort, cull, draw) is shown for scale. Name lookups over both entity
+// kinds are checked first.
+int main(int argc, char** argv) {
+    const int largest = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const int frames = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+
+    Circe::EngineSettings settings;
+    settings.Headless = true;
+    settings.VSync = false;
+    Circe::Engine engine(1280, 720, "Circe Entity Benchmark", settings);
+    Circe::Renderer& renderer = *engine.GetRenderer();
+
+    std::vector<Circe::Vertex> vertices = {
+        { { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } },
+        { {  0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f } },
+        { {  0.0f,  0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.5f, 1.0f } }
+    };
+    Resources resources;
+    resources.Mesh = std::make_shared<Circe::Mesh>(vertices, std::vector<unsigned int>{ 0, 1, 2 });
+    auto shader = std::make_shared<Circe::Shader>("../../assets/shaders/instanced.vert", "../../assets/shaders/triangle.frag");
+    resources.Material = std::make_shared<Circe::Material>(shader);
+    resources.Model = std::make_shared<Circe::Model>(resources.Mesh, resources.Material);
+
+    auto camera = std::make_shared<Circe::Camera>(45.0f, 1280.0f / 720.0f, 0.1f, 5000.0f);
+    renderer.SetCamera(camera);
+
+    CheckNameLookup();
+
+    std::cout << "Median of " << frames << " frames" << std::endl;
+    for (int count : { 10000, 100000, 1000000 }) {
+        if (count > largest) {
+            break;
+        }
+        const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+        camera->SetPosition(glm::vec3(0.0f, 0.0f, side * 1.5f + 3.0f));
+
+        Result objects;
+        {
+            Circe::Scene scene;
+            PopulateObjects(scene, resources, count, side);
+            objects = Measure(renderer, scene, frames);
+        }
+        Result registry;
+        {
+            Circe::Scene scene;
+            PopulateRegistry(scene, resources, count, side);
+            registry = Measure(renderer, scene, frames);
+        }
+        Print("Entity  ", count, objects, nullptr);
+        Print("registry", count, registry, &objects);
+    }
+    return CheckHarness::Finish();
+}
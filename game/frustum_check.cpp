@@ -0,0 +1,237 @@
+#include <Math/BatchMath.h>
+#include <Math/Frustum.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "CheckHarness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    namespace Batch = Circe::BatchMath;
+
+    void CheckSpheres(const std::string& name, size_t mismatches, size_t count) {
+        CheckHarness::Check(name, mismatches == 0, std::to_string(mismatches) + " of " + std::to_string(count) + " spheres disagree");
+    }
+
+    // Signed distance in double, independent of the engine's float plane tests
+    double Distance(const glm::vec4& plane, const glm::vec3& point) {
+        return double(plane.x) * point.x + double(plane.y) * point.y + double(plane.z) * point.z + plane.w;
+    }
+
+    struct Case {
+        Circe::PackedSpheres Spheres;
+        // 1 visible, 0 culled, -1 only compared against Frustum::Intersects
+        std::vector<int> Expected;
+
+        void Push(const Circe::BoundingSphere& sphere, int expected) {
+            Spheres.Push(sphere);
+            Expected.push_back(expected);
+        }
+    };
+
+    // A point well inside the frustum, to slide towards each plane
+    glm::vec3 InsidePoint(const Circe::Frustum& frustum, const glm::mat4& viewProjection) {
+        const glm::vec4 clip = glm::inverse(viewProjection) * glm::vec4(0.1f, -0.2f, 0.5f, 1.0f);
+        const glm::vec3 point = glm::vec3(clip) / clip.w;
+        std::string outside;
+        for (int p = 0; p < Circe::Frustum::PlaneCount; ++p) {
+            if (Distance(frustum.GetPlane(p), point) <= 0.0) {
+                outside += " " + std::to_string(p);
+            }
+        }
+        CheckHarness::Check("reference point inside the frustum", outside.empty(), outside.empty() ? std::string() : "outside plane" + outside);
+        return point;
+    }
+
+    // For every plane, spheres whose centers sit at a multiple of the radius from it, on a
+    // spot where no other plane is near: fully outside is culled, straddling or touching is kept
+    void AddStraddling(Case& result, const Circe::Frustum& frustum, const glm::vec3& inside) {
+        const float radii[] = { 0.0f, 0.05f, 0.5f, 2.0f };
+        const float offsets[] = { -1.5f, -1.01f, -0.99f, -0.5f, 0.0f, 0.5f, 1.5f };
+        for (int p = 0; p < Circe::Frustum::PlaneCount; ++p) {
+            const glm::vec4& plane = frustum.GetPlane(p);
+            const glm::vec3 normal(plane);
+            const glm::vec3 onPlane = inside - normal * static_cast<float>(Distance(plane, inside));
+            for (float radius : radii) {
+                for (float offset : offsets) {
+                    // Radius-0 points get a small fixed offset so they are not exactly on the plane
+                    const float distance = radius > 0.0f ? offset * radius : (offset < 0.0f ? -0.01f : (offset > 0.0f ? 0.01f : 1.0f));
+                    const Circe::BoundingSphere sphere{ onPlane + normal * distance, radius };
+
+                    bool visible = true;
+                    for (int q = 0; q < Circe::Frustum::PlaneCount; ++q) {
+                        visible = visible && Distance(frustum.GetPlane(q), sphere.Center) >= -radius;
+                    }
+                    result.Push(sphere, visible ? 1 : 0);
+                }
+            }
+        }
+    }
+
+    void AddRandom(Case& result, size_t count, std::mt19937& random) {
+        std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+        std::uniform_real_distribution<float> radius(0.0f, 8.0f);
+        for (size_t i = 0; i < count; ++i) {
+            // Every 16th is a default sphere, what the renderer stores for a command whose
+            // mesh or material is gone, and every 10th has radius 0
+            if (i % 16 == 5) {
+                result.Push(Circe::BoundingSphere{}, -1);
+            } else {
+                const float r = i % 10 == 3 ? 0.0f : radius(random);
+                result.Push(Circe::BoundingSphere{ glm::vec3(position(random), position(random), position(random) - 40.0f), r }, -1);
+            }
+        }
+    }
+
+    // Culls the first count spheres of a case and compares against Intersects and the expectations
+    size_t Mismatches(const Circe::Frustum& frustum, const Case& input, size_t count) {
+        Circe::PackedSpheres spheres = input.Spheres;
+        spheres.Resize(count);
+        // Guard bytes past the end catch a SIMD body that writes beyond the count
+        std::vector<uint8_t> visible(count + 8, 0xAB);
+        const size_t visibleCount = frustum.CullSpheres(spheres, visible.data());
+
+        size_t mismatches = 0;
+        size_t expectedCount = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const Circe::BoundingSphere sphere{ glm::vec3(spheres.X[i], spheres.Y[i], spheres.Z[i]), spheres.Radius[i] };
+            const bool intersects = frustum.Intersects(sphere);
+            const bool expected = input.Expected[i] < 0 ? intersects : input.Expected[i] == 1;
+            expectedCount += expected ? 1 : 0;
+            mismatches += (visible[i] != (expected ? 1 : 0) || intersects != expected) ? 1 : 0;
+        }
+        for (size_t i = count; i < visible.size(); ++i) {
+            mismatches += visible[i] != 0xAB ? 1 : 0;
+        }
+        return mismatches + (visibleCount != expectedCount ? 1 : 0);
+    }
+
+    void CheckCulling(Batch::SimdLevel level, const Circe::Frustum& frustum, const Case& straddling, const Case& random) {
+        Batch::SetLevel(level);
+        const std::string prefix = std::string(Batch::GetLevelName(level)) + " ";
+        CheckSpheres(prefix + "straddling every plane", Mismatches(frustum, straddling, straddling.Spheres.Size()), straddling.Spheres.Size());
+
+        // Counts below, between and past the 4- and 8-wide bodies, so every tail length runs
+        size_t mismatches = 0;
+        size_t total = 0;
+        for (size_t count : { 0, 1, 3, 4, 5, 7, 8, 9, 12, 13, 15, 17, 1003 }) {
+            mismatches += Mismatches(frustum, random, count);
+            total += count;
+        }
+        CheckSpheres(prefix + "random, radius 0 and default spheres, odd counts", mismatches, total);
+    }
+
+    // Largest distance of a transformed box corner outside the box, and of the box past the
+    // corners' own bounds (Arvo's method is exact for affine matrices)
+    double BoxError(const Circe::AABB& box, const glm::mat4& matrix) {
+        const Circe::AABB transformed = box.Transformed(matrix);
+        Circe::AABB corners;
+        for (int corner = 0; corner < 8; ++corner) {
+            const glm::vec3 point((corner & 1) ? box.Max.x : box.Min.x, (corner & 2) ? box.Max.y : box.Min.y, (corner & 4) ? box.Max.z : box.Min.z);
+            corners.Expand(glm::vec3(matrix * glm::vec4(point, 1.0f)));
+        }
+        const glm::vec3 minError = glm::abs(transformed.Min - corners.Min);
+        const glm::vec3 maxError = glm::abs(transformed.Max - corners.Max);
+        const glm::vec3 magnitude = glm::max(glm::abs(corners.Min), glm::abs(corners.Max));
+        const double scale = std::max({ 1.0, double(magnitude.x), double(magnitude.y), double(magnitude.z) });
+        return std::max({ minError.x, minError.y, minError.z, maxError.x, maxError.y, maxError.z }) / scale;
+    }
+
+    // Amount by which surface points escape the transformed sphere, and by which the radius
+    // exceeds the farthest of them (the axis points reach the largest scale exactly), relative
+    // to the sphere's largest coordinate as the center's rounding scales with it
+    void SphereErrors(const Circe::BoundingSphere& sphere, const glm::mat4& matrix, std::mt19937& random, double& escape, double& slack) {
+        const Circe::BoundingSphere transformed = sphere.Transformed(matrix);
+        std::normal_distribution<float> direction;
+        std::vector<glm::vec3> directions = {
+            { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }
+        };
+        for (int i = 0; i < 64; ++i) {
+            directions.push_back(glm::normalize(glm::vec3(direction(random), direction(random), direction(random))));
+        }
+
+        double farthest = 0.0;
+        for (const glm::vec3& d : directions) {
+            const glm::vec3 point = glm::vec3(matrix * glm::vec4(sphere.Center + d * sphere.Radius, 1.0f));
+            farthest = std::max(farthest, double(glm::length(point - transformed.Center)));
+        }
+        const double scale = std::max(1.0, double(glm::length(transformed.Center) + transformed.Radius));
+        escape = std::max(escape, (farthest - transformed.Radius) / scale);
+        slack = std::max(slack, (transformed.Radius - farthest) / scale);
+    }
+
+    void CheckTransforms(std::mt19937& random) {
+        std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+        std::uniform_real_distribution<float> scale(0.05f, 8.0f);
+        std::uniform_real_distribution<float> extent(0.0f, 5.0f);
+        std::normal_distribution<float> axis;
+
+        double boxError = 0.0;
+        size_t invalidMismatches = 0;
+        double escape = 0.0;
+        double slack = 0.0;
+        for (int i = 0; i < 500; ++i) {
+            // Rotated, non-uniformly scaled, and every 25th mirrored on one axis
+            const glm::vec3 scales(i % 25 == 0 ? -scale(random) : scale(random), scale(random), scale(random));
+            const glm::mat4 matrix = glm::translate(glm::mat4(1.0f), glm::vec3(position(random), position(random), position(random)))
+                * glm::mat4_cast(glm::normalize(glm::quat(axis(random), axis(random), axis(random), axis(random))))
+                * glm::scale(glm::mat4(1.0f), scales);
+
+            const glm::vec3 center(position(random), position(random), position(random));
+            const glm::vec3 half(extent(random), extent(random), extent(random));
+            boxError = std::max(boxError, BoxError(Circe::AABB(center - half, center + half), matrix));
+            // An invalid (empty) box has to come back unchanged, not as a huge one
+            invalidMismatches += Circe::AABB().Transformed(matrix).IsValid() ? 1 : 0;
+
+            SphereErrors(Circe::BoundingSphere{ center, extent(random) }, matrix, random, escape, slack);
+        }
+        CheckHarness::CheckError("AABB::Transformed vs transformed corners, non-uniform scale", invalidMismatches ? 1.0 : boxError, 1e-5);
+        CheckHarness::CheckError("BoundingSphere::Transformed contains the transformed sphere", std::max(escape, 0.0), 1e-5);
+        CheckHarness::CheckError("BoundingSphere::Transformed radius is the largest axis scale", std::max(slack, 0.0), 1e-5);
+    }
+
+}
+
+// Usage: FrustumCheck
+// Checks Frustum::CullSpheres at every supported BatchMath level (AVX, SSE, scalar) against
+// per-sphere plane tests, on spheres straddling each plane, radius-0 and default spheres and
+// counts that leave every tail length, then AABB and sphere transforms under non-uniform scale.
+int main() {
+    const Batch::SimdLevel supported = Batch::GetSupportedLevel();
+    std::cout << "Supported level: " << Batch::GetLevelName(supported) << std::endl;
+
+    std::mt19937 random(1234);
+    // One camera with the origin in view and one looking away from it, so the default
+    // spheres of null commands are kept in one and culled in the other
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    const glm::mat4 views[] = {
+        glm::lookAt(glm::vec3(1.0f, 2.0f, 10.0f), glm::vec3(0.0f, 0.0f, -20.0f), glm::vec3(0.0f, 1.0f, 0.0f)),
+        glm::lookAt(glm::vec3(3.0f, -1.0f, -5.0f), glm::vec3(10.0f, -4.0f, -40.0f), glm::vec3(0.0f, 1.0f, 0.0f))
+    };
+    for (const glm::mat4& view : views) {
+        const glm::mat4 viewProjection = projection * view;
+        const Circe::Frustum frustum(viewProjection);
+        std::cout << "Camera with the origin " << (frustum.Intersects(Circe::BoundingSphere{}) ? "in view" : "out of view") << std::endl;
+
+        Case straddling;
+        AddStraddling(straddling, frustum, InsidePoint(frustum, viewProjection));
+        Case randomSpheres;
+        AddRandom(randomSpheres, 1003, random);
+        for (int level = 0; level <= static_cast<int>(supported); ++level) {
+            CheckCulling(static_cast<Batch::SimdLevel>(level), frustum, straddling, randomSpheres);
+        }
+    }
+    Batch::SetLevel(supported);
+
+    CheckTransforms(random);
+
+    return CheckHarness::Finish();
+}
@@ -0,0 +1,149 @@
+#include <Core/Jobs/JobSystem.h>
+#include <Scene/TransformHierarchy.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using NodeID = Circe::TransformHierarchy::NodeID;
+
+    // Subtrees of 64: a root, 7 children and 8 grandchildren under each child
+    std::vector<NodeID> BuildFans(Circe::TransformHierarchy& hierarchy, size_t count) {
+        std::vector<NodeID> nodes;
+        nodes.reserve(count);
+        while (nodes.size() < count) {
+            const NodeID root = hierarchy.CreateNode();
+            nodes.push_back(root);
+            for (int child = 0; child < 7 && nodes.size() < count; ++child) {
+                Circe::Transform local;
+                local.Position = glm::vec3(1.0f, 0.0f, 0.0f);
+                const NodeID middle = hierarchy.CreateNode(local, root);
+                nodes.push_back(middle);
+                for (int leaf = 0; leaf < 8 && nodes.size() < count; ++leaf) {
+                    nodes.push_back(hierarchy.CreateNode(local, middle));
+                }
+            }
+        }
+        return nodes;
+    }
+
+    // Chains of the given length, each node the parent of the next. Returns the roots.
+    std::vector<NodeID> BuildChains(Circe::TransformHierarchy& hierarchy, size_t chains, size_t length) {
+        std::vector<NodeID> roots;
+        Circe::Transform local;
+        local.Position = glm::vec3(0.0f, 0.1f, 0.0f);
+        for (size_t chain = 0; chain < chains; ++chain) {
+            NodeID node = hierarchy.CreateNode(local);
+            roots.push_back(node);
+            for (size_t i = 1; i < length; ++i) {
+                node = hierarchy.CreateNode(local, node);
+            }
+        }
+        return roots;
+    }
+
+    struct Result {
+        double Milliseconds;
+        size_t Updated;
+    };
+
+    // Median Update() time after moving the given nodes, edits outside the timing
+    Result Measure(Circe::TransformHierarchy& hierarchy, const std::vector<NodeID>& moved, int repetitions) {
+        // Settles the initial build (a full rebuild) before timing incremental updates
+        hierarchy.Update();
+        std::vector<double> times;
+        size_t updated = 0;
+        for (int repetition = 0; repetition < repetitions; ++repetition) {
+            for (NodeID node : moved) {
+                hierarchy.EditLocal(node).Position.z += 0.001f;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            hierarchy.Update();
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            updated = hierarchy.GetLastUpdatedCount();
+        }
+        std::sort(times.begin(), times.end());
+        return { times[times.size() / 2], updated };
+    }
+
+    std::vector<NodeID> Pick(const std::vector<NodeID>& nodes, size_t count, std::mt19937& random) {
+        std::vector<NodeID> picked = nodes;
+        std::shuffle(picked.begin(), picked.end(), random);
+        picked.resize(std::min(count, picked.size()));
+        return picked;
+    }
+
+    void Print(size_t nodes, size_t moved, const Result& result) {
+        std::cout << std::setw(8) << nodes << " nodes | " << std::setw(7) << moved << " moved | "
+            << std::setw(8) << result.Updated << " updated | " << std::fixed << std::setprecision(3)
+            << std::setw(8) << result.Milliseconds << " ms";
+        if (result.Updated > 0) {
+            std::cout << " | " << std::setprecision(1) << result.Milliseconds * 1e6 / result.Updated << " ns/node";
+        }
+        std::cout << std::defaultfloat << std::endl;
+    }
+
+}
+
+// Usage: HierarchyBenchmark [repetitions]
+// Times TransformHierarchy::Update() and reports GetLastUpdatedCount(): with the node count
+// fixed and the number of moved nodes varied, with the moved count fixed and the node count
+// varied, and for deep chains above the parallel threshold against the job thread count.
+int main(int argc, char** argv) {
+    const int repetitions = argc > 1 ? std::max(1, std::atoi(argv[1])) : 21;
+    std::mt19937 random(1234);
+    Circe::JobSystem::Initialize();
+
+    std::cout << "Fixed node count, random nodes moved (64-node subtrees)" << std::endl;
+    {
+        Circe::TransformHierarchy hierarchy;
+        const std::vector<NodeID> nodes = BuildFans(hierarchy, 100000);
+        for (size_t moved : { 0, 1, 10, 100, 1000, 10000, 100000 }) {
+            Print(nodes.size(), moved, Measure(hierarchy, Pick(nodes, moved, random), repetitions));
+        }
+    }
+
+    std::cout << "Fixed moved count (100 random nodes), node count varied" << std::endl;
+    for (size_t count : { 1000, 10000, 100000, 1000000 }) {
+        Circe::TransformHierarchy hierarchy;
+        const std::vector<NodeID> nodes = BuildFans(hierarchy, count);
+        Print(nodes.size(), 100, Measure(hierarchy, Pick(nodes, 100, random), repetitions));
+    }
+
+    // 64 chains of 256 moved at their roots give 64 independent ranges and 16384 updated
+    // nodes, past the parallel threshold (4096). One chain of the same size is one range and
+    // stays serial whatever the thread count.
+    std::vector<unsigned int> threadCounts;
+    const unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int threads = 1; threads < hardwareThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(hardwareThreads);
+
+    std::cout << "Deep hierarchies, every root moved" << std::endl;
+    for (unsigned int threads : threadCounts) {
+        Circe::JobSystem::Shutdown();
+        Circe::JobSystem::Initialize(threads);
+        std::cout << std::setw(3) << threads << " threads" << std::endl;
+
+        Circe::TransformHierarchy chains;
+        const std::vector<NodeID> chainRoots = BuildChains(chains, 64, 256);
+        std::cout << "  64 x 256 chains | ";
+        Print(chains.GetNodeCount(), chainRoots.size(), Measure(chains, chainRoots, repetitions));
+
+        Circe::TransformHierarchy single;
+        const std::vector<NodeID> singleRoot = BuildChains(single, 1, 16384);
+        std::cout << "  1 x 16384 chain | ";
+        Print(single.GetNodeCount(), singleRoot.size(), Measure(single, singleRoot, repetitions));
+    }
+
+    Circe::JobSystem::Shutdown();
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <Core/Engine.h>
+#include <Core/Time.h>
+#include <Core/Window.h>
+#include <Renderer/Camera.h>
+#include <Renderer/Material.h>
+#include <Renderer/Mesh.h>
+#include <Renderer/Model.h>
+#include <Renderer/Renderer.h>
+#include <Renderer/Shader.h>
+#include <Scene/Entity.h>
+#include <Scene/Scene.h>
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+    // Spawns N entities sharing one mesh and material and reports draw calls and frame time
+    class InstancingScene : public Circe::Scene {
+    public:
+        InstancingScene(int count, bool instanced)
+            : m_Count(count) {
+            std::vector<Circe::Vertex> vertices = {
+                { { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } },
+                { {  0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f } },
+                { {  0.0f,  0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.5f, 1.0f } }
+            };
+            std::vector<unsigned int> indices = { 0, 1, 2 };
+
+            auto mesh = std::make_shared<Circe::Mesh>(vertices, indices);
+
+            // triangle.vert only has the "model" uniform and exercises the per-draw fallback
+            auto shader = std::make_shared<Circe::Shader>(
+                instanced ? "../../assets/shaders/instanced.vert" : "../../assets/shaders/triangle.vert",
+                "../../assets/shaders/triangle.frag"
+            );
+            auto material = std::make_shared<Circe::Material>(shader);
+            material->SetColor(glm::vec4(0.2f, 0.7f, 1.0f, 1.0f));
+
+            m_Model = std::make_shared<Circe::Model>(mesh, material);
+        }
+
+        void OnInit() override {
+            const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(m_Count))));
+            for (int i = 0; i < m_Count; ++i) {
+                auto entity = std::make_unique<Circe::Entity>("Prop" + std::to_string(i));
+                entity->SetModel(m_Model);
+                entity->GetTransform().Position = glm::vec3(
+                    (i % side - side * 0.5f) * 1.2f,
+                    (i / side - side * 0.5f) * 1.2f,
+                    0.0f);
+                AddEntity(std::move(entity));
+            }
+        }
+
+        void OnRender(Circe::Renderer& renderer) override {
+            m_Frames++;
+            m_Elapsed += Circe::Time::GetDeltaTime();
+            if (m_Elapsed < 1.0f) {
+                return;
+            }
+
+            const Circe::RenderStats& stats = renderer.GetStats();
+            std::cout << m_Count << " entities | "
+                << stats.DrawCalls << " draw calls | "
+                << stats.Instances << " instances | "
+                << (m_Elapsed * 1000.0f / m_Frames) << " ms/frame" << std::endl;
+
+            m_Frames = 0;
+            m_Elapsed = 0.0f;
+        }
+
+    private:
+        int m_Count;
+        int m_Frames = 0;
+        float m_Elapsed = 0.0f;
+        std::shared_ptr<Circe::Model> m_Model;
+    };
+
+}
+
+// Usage: InstancingBenchmark [entity count] [--no-instancing] [--headless [frames]] [--pipelined [latency]] [--trace file.json]
+int main(int argc, char** argv) {
+    int count = 10000;
+    bool instanced = true;
+    Circe::EngineSettings settings;
+    settings.VSync = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--no-instancing") {
+            instanced = false;
+        } else if (arg == "--trace" && i + 1 < argc) {
+            settings.TraceOutput = argv[++i];
+        } else if (arg == "--pipelined") {
+            settings.Pipelined = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                settings.FrameLatency = static_cast<uint32_t>(std::atoi(argv[++i]));
+            }
+        } else if (arg == "--headless") {
+            settings.Headless = true;
+            settings.FrameLimit = 600;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                settings.FrameLimit = static_cast<uint32_t>(std::atoi(argv[++i]));
+            }
+        } else {
+            count = std::atoi(argv[i]);
+        }
+    }
+
+    Circe::Engine engine(1280, 720, "Circe Instancing Benchmark", settings);
+    InstancingScene scene(count, instanced);
+
+    auto camera = std::make_shared<Circe::Camera>(45.0f, 1280.0f / 720.0f, 0.1f, 1000.0f);
+    camera->SetPosition(glm::vec3(0.0f, 0.0f, std::sqrt(static_cast<float>(count)) * 1.5f + 3.0f));
+    engine.GetRenderer()->SetCamera(camera);
+
+    engine.SetScene(&scene);
+    engine.Run();
+    return 0;
+}
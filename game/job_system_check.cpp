@@ -0,0 +1,312 @@
+#include <Core/Jobs/JobSystem.h>
+#include <Math/Transform.h>
+#include <Scene/Registry.h>
+
+#include "CheckHarness.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using Circe::JobCounter;
+    using Circe::JobSystem;
+
+    // Every index of [begin, end) visited exactly once, chunks in bounds, for several grains.
+    // Grain 1 over 10000 items overflows the 4096-entry deque of the submitting thread.
+    bool CheckParallelFor() {
+        bool passed = true;
+        for (size_t count : { 0, 1, 7, 1000, 10000, 100003 }) {
+            for (size_t grain : { 0, 1, 3, 64 }) {
+                if (grain == 1 && count > 10000) {
+                    continue;
+                }
+                const size_t begin = 5;
+                std::vector<std::atomic<int>> hits(count);
+                std::atomic<uint64_t> sum{ 0 };
+                std::atomic<int> outOfBounds{ 0 };
+                JobSystem::ParallelFor(begin, begin + count, [&](size_t first, size_t last) {
+                    if (first < begin || last > begin + count || first >= last) {
+                        outOfBounds.fetch_add(1);
+                        return;
+                    }
+                    uint64_t local = 0;
+                    for (size_t i = first; i < last; ++i) {
+                        hits[i - begin].fetch_add(1, std::memory_order_relaxed);
+                        local += i;
+                    }
+                    sum.fetch_add(local, std::memory_order_relaxed);
+                }, grain);
+
+                const uint64_t expected = count == 0 ? 0 : (uint64_t(begin) * 2 + count - 1) * count / 2;
+                passed = passed && outOfBounds == 0 && sum == expected
+                    && std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& hit) { return hit.load() == 1; });
+            }
+        }
+        return passed;
+    }
+
+    // Inner loops wait from inside jobs, on workers and on the initializing thread
+    bool CheckNestedParallelFor() {
+        constexpr size_t Outer = 64;
+        constexpr size_t Inner = 1000;
+        std::vector<std::atomic<int>> hits(Outer * Inner);
+        JobSystem::ParallelFor(0, Outer, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                JobSystem::ParallelFor(0, Inner, [&, i](size_t innerFirst, size_t innerLast) {
+                    for (size_t j = innerFirst; j < innerLast; ++j) {
+                        hits[i * Inner + j].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }, 16);
+            }
+        }, 1);
+        return std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& hit) { return hit.load() == 1; });
+    }
+
+    // Stages of jobs, each held back until the previous stage's counter reaches zero.
+    // A job that runs before its whole previous stage has finished is an ordering error.
+    bool CheckDependencyChain() {
+        constexpr int Stages = 50;
+        constexpr int JobsPerStage = 16;
+        std::vector<std::unique_ptr<JobCounter>> counters;
+        std::vector<std::atomic<int>> finished(Stages);
+        std::atomic<int> errors{ 0 };
+
+        for (int stage = 0; stage < Stages; ++stage) {
+            counters.push_back(std::make_unique<JobCounter>());
+            JobCounter* dependency = stage > 0 ? counters[stage - 1].get() : nullptr;
+            for (int job = 0; job < JobsPerStage; ++job) {
+                JobSystem::Run([&, stage]() {
+                    if (stage > 0 && finished[stage - 1].load() != JobsPerStage) {
+                        errors.fetch_add(1);
+                    }
+                    // Some work so later stages are queued while earlier ones still run
+                    volatile int spin = 0;
+                    for (int i = 0; i < 2000; ++i) {
+                        spin = spin + i;
+                    }
+                    finished[stage].fetch_add(1);
+                }, counters[stage].get(), dependency);
+            }
+        }
+        JobSystem::Wait(*counters.back());
+        for (auto& counter : counters) {
+            JobSystem::Wait(*counter);
+        }
+
+        // A dependency that is already done queues the job right away
+        JobCounter done;
+        JobCounter late;
+        std::atomic<bool> ran{ false };
+        JobSystem::Run([&]() { ran = true; }, &late, &done);
+        JobSystem::Wait(late);
+
+        return errors == 0 && ran && std::all_of(finished.begin(), finished.end(), [](const std::atomic<int>& count) { return count.load() == JobsPerStage; });
+    }
+
+    // Counters on the stack (and on the heap, overwritten after use) torn down right after
+    // Wait, while the last finishing thread may just have left Finish
+    bool CheckCounterTeardown() {
+        std::atomic<int> total{ 0 };
+        for (int round = 0; round < 2000; ++round) {
+            JobCounter counter;
+            for (int job = 0; job < 1 + round % 5; ++job) {
+                JobSystem::Run([&]() { total.fetch_add(1, std::memory_order_relaxed); }, &counter);
+            }
+            JobSystem::Wait(counter);
+        }
+        for (int round = 0; round < 500; ++round) {
+            auto counter = std::make_unique<JobCounter>();
+            JobCounter* dependent = new JobCounter;
+            JobSystem::Run([&]() { total.fetch_add(1, std::memory_order_relaxed); }, counter.get());
+            JobSystem::Run([&]() { total.fetch_add(1, std::memory_order_relaxed); }, dependent, counter.get());
+            JobSystem::Wait(*counter);
+            JobSystem::Wait(*dependent);
+            delete dependent;
+        }
+
+        int expected = 500 * 2;
+        for (int round = 0; round < 2000; ++round) {
+            expected += 1 + round % 5;
+        }
+        return total == expected;
+    }
+
+    // Threads outside the pool submit jobs and ParallelFors and wait on them
+    bool CheckForeignThreads() {
+        constexpr int ThreadCount = 4;
+        constexpr int JobsPerThread = 500;
+        std::atomic<int> ran{ 0 };
+        std::atomic<int> wrongIndex{ 0 };
+        std::vector<std::thread> threads;
+        for (int t = 0; t < ThreadCount; ++t) {
+            threads.emplace_back([&]() {
+                if (JobSystem::GetThreadIndex() != -1) {
+                    wrongIndex.fetch_add(1);
+                }
+                JobCounter counter;
+                for (int job = 0; job < JobsPerThread; ++job) {
+                    JobSystem::Run([&]() { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+                }
+                JobSystem::Wait(counter);
+                JobSystem::ParallelFor(0, JobsPerThread, [&](size_t first, size_t last) {
+                    ran.fetch_add(static_cast<int>(last - first), std::memory_order_relaxed);
+                }, 8);
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        return wrongIndex == 0 && ran == ThreadCount * JobsPerThread * 2;
+    }
+
+    // Background jobs only run on pool workers (inline without any), and the initializing
+    // thread can keep waiting on regular work while they are outstanding
+    bool CheckBackground(unsigned int threads) {
+        JobCounter background;
+        std::atomic<int> ran{ 0 };
+        std::atomic<int> onInitializingThread{ 0 };
+        for (int job = 0; job < 32; ++job) {
+            JobSystem::RunBackground([&]() {
+                onInitializingThread.fetch_add(JobSystem::GetThreadIndex() == 0 ? 1 : 0);
+                ran.fetch_add(1);
+            }, &background);
+        }
+
+        std::atomic<int> regular{ 0 };
+        JobSystem::ParallelFor(0, 1000, [&](size_t first, size_t last) {
+            regular.fetch_add(static_cast<int>(last - first));
+        }, 10);
+        if (threads > 1) {
+            // Thread 0 never takes background jobs, so only the workers can finish these
+            while (!background.IsDone()) {
+                std::this_thread::yield();
+            }
+        }
+        JobSystem::Wait(background);
+        return ran == 32 && regular == 1000 && (threads == 1 || onInitializingThread == 0);
+    }
+
+    // Shutdown with regular, dependent and background work still queued runs all of it,
+    // including regular jobs the drained ones submit, so every counter settles
+    bool CheckShutdownDrains(unsigned int threads) {
+        JobCounter regular;
+        JobCounter dependent;
+        JobCounter background;
+        JobCounter spawned;
+        std::atomic<int> ran{ 0 };
+        for (int job = 0; job < 3000; ++job) {
+            JobSystem::Run([&]() { ran.fetch_add(1); }, &regular);
+        }
+        for (int job = 0; job < 100; ++job) {
+            JobSystem::Run([&]() { ran.fetch_add(1); }, &dependent, &regular);
+        }
+        for (int job = 0; job < 100; ++job) {
+            JobSystem::RunBackground([&]() {
+                ran.fetch_add(1);
+                JobSystem::Run([&]() { ran.fetch_add(1); }, &spawned);
+            }, &background);
+        }
+
+        JobSystem::Shutdown();
+        const bool passed = ran == 3000 + 100 + 200 && regular.IsDone() && dependent.IsDone() && background.IsDone() && spawned.IsDone();
+        JobSystem::Initialize(threads);
+        return passed;
+    }
+
+    struct Velocity {
+        glm::vec3 Value;
+    };
+
+    // ParallelEach over transform and velocity pools, like a movement system, against the
+    // job thread count. Every entity has to be updated exactly once per pass.
+    void ParallelEachSweep(const std::vector<unsigned int>& threadCounts, int count, int passes) {
+        Circe::Registry registry;
+        for (int i = 0; i < count; ++i) {
+            Circe::EntityHandle entity = registry.Create();
+            registry.Emplace<Circe::Transform>(entity);
+            // Every fourth entity has no velocity and must be skipped
+            if (i % 4 != 3) {
+                registry.Emplace<Velocity>(entity, Velocity{ glm::vec3(0.0f, 0.0f, 1.0f) });
+            }
+        }
+        const int moving = count - count / 4;
+
+        std::cout << count << " entities, " << moving << " moving, median of " << passes << " passes" << std::endl;
+        double baseline = 0.0;
+        for (unsigned int threads : threadCounts) {
+            JobSystem::Shutdown();
+            JobSystem::Initialize(threads);
+
+            std::vector<double> times;
+            std::atomic<int> updates{ 0 };
+            for (int pass = -2; pass < passes; ++pass) {
+                const auto start = std::chrono::steady_clock::now();
+                registry.ParallelEach<Circe::Transform, Velocity>([&](Circe::EntityHandle, Circe::Transform& transform, Velocity& velocity) {
+                    transform.Position += velocity.Value * (1.0f / 60.0f);
+                    transform.Rotation = glm::normalize(transform.Rotation);
+                });
+                if (pass >= 0) {
+                    times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+                }
+            }
+            registry.ParallelEach<Circe::Transform, Velocity>([&](Circe::EntityHandle, Circe::Transform&, Velocity&) {
+                updates.fetch_add(1, std::memory_order_relaxed);
+            });
+
+            std::sort(times.begin(), times.end());
+            const double median = times[times.size() / 2];
+            baseline = baseline > 0.0 ? baseline : median;
+            std::cout << std::fixed << std::setprecision(3) << std::setw(3) << threads << " threads | ParallelEach "
+                << median << " ms (" << std::setprecision(2) << baseline / median << "x) | "
+                << std::setprecision(1) << moving / median / 1e3 << " M entities/s" << std::defaultfloat << std::endl;
+            CheckHarness::Check(std::to_string(threads) + " threads | ParallelEach visits every matching entity once", updates == moving);
+        }
+    }
+
+}
+
+// Usage: JobSystemCheck [sweep entity count] [sweep passes]
+// Stresses the job system at several thread counts, more than the cores included: ParallelFor
+// coverage and sums, nested ParallelFor, dependency chains and continuations, counter
+// teardown right after Wait, submission from foreign threads, RunBackground and Shutdown
+// draining queued work. Then sweeps Registry::ParallelEach entity updates over thread counts.
+// Best also run under -fsanitize=thread, which turns the teardown and deque races into reports.
+int main(int argc, char** argv) {
+    const int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const int passes = argc > 2 ? std::max(1, std::atoi(argv[2])) : 20;
+
+    const unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int threads : { 1u, 2u, 3u, 4u, 8u }) {
+        JobSystem::Initialize(threads);
+        const std::string prefix = std::to_string(threads) + " threads | ";
+        for (int repetition = 0; repetition < 3; ++repetition) {
+            CheckHarness::Check(prefix + "ParallelFor coverage and sums", CheckParallelFor());
+            CheckHarness::Check(prefix + "nested ParallelFor", CheckNestedParallelFor());
+            CheckHarness::Check(prefix + "dependency chains and continuations", CheckDependencyChain());
+            CheckHarness::Check(prefix + "counter teardown after Wait", CheckCounterTeardown());
+            CheckHarness::Check(prefix + "submission from foreign threads", CheckForeignThreads());
+            CheckHarness::Check(prefix + "RunBackground", CheckBackground(threads));
+            CheckHarness::Check(prefix + "Shutdown drains queued work", CheckShutdownDrains(threads));
+        }
+        JobSystem::Shutdown();
+    }
+
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < hardwareThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(hardwareThreads);
+    ParallelEachSweep(threadCounts, count, passes);
+    JobSystem::Shutdown();
+
+    return CheckHarness::Finish();
+}
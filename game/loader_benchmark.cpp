@@ -0,0 +1,247 @@
+#include <Core/Jobs/JobSystem.h>
+#include <Ressources/CookedMesh.h>
+#include <Ressources/MeshOptimizer.h>
+#include <Ressources/ModelLoader.h>
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // Row-major grid of side x side quads, two triangles each
+    struct Grid {
+        int Side = 0;
+        std::vector<Circe::Vertex> Vertices;
+        std::vector<uint32_t> Indices;
+    };
+
+    Grid MakeGrid(size_t triangles) {
+        Grid grid;
+        grid.Side = std::max(1, static_cast<int>(std::ceil(std::sqrt(triangles / 2.0))));
+        const int row = grid.Side + 1;
+        for (int y = 0; y <= grid.Side; y++) {
+            for (int x = 0; x <= grid.Side; x++) {
+                const float u = static_cast<float>(x) / grid.Side;
+                const float v = static_cast<float>(y) / grid.Side;
+                // Gentle waves so normals and overdraw sorting have something to work with
+                const float height = 0.05f * std::sin(u * 40.0f) * std::cos(v * 40.0f);
+                grid.Vertices.push_back({ { u * 100.0f, height, v * 100.0f }, { 0.0f, 1.0f, 0.0f }, { u, v } });
+            }
+        }
+        for (int y = 0; y < grid.Side; y++) {
+            for (int x = 0; x < grid.Side; x++) {
+                const uint32_t a = y * row + x;
+                const uint32_t b = a + 1;
+                const uint32_t c = a + row + 1;
+                const uint32_t d = a + row;
+                grid.Indices.insert(grid.Indices.end(), { a, b, c, a, c, d });
+            }
+        }
+        return grid;
+    }
+
+    void AppendFloat(std::string& out, float value) {
+        char buffer[32];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+
+    void WriteObj(const Grid& grid, const std::filesystem::path& path) {
+        std::string out;
+        out.reserve(grid.Vertices.size() * 80 + grid.Indices.size() * 12);
+        out += "# generated by LoaderBenchmark\n";
+        for (const Circe::Vertex& vertex : grid.Vertices) {
+            out += "v ";
+            AppendFloat(out, vertex.position.x); out += ' ';
+            AppendFloat(out, vertex.position.y); out += ' ';
+            AppendFloat(out, vertex.position.z); out += "\nvt ";
+            AppendFloat(out, vertex.texCoord.x); out += ' ';
+            AppendFloat(out, vertex.texCoord.y); out += "\nvn 0 1 0\n";
+        }
+        // Quads, so the parser also exercises polygon triangulation
+        const int row = grid.Side + 1;
+        for (int y = 0; y < grid.Side; y++) {
+            for (int x = 0; x < grid.Side; x++) {
+                const uint32_t quad[4] = {
+                    static_cast<uint32_t>(y * row + x + 1), static_cast<uint32_t>(y * row + x + 2),
+                    static_cast<uint32_t>((y + 1) * row + x + 2), static_cast<uint32_t>((y + 1) * row + x + 1)
+                };
+                out += 'f';
+                for (uint32_t index : quad) {
+                    const std::string text = std::to_string(index);
+                    out += ' ';
+                    out += text; out += '/';
+                    out += text; out += '/';
+                    out += text;
+                }
+                out += '\n';
+            }
+        }
+        std::ofstream(path, std::ios::binary).write(out.data(), static_cast<std::streamsize>(out.size()));
+    }
+
+    void WriteGlb(const Grid& grid, const std::filesystem::path& path) {
+        const size_t vertexBytes = grid.Vertices.size() * sizeof(Circe::Vertex);
+        const size_t indexBytes = grid.Indices.size() * sizeof(uint32_t);
+
+        // One interleaved vertex view, Vertex is position/normal/texCoord back to back
+        const std::string json =
+            "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+            "\"nodes\":[{\"mesh\":0}],"
+            "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":3}]}],"
+            "\"buffers\":[{\"byteLength\":" + std::to_string(vertexBytes + indexBytes) + "}],"
+            "\"bufferViews\":["
+            "{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" + std::to_string(vertexBytes) + ",\"byteStride\":" + std::to_string(sizeof(Circe::Vertex)) + "},"
+            "{\"buffer\":0,\"byteOffset\":" + std::to_string(vertexBytes) + ",\"byteLength\":" + std::to_string(indexBytes) + "}],"
+            "\"accessors\":["
+            "{\"bufferView\":0,\"byteOffset\":0,\"componentType\":5126,\"count\":" + std::to_string(grid.Vertices.size()) + ",\"type\":\"VEC3\"},"
+            "{\"bufferView\":0,\"byteOffset\":12,\"componentType\":5126,\"count\":" + std::to_string(grid.Vertices.size()) + ",\"type\":\"VEC3\"},"
+            "{\"bufferView\":0,\"byteOffset\":24,\"componentType\":5126,\"count\":" + std::to_string(grid.Vertices.size()) + ",\"type\":\"VEC2\"},"
+            "{\"bufferView\":1,\"componentType\":5125,\"count\":" + std::to_string(grid.Indices.size()) + ",\"type\":\"SCALAR\"}]}";
+
+        std::string jsonChunk = json;
+        jsonChunk.resize((jsonChunk.size() + 3) & ~size_t(3), ' ');
+        const uint32_t binLength = static_cast<uint32_t>(vertexBytes + indexBytes);
+        const uint32_t jsonLength = static_cast<uint32_t>(jsonChunk.size());
+        const uint32_t header[3] = { 0x46546C67, 2, 12 + 8 + jsonLength + 8 + binLength };
+        const uint32_t jsonHeader[2] = { jsonLength, 0x4E4F534A };
+        const uint32_t binHeader[2] = { binLength, 0x004E4942 };
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(jsonHeader), sizeof(jsonHeader));
+        file.write(jsonChunk.data(), jsonLength);
+        file.write(reinterpret_cast<const char*>(binHeader), sizeof(binHeader));
+        file.write(reinterpret_cast<const char*>(grid.Vertices.data()), static_cast<std::streamsize>(vertexBytes));
+        file.write(reinterpret_cast<const char*>(grid.Indices.data()), static_cast<std::streamsize>(indexBytes));
+    }
+
+    float AverageACMR(const Circe::ModelData& model) {
+        double misses = 0.0;
+        size_t triangles = 0;
+        for (const Circe::MeshData& mesh : model.Meshes) {
+            const size_t count = mesh.Indices.size() / 3;
+            misses += Circe::MeshOptimizer::ComputeACMR(mesh.Indices, mesh.Vertices.size()) * count;
+            triangles += count;
+        }
+        return triangles ? static_cast<float>(misses / triangles) : 0.0f;
+    }
+
+    void Measure(const std::filesystem::path& path, bool optimize) {
+        Circe::ModelLoadOptions options;
+        options.Optimize = optimize;
+
+        const auto start = std::chrono::steady_clock::now();
+        const Circe::ModelData model = Circe::ModelLoader::LoadData(path.string(), options);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const size_t triangles = model.GetTriangleCount();
+        std::cout << path.filename().string() << (optimize ? " (optimized)" : " (raw)")
+            << " | " << seconds * 1000.0 << " ms"
+            << " | " << model.SourceBytes / (1024.0 * 1024.0) / seconds << " MB/s"
+            << " | " << triangles / seconds / 1e6 << " Mtri/s"
+            << " | ACMR " << AverageACMR(model) << std::endl;
+    }
+
+
+    // Keeps the page-touch loop from being optimized away
+    volatile unsigned int s_Checksum = 0;
+
+    // Startup cost of the cooked path: map + validate, then fault in every page the upload would
+    // read (one byte per 4 KiB page of each stream), versus copying out through LoadData
+    void MeasureCooked(const std::filesystem::path& path) {
+        const auto start = std::chrono::steady_clock::now();
+        Circe::CookedMesh cooked;
+        cooked.Open(path.string());
+        const auto opened = std::chrono::steady_clock::now();
+
+        unsigned int checksum = 0;
+        size_t triangles = 0;
+        for (size_t i = 0; i < cooked.GetMeshCount(); i++) {
+            const Circe::CookedMeshEntry& entry = cooked.GetEntry(i);
+            const auto* vertices = reinterpret_cast<const unsigned char*>(cooked.GetVertices(i));
+            const auto* indices = static_cast<const unsigned char*>(cooked.GetIndices(i));
+            for (size_t offset = 0; offset < entry.VertexCount * sizeof(Circe::Vertex); offset += 4096) {
+                checksum += vertices[offset];
+            }
+            for (size_t offset = 0; offset < static_cast<size_t>(entry.IndexCount) * entry.IndexSize; offset += 4096) {
+                checksum += indices[offset];
+            }
+            triangles += entry.IndexCount / 3;
+        }
+        const auto touched = std::chrono::steady_clock::now();
+        s_Checksum = checksum;
+        cooked.Close();
+
+        const auto copyStart = std::chrono::steady_clock::now();
+        const Circe::ModelData model = Circe::ModelLoader::LoadData(path.string());
+        const double copySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - copyStart).count();
+
+        const double openSeconds = std::chrono::duration<double>(opened - start).count();
+        const double touchSeconds = std::chrono::duration<double>(touched - start).count();
+        std::cout << path.filename().string() << " (mapped)"
+            << " | open " << openSeconds * 1000.0 << " ms"
+            << " | open+touch " << touchSeconds * 1000.0 << " ms"
+            << " | " << model.SourceBytes / (1024.0 * 1024.0) / touchSeconds << " MB/s"
+            << " | " << triangles / touchSeconds / 1e6 << " Mtri/s"
+            << " | copy out " << copySeconds * 1000.0 << " ms"
+            << " | ACMR " << AverageACMR(model) << std::endl;
+    }
+
+}
+
+// Usage: LoaderBenchmark [million triangles] [--keep]
+// Generates a grid as OBJ and GLB in the temp directory and times ModelLoader on both,
+// with and without index optimization, then cooks the optimized GLB and times the mapped path.
+int main(int argc, char** argv) {
+    double millions = 2.0;
+    bool keep = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--keep") == 0) {
+            keep = true;
+        } else {
+            millions = std::atof(argv[i]);
+        }
+    }
+
+    Circe::JobSystem::Initialize();
+
+    const Grid grid = MakeGrid(static_cast<size_t>(millions * 1e6));
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::filesystem::path obj = directory / "circe_loader_benchmark.obj";
+    const std::filesystem::path glb = directory / "circe_loader_benchmark.glb";
+    const std::filesystem::path cooked = directory / "circe_loader_benchmark.cmesh";
+    WriteObj(grid, obj);
+    WriteGlb(grid, glb);
+    std::cout << grid.Indices.size() / 3 << " triangles, " << Circe::JobSystem::GetThreadCount() << " threads" << std::endl;
+
+    int result = 0;
+    try {
+        for (const auto& path : { obj, glb }) {
+            Measure(path, false);
+            Measure(path, true);
+        }
+        Circe::CookedMesh::Write(Circe::ModelLoader::LoadData(glb.string()), cooked.string());
+        MeasureCooked(cooked);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        result = 1;
+    }
+
+    if (!keep) {
+        std::filesystem::remove(obj);
+        std::filesystem::remove(glb);
+        std::filesystem::remove(cooked);
+    }
+    Circe::JobSystem::Shutdown();
+    return result;
+}
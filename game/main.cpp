@@ -8,7 +8,10 @@
 #include <Scene/Entity.h>
 #include <Scene/Scene.h>
 
+#include <cctype>
+#include <cstdlib>
 #include <iostream>
+#include <string>
 
 namespace {
 
@@ -57,8 +60,22 @@ namespace {
 
 }
 
-int main() {
-    Circe::Engine engine(1280, 720, "Circe Engine");
+// Usage: Game [--headless [frames]]
+int main(int argc, char** argv) {
+    Circe::EngineSettings settings;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--headless") {
+            settings.Headless = true;
+            settings.FrameLimit = 300;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                settings.FrameLimit = static_cast<uint32_t>(std::atoi(argv[++i]));
+            }
+        }
+    }
+    // Edits to the shaders under assets/ show up without a restart
+    settings.HotReload = !settings.Headless;
+
+    Circe::Engine engine(1280, 720, "Circe Engine", settings);
     TriangleScene scene;
     
     // Create a camera and set it on the renderer
@@ -0,0 +1,200 @@
+#include <Core/Engine.h>
+#include <Renderer/Material.h>
+#include <Renderer/MaterialBlockPool.h>
+#include <Renderer/RenderState.h>
+#include <Renderer/Shader.h>
+#include <Renderer/ShaderLibrary.h>
+#include <Renderer/Texture.h>
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // Both programs sample a single texture; the draws are single points so the GL work per draw
+    // stays small next to the CPU cost of binding the material
+    const char* VertexSource = R"(#version 330 core
+out vec2 vTexCoord;
+void main() {
+    vTexCoord = vec2(0.5);
+    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+}
+)";
+
+    const char* UniformFragmentSource = R"(#version 330 core
+in vec2 vTexCoord;
+out vec4 FragColor;
+uniform sampler2D albedo;
+uniform vec4 color;
+void main() {
+    FragColor = texture(albedo, vTexCoord) * color;
+}
+)";
+
+    // The previous Material: textures in a map, units handed out in map order on every bind and
+    // written to the sampler uniforms, parameters set as plain uniforms
+    struct UniformMaterial {
+        struct Binding {
+            std::shared_ptr<Circe::Texture> texture;
+            Circe::UniformHandle sampler;
+        };
+
+        std::shared_ptr<Circe::Shader> shader;
+        std::map<std::string, Binding> textures;
+        Circe::UniformHandle colorUniform;
+        glm::vec4 color = glm::vec4(1.0f);
+
+        void Bind(Circe::RenderState& state) {
+            state.UseProgram(shader->GetID());
+            shader->SetVec4(colorUniform, color);
+            int unit = 0;
+            for (const auto& [name, binding] : textures) {
+                state.BindTexture(unit, binding.texture->GetID());
+                shader->SetInt(binding.sampler, unit);
+                unit++;
+            }
+        }
+    };
+
+    struct Timing {
+        double NsPerDraw = 0.0;
+        Circe::RenderStats Stats;
+    };
+
+    template<typename BindFunction>
+    Timing Measure(size_t materials, int frames, GLuint vertexArray, BindFunction&& bind) {
+        Circe::RenderState state;
+        double total = 0.0;
+        for (int frame = 0; frame < frames; frame++) {
+            state.Reset();
+            state.ResetStats();
+            const auto start = std::chrono::steady_clock::now();
+            state.BindVertexArray(vertexArray);
+            for (size_t i = 0; i < materials; i++) {
+                bind(i, state);
+                glDrawArrays(GL_POINTS, 0, 1);
+                state.CountDrawCall();
+            }
+            total += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            // Keep the driver's queue from growing across frames, outside the timed part
+            glFinish();
+        }
+        return { total / (static_cast<double>(frames) * materials), state.GetStats() };
+    }
+
+    void Report(const char* label, const Timing& timing, double baseline) {
+        std::cout << label << " | " << timing.NsPerDraw << " ns/draw"
+            << " | programs " << timing.Stats.ProgramBinds
+            << ", textures " << timing.Stats.TextureBinds
+            << ", blocks " << timing.Stats.UniformBlockBinds;
+        if (baseline > 0.0) {
+            std::cout << " | " << baseline / timing.NsPerDraw << "x";
+        }
+        std::cout << std::endl;
+    }
+
+}
+
+// Usage: MaterialBindBenchmark [shader directory] [--materials N] [--frames N] [--bindless]
+// Draws one point per material, every material with its own texture and color, and times the
+// CPU side of binding: the previous uniform-based Material against parameter blocks with the
+// texture slot table (and bindless handles when --bindless is given and supported).
+int main(int argc, char** argv) {
+    std::string directory = "../../assets/shaders";
+    size_t materialCount = 4096;
+    int frames = 60;
+    bool bindless = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--materials" && i + 1 < argc) {
+            materialCount = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--frames" && i + 1 < argc) {
+            frames = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--bindless") {
+            bindless = true;
+        } else {
+            directory = arg;
+        }
+    }
+
+    Circe::EngineSettings settings;
+    settings.Headless = true;
+    settings.BindlessTextures = bindless;
+    Circe::Engine engine(64, 64, "Circe Material Bind Benchmark", settings);
+
+    int result = 0;
+    try {
+        std::vector<std::shared_ptr<Circe::Texture>> textures;
+        for (size_t i = 0; i < materialCount; i++) {
+            const unsigned char value = static_cast<unsigned char>(i);
+            std::vector<unsigned char> pixels(4 * 4 * 4);
+            for (size_t p = 0; p < pixels.size(); p += 4) {
+                pixels[p] = value;
+                pixels[p + 1] = static_cast<unsigned char>(255 - value);
+                pixels[p + 2] = 128;
+                pixels[p + 3] = 255;
+            }
+            textures.push_back(std::make_shared<Circe::Texture>(4, 4, pixels.data()));
+        }
+
+        auto uniformShader = std::make_shared<Circe::Shader>(Circe::ShaderSources{ VertexSource, UniformFragmentSource });
+        std::vector<UniformMaterial> uniformMaterials(materialCount);
+        for (size_t i = 0; i < materialCount; i++) {
+            UniformMaterial& material = uniformMaterials[i];
+            material.shader = uniformShader;
+            material.colorUniform = uniformShader->GetUniform("color");
+            material.color = glm::vec4(static_cast<float>(i % 7) / 7.0f, 0.5f, 1.0f, 1.0f);
+            material.textures["albedo"] = { textures[i], uniformShader->GetUniform("albedo") };
+        }
+
+        std::vector<std::string> defines = Circe::ShaderLibrary::GetGlobalDefines();
+        defines.push_back("HAS_ALBEDO");
+        const std::string blockFragment = Circe::ShaderLibrary::InjectDefines(
+            Circe::ShaderLibrary::Preprocess(directory + "/standard.frag"), defines);
+        auto blockShader = std::make_shared<Circe::Shader>(Circe::ShaderSources{ VertexSource, blockFragment });
+        std::vector<std::unique_ptr<Circe::Material>> blockMaterials;
+        for (size_t i = 0; i < materialCount; i++) {
+            auto material = std::make_unique<Circe::Material>(blockShader);
+            material->SetColor(glm::vec4(static_cast<float>(i % 7) / 7.0f, 0.5f, 1.0f, 1.0f));
+            material->SetTexture("albedo", textures[i]);
+            blockMaterials.push_back(std::move(material));
+        }
+
+        GLuint vertexArray = 0;
+        glGenVertexArrays(1, &vertexArray);
+
+        std::cout << materialCount << " materials, " << frames << " frames"
+            << " | bindless: " << (blockMaterials.front()->UsesBindlessTextures() ? "yes" : "no") << std::endl;
+
+        const Timing uniform = Measure(materialCount, frames, vertexArray,
+            [&](size_t i, Circe::RenderState& state) { uniformMaterials[i].Bind(state); });
+        const Timing block = Measure(materialCount, frames, vertexArray,
+            [&](size_t i, Circe::RenderState& state) { blockMaterials[i]->Bind(state); });
+
+        Report("uniforms", uniform, 0.0);
+        Report("blocks  ", block, uniform.NsPerDraw);
+
+        const Circe::MaterialBlockPoolStats pool = Circe::MaterialBlockPool::GetStats();
+        std::cout << "pool     | " << pool.Pages << " pages, " << pool.Slots << " slots, "
+            << pool.BytesUsed << " bytes, " << pool.Uploads << " uploads" << std::endl;
+
+        // Unchanged blocks must not be uploaded again after the first bind
+        if (!blockMaterials.front()->UsesParameterBlock() || pool.Uploads != materialCount) {
+            std::cerr << "Material blocks were not uploaded exactly once" << std::endl;
+            result = 1;
+        }
+
+        glDeleteVertexArrays(1, &vertexArray);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        result = 1;
+    }
+    return result;
+}
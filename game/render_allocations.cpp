@@ -0,0 +1,261 @@
+#include <Core/Engine.h>
+#include <Renderer/Camera.h>
+#include <Renderer/Material.h>
+#include <Renderer/Mesh.h>
+#include <Renderer/Model.h>
+#include <Renderer/Renderer.h>
+#include <Renderer/Shader.h>
+#include <Scene/Entity.h>
+#include <Scene/Scene.h>
+
+#include "CheckHarness.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Every C++ heap allocation in the process goes through here and is counted
+namespace {
+    std::atomic<uint64_t> s_Allocations{ 0 };
+}
+
+void* operator new(size_t size) {
+    s_Allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    s_Allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+// Over-aligned types (CommandBucket is alignas(64)) come through the align_val_t overloads
+namespace {
+    void* AlignedAllocate(size_t size, std::align_val_t alignment) noexcept {
+        const size_t align = static_cast<size_t>(alignment);
+        // aligned_alloc wants a size that is a multiple of the alignment
+        size = (std::max<size_t>(size, 1) + align - 1) & ~(align - 1);
+#ifdef _WIN32
+        return _aligned_malloc(size, align);
+#else
+        return std::aligned_alloc(align, size);
+#endif
+    }
+
+    void AlignedFree(void* pointer) noexcept {
+#ifdef _WIN32
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    s_Allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = AlignedAllocate(size, alignment)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    s_Allocations.fetch_add(1, std::memory_order_relaxed);
+    return AlignedAllocate(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept {
+    return operator new(size, alignment, tag);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { AlignedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { AlignedFree(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { AlignedFree(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { AlignedFree(pointer); }
+
+namespace {
+
+    // Registry renderables (the parallel command path), hierarchy children and object
+    // entities with models, all moving every frame. Counts heap allocations per frame
+    // once the warm-up frames have sized the frame arenas and queues. The arenas take their
+    // blocks with malloc, which operator new never sees, so their own counters are tracked too.
+    class AllocationScene : public Circe::Scene {
+    public:
+        AllocationScene(Circe::Renderer& renderer, int count, uint32_t warmupFrames)
+            : m_Renderer(renderer), m_Count(count), m_WarmupFrames(warmupFrames) {
+            std::vector<Circe::Vertex> vertices = {
+                { { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } },
+                { {  0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f } },
+                { {  0.0f,  0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.5f, 1.0f } }
+            };
+            std::vector<unsigned int> indices = { 0, 1, 2 };
+            m_Mesh = std::make_shared<Circe::Mesh>(vertices, indices);
+
+            // One instanced and one per-draw material so both Flush paths run
+            auto instanced = std::make_shared<Circe::Shader>("../../assets/shaders/instanced.vert", "../../assets/shaders/triangle.frag");
+            auto plain = std::make_shared<Circe::Shader>("../../assets/shaders/triangle.vert", "../../assets/shaders/triangle.frag");
+            m_Materials[0] = std::make_shared<Circe::Material>(instanced);
+            m_Materials[1] = std::make_shared<Circe::Material>(plain);
+            m_Model = std::make_shared<Circe::Model>(m_Mesh, m_Materials[1]);
+        }
+
+        void OnInit() override {
+            const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(m_Count))));
+            Circe::EntityHandle parent;
+            for (int i = 0; i < m_Count; ++i) {
+                Circe::EntityHandle entity = CreateEntity("Prop" + std::to_string(i));
+                m_Registry.Get<Circe::Transform>(entity).Position = glm::vec3(i % side - side * 0.5f, i / side - side * 0.5f, 0.0f);
+                m_Registry.Emplace<Circe::RenderableComponent>(entity, m_Mesh, m_Materials[i % 7 == 0 ? 1 : 0]);
+                // Every 16th entity hangs off the previous one, the rest render from their Transform
+                if (i % 16 == 15) {
+                    SetParent(entity, parent);
+                }
+                parent = entity;
+            }
+            for (int i = 0; i < 32; ++i) {
+                auto entity = std::make_unique<Circe::Entity>("Object" + std::to_string(i));
+                entity->SetModel(m_Model);
+                entity->GetTransform().Position = glm::vec3(i - 16.0f, -side * 0.5f - 2.0f, 0.0f);
+                AddEntity(std::move(entity));
+            }
+            AddSystem([](Circe::Registry& registry, float deltaTime) {
+                registry.Each<Circe::Transform>([deltaTime](Circe::EntityHandle, Circe::Transform& transform) {
+                    transform.Rotation = glm::quat(glm::vec3(0.0f, 0.0f, deltaTime)) * transform.Rotation;
+                });
+            });
+        }
+
+        // A whole frame lies between two updates: update, render, flush, present and swap
+        // The frame arena and the command buckets belong to the recording thread, which runs
+        // this in both modes.
+        void OnUpdate(float deltaTime) override {
+            const uint64_t allocations = s_Allocations.load(std::memory_order_relaxed);
+            const uint64_t arenaBlocks = m_Renderer.GetFrameAllocator().GetHeapAllocations();
+            const uint64_t bucketBlocks = m_Renderer.GetCommandBucketHeapAllocations();
+            if (m_Frame > m_WarmupFrames) {
+                const uint64_t frameAllocations = allocations - m_LastAllocations;
+                m_MaxAllocations = std::max(m_MaxAllocations, frameAllocations);
+                m_TotalAllocations += frameAllocations;
+                m_ArenaBlocks += arenaBlocks - m_LastArenaBlocks;
+                m_BucketBlocks += bucketBlocks - m_LastBucketBlocks;
+                m_MeasuredFrames++;
+            }
+            m_LastAllocations = allocations;
+            m_LastArenaBlocks = arenaBlocks;
+            m_LastBucketBlocks = bucketBlocks;
+            m_Frame++;
+        }
+
+        uint64_t GetMaxAllocations() const { return m_MaxAllocations; }
+        uint64_t GetTotalAllocations() const { return m_TotalAllocations; }
+        // Heap blocks the frame arena and the command buckets took after the warm-up
+        uint64_t GetArenaBlocks() const { return m_ArenaBlocks; }
+        uint64_t GetBucketBlocks() const { return m_BucketBlocks; }
+        uint32_t GetMeasuredFrames() const { return m_MeasuredFrames; }
+
+    private:
+        Circe::Renderer& m_Renderer;
+        int m_Count;
+        uint32_t m_WarmupFrames;
+        uint32_t m_Frame = 0;
+        uint32_t m_MeasuredFrames = 0;
+        uint64_t m_LastAllocations = 0;
+        uint64_t m_MaxAllocations = 0;
+        uint64_t m_TotalAllocations = 0;
+        uint64_t m_LastArenaBlocks = 0;
+        uint64_t m_LastBucketBlocks = 0;
+        uint64_t m_ArenaBlocks = 0;
+        uint64_t m_BucketBlocks = 0;
+        std::shared_ptr<Circe::Mesh> m_Mesh;
+        std::shared_ptr<Circe::Material> m_Materials[2];
+        std::shared_ptr<Circe::Model> m_Model;
+    };
+
+    // Renders one headless pass, serial or pipelined, and reports whether its steady-state
+    // frames stayed off the heap
+    bool RunPass(int count, uint32_t frames, uint32_t warmupFrames, bool pipelined) {
+        Circe::EngineSettings settings;
+        settings.Headless = true;
+        settings.VSync = false;
+        settings.FrameLimit = frames + warmupFrames;
+        settings.ShaderCacheDirectory.clear();
+        settings.Pipelined = pipelined;
+
+        Circe::Engine engine(1280, 720, "Circe Render Allocations", settings);
+        Circe::Renderer& renderer = *engine.GetRenderer();
+        AllocationScene scene(renderer, count, warmupFrames);
+
+        auto camera = std::make_shared<Circe::Camera>(45.0f, 1280.0f / 720.0f, 0.1f, 1000.0f);
+        camera->SetPosition(glm::vec3(0.0f, 0.0f, std::sqrt(static_cast<float>(count)) * 1.2f + 3.0f));
+        renderer.SetCamera(camera);
+
+        engine.SetScene(&scene);
+        engine.Run();
+
+        const Circe::FrameAllocator& frameAllocator = renderer.GetFrameAllocator();
+        std::cout << (pipelined ? "pipelined | " : "serial    | ")
+            << count << " entities | "
+            << renderer.GetStats().DrawCalls << " draw calls | "
+            << scene.GetMeasuredFrames() << " frames measured | "
+            << scene.GetTotalAllocations() << " allocations (max " << scene.GetMaxAllocations() << " in a frame) | "
+            << "frame arena " << frameAllocator.GetUsed() / 1024 << " of " << frameAllocator.GetCapacity() / 1024 << " KiB, "
+            << frameAllocator.GetHeapAllocations() << " heap blocks ("
+            << scene.GetArenaBlocks() << " after warm-up) | "
+            << renderer.GetCommandBucketHeapAllocations() << " bucket blocks ("
+            << scene.GetBucketBlocks() << " after warm-up)" << std::endl;
+
+        return scene.GetMeasuredFrames() > 0 && scene.GetTotalAllocations() == 0
+            && scene.GetArenaBlocks() == 0 && scene.GetBucketBlocks() == 0;
+    }
+
+}
+
+// Usage: RenderAllocations [entity count] [frames]
+// Renders headless, serial and then pipelined, and fails when any frame after the warm-up
+// allocates: through operator new (aligned included) or a frame arena or command bucket
+// taking a heap block. Driver-internal malloc calls are not seen.
+int main(int argc, char** argv) {
+    int count = 10000;
+    uint32_t frames = 240;
+    if (argc > 1) {
+        count = std::atoi(argv[1]);
+    }
+    if (argc > 2) {
+        frames = static_cast<uint32_t>(std::atoi(argv[2]));
+    }
+    const uint32_t warmupFrames = 8;
+
+    for (bool pipelined : { false, true }) {
+        CheckHarness::Check(std::string(pipelined ? "pipelined" : "serial") + " steady-state frames do not allocate",
+            RunPass(count, frames, warmupFrames, pipelined));
+    }
+    return CheckHarness::Finish();
+}
@@ -0,0 +1,135 @@
+#include <Core/Engine.h>
+#include <Renderer/Camera.h>
+#include <Renderer/Material.h>
+#include <Renderer/Mesh.h>
+#include <Renderer/Renderer.h>
+#include <Renderer/Shader.h>
+#include <Renderer/Texture.h>
+#include <Scene/Scene.h>
+
+#include "CheckHarness.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+    constexpr int ShaderCount = 3;
+    constexpr int MaterialsPerShader = 2;
+    constexpr int MeshCount = 3;
+    constexpr int TextureCount = 2;
+
+    void CheckAtMost(const std::string& name, uint32_t actual, uint32_t bound) {
+        CheckHarness::Check(name, actual <= bound, std::to_string(actual) + " (at most " + std::to_string(bound) + ")");
+    }
+
+    // Entities cycle through every material and mesh in an order that changes state on
+    // each submission, so only the sorted, state-tracked flush keeps the binds low
+    class StateScene : public Circe::Scene {
+    public:
+        explicit StateScene(int count)
+            : m_Count(count) {
+        }
+
+        void OnInit() override {
+            const std::vector<Circe::Vertex> triangle = {
+                { { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } },
+                { {  0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f } },
+                { {  0.0f,  0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.5f, 1.0f } }
+            };
+            const std::vector<Circe::Vertex> quad = {
+                { { -0.4f, -0.4f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } },
+                { {  0.4f, -0.4f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f } },
+                { {  0.4f,  0.4f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f } },
+                { { -0.4f,  0.4f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f } }
+            };
+            m_Meshes.push_back(std::make_shared<Circe::Mesh>(triangle, std::vector<unsigned int>{ 0, 1, 2 }));
+            m_Meshes.push_back(std::make_shared<Circe::Mesh>(quad, std::vector<unsigned int>{ 0, 1, 2, 2, 3, 0 }));
+            m_Meshes.push_back(std::make_shared<Circe::Mesh>(quad, std::vector<unsigned int>{ 0, 1, 3 }));
+
+            // Plain per-draw, textured per-draw and instanced programs
+            const std::shared_ptr<Circe::Shader> shaders[ShaderCount] = {
+                std::make_shared<Circe::Shader>("../../assets/shaders/triangle.vert", "../../assets/shaders/triangle.frag"),
+                std::make_shared<Circe::Shader>("../../assets/shaders/textured.vert", "../../assets/shaders/textured.frag"),
+                std::make_shared<Circe::Shader>("../../assets/shaders/instanced.vert", "../../assets/shaders/triangle.frag")
+            };
+            std::shared_ptr<Circe::Texture> textures[TextureCount];
+            for (int i = 0; i < TextureCount; ++i) {
+                const unsigned char pixels[16] = {
+                    255, static_cast<unsigned char>(i * 255), 0, 255, 0, 255, 0, 255,
+                    0, 0, 255, 255, 255, 255, 255, 255
+                };
+                textures[i] = std::make_shared<Circe::Texture>(2, 2, pixels);
+            }
+            for (int shader = 0; shader < ShaderCount; ++shader) {
+                for (int i = 0; i < MaterialsPerShader; ++i) {
+                    auto material = std::make_shared<Circe::Material>(shaders[shader]);
+                    material->SetColor(glm::vec4(0.5f + i * 0.5f, 0.5f, 1.0f, 1.0f));
+                    if (shader == 1) {
+                        material->SetTexture("albedo", textures[i]);
+                    }
+                    m_Materials.push_back(material);
+                }
+            }
+
+            const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(m_Count))));
+            for (int i = 0; i < m_Count; ++i) {
+                Circe::EntityHandle entity = CreateEntity();
+                m_Registry.Get<Circe::Transform>(entity).Position = glm::vec3(i % side - side * 0.5f, i / side - side * 0.5f, 0.0f);
+                m_Registry.Emplace<Circe::RenderableComponent>(entity, m_Meshes[(i / m_Materials.size()) % MeshCount], m_Materials[i % m_Materials.size()]);
+            }
+        }
+
+    private:
+        int m_Count;
+        std::vector<std::shared_ptr<Circe::Mesh>> m_Meshes;
+        std::vector<std::shared_ptr<Circe::Material>> m_Materials;
+    };
+
+}
+
+// Usage: RenderStateCheck [entity count]
+// Renders a few headless frames of many entities over several shaders, materials and
+// meshes and checks that program, texture and VAO binds follow the number of distinct
+// states rather than the number of draws.
+int main(int argc, char** argv) {
+    const int count = argc > 1 ? std::atoi(argv[1]) : 3000;
+
+    Circe::EngineSettings settings;
+    settings.Headless = true;
+    settings.VSync = false;
+    settings.FrameLimit = 4;
+    settings.ShaderCacheDirectory.clear();
+
+    Circe::Engine engine(1280, 720, "Circe Render State Check", settings);
+    StateScene scene(count);
+
+    auto camera = std::make_shared<Circe::Camera>(45.0f, 1280.0f / 720.0f, 0.1f, 1000.0f);
+    camera->SetPosition(glm::vec3(0.0f, 0.0f, std::sqrt(static_cast<float>(count)) * 1.5f + 3.0f));
+    engine.GetRenderer()->SetCamera(camera);
+
+    engine.SetScene(&scene);
+    engine.Run();
+
+    const Circe::RenderStats& stats = engine.GetRenderer()->GetStats();
+    const uint32_t materialCount = ShaderCount * MaterialsPerShader;
+    std::cout << count << " entities | " << stats.Visible << " visible | " << stats.DrawCalls << " draw calls, "
+        << stats.Instances << " instances" << std::endl;
+
+    CheckAtMost("program binds", stats.ProgramBinds, ShaderCount);
+    CheckAtMost("texture binds", stats.TextureBinds, TextureCount);
+    // One VAO per (material, mesh) run, plus the unbind at the end of the flush
+    CheckAtMost("vertex array binds", stats.VertexArrayBinds, materialCount * MeshCount + 1);
+    // Every visible entity is drawn, the per-draw programs once each and the instanced
+    // one batched per (material, mesh)
+    const uint32_t perDraw = static_cast<uint32_t>(stats.Visible) * (ShaderCount - 1) / ShaderCount;
+    const bool drew = stats.Visible == static_cast<uint32_t>(count) && stats.Instances == stats.Visible && stats.DrawCalls >= perDraw;
+    CheckHarness::Check("every entity drawn", drew, std::to_string(stats.DrawCalls) + " draws for " +
+        std::to_string(stats.ProgramBinds + stats.TextureBinds + stats.VertexArrayBinds) + " state changes");
+
+    return CheckHarness::Finish();
+}
@@ -0,0 +1,128 @@
+#include <Core/Engine.h>
+#include <Renderer/Shader.h>
+#include <Renderer/ShaderCache.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using ProgramList = std::vector<std::pair<std::string, std::string>>;
+
+    // Every X.vert with X.frag; vertex shaders without their own fragment shader use
+    // triangle.frag, as the instancing benchmark does
+    ProgramList FindPrograms(const std::filesystem::path& directory) {
+        ProgramList programs;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            if (entry.path().extension() != ".vert") {
+                continue;
+            }
+            std::filesystem::path fragment = entry.path();
+            fragment.replace_extension(".frag");
+            if (!std::filesystem::exists(fragment)) {
+                fragment = directory / "triangle.frag";
+            }
+            programs.emplace_back(entry.path().string(), fragment.string());
+        }
+        std::sort(programs.begin(), programs.end());
+        return programs;
+    }
+
+    double LoadAll(const ProgramList& programs) {
+        std::vector<std::unique_ptr<Circe::Shader>> shaders;
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto& [vertex, fragment] : programs) {
+            shaders.push_back(std::make_unique<Circe::Shader>(vertex, fragment));
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void Report(const char* label, double milliseconds, size_t count) {
+        const Circe::ShaderCacheStats stats = Circe::ShaderCache::GetStats();
+        std::cout << label << " | " << milliseconds << " ms for " << count << " programs"
+            << " | " << milliseconds / count << " ms each"
+            << " | hits " << stats.Hits << ", misses " << stats.Misses
+            << ", rejected " << stats.Rejected << ", stored " << stats.Stores << std::endl;
+        Circe::ShaderCache::ResetStats();
+    }
+
+    void SetEnvironment(const char* name, const char* value) {
+#ifdef _WIN32
+        _putenv_s(name, value);
+#else
+        setenv(name, value, 1);
+#endif
+    }
+
+}
+
+// Usage: ShaderCacheBenchmark [shader directory] [--runs N] [--driver-cache]
+// Loads the full shader set cold (empty cache: compile, link and store), warm (restored from
+// program binaries) and with the cache disabled. The driver's own disk caches are turned off
+// for the run unless --driver-cache is given, so "cold" really compiles.
+int main(int argc, char** argv) {
+    std::string directory = "../../assets/shaders";
+    int runs = 5;
+    bool driverCache = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc) {
+            runs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--driver-cache") {
+            driverCache = true;
+        } else {
+            directory = arg;
+        }
+    }
+
+    if (!driverCache) {
+        SetEnvironment("MESA_SHADER_CACHE_DISABLE", "true");
+        SetEnvironment("__GL_SHADER_DISK_CACHE", "0");
+    }
+
+    Circe::EngineSettings settings;
+    settings.Headless = true;
+    settings.ShaderCacheDirectory = (std::filesystem::temp_directory_path() / "circe_shader_cache_benchmark").string();
+    Circe::Engine engine(64, 64, "Circe Shader Cache Benchmark", settings);
+
+    if (!Circe::ShaderCache::IsEnabled()) {
+        std::cerr << "Program binaries are not supported by this driver" << std::endl;
+        return 1;
+    }
+
+    const ProgramList programs = FindPrograms(directory);
+    if (programs.empty()) {
+        std::cerr << "No shaders found in " << directory << std::endl;
+        return 1;
+    }
+
+    int result = 0;
+    try {
+        Circe::ShaderCache::Clear();
+        Circe::ShaderCache::ResetStats();
+        Report("cold ", LoadAll(programs), programs.size());
+
+        double warm = 0.0;
+        for (int run = 0; run < runs; run++) {
+            warm += LoadAll(programs);
+        }
+        const Circe::ShaderCacheStats stats = Circe::ShaderCache::GetStats();
+        Report("warm ", warm / runs, programs.size());
+        result = stats.Hits == programs.size() * runs ? 0 : 1;
+
+        // Same process, no program binaries: what the driver's in-memory caching alone gives
+        Circe::ShaderCache::Initialize("");
+        Report("nocache", LoadAll(programs), programs.size());
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        result = 1;
+    }
+    return result;
+}
@@ -0,0 +1,133 @@
+#include <Core/Engine.h>
+#include <Renderer/Shader.h>
+#include <Renderer/ShaderLibrary.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+    const std::vector<std::string> Features = { "INSTANCED", "HAS_ALBEDO", "ALPHA_TEST", "SKINNED" };
+
+    // Every permutation of the feature list, plus a define unique to the pass so the driver's
+    // in-memory cache cannot answer for sources it already compiled in an earlier pass
+    std::vector<Circe::ShaderSources> BuildPermutations(const Circe::ShaderSources& base, int pass) {
+        std::vector<Circe::ShaderSources> permutations;
+        for (uint32_t mask = 0; mask < (1u << Features.size()); mask++) {
+            std::vector<std::string> defines = { "BENCHMARK_PASS_" + std::to_string(pass) };
+            for (size_t i = 0; i < Features.size(); i++) {
+                if (mask & (1u << i)) {
+                    defines.push_back(Features[i]);
+                }
+            }
+            permutations.push_back({
+                Circe::ShaderLibrary::InjectDefines(base.Vertex, defines),
+                Circe::ShaderLibrary::InjectDefines(base.Fragment, defines) });
+        }
+        return permutations;
+    }
+
+    double Sequential(const std::vector<Circe::ShaderSources>& permutations) {
+        std::vector<std::unique_ptr<Circe::Shader>> shaders;
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto& sources : permutations) {
+            shaders.push_back(std::make_unique<Circe::Shader>(sources));
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double Batched(const std::vector<Circe::ShaderSources>& permutations) {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::shared_ptr<Circe::Shader>> shaders = Circe::ShaderLibrary::Compile(permutations);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+}
+
+// Usage: ShaderVariantBenchmark [shader directory] [--runs N]
+// Compiles every permutation of standard.vert/frag one program at a time, then as a single
+// batch through ShaderLibrary (parallel when the driver has GL_KHR_parallel_shader_compile),
+// with program binaries and the driver's disk cache disabled. Also reports how many programs
+// the variant set deduplicates for a feature the sources never use.
+int main(int argc, char** argv) {
+    std::string directory = "../../assets/shaders";
+    int runs = 3;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc) {
+            runs = std::max(1, std::atoi(argv[++i]));
+        } else {
+            directory = arg;
+        }
+    }
+
+#ifdef _WIN32
+    _putenv_s("MESA_SHADER_CACHE_DISABLE", "true");
+    _putenv_s("__GL_SHADER_DISK_CACHE", "0");
+#else
+    setenv("MESA_SHADER_CACHE_DISABLE", "true", 1);
+    setenv("__GL_SHADER_DISK_CACHE", "0", 1);
+#endif
+
+    Circe::EngineSettings settings;
+    settings.Headless = true;
+    settings.ShaderCacheDirectory = "";
+    Circe::Engine engine(64, 64, "Circe Shader Variant Benchmark", settings);
+
+    int result = 0;
+    try {
+        const std::string vertexPath = directory + "/standard.vert";
+        const std::string fragmentPath = directory + "/standard.frag";
+        const Circe::ShaderSources base = {
+            Circe::ShaderLibrary::Preprocess(vertexPath),
+            Circe::ShaderLibrary::Preprocess(fragmentPath) };
+
+        std::cout << "parallel compile: " << (Circe::ShaderLibrary::SupportsParallelCompile() ? "yes" : "no") << std::endl;
+
+        double sequential = 0.0;
+        double batched = 0.0;
+        size_t count = 0;
+        for (int run = 0; run < runs; run++) {
+            const auto first = BuildPermutations(base, run * 2);
+            const auto second = BuildPermutations(base, run * 2 + 1);
+            sequential += Sequential(first);
+            batched += Batched(second);
+            count = first.size();
+        }
+        sequential /= runs;
+        batched /= runs;
+        std::cout << "sequential | " << sequential << " ms for " << count << " programs" << std::endl;
+        std::cout << "batched    | " << batched << " ms for " << count << " programs"
+            << " | " << sequential / batched << "x" << std::endl;
+
+        // SKINNED is not referenced by the sources, so half of the masks collapse onto the other half
+        Circe::ShaderLibrary::ResetStats();
+        auto variants = Circe::ShaderLibrary::LoadVariants(vertexPath, fragmentPath, Features);
+        std::vector<uint32_t> masks;
+        for (uint32_t mask = 0; mask < (1u << Features.size()); mask++) {
+            masks.push_back(mask);
+        }
+        variants->Compile(masks);
+        // A second set without SKINNED produces byte-identical sources and reuses those programs
+        auto reduced = Circe::ShaderLibrary::LoadVariants(vertexPath, fragmentPath, { "INSTANCED", "HAS_ALBEDO", "ALPHA_TEST" });
+        reduced->CompileAll();
+        const Circe::ShaderLibraryStats stats = Circe::ShaderLibrary::GetStats();
+        std::cout << "variants   | " << masks.size() << " masks, " << variants->GetVariantCount() << " programs"
+            << " | requested " << stats.Requested << ", compiled " << stats.Compiled
+            << ", deduplicated " << stats.Deduplicated << std::endl;
+
+        if (variants->GetVariantCount() != (1u << (Features.size() - 1)) || stats.Deduplicated != reduced->GetVariantCount()) {
+            std::cerr << "Permutations were not deduplicated" << std::endl;
+            result = 1;
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        result = 1;
+    }
+    return result;
+}
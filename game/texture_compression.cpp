@@ -0,0 +1,226 @@
+#include <Core/Jobs/JobSystem.h>
+#include <Renderer/Ktx2.h>
+#include <Renderer/TextureCompression.h>
+#include <stb_image.h>
+
+#include "CheckHarness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    namespace Compression = Circe::TextureCompression;
+
+    // Smooth gradients, a few hard edges and some grain: roughly what photographs and painted
+    // albedo maps throw at a block encoder. Alpha is a radial falloff.
+    std::vector<unsigned char> MakeImage(int width, int height) {
+        std::mt19937 random(7);
+        std::normal_distribution<float> grain(0.0f, 6.0f);
+        std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 4);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                const float u = static_cast<float>(x) / width;
+                const float v = static_cast<float>(y) / height;
+                float color[3] = {
+                    255.0f * u,
+                    255.0f * (0.5f + 0.5f * std::sin(v * 9.0f + u * 3.0f)),
+                    255.0f * (1.0f - 0.6f * u * v)
+                };
+                if (((x / 37) + (y / 29)) % 5 == 0) {
+                    color[0] = 240.0f;
+                    color[1] = 40.0f;
+                    color[2] = 20.0f;
+                }
+                unsigned char* pixel = pixels.data() + (static_cast<size_t>(y) * width + x) * 4;
+                for (int c = 0; c < 3; c++) {
+                    pixel[c] = static_cast<unsigned char>(std::clamp(color[c] + grain(random), 0.0f, 255.0f));
+                }
+                const float distance = std::hypot(u - 0.5f, v - 0.5f);
+                pixel[3] = static_cast<unsigned char>(std::clamp(255.0f * (1.2f - distance * 2.0f), 0.0f, 255.0f));
+            }
+        }
+        return pixels;
+    }
+
+    double CheckFormat(Circe::TextureFormat format, const std::vector<unsigned char>& pixels, int width, int height, int channels, double minimumPsnr) {
+        const std::vector<unsigned char> blocks = Compression::Compress(pixels.data(), width, height, format);
+        const std::vector<unsigned char> decoded = Compression::Decompress(blocks.data(), width, height, format);
+        const double psnr = Compression::ComputePSNR(pixels.data(), decoded.data(), width, height, channels);
+        CheckHarness::Check(std::string(Compression::GetFormatName(format)) + " PSNR", psnr >= minimumPsnr,
+            std::to_string(psnr) + " dB over " + std::to_string(channels) + " channels (minimum " + std::to_string(minimumPsnr) + ")");
+        return psnr;
+    }
+
+    void CheckFlatBlocks() {
+        std::mt19937 random(11);
+        std::uniform_int_distribution<int> value(0, 255);
+        int bc1Error = 0;
+        int bc7Error = 0;
+        for (int i = 0; i < 256; i++) {
+            unsigned char texels[64];
+            const unsigned char color[4] = { (unsigned char)value(random), (unsigned char)value(random), (unsigned char)value(random), 255 };
+            for (int t = 0; t < 16; t++) {
+                std::memcpy(texels + t * 4, color, 4);
+            }
+            unsigned char block[16];
+            unsigned char decoded[64];
+            Compression::EncodeBC1Block(texels, block);
+            Compression::DecodeBlock(Circe::TextureFormat::BC1, block, decoded);
+            for (int c = 0; c < 3; c++) {
+                bc1Error = std::max(bc1Error, std::abs(decoded[c] - color[c]));
+            }
+            Compression::EncodeBC7Block(texels, block);
+            Compression::DecodeBlock(Circe::TextureFormat::BC7, block, decoded);
+            for (int c = 0; c < 4; c++) {
+                bc7Error = std::max(bc7Error, std::abs(decoded[c] - color[c]));
+            }
+        }
+        // 5:6:5 endpoints are at most half a step off; BC7 shares one low bit per endpoint
+        CheckHarness::Check("BC1 flat blocks", bc1Error <= 4, "max error " + std::to_string(bc1Error));
+        CheckHarness::Check("BC7 flat blocks", bc7Error <= 1, "max error " + std::to_string(bc7Error));
+    }
+
+    void CheckTransparency() {
+        unsigned char texels[64];
+        for (int t = 0; t < 16; t++) {
+            texels[t * 4 + 0] = static_cast<unsigned char>(t * 16);
+            texels[t * 4 + 1] = 100;
+            texels[t * 4 + 2] = 50;
+            texels[t * 4 + 3] = t % 3 == 0 ? 0 : 255;
+        }
+        unsigned char block[8];
+        unsigned char decoded[64];
+        Compression::EncodeBC1Block(texels, block);
+        Compression::DecodeBlock(Circe::TextureFormat::BC1, block, decoded);
+        bool matches = true;
+        for (int t = 0; t < 16; t++) {
+            matches &= (decoded[t * 4 + 3] == 0) == (texels[t * 4 + 3] == 0);
+        }
+        CheckHarness::Check("BC1 transparent texels", matches);
+    }
+
+    void CheckMips() {
+        // 0/255 checker: the first mip is 50% coverage, which is 188 in sRGB and 128 when linear.
+        // Sampled away from the border, where the Kaiser taps are clamped.
+        std::vector<unsigned char> checker(16 * 16 * 4);
+        for (int i = 0; i < 256; i++) {
+            const unsigned char value = ((i % 16) + (i / 16)) % 2 ? 255 : 0;
+            std::fill_n(checker.data() + i * 4, 3, value);
+            checker[i * 4 + 3] = 255;
+        }
+        for (Circe::MipFilter filter : { Circe::MipFilter::Box, Circe::MipFilter::Kaiser }) {
+            const char* name = filter == Circe::MipFilter::Box ? "box" : "kaiser";
+            const Circe::TextureImage srgb = Compression::GenerateMips(checker.data(), 16, 16, true, filter);
+            const Circe::TextureImage linear = Compression::GenerateMips(checker.data(), 16, 16, false, filter);
+            const size_t center = (4 * 8 + 4) * 4;
+            const int srgbValue = srgb.GetLevelData(1)[center];
+            const int linearValue = linear.GetLevelData(1)[center];
+            CheckHarness::Check(std::string("mips ") + name + " sRGB-correct", srgb.Levels.size() == 5 && std::abs(srgbValue - 188) <= 2 && std::abs(linearValue - 128) <= 2,
+                std::to_string(srgb.Levels.size()) + " levels, sRGB " + std::to_string(srgbValue) + ", linear " + std::to_string(linearValue));
+        }
+
+        const Circe::TextureImage odd = Compression::GenerateMips(checker.data(), 8, 3, true, Circe::MipFilter::Kaiser);
+        const bool shapes = odd.Levels.size() == 4 && odd.Levels[1].Width == 4 && odd.Levels[1].Height == 1 && odd.Levels[3].Width == 1;
+        CheckHarness::Check("mips non-square chain", shapes);
+    }
+
+    void CheckContainer(const std::vector<unsigned char>& pixels, int width, int height) {
+        const Circe::TextureImage mips = Compression::GenerateMips(pixels.data(), width, height, true, Circe::MipFilter::Kaiser);
+        const std::string path = (std::filesystem::temp_directory_path() / "circe_texture_compression.ktx2").string();
+        for (Circe::TextureFormat format : { Circe::TextureFormat::BC1, Circe::TextureFormat::BC7, Circe::TextureFormat::RGBA8 }) {
+            const Circe::TextureImage cooked = Compression::Compress(mips, format);
+            Circe::Ktx2::Write(cooked, path);
+            const Circe::TextureImage loaded = Circe::Ktx2::Read(path);
+            bool same = loaded.Format == cooked.Format && loaded.SRGB && loaded.Levels.size() == cooked.Levels.size() && loaded.Data == cooked.Data;
+            for (size_t i = 0; same && i < loaded.Levels.size(); i++) {
+                same = loaded.Levels[i].Width == cooked.Levels[i].Width && loaded.Levels[i].Height == cooked.Levels[i].Height;
+            }
+            CheckHarness::Check(std::string("KTX2 round trip ") + Compression::GetFormatName(format), same,
+                std::to_string(std::filesystem::file_size(path) / 1024) + " KiB, " + std::to_string(loaded.Levels.size()) + " levels");
+        }
+        std::filesystem::remove(path);
+    }
+
+    // Worker threads split the block rows; the output must not depend on how many there are
+    void CheckThreading(const std::vector<unsigned char>& pixels, int width, int height) {
+        for (Circe::TextureFormat format : { Circe::TextureFormat::BC1, Circe::TextureFormat::BC7 }) {
+            auto start = std::chrono::steady_clock::now();
+            const std::vector<unsigned char> serial = Compression::Compress(pixels.data(), width, height, format);
+            const double serialMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            // At least four workers so the rows really are split on small machines
+            Circe::JobSystem::Initialize(std::max(4u, std::thread::hardware_concurrency()));
+            start = std::chrono::steady_clock::now();
+            const std::vector<unsigned char> parallel = Compression::Compress(pixels.data(), width, height, format);
+            const double parallelMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            const unsigned int threads = Circe::JobSystem::GetThreadCount();
+            Circe::JobSystem::Shutdown();
+
+            const double megapixels = static_cast<double>(width) * height / 1e6;
+            CheckHarness::Check(std::string(Compression::GetFormatName(format)) + " threaded output", serial == parallel,
+                std::to_string(megapixels / serialMs * 1000.0) + " MP/s on 1 thread, " +
+                std::to_string(megapixels / parallelMs * 1000.0) + " MP/s on " + std::to_string(threads));
+        }
+    }
+
+    void ReportFile(const std::string& path) {
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        std::unique_ptr<unsigned char, void (*)(void*)> pixels(stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha), stbi_image_free);
+        if (!pixels) {
+            CheckHarness::Check(path, false, "failed to load");
+            return;
+        }
+        const std::vector<unsigned char> source(pixels.get(), pixels.get() + static_cast<size_t>(width) * height * 4);
+        std::cout << path << " (" << width << "x" << height << ")" << std::endl;
+        CheckFormat(Circe::TextureFormat::BC1, source, width, height, 3, 0.0);
+        CheckFormat(Circe::TextureFormat::BC3, source, width, height, 4, 0.0);
+        CheckFormat(Circe::TextureFormat::BC7, source, width, height, 4, 0.0);
+    }
+
+}
+
+// Usage: TextureCompression [image...]
+// Checks the BCn encoders against PSNR floors on a synthetic image, the sRGB-correct mip
+// filters and the KTX2 container, and reports encode throughput. Images given on the
+// command line are encoded too and their PSNR reported.
+int main(int argc, char** argv) {
+    const int width = 512;
+    const int height = 512;
+    const std::vector<unsigned char> pixels = MakeImage(width, height);
+
+    // BC1 punches out texels below half alpha, so measure its color on an opaque copy
+    std::vector<unsigned char> opaque = pixels;
+    for (size_t i = 3; i < opaque.size(); i += 4) {
+        opaque[i] = 255;
+    }
+    CheckFormat(Circe::TextureFormat::BC1, opaque, width, height, 3, 32.0);
+    CheckFormat(Circe::TextureFormat::BC3, pixels, width, height, 4, 34.0);
+    CheckFormat(Circe::TextureFormat::BC5, pixels, width, height, 2, 36.0);
+    CheckFormat(Circe::TextureFormat::BC7, pixels, width, height, 4, 36.0);
+    CheckFlatBlocks();
+    CheckTransparency();
+    CheckMips();
+    CheckContainer(pixels, width, height);
+    CheckThreading(pixels, width, height);
+
+    Circe::JobSystem::Initialize();
+    for (int i = 1; i < argc; i++) {
+        ReportFile(argv[i]);
+    }
+    Circe::JobSystem::Shutdown();
+
+    return CheckHarness::Finish();
+}
@@ -0,0 +1,166 @@
+#include <Core/Engine.h>
+#include <Core/Time.h>
+#include <Renderer/Camera.h>
+#include <Renderer/Material.h>
+#include <Renderer/Mesh.h>
+#include <Renderer/Model.h>
+#include <Renderer/Renderer.h>
+#include <Renderer/Shader.h>
+#include <Renderer/Texture.h>
+#include <Renderer/TextureLoader.h>
+#include <Ressources/TextureManager.h>
+#include <Scene/Entity.h>
+#include <Scene/Scene.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+namespace {
+
+    bool IsImage(const std::filesystem::path& path) {
+        std::string extension = path.extension().string();
+        for (char& c : extension) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return extension == ".png" || extension == ".jpg" || extension == ".jpeg"
+            || extension == ".tga" || extension == ".bmp" || extension == ".hdr";
+    }
+
+    // Requests every image of a directory at once and keeps rendering while they stream in.
+    // Loading must not block the frame: issuing the requests has to be quick and frames
+    // must keep coming while the queue drains.
+    class StreamingScene : public Circe::Scene {
+    public:
+        explicit StreamingScene(std::filesystem::path directory)
+            : m_Directory(std::move(directory)) {
+            std::vector<Circe::Vertex> vertices = {
+                { { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } },
+                { {  0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f } },
+                { {  0.5f,  0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f } },
+                { { -0.5f,  0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f } }
+            };
+            std::vector<unsigned int> indices = { 0, 1, 2, 2, 3, 0 };
+            m_Quad = std::make_shared<Circe::Mesh>(vertices, indices);
+
+            m_Shader = std::make_shared<Circe::Shader>(
+                "../../assets/shaders/textured.vert",
+                "../../assets/shaders/textured.frag"
+            );
+        }
+
+        void OnInit() override {
+            std::vector<std::filesystem::path> files;
+            for (const auto& entry : std::filesystem::directory_iterator(m_Directory)) {
+                if (entry.is_regular_file() && IsImage(entry.path())) {
+                    files.push_back(entry.path());
+                }
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            for (const auto& file : files) {
+                auto material = std::make_shared<Circe::Material>(m_Shader);
+                material->SetTexture("albedo", Circe::TextureManager::LoadAsync(file.string()));
+                m_Models.push_back(std::make_shared<Circe::Model>(m_Quad, material));
+            }
+            m_RequestMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            const int side = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<float>(m_Models.size())))));
+            for (size_t i = 0; i < m_Models.size(); ++i) {
+                auto entity = std::make_unique<Circe::Entity>("Image" + std::to_string(i));
+                entity->SetModel(m_Models[i]);
+                entity->GetTransform().Position = glm::vec3(
+                    (static_cast<int>(i) % side - side * 0.5f) * 1.1f,
+                    (static_cast<int>(i) / side - side * 0.5f) * 1.1f,
+                    0.0f);
+                AddEntity(std::move(entity));
+            }
+
+            std::cout << "Requested " << files.size() << " textures in " << m_RequestMs << " ms" << std::endl;
+        }
+
+        void OnRender(Circe::Renderer& renderer) override {
+            const Circe::TextureLoaderStats stats = Circe::TextureLoader::GetStats();
+            if (stats.QueueDepth > 0) {
+                m_FramesWhileLoading++;
+            }
+
+            m_Elapsed += Circe::Time::GetDeltaTime();
+            if (m_Elapsed < 1.0f) {
+                return;
+            }
+            std::cout << "queue " << stats.QueueDepth
+                << " | pending uploads " << stats.PendingUploads
+                << " | " << stats.BytesUploadedLastFrame / 1024 << " KiB last frame"
+                << " | loaded " << stats.Loaded << " failed " << stats.Failed << std::endl;
+            m_Elapsed = 0.0f;
+        }
+
+        size_t GetRequested() const { return m_Models.size(); }
+        double GetRequestMs() const { return m_RequestMs; }
+        uint32_t GetFramesWhileLoading() const { return m_FramesWhileLoading; }
+
+    private:
+        std::filesystem::path m_Directory;
+        std::shared_ptr<Circe::Mesh> m_Quad;
+        std::shared_ptr<Circe::Shader> m_Shader;
+        std::vector<std::shared_ptr<Circe::Model>> m_Models;
+        double m_RequestMs = 0.0;
+        uint32_t m_FramesWhileLoading = 0;
+        float m_Elapsed = 0.0f;
+    };
+
+}
+
+// Usage: TextureStreaming <image directory> [--budget MiB] [--headless [frames]]
+// Exits non-zero when issuing the loads blocked or not every image arrived.
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: TextureStreaming <image directory> [--budget MiB] [--headless [frames]]" << std::endl;
+        return 1;
+    }
+
+    Circe::EngineSettings settings;
+    settings.VSync = false;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--budget" && i + 1 < argc) {
+            Circe::TextureLoader::SetUploadBudget(static_cast<size_t>(std::atof(argv[++i]) * 1024 * 1024));
+        } else if (arg == "--headless") {
+            settings.Headless = true;
+            settings.FrameLimit = 600;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                settings.FrameLimit = static_cast<uint32_t>(std::atoi(argv[++i]));
+            }
+        }
+    }
+
+    Circe::Engine engine(1280, 720, "Circe Texture Streaming", settings);
+    StreamingScene scene(argv[1]);
+
+    auto camera = std::make_shared<Circe::Camera>(45.0f, 1280.0f / 720.0f, 0.1f, 1000.0f);
+    camera->SetPosition(glm::vec3(0.0f, 0.0f, 12.0f));
+    engine.GetRenderer()->SetCamera(camera);
+
+    engine.SetScene(&scene);
+    engine.Run();
+
+    const Circe::TextureLoaderStats stats = Circe::TextureLoader::GetStats();
+    std::cout << "Loaded " << stats.Loaded << "/" << scene.GetRequested()
+        << " (" << stats.Failed << " failed), " << stats.TotalBytesUploaded / (1024 * 1024) << " MiB uploaded, "
+        << scene.GetFramesWhileLoading() << " frames rendered while loading" << std::endl;
+
+    const Circe::TextureCacheStats cache = Circe::TextureManager::GetStats();
+    std::cout << "Cache: " << cache.ResidentCount << " textures, " << cache.ResidentBytes / (1024 * 1024) << " MiB resident, "
+        << cache.Hits << " hits, " << cache.Misses << " misses, " << cache.Evictions << " evictions" << std::endl;
+
+    // Requests only create 2x2 placeholders, anything slower means decoding ran inline
+    const bool nonBlocking = scene.GetRequestMs() < 1.0 + 0.1 * static_cast<double>(scene.GetRequested());
+    const bool complete = stats.Loaded + stats.Failed == scene.GetRequested();
+    return nonBlocking && complete ? 0 : 1;
+}
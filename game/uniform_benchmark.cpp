@@ -0,0 +1,127 @@
+#include <Core/Engine.h>
+#include <Renderer/Shader.h>
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+
+    // A handful of default-block uniforms of the kinds the renderer sets per draw
+    const char* VertexSource = R"(#version 330 core
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+void main() {
+    gl_Position = projection * view * model * vec4(0.0, 0.0, 0.0, 1.0);
+}
+)";
+
+    const char* FragmentSource = R"(#version 330 core
+out vec4 FragColor;
+uniform vec4 color;
+uniform float intensity;
+uniform int mode;
+void main() {
+    FragColor = color * (mode > 0 ? intensity : 1.0);
+}
+)";
+
+    const char* UniformNames[] = { "model", "view", "projection", "color", "intensity", "mode" };
+
+    // Nanoseconds per iteration of set, each iteration setting all six uniforms
+    template<typename SetFunction>
+    double Measure(int iterations, SetFunction&& set) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            set(static_cast<float>(i & 255));
+        }
+        const double total = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        glFinish();
+        return total / iterations;
+    }
+
+}
+
+// Usage: UniformBenchmark [iterations]
+// Times setting six uniforms per simulated draw three ways: glGetUniformLocation before every
+// glUniform* call, the name-based Shader setters (reflected table lookup) and handles resolved
+// once with GetUniform. Fails when a handle disagrees with the driver's location.
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200000;
+
+    Circe::EngineSettings settings;
+    settings.Headless = true;
+    settings.ShaderCacheDirectory.clear();
+    Circe::Engine engine(64, 64, "Circe Uniform Benchmark", settings);
+
+    int result = 0;
+    try {
+        Circe::Shader shader(Circe::ShaderSources{ VertexSource, FragmentSource });
+        shader.Use();
+        const GLuint program = shader.GetID();
+
+        for (const char* name : UniformNames) {
+            if (shader.GetUniform(name).Location != glGetUniformLocation(program, name)) {
+                std::cout << "[FAIL] handle for " << name << " does not match glGetUniformLocation" << std::endl;
+                result = 1;
+            }
+        }
+
+        const glm::mat4 view(1.0f);
+        const glm::mat4 projection(1.0f);
+        const glm::vec4 color(1.0f, 0.5f, 0.25f, 1.0f);
+
+        // Warm-up so the driver's first-use work stays out of the timings
+        for (int i = 0; i < 1000; i++) {
+            glUniform1f(glGetUniformLocation(program, "intensity"), 1.0f);
+        }
+
+        const double lookup = Measure(iterations, [&](float value) {
+            const glm::mat4 model(value);
+            glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, &model[0][0]);
+            glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, &view[0][0]);
+            glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, &projection[0][0]);
+            glUniform4fv(glGetUniformLocation(program, "color"), 1, &color[0]);
+            glUniform1f(glGetUniformLocation(program, "intensity"), value);
+            glUniform1i(glGetUniformLocation(program, "mode"), 1);
+        });
+
+        const double byName = Measure(iterations, [&](float value) {
+            shader.SetMat4("model", glm::mat4(value));
+            shader.SetMat4("view", view);
+            shader.SetMat4("projection", projection);
+            shader.SetVec4("color", color);
+            shader.SetFloat("intensity", value);
+            shader.SetInt("mode", 1);
+        });
+
+        const Circe::UniformHandle model = shader.GetUniform("model");
+        const Circe::UniformHandle viewHandle = shader.GetUniform("view");
+        const Circe::UniformHandle projectionHandle = shader.GetUniform("projection");
+        const Circe::UniformHandle colorHandle = shader.GetUniform("color");
+        const Circe::UniformHandle intensity = shader.GetUniform("intensity");
+        const Circe::UniformHandle mode = shader.GetUniform("mode");
+        const double byHandle = Measure(iterations, [&](float value) {
+            shader.SetMat4(model, glm::mat4(value));
+            shader.SetMat4(viewHandle, view);
+            shader.SetMat4(projectionHandle, projection);
+            shader.SetVec4(colorHandle, color);
+            shader.SetFloat(intensity, value);
+            shader.SetInt(mode, 1);
+        });
+
+        std::cout << iterations << " draws, 6 uniforms each" << std::endl;
+        std::cout << "glGetUniformLocation | " << lookup << " ns/draw" << std::endl;
+        std::cout << "name setters         | " << byName << " ns/draw | " << lookup / byName << "x" << std::endl;
+        std::cout << "handles              | " << byHandle << " ns/draw | " << lookup / byHandle << "x" << std::endl;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        result = 1;
+    }
+    return result;
+}
@@ -0,0 +1,268 @@
+#include <Core/Jobs/JobSystem.h>
+#include <Renderer/Mesh.h>
+#include <Renderer/VertexEncoding.h>
+#include <Renderer/VertexLayout.h>
+#include <Ressources/ModelLoader.h>
+
+#include "CheckHarness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    namespace Encoding = Circe::VertexEncoding;
+
+    // Lanes that run through the SIMD body must match the scalar tail (count 1) bit for bit
+    template <typename Out, typename Encode>
+    void CheckMatchesScalar(const char* name, const float* input, size_t count, size_t inputPerOutput, size_t outputsPerItem, Encode encode) {
+        std::vector<Out> batch(count * outputsPerItem);
+        encode(input, batch.data(), count);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < count; ++i) {
+            Out single[4] = {};
+            encode(input + i * inputPerOutput, single, 1);
+            mismatches += std::memcmp(single, batch.data() + i * outputsPerItem, outputsPerItem * sizeof(Out)) != 0 ? 1 : 0;
+        }
+        CheckHarness::Check(name, mismatches == 0, "SIMD vs scalar mismatches " + std::to_string(mismatches));
+    }
+
+    std::vector<float> RandomFloats(std::mt19937& random, size_t count, float low, float high) {
+        std::uniform_real_distribution<float> distribution(low, high);
+        std::vector<float> values(count);
+        for (float& value : values) {
+            value = distribution(random);
+        }
+        return values;
+    }
+
+    std::vector<float> RandomUnitVectors(std::mt19937& random, size_t count) {
+        std::normal_distribution<float> distribution;
+        std::vector<float> values(count * 3);
+        for (size_t i = 0; i < count; ++i) {
+            const glm::vec3 v = glm::normalize(glm::vec3(distribution(random), distribution(random), distribution(random)));
+            values[i * 3 + 0] = v.x;
+            values[i * 3 + 1] = v.y;
+            values[i * 3 + 2] = v.z;
+        }
+        // Poles and axes, where the octahedral fold has its edges
+        const float axes[] = { 1, 0, 0, -1, 0, 0, 0, 1, 0, 0, -1, 0, 0, 0, 1, 0, 0, -1 };
+        std::copy(std::begin(axes), std::end(axes), values.begin());
+        return values;
+    }
+
+    void CheckKernels() {
+        std::mt19937 random(1234);
+        const size_t count = 100003;
+
+        // Half: relative 2^-11 in the normal range, absolute 2^-25 below it
+        {
+            std::vector<float> input = RandomFloats(random, count, -60000.0f, 60000.0f);
+            const std::vector<float> small = RandomFloats(random, count, -1e-4f, 1e-4f);
+            input.insert(input.end(), small.begin(), small.end());
+            input.insert(input.end(), { 0.0f, -0.0f, 65504.0f, -65504.0f, 6.1035156e-5f, 5.9604645e-8f });
+            std::vector<uint16_t> encoded(input.size());
+            std::vector<float> decoded(input.size());
+            Encoding::EncodeHalf(input.data(), encoded.data(), input.size());
+            Encoding::DecodeHalf(encoded.data(), decoded.data(), input.size());
+            double worst = 0.0;
+            for (size_t i = 0; i < input.size(); ++i) {
+                const double allowed = std::max(std::fabs(input[i]) * std::ldexp(1.0, -11), std::ldexp(1.0, -25));
+                worst = std::max(worst, std::fabs(decoded[i] - input[i]) / allowed);
+            }
+            CheckHarness::CheckError("half round trip (in units of the bound)", worst, 1.0);
+            CheckMatchesScalar<uint16_t>("half", input.data(), input.size(), 1, 1, Encoding::EncodeHalf);
+
+            const float special[] = { 1e6f, -1e6f, std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN() };
+            uint16_t specialEncoded[4];
+            Encoding::EncodeHalf(special, specialEncoded, 4);
+            const bool specialOk = specialEncoded[0] == 0x7C00 && specialEncoded[1] == 0xFC00 && specialEncoded[2] == 0x7C00 && specialEncoded[3] == 0x7E00;
+            CheckHarness::Check("half overflow/inf/NaN", specialOk);
+        }
+
+        // UNORM16 / UNORM8: half a step (plus float rounding of the scaled input), inputs outside [0, 1] clamp
+        {
+            const std::vector<float> input = RandomFloats(random, count, -0.25f, 1.25f);
+            std::vector<uint16_t> words(count);
+            std::vector<uint8_t> bytes(count);
+            Encoding::EncodeUNorm16(input.data(), words.data(), count);
+            Encoding::EncodeUNorm8(input.data(), bytes.data(), count);
+            double worst16 = 0.0;
+            double worst8 = 0.0;
+            for (size_t i = 0; i < count; ++i) {
+                const double expected = std::clamp(input[i], 0.0f, 1.0f);
+                worst16 = std::max(worst16, std::fabs(words[i] / 65535.0 - expected));
+                worst8 = std::max(worst8, std::fabs(bytes[i] / 255.0 - expected));
+            }
+            CheckHarness::CheckError("unorm16 round trip", worst16, 0.5 / 65535.0 + 1e-7);
+            CheckHarness::CheckError("unorm8 round trip", worst8, 0.5 / 255.0 + 1e-7);
+            CheckMatchesScalar<uint16_t>("unorm16", input.data(), count, 1, 1, Encoding::EncodeUNorm16);
+            CheckMatchesScalar<uint8_t>("unorm8", input.data(), count, 1, 1, Encoding::EncodeUNorm8);
+        }
+
+        // 10-10-10-2: half a step per axis, w exact for tangent handedness
+        {
+            const std::vector<float> directions = RandomUnitVectors(random, count);
+            std::vector<float> input(count * 4);
+            for (size_t i = 0; i < count; ++i) {
+                std::copy_n(directions.data() + i * 3, 3, input.data() + i * 4);
+                input[i * 4 + 3] = (i % 3 == 0) ? -1.0f : (i % 3 == 1 ? 0.0f : 1.0f);
+            }
+            std::vector<uint32_t> packed(count);
+            Encoding::EncodeSNorm10x3_2(input.data(), packed.data(), count);
+            double worst = 0.0;
+            double worstW = 0.0;
+            for (size_t i = 0; i < count; ++i) {
+                const glm::vec4 decoded = Encoding::DecodeSNorm10x3_2(packed[i]);
+                for (int c = 0; c < 3; ++c) {
+                    worst = std::max(worst, static_cast<double>(std::fabs(decoded[c] - input[i * 4 + c])));
+                }
+                worstW = std::max(worstW, static_cast<double>(std::fabs(decoded.w - input[i * 4 + 3])));
+            }
+            CheckHarness::CheckError("snorm 10-10-10-2 round trip", worst, 0.5 / 511.0 + 1e-7);
+            CheckHarness::CheckError("snorm 10-10-10-2 handedness", worstW, 0.0);
+            CheckMatchesScalar<uint32_t>("snorm 10-10-10-2", input.data(), count, 4, 1, Encoding::EncodeSNorm10x3_2);
+        }
+
+        // Octahedral: distance between unit vectors after decode
+        {
+            const std::vector<float> input = RandomUnitVectors(random, count);
+            std::vector<int16_t> encoded(count * 2);
+            Encoding::EncodeOctahedral(input.data(), encoded.data(), count);
+            double worst = 0.0;
+            for (size_t i = 0; i < count; ++i) {
+                const glm::vec3 decoded = Encoding::DecodeOctahedral(encoded.data() + i * 2);
+                const glm::vec3 original(input[i * 3], input[i * 3 + 1], input[i * 3 + 2]);
+                worst = std::max(worst, static_cast<double>(glm::length(decoded - original)));
+            }
+            CheckHarness::CheckError("octahedral round trip", worst, 1e-4);
+            CheckMatchesScalar<int16_t>("octahedral", input.data(), count, 3, 2, Encoding::EncodeOctahedral);
+        }
+
+        // Index narrowing is exact
+        {
+            std::vector<uint32_t> indices(count);
+            for (size_t i = 0; i < count; ++i) {
+                indices[i] = static_cast<uint32_t>((i * 7919) % 65536);
+            }
+            std::vector<uint16_t> narrow(count);
+            Encoding::NarrowIndices(indices.data(), narrow.data(), count);
+            size_t mismatches = 0;
+            for (size_t i = 0; i < count; ++i) {
+                mismatches += narrow[i] != indices[i] ? 1 : 0;
+            }
+            CheckHarness::Check("16-bit index narrowing", mismatches == 0, "mismatches " + std::to_string(mismatches));
+        }
+    }
+
+    template <typename Function>
+    double Throughput(size_t bytes, Function function) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return bytes / (1024.0 * 1024.0) / seconds;
+    }
+
+    void MeasureKernels() {
+        std::mt19937 random(42);
+        const size_t count = 1 << 22;
+        const std::vector<float> input = RandomFloats(random, count * 4, -1.0f, 1.0f);
+        std::vector<uint32_t> output(count * 2);
+        const size_t inputBytes = input.size() * sizeof(float);
+
+        std::cout << "half     " << Throughput(inputBytes, [&] { Encoding::EncodeHalf(input.data(), reinterpret_cast<uint16_t*>(output.data()), input.size()); }) << " MB/s in" << std::endl;
+        std::cout << "unorm16  " << Throughput(inputBytes, [&] { Encoding::EncodeUNorm16(input.data(), reinterpret_cast<uint16_t*>(output.data()), input.size()); }) << " MB/s in" << std::endl;
+        std::cout << "10-10-10 " << Throughput(inputBytes, [&] { Encoding::EncodeSNorm10x3_2(input.data(), output.data(), count); }) << " MB/s in" << std::endl;
+        std::cout << "oct16    " << Throughput(count * 12, [&] { Encoding::EncodeOctahedral(input.data(), reinterpret_cast<int16_t*>(output.data()), count); }) << " MB/s in" << std::endl;
+    }
+
+    std::string FormatBytes(size_t bytes) {
+        return std::to_string(bytes / 1024) + " KiB";
+    }
+
+    // Bytes saved per mesh with the compact layout, and the largest error it introduces
+    void ReportMeshes(const std::string& name, const Circe::ModelData& model) {
+        for (size_t i = 0; i < model.Meshes.size(); ++i) {
+            const Circe::MeshData& mesh = model.Meshes[i];
+            const bool unitTexCoords = Encoding::TexCoordsInUnitRange(mesh.Vertices.data(), mesh.Vertices.size());
+            const Circe::VertexLayout layout = Circe::VertexLayout::Compact(unitTexCoords);
+            const Circe::MeshMemoryStats stats = Circe::Mesh::EstimateMemory(layout, mesh.Vertices.size(), mesh.Indices.size());
+
+            Circe::VertexSource source;
+            source.Vertices = mesh.Vertices.data();
+            source.Count = mesh.Vertices.size();
+            const Circe::PackedVertices packed = Encoding::Pack(source, layout);
+
+            // Stream 0 holds half4 positions
+            float positionError = 0.0f;
+            for (size_t v = 0; v < mesh.Vertices.size(); ++v) {
+                float decoded[4];
+                Encoding::DecodeHalf(reinterpret_cast<const uint16_t*>(packed.Streams[0].data() + v * layout.GetStride(0)), decoded, 4);
+                for (int c = 0; c < 3; ++c) {
+                    positionError = std::max(positionError, std::fabs(decoded[c] - mesh.Vertices[v].position[c]));
+                }
+            }
+
+            std::cout << name << " mesh " << i
+                << " | " << mesh.Vertices.size() << " vertices, " << mesh.Indices.size() / 3 << " triangles"
+                << " | " << FormatBytes(stats.StandardBytes) << " -> " << FormatBytes(stats.GetBytes())
+                << " | saved " << FormatBytes(stats.GetBytesSaved())
+                << " (" << (stats.StandardBytes ? 100.0 * stats.GetBytesSaved() / stats.StandardBytes : 0.0) << "%)"
+                << " | " << (Circe::VertexLayout::SelectIndexFormat(mesh.Vertices.size()) == Circe::IndexFormat::UInt16 ? "u16" : "u32") << " indices"
+                << " | " << (unitTexCoords ? "unorm16" : "half") << " uv"
+                << " | max position error " << positionError << std::endl;
+        }
+    }
+
+    Circe::ModelData MakeGrid(int side, float extent) {
+        Circe::ModelData model;
+        Circe::MeshData& mesh = model.Meshes.emplace_back();
+        for (int y = 0; y <= side; y++) {
+            for (int x = 0; x <= side; x++) {
+                const float u = static_cast<float>(x) / side;
+                const float v = static_cast<float>(y) / side;
+                mesh.Vertices.push_back({ { u * extent, 0.0f, v * extent }, { 0.0f, 1.0f, 0.0f }, { u, v } });
+            }
+        }
+        for (int y = 0; y < side; y++) {
+            for (int x = 0; x < side; x++) {
+                const unsigned int a = y * (side + 1) + x;
+                mesh.Indices.insert(mesh.Indices.end(), { a, a + 1, a + side + 2, a, a + side + 2, a + side + 1 });
+            }
+        }
+        return model;
+    }
+
+}
+
+// Usage: VertexCompression [model files...]
+// Checks the vertex encoders against their round-trip error bounds, times them, and reports
+// the bytes the compact layout saves per mesh (generated grids, plus any models given).
+// Exits non-zero when a bound is violated.
+int main(int argc, char** argv) {
+    CheckKernels();
+    MeasureKernels();
+
+    ReportMeshes("grid 100x100", MakeGrid(100, 10.0f));
+    ReportMeshes("grid 1000x1000", MakeGrid(1000, 100.0f));
+
+    Circe::JobSystem::Initialize();
+    for (int i = 1; i < argc; i++) {
+        try {
+            ReportMeshes(argv[i], Circe::ModelLoader::LoadData(argv[i]));
+        } catch (const std::exception& error) {
+            CheckHarness::Check(argv[i], false, error.what());
+        }
+    }
+    Circe::JobSystem::Shutdown();
+
+    return CheckHarness::Finish();
+}
@@ -0,0 +1,61 @@
+#include <Core/Jobs/JobSystem.h>
+#include <Ressources/CookedMesh.h>
+#include <Ressources/ModelLoader.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Usage: MeshCooker [--no-optimize] [--no-normals] [-o output.cmesh] source...
+// Converts OBJ/glTF/GLB sources into the cooked .cmesh format next to each source,
+// or to the -o path when cooking a single file.
+int main(int argc, char** argv) {
+    Circe::ModelLoadOptions options;
+    std::string output;
+    std::vector<std::string> sources;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--no-optimize") == 0) {
+            options.Optimize = false;
+        } else if (std::strcmp(argv[i], "--no-normals") == 0) {
+            options.GenerateNormals = false;
+        } else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            sources.push_back(argv[i]);
+        }
+    }
+
+    if (sources.empty() || (!output.empty() && sources.size() > 1)) {
+        std::cerr << "Usage: MeshCooker [--no-optimize] [--no-normals] [-o output.cmesh] source..." << std::endl;
+        return 2;
+    }
+
+    Circe::JobSystem::Initialize();
+
+    int result = 0;
+    for (const std::string& source : sources) {
+        const std::string target = output.empty()
+            ? std::filesystem::path(source).replace_extension(".cmesh").string()
+            : output;
+        try {
+            const auto start = std::chrono::steady_clock::now();
+            const Circe::ModelData model = Circe::ModelLoader::LoadData(source, options);
+            Circe::CookedMesh::Write(model, target);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::cout << source << " -> " << target
+                << " | " << model.Meshes.size() << " meshes, " << model.GetTriangleCount() << " triangles"
+                << " | " << std::filesystem::file_size(target) / 1024 << " KiB"
+                << " | " << seconds * 1000.0 << " ms" << std::endl;
+        } catch (const std::exception& error) {
+            std::cerr << source << ": " << error.what() << std::endl;
+            result = 1;
+        }
+    }
+
+    Circe::JobSystem::Shutdown();
+    return result;
+}
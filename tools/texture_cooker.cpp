@@ -0,0 +1,125 @@
+#include <Core/Jobs/JobSystem.h>
+#include <Renderer/Ktx2.h>
+#include <Renderer/TextureCompression.h>
+#include <stb_image.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    bool ParseFormat(const std::string& name, Circe::TextureFormat& format) {
+        static const std::pair<const char*, Circe::TextureFormat> Formats[] = {
+            { "rgba8", Circe::TextureFormat::RGBA8 },
+            { "bc1", Circe::TextureFormat::BC1 },
+            { "bc3", Circe::TextureFormat::BC3 },
+            { "bc5", Circe::TextureFormat::BC5 },
+            { "bc7", Circe::TextureFormat::BC7 },
+        };
+        for (const auto& [key, value] : Formats) {
+            if (name == key) {
+                format = value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool HasAlpha(const unsigned char* pixels, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            if (pixels[i * 4 + 3] != 255) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+}
+
+// Usage: TextureCooker [--format auto|bc1|bc3|bc5|bc7|rgba8] [--linear] [--filter box|kaiser] [-o output.ktx2] source...
+// Converts PNG/JPEG/TGA sources into .ktx2 files with a precomputed mip chain, next to each
+// source or to the -o path when cooking a single file. auto picks BC7 for color data and BC5
+// for --linear data (normal maps). Color is treated as sRGB unless --linear is given.
+int main(int argc, char** argv) {
+    std::string formatName = "auto";
+    bool linear = false;
+    Circe::MipFilter filter = Circe::MipFilter::Kaiser;
+    std::string output;
+    std::vector<std::string> sources;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            formatName = argv[++i];
+        } else if (std::strcmp(argv[i], "--linear") == 0) {
+            linear = true;
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = std::strcmp(argv[++i], "box") == 0 ? Circe::MipFilter::Box : Circe::MipFilter::Kaiser;
+        } else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            sources.push_back(argv[i]);
+        }
+    }
+
+    Circe::TextureFormat format = Circe::TextureFormat::BC7;
+    if (formatName == "auto") {
+        format = linear ? Circe::TextureFormat::BC5 : Circe::TextureFormat::BC7;
+    } else if (!ParseFormat(formatName, format)) {
+        sources.clear();
+    }
+    if (sources.empty() || (!output.empty() && sources.size() > 1)) {
+        std::cerr << "Usage: TextureCooker [--format auto|bc1|bc3|bc5|bc7|rgba8] [--linear] [--filter box|kaiser] [-o output.ktx2] source..." << std::endl;
+        return 2;
+    }
+
+    Circe::JobSystem::Initialize();
+
+    int result = 0;
+    for (const std::string& source : sources) {
+        const std::string target = output.empty()
+            ? std::filesystem::path(source).replace_extension(".ktx2").string()
+            : output;
+        try {
+            const auto start = std::chrono::steady_clock::now();
+            int width = 0;
+            int height = 0;
+            int channels = 0;
+            std::unique_ptr<unsigned char, void (*)(void*)> pixels(stbi_load(source.c_str(), &width, &height, &channels, STBI_rgb_alpha), stbi_image_free);
+            if (!pixels) {
+                throw std::runtime_error(std::string("Failed to load image: ") + stbi_failure_reason());
+            }
+            if (format == Circe::TextureFormat::BC1 && HasAlpha(pixels.get(), static_cast<size_t>(width) * height)) {
+                std::cout << source << ": BC1 keeps 1-bit alpha only, consider --format bc3 or bc7" << std::endl;
+            }
+
+            const Circe::TextureImage mips = Circe::TextureCompression::GenerateMips(pixels.get(), width, height, !linear, filter);
+            const Circe::TextureImage cooked = Circe::TextureCompression::Compress(mips, format);
+            Circe::Ktx2::Write(cooked, target);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            // Quality of the top level, over the channels the format keeps
+            const Circe::TextureImage decoded = Circe::TextureCompression::Decompress(cooked);
+            const int compared = format == Circe::TextureFormat::BC5 ? 2 : format == Circe::TextureFormat::BC1 ? 3 : 4;
+            const double psnr = Circe::TextureCompression::ComputePSNR(pixels.get(), decoded.GetLevelData(0), width, height, compared);
+
+            std::cout << source << " -> " << target
+                << " | " << width << "x" << height << " " << Circe::TextureCompression::GetFormatName(format)
+                << ", " << cooked.Levels.size() << " levels"
+                << " | " << cooked.Data.size() / 1024 << " KiB (RGBA8 " << mips.Data.size() / 1024 << " KiB)"
+                << " | PSNR " << psnr << " dB"
+                << " | " << seconds * 1000.0 << " ms" << std::endl;
+        } catch (const std::exception& error) {
+            std::cerr << source << ": " << error.what() << std::endl;
+            result = 1;
+        }
+    }
+
+    Circe::JobSystem::Shutdown();
+    return result;
+}